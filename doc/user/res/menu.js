@@ -30,6 +30,7 @@ function headerAndContentsMenu(pageName, relativePath) {
                                 { "level": 2, "label": "SingleCellView", "link": "user/plugins/simulation/SingleCellView.html", "subMenuItem": true },
                                 { "level": 1, "label": "Solver", "subMenuHeader": true },
                                 { "level": 2, "label": "CVODESolver", "link": "user/plugins/solver/CVODESolver.html", "subMenuItem": true },
+                                { "level": 2, "label": "DormandPrinceSolver", "link": "user/plugins/solver/DormandPrinceSolver.html", "subMenuItem": true },
                                 { "level": 2, "label": "ForwardEulerSolver", "link": "user/plugins/solver/ForwardEulerSolver.html", "subMenuItem": true },
                                 { "level": 2, "label": "FourthOrderRungeKuttaSolver", "link": "user/plugins/solver/FourthOrderRungeKuttaSolver.html", "subMenuItem": true },
                                 { "level": 2, "label": "HeunSolver", "link": "user/plugins/solver/HeunSolver.html", "subMenuItem": true },
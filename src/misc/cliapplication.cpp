@@ -23,6 +23,7 @@ limitations under the License.
 #include "cliapplication.h"
 #include "cliinterface.h"
 #include "cliutils.h"
+#include "plugininterface.h"
 #include "pluginmanager.h"
 
 //==============================================================================
@@ -77,6 +78,18 @@ void CliApplication::loadPlugins()
         if (qobject_cast<CliInterface *>(plugin->instance()))
             mLoadedCliPlugins << plugin;
     }
+
+    // Let our CLI plugins know that all the plugins have been loaded, so that
+    // they can retrieve the interfaces (e.g. solvers) they need
+    // Note: unlike in GUI mode, we don't initialise our CLI plugins since this
+    //       would result in some GUI-related objects being created...
+
+    foreach (Plugin *plugin, mLoadedCliPlugins) {
+        PluginInterface *pluginInterface = qobject_cast<PluginInterface *>(plugin->instance());
+
+        if (pluginInterface)
+            pluginInterface->pluginsInitialized(mPluginManager->loadedPlugins());
+    }
 }
 
 //==============================================================================
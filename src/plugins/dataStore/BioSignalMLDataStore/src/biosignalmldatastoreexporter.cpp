@@ -78,11 +78,24 @@ void BiosignalmlDataStoreExporter::execute(QString &pErrorMessage) const
         recording->set_label(dataStoreData->shortName().toStdString());
 
         // Create and poluate a clock
+        // Note: our variable of integration stores its values in chunks, so we
+        //       need to gather them before we can create our clock...
+
+        std::vector<double> times;
+
+        times.reserve(voi->size());
+
+        for (int i = 0, iMax = voi->chunksCount(); i < iMax; ++i) {
+            qulonglong chunkSize;
+            const double *chunk = voi->chunk(i, chunkSize);
+
+            times.insert(times.end(), chunk, chunk+chunkSize);
+        }
 
         bsml::HDF5::Clock::Ptr clock = recording->new_clock(recordingUri+"/clock/"+voi->uri().toStdString(),
                                                             rdf::URI(baseUnits+voi->unit().toStdString()),
-                                                            voi->values(),
-                                                            voi->size());
+                                                            times.data(),
+                                                            times.size());
 
         clock->set_label(voi->label().toStdString());
 
@@ -96,7 +109,8 @@ void BiosignalmlDataStoreExporter::execute(QString &pErrorMessage) const
         int nbOfVariables = variables.size();
 
         for (int i = 0;  i < nbOfVariables; ++i) {
-            if (dataStoreData->selectedVariables()[i]) {
+            if (   dataStoreData->selectedVariables()[i]
+                && variables[i]->isRecorded()) {
                 uris.push_back(recordingUri+"/signal/"+variables[i]->uri().toStdString());
                 units.push_back(rdf::URI(baseUnits+variables[i]->unit().toStdString()));
                 indexes.push_back(i);
@@ -20,12 +20,15 @@ limitations under the License.
 // CSV data store exporter
 //==============================================================================
 
-#include "corecliutils.h"
 #include "csvdatastoreexporter.h"
 
 //==============================================================================
 
-#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QSaveFile>
+#include <QThread>
+#include <QtConcurrentRun>
 
 //==============================================================================
 
@@ -43,52 +46,155 @@ CsvDataStoreExporter::CsvDataStoreExporter(const QString &pFileName,
 
 //==============================================================================
 
-void CsvDataStoreExporter::execute(QString &pErrorMessage) const
+static QByteArray formatRows(DataStore::DataStoreVariable *pVoi,
+                             const DataStore::DataStoreVariables &pVariables,
+                             const qulonglong &pFrom, const qulonglong &pTo)
 {
-    Q_UNUSED(pErrorMessage);
+    // Format the given range of rows
+    // Note #1: we go through our range one chunk at a time, so that we can
+    //          directly access the values of our variables rather than retrieve
+    //          them one by one...
+    // Note #2: a variable that holds a single value doesn't have any chunk, in
+    //          which case we use that value for all of our rows...
+
+    DataStore::DataStoreVariables variables = DataStore::DataStoreVariables() << pVoi << pVariables;
+    int variablesCount = variables.count();
+    QVector<const double *> values(variablesCount);
+    QVector<int> steps(variablesCount);
+    QVector<double> singleValues(variablesCount);
+    QByteArray res = QByteArray();
+    char buffer[DataStore::ValueBufferSize];
+
+    res.reserve(int(pTo-pFrom)*variablesCount*16);
+
+    for (qulonglong i = pFrom; i < pTo;) {
+        // Retrieve the values of our variables for the current chunk
+
+        int chunkIndex = int(i >> DataStore::ChunkShift);
+        qulonglong offset = i & DataStore::ChunkMask;
+        qulonglong rowsCount = qMin(pTo-i, qulonglong(DataStore::ChunkSize)-offset);
+
+        for (int j = 0; j < variablesCount; ++j) {
+            qulonglong chunkSize;
+            const double *chunk = variables[j]->chunk(chunkIndex, chunkSize);
+
+            Q_ASSERT(offset+rowsCount <= chunkSize);
+
+            if (chunk) {
+                values[j] = chunk+offset;
+                steps[j] = 1;
+            } else {
+                singleValues[j] = variables[j]->value(i);
+                values[j] = singleValues.constData()+j;
+                steps[j] = 0;
+            }
+        }
+
+        // Format the rows that are in the current chunk
+
+        for (qulonglong k = 0; k < rowsCount; ++k) {
+            for (int j = 0; j < variablesCount; ++j) {
+                if (j)
+                    res.append(',');
+
+                res.append(buffer, DataStore::formatValue(buffer, *values[j]));
+
+                values[j] += steps[j];
+            }
+
+            res.append('\n');
+        }
 
-    // Header
+        i += rowsCount;
+    }
+
+    return res;
+}
+
+//==============================================================================
+
+void CsvDataStoreExporter::execute(QString &pErrorMessage) const
+{
+    // Export our data store to a CSV file
+    // Note: we stream our data to our file as we go along, rather than build
+    //       all of it in memory first. Also, our rows are formatted in blocks,
+    //       which are formatted in parallel if we have several cores...
 
     static const QString Header = "%1 (%2)";
+    static const int RowsPerBlock = 4096;
+    static const qint64 ProgressInterval = 250;
 
-    DataStore::DataStoreVariable *voi = mDataStore->voi();
-    DataStore::DataStoreVariables variables = mDataStore->variables();
+    QSaveFile file(mDataStoreData->fileName());
+
+    if (!file.open(QIODevice::WriteOnly)) {
+        pErrorMessage = QObject::tr("The simulation data could not be exported to CSV (the file could not be created).");
+
+        return;
+    }
 
-    QByteArray data = QByteArray();
+    // Determine the variables that are to be exported, and output our header
 
-    data += Header.arg(voi->uri().replace("/prime", "'").replace("/", " | "),
-                       voi->unit());
+    DataStore::DataStoreVariable *voi = mDataStore->voi();
+    DataStore::DataStoreVariables allVariables = mDataStore->variables();
+    DataStore::DataStoreVariables variables = DataStore::DataStoreVariables();
+
+    QByteArray header = Header.arg(voi->uri().replace("/prime", "'").replace("/", " | "),
+                                   voi->unit()).toUtf8();
 
-    auto variableBegin = variables.constBegin();
-    auto variableEnd = variables.constEnd();
+    for (auto variable = allVariables.constBegin(), variableEnd = allVariables.constEnd();
+         variable != variableEnd; ++variable) {
+        if ((*variable)->isValid() && (*variable)->isRecorded()) {
+            header += ","+Header.arg((*variable)->uri().replace("/prime", "'").replace("/", " | "),
+                                     (*variable)->unit()).toUtf8();
 
-    for (auto variable = variableBegin; variable != variableEnd; ++variable) {
-        if ((*variable)->isValid()) {
-            data += ","+Header.arg((*variable)->uri().replace("/prime", "'").replace("/", " | "),
-                                   (*variable)->unit());
+            variables << *variable;
         }
     }
 
-    data += "\n";
+    header += "\n";
+
+    bool ok = file.write(header) != -1;
+
+    // Output our data itself, letting people know about our progress every so
+    // often
 
-    // Data itself
+    qulonglong size = mDataStore->size();
+    int blocksCount = qMax(QThread::idealThreadCount(), 1);
+    QElapsedTimer timer;
 
-    for (qulonglong i = 0; i < mDataStore->size(); ++i) {
-        data += QString::number(voi->value(i));
+    timer.start();
 
-        for (auto variable = variableBegin; variable != variableEnd; ++variable) {
-            if ((*variable)->isValid())
-                data += ","+QString::number((*variable)->value(i));
+    for (qulonglong i = 0; ok && (i < size);) {
+        QList<QFuture<QByteArray>> futures = QList<QFuture<QByteArray>>();
+
+        for (int j = 0; (j < blocksCount) && (i < size); ++j) {
+            qulonglong to = qMin(i+RowsPerBlock, size);
+
+            futures << QtConcurrent::run(formatRows, voi, variables, i, to);
+
+            i = to;
         }
 
-        data += "\n";
+        foreach (QFuture<QByteArray> future, futures) {
+            if (ok)
+                ok = file.write(future.result()) != -1;
+            else
+                future.waitForFinished();
+        }
 
-        emit progress(double(i)/(mDataStore->size()-1));
+        if (timer.elapsed() >= ProgressInterval) {
+            emit progress(double(i)/size);
+
+            timer.restart();
+        }
     }
 
-    // The data is ready, so write it to the file
+    emit progress(1.0);
+
+    // Commit our file, i.e. make it our final file if everything went fine
 
-    Core::writeFileContentsToFile(mDataStoreData->fileName(), data);
+    if (!ok || !file.commit())
+        pErrorMessage = QObject::tr("The simulation data could not be exported to CSV (the file could not be saved).");
 }
 
 //==============================================================================
@@ -24,7 +24,17 @@ limitations under the License.
 
 //==============================================================================
 
+#include <QDir>
+#include <QTemporaryFile>
 #include <QThread>
+#include <QtNumeric>
+
+//==============================================================================
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
 
 //==============================================================================
 
@@ -49,16 +59,62 @@ QString DataStoreData::fileName() const
 
 //==============================================================================
 
-DataStoreVariable::DataStoreVariable(const qulonglong &pSize, double *pValue) :
+static quint64 doubleToBits(const double &pValue)
+{
+    // Return the bit pattern of the given double value
+
+    quint64 res;
+
+    memcpy(&res, &pValue, sizeof(res));
+
+    return res;
+}
+
+//==============================================================================
+
+static double bitsToDouble(const quint64 &pBits)
+{
+    // Return the double value that has the given bit pattern
+
+    double res;
+
+    memcpy(&res, &pBits, sizeof(res));
+
+    return res;
+}
+
+//==============================================================================
+
+DataStoreVariable::DataStoreVariable(const qulonglong &pCapacity,
+                                     const QString &pScratchDirName,
+                                     double *pValue) :
     mUri(QString()),
     mName(QString()),
     mUnit(QString()),
-    mSize(pSize),
-    mValue(pValue)
+    mRecorded(true),
+    mConstant(false),
+    mCapacity(pCapacity),
+    mSize(0),
+    mMinimum(doubleToBits(qQNaN())),
+    mMaximum(doubleToBits(qQNaN())),
+    mValue(pValue),
+    mScratchDirName(pScratchDirName),
+    mScratchFile(0),
+    mSegments(0),
+    mSingleValue(0),
+    mConstantValue(0.0)
 {
-    // Create our array of values
-
-    mValues = new double[pSize];
+    // Create our (empty) table of chunks
+    // Note: our values are stored in chunks of ChunkSize values, which get
+    //       allocated as values are being set. This means that we only use
+    //       the memory we really need (e.g. when a simulation gets stopped
+    //       early), not to mention that we don't need one big contiguous block
+    //       of memory. Also, if we have a scratch directory, then our chunks
+    //       live in a (temporary) file in that directory, which is
+    //       memory-mapped (see mapChunk()), so that we are not limited by the
+    //       amount of memory that is available...
+
+    mChunks = new double*[(pCapacity+ChunkMask) >> ChunkShift]();
 }
 
 //==============================================================================
@@ -66,8 +122,19 @@ DataStoreVariable::DataStoreVariable(const qulonglong &pSize, double *pValue) :
 DataStoreVariable::~DataStoreVariable()
 {
     // Delete some internal objects
+    // Note: deleting our scratch file, if any, unmaps our segments and removes
+    //       the file itself...
+
+    if (mScratchFile) {
+        delete mScratchFile;
 
-    delete[] mValues;
+        delete[] mSegments;
+    } else {
+        for (qulonglong i = 0, iMax = (mCapacity+ChunkMask) >> ChunkShift; i < iMax; ++i)
+            delete[] mChunks[i];
+    }
+
+    delete[] mChunks;
 }
 
 //==============================================================================
@@ -139,11 +206,228 @@ void DataStoreVariable::setUnit(const QString &pUnit)
 
 //==============================================================================
 
+bool DataStoreVariable::isRecorded() const
+{
+    // Return whether we are recorded
+
+    return mRecorded;
+}
+
+//==============================================================================
+
+void DataStoreVariable::setRecorded(const bool &pRecorded)
+{
+    // Set whether we are recorded
+    // Note: a variable that is not recorded gets ignored by
+    //       DataStore::setValues(), meaning that it never holds any value...
+
+    mRecorded = pRecorded;
+}
+
+//==============================================================================
+
+bool DataStoreVariable::isConstant() const
+{
+    // Return whether we are (expected to be) constant
+
+    return mConstant;
+}
+
+//==============================================================================
+
+void DataStoreVariable::setConstant(const bool &pConstant)
+{
+    // Set whether we are (expected to be) constant
+    // Note: a constant variable only holds a single value for as long as its
+    //       value doesn't change, at which point all of its values (so far)
+    //       get stored in chunks. This means that we don't need to do
+    //       anything else than to keep track of whether we are constant, and
+    //       that we are robust to a constant being modified in the middle of
+    //       a simulation (e.g. after a pause)...
+
+    Q_ASSERT(!mSize.load());
+
+    mConstant = pConstant;
+    mSingleValue.storeRelease(pConstant);
+}
+
+//==============================================================================
+
+qulonglong DataStoreVariable::capacity() const
+{
+    // Return our capacity
+
+    return mCapacity;
+}
+
+//==============================================================================
+
 qulonglong DataStoreVariable::size() const
 {
-    // Return our size
+    // Return our size, i.e. the number of values that have been set so far
 
-    return mSize;
+    return mSize.loadAcquire();
+}
+
+//==============================================================================
+
+double DataStoreVariable::minimum() const
+{
+    // Return our minimum value, i.e. the smallest value that has been set so
+    // far (NaN values excepted), or NaN if no value has been set
+
+    return bitsToDouble(mMinimum.loadAcquire());
+}
+
+//==============================================================================
+
+double DataStoreVariable::maximum() const
+{
+    // Return our maximum value, i.e. the biggest value that has been set so far
+    // (NaN values excepted), or NaN if no value has been set
+
+    return bitsToDouble(mMaximum.loadAcquire());
+}
+
+//==============================================================================
+
+double * DataStoreVariable::chunkAt(const qulonglong &pPosition)
+{
+    // Return the chunk that contains the given position, after having created
+    // it, if needed
+    // Note: creating a chunk may throw an std::bad_alloc exception, which we
+    //       let our caller handle...
+
+    Q_ASSERT(pPosition < mCapacity);
+
+    double *&res = mChunks[pPosition >> ChunkShift];
+
+    if (!res) {
+        res = mScratchDirName.isEmpty()?
+                  new double[ChunkSize]:
+                  mapChunk(pPosition >> ChunkShift);
+    }
+
+    return res;
+}
+
+//==============================================================================
+
+double * DataStoreVariable::mapChunk(const qulonglong &pIndex)
+{
+    // Return the chunk at the given index from our scratch file, after having
+    // created our scratch file and/or memory-mapped the segment that contains
+    // the chunk, if needed
+    // Note #1: our scratch file is given its full size upon creation (which
+    //          doesn't use any disk space until something gets written to it,
+    //          at least on file systems that support sparse files), so that we
+    //          never have to resize it while some of it is mapped (something
+    //          that fails on Windows)...
+    // Note #2: we map our scratch file in segments of SegmentChunks chunks,
+    //          rather than chunk by chunk, so that we don't end up with more
+    //          mappings than the system allows (see vm.max_map_count on
+    //          Linux)...
+    // Note #3: we throw an std::bad_alloc exception if anything goes wrong, so
+    //          that our caller can handle things as if we had run out of
+    //          memory...
+
+    static const qint64 ChunkBytes = ChunkSize*sizeof(double);
+    static const qulonglong SegmentChunks = 512;
+
+    if (!mScratchFile) {
+        qulonglong chunksCount = (mCapacity+ChunkMask) >> ChunkShift;
+
+        mScratchFile = new QTemporaryFile(mScratchDirName+QDir::separator()+"OpenCOR-XXXXXX.dat");
+
+        if (   !mScratchFile->open()
+            || !mScratchFile->resize(qint64(chunksCount)*ChunkBytes)) {
+            delete mScratchFile;
+
+            mScratchFile = 0;
+
+            throw std::bad_alloc();
+        }
+
+        mSegments = new uchar*[(chunksCount+SegmentChunks-1)/SegmentChunks]();
+    }
+
+    qulonglong segmentIndex = pIndex/SegmentChunks;
+    uchar *&segment = mSegments[segmentIndex];
+
+    if (!segment) {
+        qint64 offset = qint64(segmentIndex*SegmentChunks)*ChunkBytes;
+
+        segment = mScratchFile->map(offset, qMin(qint64(SegmentChunks)*ChunkBytes,
+                                                 mScratchFile->size()-offset));
+
+        if (!segment)
+            throw std::bad_alloc();
+    }
+
+    return reinterpret_cast<double *>(segment+(pIndex%SegmentChunks)*ChunkBytes);
+}
+
+//==============================================================================
+
+void DataStoreVariable::doSetValue(const qulonglong &pPosition,
+                                   const double &pValue)
+{
+    // Keep track of our minimum and maximum values
+    // Note #1: we do it here, rather than compute them when needed, so that our
+    //          users (e.g. a graph that needs to know its bounding rectangle)
+    //          can retrieve them without having to go through all our
+    //          values...
+    // Note #2: our minimum and maximum values may be retrieved from another
+    //          thread (e.g. the GUI thread) while we are setting values, hence
+    //          we keep track of them as atomic bit patterns...
+
+    if (!qIsNaN(pValue)) {
+        double minimum = bitsToDouble(mMinimum.load());
+        double maximum = bitsToDouble(mMaximum.load());
+
+        if (qIsNaN(minimum) || (pValue < minimum))
+            mMinimum.storeRelease(doubleToBits(pValue));
+
+        if (qIsNaN(maximum) || (pValue > maximum))
+            mMaximum.storeRelease(doubleToBits(pValue));
+    }
+
+    // Set our value at the given position
+    // Note #1: our values may be read from another thread (e.g. by a graph)
+    //          while we are setting them, so we only let people know that we
+    //          don't hold a single value anymore once all of our values (so
+    //          far) have been stored in chunks, hence our use of
+    //          release/acquire semantics...
+    // Note #2: for the same reason, we only update our size once our value
+    //          has been set, so that our readers never access a value (or a
+    //          chunk) that is not there yet. We are the only ones to update our
+    //          size, hence we can use a relaxed load to retrieve it here...
+
+    qulonglong size = mSize.load();
+
+    if (mSingleValue.load()) {
+        // We currently hold a single value, so check whether that is still
+        // good enough and, if not, then store our values (so far) in chunks
+
+        if (!size || (pValue == mConstantValue)) {
+            mConstantValue = pValue;
+
+            if (pPosition >= size)
+                mSize.storeRelease(pPosition+1);
+
+            return;
+        }
+
+        for (qulonglong i = 0; i < size; ++i)
+            chunkAt(i)[i & ChunkMask] = mConstantValue;
+
+        mSingleValue.storeRelease(0);
+    }
+
+    chunkAt(pPosition)[pPosition & ChunkMask] = pValue;
+
+    if (pPosition >= size)
+        mSize.storeRelease(pPosition+1);
 }
 
 //==============================================================================
@@ -152,10 +436,9 @@ void DataStoreVariable::setValue(const qulonglong &pPosition)
 {
     // Set the value of the variable at the given position
 
-    Q_ASSERT(pPosition < mSize);
     Q_ASSERT(mValue);
 
-    mValues[pPosition] = *mValue;
+    doSetValue(pPosition, *mValue);
 }
 
 //==============================================================================
@@ -165,9 +448,7 @@ void DataStoreVariable::setValue(const qulonglong &pPosition,
 {
     // Set the value of the variable at the given position using the given value
 
-    Q_ASSERT(pPosition < mSize);
-
-    mValues[pPosition] = pValue;
+    doSetValue(pPosition, pValue);
 }
 
 //==============================================================================
@@ -176,26 +457,57 @@ double DataStoreVariable::value(const qulonglong &pPosition) const
 {
     // Return our value at the given position
 
-    Q_ASSERT(pPosition < mSize);
+    Q_ASSERT(pPosition < mSize.loadAcquire());
 
-    return mValues[pPosition];
+    if (mSingleValue.loadAcquire())
+        return mConstantValue;
+
+    return mChunks[pPosition >> ChunkShift][pPosition & ChunkMask];
 }
 
 //==============================================================================
 
-double * DataStoreVariable::values() const
+int DataStoreVariable::chunksCount() const
 {
-    // Return our values
+    // Return the number of chunks that contain our values
 
-    return mValues;
+    return int((mSize.loadAcquire()+ChunkMask) >> ChunkShift);
+}
+
+//==============================================================================
+
+const double * DataStoreVariable::chunk(const int &pIndex,
+                                        qulonglong &pSize) const
+{
+    // Return the chunk at the given index and its number of values, i.e.
+    // ChunkSize unless it is our last chunk, or no chunk at all if we hold a
+    // single value, in which case all our values are equal to value(0)
+    // Note: our size is only retrieved once, so that our chunk and its number
+    //       of values are consistent with one another even if values are
+    //       being set from another thread...
+
+    qulonglong size = mSize.loadAcquire();
+    qulonglong from = qulonglong(pIndex) << ChunkShift;
+
+    Q_ASSERT((pIndex >= 0) && (from < size));
+
+    pSize = qMin(qulonglong(ChunkSize), size-from);
+
+    if (mSingleValue.loadAcquire())
+        return 0;
+
+    return mChunks[pIndex];
 }
 
 //==============================================================================
 
 DataStore::DataStore(const QString &pUri,
-                     const qulonglong &pSize) :
+                     const qulonglong &pCapacity,
+                     const QString &pScratchDirName) :
     mlUri(pUri),
-    mSize(pSize),
+    mCapacity(pCapacity),
+    mSize(0),
+    mScratchDirName(pScratchDirName),
     mVoi(0),
     mVariables(0)
 {
@@ -226,9 +538,27 @@ QString DataStore::uri() const
 
 //==============================================================================
 
+QString DataStore::scratchDirName() const
+{
+    // Return the name of our scratch directory, if any
+
+    return mScratchDirName;
+}
+
+//==============================================================================
+
+qulonglong DataStore::capacity() const
+{
+    // Return our capacity
+
+    return mCapacity;
+}
+
+//==============================================================================
+
 qulonglong DataStore::size() const
 {
-    // Return our size
+    // Return our size, i.e. the number of positions that have been set so far
 
     return mSize;
 }
@@ -250,7 +580,7 @@ DataStoreVariable * DataStore::addVoi()
 
     delete mVoi;
 
-    mVoi = new DataStoreVariable(mSize);
+    mVoi = new DataStoreVariable(mCapacity, mScratchDirName);
 
     return mVoi;
 }
@@ -283,7 +613,7 @@ DataStoreVariable * DataStore::addVariable(double *pValue)
 {
     // Add a variable to our data store
 
-    DataStoreVariable *variable = new DataStoreVariable(mSize, pValue);
+    DataStoreVariable *variable = new DataStoreVariable(mCapacity, mScratchDirName, pValue);
 
     mVariables << variable;
 
@@ -300,7 +630,7 @@ DataStoreVariables DataStore::addVariables(const int &pCount,
     DataStoreVariables variables(pCount);
 
     for (int i = 0; i < pCount; ++i, ++pValues) {
-        variables[i] = new DataStoreVariable(mSize, pValues);
+        variables[i] = new DataStoreVariable(mCapacity, mScratchDirName, pValues);
 
         mVariables << variables[i];
     }
@@ -312,16 +642,68 @@ DataStoreVariables DataStore::addVariables(const int &pCount,
 
 void DataStore::setValues(const qulonglong &pPosition, const double &pValue)
 {
-    // Set the value at the given position of all our variables including our
-    // variable of integration, which value is directly given to us
+    // Set the value at the given position of all our recorded variables
+    // including our variable of integration, which value is directly given to
+    // us
+    // Note: this may throw an std::bad_alloc exception if a new chunk of
+    //       values cannot be allocated, in which case our size is left
+    //       untouched...
 
     if (mVoi)
         mVoi->setValue(pPosition, pValue);
 
     for (auto variable = mVariables.constBegin(), variableEnd = mVariables.constEnd();
          variable != variableEnd; ++variable) {
-        (*variable)->setValue(pPosition);
+        if ((*variable)->isRecorded())
+            (*variable)->setValue(pPosition);
     }
+
+    if (pPosition >= mSize)
+        mSize = pPosition+1;
+}
+
+//==============================================================================
+
+int formatValue(char *pBuffer, const double &pValue)
+{
+    // Format the given value using as few significant digits as possible while
+    // still making sure that it can be read back without any loss of precision
+    // Note: snprintf() and strtod() both rely on the current locale, hence we
+    //       only make sure that our decimal separator is a point once we know
+    //       how many significant digits we need...
+
+    if (qIsNaN(pValue)) {
+        qstrcpy(pBuffer, "nan");
+
+        return 3;
+    }
+
+    int res = 0;
+
+    for (int precision = 15; precision <= 17; ++precision) {
+        res = snprintf(pBuffer, ValueBufferSize, "%.*g", precision, pValue);
+
+        if (strtod(pBuffer, 0) == pValue)
+            break;
+    }
+
+    for (char *character = pBuffer; *character; ++character) {
+        if (*character == ',')
+            *character = '.';
+    }
+
+    return res;
+}
+
+//==============================================================================
+
+QByteArray formatValue(const double &pValue)
+{
+    // Format the given value (see above)
+
+    char buffer[ValueBufferSize];
+
+    return QByteArray(buffer, formatValue(buffer, pValue));
 }
 
 //==============================================================================
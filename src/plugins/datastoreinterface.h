@@ -28,10 +28,16 @@ limitations under the License.
 
 //==============================================================================
 
+#include <QAtomicInt>
+#include <QAtomicInteger>
 #include <QVector>
 
 //==============================================================================
 
+class QTemporaryFile;
+
+//==============================================================================
+
 namespace OpenCOR {
 namespace DataStore {
 
@@ -50,10 +56,20 @@ private:
 
 //==============================================================================
 
+enum {
+    ChunkShift = 14,
+    ChunkSize = 1 << ChunkShift,
+    ChunkMask = ChunkSize-1
+};
+
+//==============================================================================
+
 class DataStoreVariable
 {
 public:
-    explicit DataStoreVariable(const qulonglong &pSize, double *pValue = 0);
+    explicit DataStoreVariable(const qulonglong &pCapacity,
+                               const QString &pScratchDirName,
+                               double *pValue = 0);
     virtual ~DataStoreVariable();
 
     bool isValid() const;
@@ -67,23 +83,54 @@ public:
     QString unit() const;
     void setUnit(const QString &pUnit);
 
+    bool isRecorded() const;
+    void setRecorded(const bool &pRecorded);
+
+    bool isConstant() const;
+    void setConstant(const bool &pConstant);
+
+    qulonglong capacity() const;
     qulonglong size() const;
 
+    double minimum() const;
+    double maximum() const;
+
     void setValue(const qulonglong &pPosition);
     void setValue(const qulonglong &pPosition, const double &pValue);
 
     double value(const qulonglong &pPosition) const;
-    double * values() const;
+
+    int chunksCount() const;
+    const double * chunk(const int &pIndex, qulonglong &pSize) const;
 
 private:
     QString mUri;
     QString mName;
     QString mUnit;
 
-    qulonglong mSize;
+    bool mRecorded;
+    bool mConstant;
+
+    qulonglong mCapacity;
+    QAtomicInteger<qulonglong> mSize;
+
+    QAtomicInteger<quint64> mMinimum;
+    QAtomicInteger<quint64> mMaximum;
 
     double *mValue;
-    double *mValues;
+    double **mChunks;
+
+    QString mScratchDirName;
+    QTemporaryFile *mScratchFile;
+    uchar **mSegments;
+
+    QAtomicInt mSingleValue;
+    double mConstantValue;
+
+    double * chunkAt(const qulonglong &pPosition);
+    double * mapChunk(const qulonglong &pIndex);
+
+    void doSetValue(const qulonglong &pPosition, const double &pValue);
 };
 
 //==============================================================================
@@ -95,11 +142,15 @@ typedef QVector<DataStoreVariable *> DataStoreVariables;
 class DataStore
 {
 public:
-    explicit DataStore(const QString &pUri, const qulonglong &pSize);
+    explicit DataStore(const QString &pUri, const qulonglong &pCapacity,
+                       const QString &pScratchDirName = QString());
     virtual ~DataStore();
 
     QString uri() const;
 
+    QString scratchDirName() const;
+
+    qulonglong capacity() const;
     qulonglong size() const;
 
     DataStoreVariable * voi() const;
@@ -114,7 +165,10 @@ public:
 private:
     QString mlUri;
 
-    const qulonglong mSize;
+    const qulonglong mCapacity;
+    qulonglong mSize;
+
+    QString mScratchDirName;
 
     DataStoreVariable *mVoi;
     DataStoreVariables mVariables;
@@ -122,6 +176,18 @@ private:
 
 //==============================================================================
 
+// Note: a buffer of ValueBufferSize characters is big enough to hold any value
+//       formatted using formatValue()...
+
+static const int ValueBufferSize = 32;
+
+//==============================================================================
+
+int formatValue(char *pBuffer, const double &pValue);
+QByteArray formatValue(const double &pValue);
+
+//==============================================================================
+
 class DataStoreExporter : public QObject
 {
     Q_OBJECT
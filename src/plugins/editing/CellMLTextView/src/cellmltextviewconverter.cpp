@@ -141,9 +141,16 @@ bool CellMLTextViewConverter::execute(const QString &pRawCellml)
 
     if (domDocument.setContent(pRawCellml, true,
                                &mErrorMessage, &mErrorLine, &mErrorColumn)) {
+        // Get ready for our output
+        // Note: we reserve as much memory as the raw CellML uses, which should
+        //       be more than enough, so that our output doesn't need to be
+        //       reallocated as it grows...
+
         mOutput = QString();
         mIndent = QString();
 
+        mOutput.reserve(pRawCellml.size());
+
         mLastOutputType = None;
 
         mWarnings = CellMLTextViewConverterWarnings();
@@ -170,6 +177,10 @@ bool CellMLTextViewConverter::execute(const QString &pRawCellml)
             }
         }
 
+        // Release the memory that we reserved, but didn't use, for our output
+
+        mOutput.squeeze();
+
         return true;
     } else {
         mOutput = pRawCellml;
@@ -277,17 +288,24 @@ void CellMLTextViewConverter::outputString(const OutputType &pOutputType,
         if (mLastOutputType != EmptyLine)
             mOutput += "\n";
     } else {
+        // Note: we append our indent, string and new line one after the other
+        //       rather than all at once, so that no temporary string needs to
+        //       be created...
+
         if (pOutputType == Comment) {
             // When converting a comment that is within a piecewise equation,
             // mIndent will be wrong (since it will have been 'incremented'), so
             // we need to rely on the indent that we previously used
 
-            mOutput += mPrevIndent+pString+"\n";
+            mOutput += mPrevIndent;
         } else {
-            mOutput += mIndent+pString+"\n";
+            mOutput += mIndent;
 
             mPrevIndent = mIndent;
         }
+
+        mOutput += pString;
+        mOutput += '\n';
     }
 
     mLastOutputType = pOutputType;
@@ -860,13 +878,17 @@ bool CellMLTextViewConverter::processMathNode(const QDomNode &pDomNode)
 int CellMLTextViewConverter::childNodesCount(const QDomNode &pDomNode) const
 {
     // Return the number of child elements in the given node
+    // Note: we go through the node's siblings rather than use a QDomNodeList
+    //       object, since the latter would require a list of all the child
+    //       nodes to be created every time...
 
     int res = 0;
-    QDomNodeList childNodes = pDomNode.childNodes();
 
-    for (int i = 0, iMax = childNodes.count(); i < iMax; ++i)
-        if (!childNodes.item(i).isComment())
+    for (QDomNode domNode = pDomNode.firstChild();
+         !domNode.isNull(); domNode = domNode.nextSibling()) {
+        if (!domNode.isComment())
             ++res;
+    }
 
     return res;
 }
@@ -879,12 +901,12 @@ QDomNode CellMLTextViewConverter::childNode(const QDomNode &pDomNode,
     // Return the nth child element of the given node
 
     int childNodeIndex = 0;
-    QDomNodeList childNodes = pDomNode.childNodes();
 
-    for (int i = 0, iMax = childNodes.count(); i < iMax; ++i) {
-        if (!childNodes.item(i).isComment()) {
+    for (QDomNode domNode = pDomNode.firstChild();
+         !domNode.isNull(); domNode = domNode.nextSibling()) {
+        if (!domNode.isComment()) {
             if (childNodeIndex == pChildNodeIndex)
-                return childNodes.item(i);
+                return domNode;
             else
                 ++childNodeIndex;
         }
@@ -1222,12 +1244,12 @@ QString CellMLTextViewConverter::processPiecewiseNode(const QDomNode &pDomNode,
     // Process the piecewise node
 
     QString res = "sel\n";
-    QDomNodeList childNodes = pDomNode.childNodes();
 
     indent(false);
 
-    for (int i = 0, iMax = childNodes.count(); i < iMax; ++i) {
-        res += processMathmlNode(childNodes.item(i), pHasError);
+    for (QDomNode childNode = pDomNode.firstChild();
+         !childNode.isNull(); childNode = childNode.nextSibling()) {
+        res += processMathmlNode(childNode, pHasError);
 
         if (pHasError)
             return QString();
@@ -1246,14 +1268,11 @@ QString CellMLTextViewConverter::processPieceNode(const QDomNode &pDomNode,
     // Process the piece node
 
     QString res = QString();
-    QDomNodeList childNodes = pDomNode.childNodes();
-    QDomNode childNode = QDomNode();
     int childElementNodeNumber = 0;
     QString statement = QString();
 
-    for (int i = 0, iMax = childNodes.count(); i < iMax; ++i) {
-        childNode = childNodes.item(i);
-
+    for (QDomNode childNode = pDomNode.firstChild();
+         !childNode.isNull(); childNode = childNode.nextSibling()) {
         if (childNode.isComment()) {
             processCommentNode(childNode);
         } else {
@@ -1293,12 +1312,9 @@ QString CellMLTextViewConverter::processOtherwiseNode(const QDomNode &pDomNode,
     // Process the otherwise node
 
     QString res = QString();
-    QDomNodeList childNodes = pDomNode.childNodes();
-    QDomNode childNode = QDomNode();
-
-    for (int i = 0, iMax = childNodes.count(); i < iMax; ++i) {
-        childNode = childNodes.item(i);
 
+    for (QDomNode childNode = pDomNode.firstChild();
+         !childNode.isNull(); childNode = childNode.nextSibling()) {
         if (childNode.isComment()) {
             processCommentNode(childNode);
         } else {
@@ -1330,16 +1346,13 @@ QString CellMLTextViewConverter::processOperatorNode(const QString &pOperator,
     // Process the operator node, based on its number of siblings
 
     QString res = QString();
-    QDomNodeList childNodes = pDomNode.childNodes();
-    QDomNode childNode = QDomNode();
     int childElementNodeNumber = 0;
     MathmlNodeType operatorNodeType = UnknownMathmlNode;
 
     if (childNodesCount(pDomNode) == 2) {
 
-        for (int i = 0, iMax = childNodes.count(); i < iMax; ++i) {
-            childNode = childNodes.item(i);
-
+        for (QDomNode childNode = pDomNode.firstChild();
+             !childNode.isNull(); childNode = childNode.nextSibling()) {
             if (childNode.isComment()) {
                 processCommentNode(childNode);
             } else {
@@ -1380,9 +1393,8 @@ QString CellMLTextViewConverter::processOperatorNode(const QString &pOperator,
         MathmlNodeType leftOperandNodeType = UnknownMathmlNode;
         QString leftOperand = QString();
 
-        for (int i = 0, iMax = childNodes.count(); i < iMax; ++i) {
-            childNode = childNodes.item(i);
-
+        for (QDomNode childNode = pDomNode.firstChild();
+             !childNode.isNull(); childNode = childNode.nextSibling()) {
             if (childNode.isComment()) {
                 processCommentNode(childNode);
             } else {
@@ -1619,7 +1631,15 @@ QString CellMLTextViewConverter::processOperatorNode(const QString &pOperator,
                             ;
                         }
 
-                        res = leftOperand = leftOperand+pOperator+rightOperand;
+                        // Append our operator and right operand to our left
+                        // operand
+                        // Note: we append to our left operand rather than
+                        //       create a new string, so that the processing of
+                        //       an operator with many operands doesn't become
+                        //       quadratic...
+
+                        leftOperand += pOperator;
+                        leftOperand += rightOperand;
 
                         leftOperandNodeType = operatorNodeType;
                     }
@@ -1628,6 +1648,12 @@ QString CellMLTextViewConverter::processOperatorNode(const QString &pOperator,
                 ++childElementNodeNumber;
             }
         }
+
+        // Our left operand is our result, if we came across at least one right
+        // operand
+
+        if (childElementNodeNumber > 2)
+            res = leftOperand;
     }
 
     return res;
@@ -1642,14 +1668,11 @@ QString CellMLTextViewConverter::processFunctionNode(const QString &pFunction,
     // Process the one-parameter function node
 
     QString res = QString();
-    QDomNodeList childNodes = pDomNode.childNodes();
-    QDomNode childNode = QDomNode();
     int childElementNodeNumber = 0;
     QString argument = QString();
 
-    for (int i = 0, iMax = childNodes.count(); i < iMax; ++i) {
-        childNode = childNodes.item(i);
-
+    for (QDomNode childNode = pDomNode.firstChild();
+         !childNode.isNull(); childNode = childNode.nextSibling()) {
         if (childNode.isComment()) {
             processCommentNode(childNode);
         } else {
@@ -1684,14 +1707,11 @@ QString CellMLTextViewConverter::processPowerNode(const QDomNode &pDomNode,
     // Process the power node
 
     QString res = QString();
-    QDomNodeList childNodes = pDomNode.childNodes();
-    QDomNode childNode = QDomNode();
     int childElementNodeNumber = 0;
     QString a = QString();
 
-    for (int i = 0, iMax = childNodes.count(); i < iMax; ++i) {
-        childNode = childNodes.item(i);
-
+    for (QDomNode childNode = pDomNode.firstChild();
+         !childNode.isNull(); childNode = childNode.nextSibling()) {
         if (childNode.isComment()) {
             processCommentNode(childNode);
         } else {
@@ -1743,15 +1763,12 @@ QString CellMLTextViewConverter::processRootNode(const QDomNode &pDomNode,
     // Process the root node, based on its number of arguments
 
     QString res = QString();
-    QDomNodeList childNodes = pDomNode.childNodes();
     int currentChildNodesCount = childNodesCount(pDomNode);
-    QDomNode childNode = QDomNode();
     int childElementNodeNumber = 0;
     QString b = QString();
 
-    for (int i = 0, iMax = childNodes.count(); i < iMax; ++i) {
-        childNode = childNodes.item(i);
-
+    for (QDomNode childNode = pDomNode.firstChild();
+         !childNode.isNull(); childNode = childNode.nextSibling()) {
         if (childNode.isComment()) {
             processCommentNode(childNode);
         } else {
@@ -1820,15 +1837,12 @@ QString CellMLTextViewConverter::processLogNode(const QDomNode &pDomNode,
     // Process the log node
 
     QString res = QString();
-    QDomNodeList childNodes = pDomNode.childNodes();
     int currentChildNodesCount = childNodesCount(pDomNode);
-    QDomNode childNode = QDomNode();
     int childElementNodeNumber = 0;
     QString argumentOrBase = QString();
 
-    for (int i = 0, iMax = childNodes.count(); i < iMax; ++i) {
-        childNode = childNodes.item(i);
-
+    for (QDomNode childNode = pDomNode.firstChild();
+         !childNode.isNull(); childNode = childNode.nextSibling()) {
         if (childNode.isComment()) {
             processCommentNode(childNode);
         } else {
@@ -1867,13 +1881,10 @@ QString CellMLTextViewConverter::processNotNode(const QDomNode &pDomNode,
     // Process the not node
 
     QString res = QString();
-    QDomNodeList childNodes = pDomNode.childNodes();
-    QDomNode childNode = QDomNode();
     int childElementNodeNumber = 0;
 
-    for (int i = 0, iMax = childNodes.count(); i < iMax; ++i) {
-        childNode = childNodes.item(i);
-
+    for (QDomNode childNode = pDomNode.firstChild();
+         !childNode.isNull(); childNode = childNode.nextSibling()) {
         if (childNode.isComment()) {
             processCommentNode(childNode);
         } else {
@@ -1915,14 +1926,11 @@ QString CellMLTextViewConverter::processDiffNode(const QDomNode &pDomNode,
     // Process the diff node
 
     QString res = QString();
-    QDomNodeList childNodes = pDomNode.childNodes();
-    QDomNode childNode = QDomNode();
     int childElementNodeNumber = 0;
     QString x = QString();
 
-    for (int i = 0, iMax = childNodes.count(); i < iMax; ++i) {
-        childNode = childNodes.item(i);
-
+    for (QDomNode childNode = pDomNode.firstChild();
+         !childNode.isNull(); childNode = childNode.nextSibling()) {
         if (childNode.isComment()) {
             processCommentNode(childNode);
         } else {
@@ -1969,12 +1977,9 @@ QString CellMLTextViewConverter::processChildNode(const QDomNode &pDomNode,
     // Process the node's child
 
     QString res = QString();
-    QDomNodeList childNodes = pDomNode.childNodes();
-    QDomNode childNode = QDomNode();
-
-    for (int i = 0, iMax = childNodes.count(); i < iMax; ++i) {
-        childNode = childNodes.item(i);
 
+    for (QDomNode childNode = pDomNode.firstChild();
+         !childNode.isNull(); childNode = childNode.nextSibling()) {
         if (childNode.isComment()) {
             processCommentNode(childNode);
         } else {
@@ -1996,15 +2001,12 @@ QString CellMLTextViewConverter::processBvarNode(const QDomNode &pDomNode,
     // Process the bvar node, based on its number of child elements
 
     QString res = QString();
-    QDomNodeList childNodes = pDomNode.childNodes();
     int currentChildNodesCount = childNodesCount(pDomNode);
-    QDomNode childNode = QDomNode();
     int childElementNodeNumber = 0;
     QString a = QString();
 
-    for (int i = 0, iMax = childNodes.count(); i < iMax; ++i) {
-        childNode = childNodes.item(i);
-
+    for (QDomNode childNode = pDomNode.firstChild();
+         !childNode.isNull(); childNode = childNode.nextSibling()) {
         if (childNode.isComment()) {
             processCommentNode(childNode);
         } else {
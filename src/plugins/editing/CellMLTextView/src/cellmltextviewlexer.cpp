@@ -21,7 +21,6 @@ limitations under the License.
 //==============================================================================
 
 #include "cellmltextviewlexer.h"
-#include "qscintillawidget.h"
 
 //==============================================================================
 
@@ -31,10 +30,7 @@ namespace CellMLTextView {
 //==============================================================================
 
 CellmlTextViewLexer::CellmlTextViewLexer(QObject *pParent) :
-    QsciLexerCustom(pParent),
-    mFullText(QString()),
-    mFullTextUtf8(QByteArray()),
-    mEolString(QString())
+    QsciLexerCustom(pParent)
 {
 }
 
@@ -144,37 +140,84 @@ void CellmlTextViewLexer::styleText(int pBytesStart, int pBytesEnd)
     if (!editor())
         return;
 
-    // Retrieve the text to style
+    // Determine the line from which we need to style our text, as well as the
+    // state we were in at the end of the previous line
+    // Note: QScintilla keeps track of (and shifts, if needed) the state of each
+    //       line, so we don't need to look at what comes before the given text
+    //       to know whether it starts within a multiline comment and/or a
+    //       parameter block...
 
-    char *data = new char[pBytesEnd-pBytesStart+1];
+    int line = editor()->SendScintilla(QsciScintilla::SCI_LINEFROMPOSITION, pBytesStart);
+    int bytesStart = editor()->SendScintilla(QsciScintilla::SCI_POSITIONFROMLINE, line);
+    int state = line?editor()->SendScintilla(QsciScintilla::SCI_GETLINESTATE, line-1):0;
 
-    editor()->SendScintilla(QsciScintilla::SCI_GETTEXTRANGE,
-                            pBytesStart, pBytesEnd, data);
+    // Style our text, one line at a time, keeping track of the state we are in
+    // at the end of each line
+    // Note: we only style the lines that QScintilla asked for. Indeed, if the
+    //       state at the end of our last line has changed, then the lines after
+    //       it will be restyled once needed, since QScintilla considers that
+    //       they haven't been styled yet...
 
-    QString text = QString(data);
+    QByteArray bytesStyles = QByteArray();
+    int bytesPosition = bytesStart;
 
-    delete[] data;
+    bytesStyles.reserve(pBytesEnd-bytesStart);
 
-    // Use a default style for our text
-    // Note: this is so that validString() can work properly...
+    while (bytesPosition < pBytesEnd) {
+        int lineLength = editor()->SendScintilla(QsciScintilla::SCI_LINELENGTH, line);
 
-    startStyling(pBytesStart);
-    setStyling(pBytesEnd-pBytesStart, Default);
+        if (!lineLength)
+            break;
 
-    // Effectively style our text
+        QString text = editor()->text(line);
+        QByteArray styles = QByteArray(text.length(), Default);
 
-    mFullText = editor()->text();
-    mFullTextUtf8 = mFullText.toUtf8();
+        state = styleLine(text, state, styles);
 
-    mEolString = qobject_cast<QScintillaSupport::QScintillaWidget *>(editor())->eolString();
+        editor()->SendScintilla(QsciScintilla::SCI_SETLINESTATE, line, state);
 
-    doStyleText(pBytesStart, pBytesEnd, text, false);
+        // Convert our character-based styles to byte-based ones, based on the
+        // number of bytes needed to encode each character in UTF-8
+
+        for (int i = 0, iMax = text.length(); i < iMax; ++i) {
+            ushort character = text[i].unicode();
+            int characterBytes = (character < 0x80)?
+                                     1:
+                                     (character < 0x800)?
+                                         2:
+                                         text[i].isHighSurrogate()?
+                                             4:
+                                             text[i].isLowSurrogate()?0:3;
+
+            for (int j = 0; j < characterBytes; ++j)
+                bytesStyles.append(styles[i]);
+        }
+
+        bytesPosition += lineLength;
+
+        ++line;
+    }
+
+    // Apply our styles, all in one go
+    // Note: we may have styled more than needed (since we style whole lines)
+    //       or, in the unlikely case where our text couldn't be retrieved, not
+    //       enough...
+
+    int bytesLength = pBytesEnd-bytesStart;
+
+    if (bytesStyles.length() < bytesLength)
+        bytesStyles.append(QByteArray(bytesLength-bytesStyles.length(), Default));
+
+    startStyling(bytesStart);
+
+    editor()->SendScintilla(QsciScintilla::SCI_SETSTYLINGEX,
+                            bytesLength, bytesStyles.constData());
 
 #ifdef QT_DEBUG
     // Make sure that the end position of the last bit of text that we styled is
     // pBytesEnd
-    // Note: we need to ensure that it is the case, so that validString() can
-    //       take advantage of the style of a given character in the editor...
+    // Note: we need to ensure that it is the case, so that QScintilla knows
+    //       from where to carry on styling...
 
     if (editor()->SendScintilla(QsciScintillaBase::SCI_GETENDSTYLED) != pBytesEnd)
         qFatal("FATAL ERROR | %s:%d: the styling of the text must be incremental.", __FILE__, __LINE__);
@@ -184,12 +227,12 @@ void CellmlTextViewLexer::styleText(int pBytesStart, int pBytesEnd)
 //==============================================================================
 
 static const auto SingleLineCommentString = QStringLiteral("//");
-static const int SingleLineCommentLength  = SingleLineCommentString.length();
 
 //==============================================================================
 
 static const auto StartMultilineCommentString = QStringLiteral("/*");
 static const auto EndMultilineCommentString   = QStringLiteral("*/");
+static const int StartMultilineCommentLength  = StartMultilineCommentString.length();
 static const int EndMultilineCommentLength    = EndMultilineCommentString.length();
 
 //==============================================================================
@@ -206,493 +249,244 @@ static const int StringLength = StringString.length();
 
 //==============================================================================
 
-void CellmlTextViewLexer::doStyleText(const int &pBytesStart,
-                                      const int &pBytesEnd,
-                                      const QString &pText,
-                                      const bool &pParameterBlock)
+static void setStyles(QByteArray &pStyles, const int &pStart, const int &pEnd,
+                      const int &pStyle)
 {
-    // Make sure that we are given some text to style
-
-    if (pBytesStart == pBytesEnd)
-        return;
-
-    // Check whether a /* XXX */ comment or a parameter block started before or
-    // at the beginning of the given text
-
-    int start = fullTextPosition(pBytesStart);
-    int multilineCommentStartPosition = findString(StartMultilineCommentString, start, MultilineComment, false);
-    int parameterBlockStartPosition = findString(StartParameterBlockString, start, ParameterBlock, false);
-
-    multilineCommentStartPosition = (multilineCommentStartPosition == -1)?INT_MAX:multilineCommentStartPosition;
-    parameterBlockStartPosition = (parameterBlockStartPosition == -1)?INT_MAX:parameterBlockStartPosition;
-
-    int multilineCommentEndPosition = (multilineCommentStartPosition == INT_MAX)?INT_MAX:findString(EndMultilineCommentString, multilineCommentStartPosition, MultilineComment);
-    int parameterBlockEndPosition = (parameterBlockStartPosition == INT_MAX)?INT_MAX:findString(EndParameterBlockString, parameterBlockStartPosition, ParameterBlock);
+    // Set the style of the given range of characters
 
-    multilineCommentEndPosition = (multilineCommentEndPosition == -1)?INT_MAX:multilineCommentEndPosition;
-    parameterBlockEndPosition = (parameterBlockEndPosition == -1)?INT_MAX:parameterBlockEndPosition;
-
-    if (   (multilineCommentStartPosition != INT_MAX)
-        && (   (parameterBlockStartPosition == INT_MAX)
-            || (   (multilineCommentStartPosition > parameterBlockStartPosition)
-                && (multilineCommentEndPosition > start)))) {
-        // There is a previous /* XXX */ comment to style
-
-        doStyleTextPreviousMultilineComment(multilineCommentStartPosition, pBytesStart, pBytesEnd, pText, pParameterBlock);
-    } else if (   (parameterBlockStartPosition != INT_MAX)
-               && (   (multilineCommentStartPosition == INT_MAX)
-                   || (   (parameterBlockStartPosition > multilineCommentStartPosition)
-                       && (parameterBlockEndPosition > start)))) {
-        // There is a previous parameter block to style
-
-        doStyleTextPreviousParameterBlock(parameterBlockStartPosition, pBytesStart, pBytesEnd, pText, pParameterBlock);
-    } else {
-        // Style the current text
-
-        doStyleTextCurrent(pBytesStart, pBytesEnd, pText,
-                           (parameterBlockStartPosition < start) && (parameterBlockEndPosition > start));
-    }
+    for (int i = pStart; i < pEnd; ++i)
+        pStyles[i] = pStyle;
 }
 
 //==============================================================================
 
-void CellmlTextViewLexer::doStyleTextCurrent(const int &pBytesStart,
-                                             const int &pBytesEnd,
-                                             const QString &pText,
-                                             const bool &pParameterBlock)
+int CellmlTextViewLexer::styleLine(const QString &pText, const int &pState,
+                                   QByteArray &pStyles) const
 {
-    // Make sure that we are given some text to style
-
-    if (pBytesStart == pBytesEnd)
-        return;
+    // Style the given line of text, which starts in the given state, and
+    // return the state in which it ends
 
-    // Check whether the given text contains a string, a // comment, a /* XXX */
-    // comment or a parameter block
+    int position = 0;
+    int length = pText.length();
+    bool multilineComment = pState & MultilineCommentState;
+    bool parameterBlock = pState & ParameterBlockState;
 
-    int stringPosition = pText.indexOf(StringString);
-    int singleLineCommentPosition = pText.indexOf(SingleLineCommentString);
-    int multilineCommentStartPosition = pText.indexOf(StartMultilineCommentString);
-    int parameterBlockStartPosition = pText.indexOf(StartParameterBlockString);
+    while (position < length) {
+        // Finish styling our /* XXX */ comment, if we are in one
 
-    stringPosition = (stringPosition == -1)?INT_MAX:stringPosition;
-    singleLineCommentPosition = (singleLineCommentPosition == -1)?INT_MAX:singleLineCommentPosition;
-    multilineCommentStartPosition = (multilineCommentStartPosition == -1)?INT_MAX:multilineCommentStartPosition;
-    parameterBlockStartPosition = (parameterBlockStartPosition == -1)?INT_MAX:parameterBlockStartPosition;
+        if (multilineComment) {
+            int multilineCommentEndPosition = pText.indexOf(EndMultilineCommentString, position);
 
-    if (   (stringPosition != INT_MAX)
-        && (stringPosition < singleLineCommentPosition)
-        && (stringPosition < multilineCommentStartPosition)) {
-        // There is a string to style
+            if (multilineCommentEndPosition == -1) {
+                setStyles(pStyles, position, length, MultilineComment);
 
-        doStyleTextString(stringPosition, pBytesStart, pBytesEnd, pText, pParameterBlock);
-    } else if (   (singleLineCommentPosition != INT_MAX)
-               && (singleLineCommentPosition < stringPosition)
-               && (singleLineCommentPosition < multilineCommentStartPosition)) {
-        // There is a // comment to style, so first style everything that is
-        // before it
-
-        int singleLineCommentBytesPosition = fullTextBytesPosition(fullTextPosition(pBytesStart)+singleLineCommentPosition);
-
-        doStyleTextCurrent(pBytesStart, singleLineCommentBytesPosition,
-                           pText.left(singleLineCommentPosition),
-                           pParameterBlock);
-
-        // Style the // comment itself, after having looked for the end of the
-        // line, if any
-
-        int eolPosition = pText.indexOf(mEolString, singleLineCommentPosition+SingleLineCommentLength);
-        int eolBytesPosition = (eolPosition == -1)?-1:textBytesPosition(pText, eolPosition);
-        int end = (eolBytesPosition == -1)?pBytesEnd:pBytesStart+eolBytesPosition+mEolString.length();
+                break;
+            }
 
-        startStyling(singleLineCommentBytesPosition);
-        setStyling(end-singleLineCommentBytesPosition, SingleLineComment);
+            multilineCommentEndPosition += EndMultilineCommentLength;
 
-        // Now, style everything that is after the // comment, if anything
+            setStyles(pStyles, position, multilineCommentEndPosition, MultilineComment);
 
-        if (eolBytesPosition != -1) {
-            doStyleText(end, pBytesEnd,
-                        pText.right(fullTextLength(end, pBytesEnd)),
-                        pParameterBlock);
-        }
-    } else if (   (multilineCommentStartPosition != INT_MAX)
-               && (multilineCommentStartPosition < stringPosition)
-               && (multilineCommentStartPosition < singleLineCommentPosition)) {
-        // There is a /* XXX */ comment to style, so first style everything that
-        // is before it
-
-        int multilineCommentStartBytesPosition = fullTextBytesPosition(fullTextPosition(pBytesStart)+multilineCommentStartPosition);
-
-        doStyleTextCurrent(pBytesStart, multilineCommentStartBytesPosition,
-                           pText.left(multilineCommentStartPosition),
-                           pParameterBlock);
-
-        // Now style everything from the comment onwards
-        // Note #1: to style everything from the comment onwards means that we
-        //          will find that a /* XXX */ comment starts at the beginning
-        //          of the 'new' given text...
-        // Note #2: for the parameter block value, we check whether a parameter
-        //          block was started before the /* XXX */ comment line since
-        //          we need to finish styling it (which is effectively done in
-        //          doStyleTextPreviousMultilineComment())...
-
-        int start = fullTextPosition(pBytesStart);
-        int multilineCommentParameterBlockStartPosition = findString(StartParameterBlockString, start+multilineCommentStartPosition, ParameterBlock, false);
-        int multilineCommentParameterBlockEndPosition = findString(EndParameterBlockString, multilineCommentParameterBlockStartPosition, ParameterBlock);
-
-        multilineCommentParameterBlockStartPosition = (multilineCommentParameterBlockStartPosition == -1)?INT_MAX:multilineCommentParameterBlockStartPosition;
-        multilineCommentParameterBlockEndPosition = (multilineCommentParameterBlockEndPosition == -1)?INT_MAX:multilineCommentParameterBlockEndPosition;
-
-        int absoluteMultilineCommentStartPosition = start+multilineCommentStartPosition;
-
-        doStyleText(multilineCommentStartBytesPosition, pBytesEnd,
-                    pText.right(fullTextLength(multilineCommentStartBytesPosition, pBytesEnd)),
-                       (multilineCommentParameterBlockStartPosition < absoluteMultilineCommentStartPosition)
-                    && (absoluteMultilineCommentStartPosition < multilineCommentParameterBlockEndPosition));
-    } else if (   (parameterBlockStartPosition != INT_MAX)
-               && (parameterBlockStartPosition < stringPosition)
-               && (parameterBlockStartPosition < singleLineCommentPosition)
-               && (parameterBlockStartPosition < multilineCommentStartPosition)) {
-        // There is a parameter block, so first style everything that is before
-        // it
-
-        int parameterBlockStartBytesPosition = fullTextBytesPosition(fullTextPosition(pBytesStart)+parameterBlockStartPosition);
-
-        doStyleTextCurrent(pBytesStart, parameterBlockStartBytesPosition,
-                           pText.left(parameterBlockStartPosition),
-                           pParameterBlock);
-
-        // Now style everything from the parameter block onwards
-        // Note: to style everything from the parameter block onwards means that
-        //       we will find that a parameter block starts at the beginning of
-        //       the 'new' given text...
-
-        doStyleText(parameterBlockStartBytesPosition, pBytesEnd,
-                    pText.right(fullTextLength(parameterBlockStartBytesPosition, pBytesEnd)),
-                    pParameterBlock);
-    } else {
-        // Style the given text as a parameter block, if needed
+            position = multilineCommentEndPosition;
+            multilineComment = false;
 
-        if (pParameterBlock) {
-            startStyling(pBytesStart);
-            setStyling(pBytesEnd-pBytesStart, ParameterBlock);
+            continue;
         }
 
-        // Check whether the given text contains some keywords from various
-        // categories
-
-        static const QRegularExpression KeywordsRegEx = QRegularExpression(
-            "\\b("
-                // CellML text keywords
+        // Look for the next string, // comment, /* XXX */ comment or start/end
+        // of a parameter block, whichever comes first
 
-                "and|as|between|case|comp|def|endcomp|enddef|endsel|for|group|"
-                "import|incl|map|model|otherwise|sel|unit|using|var|vars|"
+        int stringPosition = pText.indexOf(StringString, position);
+        int singleLineCommentPosition = pText.indexOf(SingleLineCommentString, position);
+        int multilineCommentStartPosition = pText.indexOf(StartMultilineCommentString, position);
+        int parameterBlockPosition = pText.indexOf(parameterBlock?EndParameterBlockString:StartParameterBlockString, position);
 
-                // MathML arithmetic operators
+        stringPosition = (stringPosition == -1)?length:stringPosition;
+        singleLineCommentPosition = (singleLineCommentPosition == -1)?length:singleLineCommentPosition;
+        multilineCommentStartPosition = (multilineCommentStartPosition == -1)?length:multilineCommentStartPosition;
+        parameterBlockPosition = (parameterBlockPosition == -1)?length:parameterBlockPosition;
 
-                "abs|ceil|exp|fact|floor|ln|log|pow|root|sqr|sqrt|"
+        int nextPosition = qMin(qMin(stringPosition, singleLineCommentPosition),
+                                qMin(multilineCommentStartPosition, parameterBlockPosition));
 
-                // MathML logical operators
+        // Style everything that is before whatever we found
 
-                "and|or|xor|not|"
+        styleCode(pText, position, nextPosition, parameterBlock, pStyles);
 
-                // MathML calculus elements
+        if (nextPosition == length) {
+            break;
+        } else if (nextPosition == stringPosition) {
+            // There is a string to style, which we consider to end at the end
+            // of the line if it doesn't end on it
 
-                "ode|"
+            int stringEndPosition = pText.indexOf(StringString, stringPosition+StringLength);
 
-                // MathML min/max operators
+            position = (stringEndPosition == -1)?length:stringEndPosition+StringLength;
 
-                "min|max|"
+            setStyles(pStyles, stringPosition, position,
+                      parameterBlock?ParameterString:String);
+        } else if (nextPosition == singleLineCommentPosition) {
+            // There is a // comment to style
 
-                // MathML gcd/lcm operators
+            setStyles(pStyles, singleLineCommentPosition, length, SingleLineComment);
 
-                "gcd|lcm|"
+            position = length;
+        } else if (nextPosition == multilineCommentStartPosition) {
+            // There is a /* XXX */ comment to style
 
-                // MathML trigonometric operators
+            setStyles(pStyles, multilineCommentStartPosition,
+                      multilineCommentStartPosition+StartMultilineCommentLength,
+                      MultilineComment);
 
-                "sin|cos|tan|sec|csc|cot|sinh|cosh|tanh|sech|csch|coth|asin|"
-                "acos|atan|asec|acsc|acot|asinh|acosh|atanh|asech|acsch|acoth|"
-
-                // MathML constants
-
-                "true|false|nan|pi|inf|e|"
-
-                // Extra operators
-
-                "rem"
-            ")\\b");
-
-        static const QRegularExpression CellmlKeywordsRegEx = QRegularExpression(
-            "\\b("
-                 // Miscellaneous
-
-                "base|encapsulation|containment"
-            ")\\b");
-
-        static const QRegularExpression ParameterKeywordsRegEx = QRegularExpression(
-            "\\b("
-                // Unit keywords
-
-                "pref|expo|mult|off|"
-
-                // Variable keywords
-
-                "init|pub|priv"
-            ")\\b");
-
-        static const QRegularExpression ParameterValueKeywordsRegEx = QRegularExpression(
-            "\\b("
-                // Unit prefixes
-
-                "yotta|zetta|exa|peta|tera|giga|mega|kilo|hecto|deka|deci|"
-                "centi|milli|micro|nano|pico|femto|atto|zepto|yocto|"
-
-                // Public/private interfaces
-
-                "in|out|none"
-            ")\\b");
-
-        static const QRegularExpression SiUnitKeywordsRegEx = QRegularExpression(
-            "\\b("
-                // Standard units
-
-                "ampere|becquerel|candela|celsius|coulomb|dimensionless|farad|"
-                "gram|gray|henry|hertz|joule|katal|kelvin|kilogram|liter|litre|"
-                "lumen|lux|meter|metre|mole|newton|ohm|pascal|radian|second|"
-                "siemens|sievert|steradian|tesla|volt|watt|weber"
-            ")\\b");
-
-        if (pParameterBlock) {
-            doStyleTextRegEx(pBytesStart, pText, ParameterKeywordsRegEx, ParameterKeyword);
-            doStyleTextRegEx(pBytesStart, pText, ParameterValueKeywordsRegEx, ParameterCellmlKeyword);
+            position = multilineCommentStartPosition+StartMultilineCommentLength;
+            multilineComment = true;
         } else {
-            doStyleTextRegEx(pBytesStart, pText, KeywordsRegEx, Keyword);
-            doStyleTextRegEx(pBytesStart, pText, CellmlKeywordsRegEx, CellmlKeyword);
-        }
-
-        doStyleTextRegEx(pBytesStart, pText, SiUnitKeywordsRegEx, pParameterBlock?ParameterCellmlKeyword:CellmlKeyword);
-
-        // Check whether the given text contains some numbers
+            // There is the start/end of a parameter block to style
 
-        doStyleTextNumberRegEx(pBytesStart, pText, pParameterBlock?ParameterNumber:Number);
+            int parameterBlockLength = parameterBlock?EndParameterBlockLength:StartParameterBlockLength;
 
-        // Let QScintilla know that we are done with the styling of the given
-        // text
-        // Note: indeed, QScintilla uses the end position of the last bit of
-        //       text that has been styled to determine the starting position of
-        //       the next bit of text that needs to be styled (see
-        //       QsciLexerCustom::handleStyleNeeded()). Now, depending on
-        //       whether keywords and/or numbers have been styled, the end
-        //       position may or not be pBytesEnd. So, here, we make sure that
-        //       it is, so that QScintilla can work as it should...
+            setStyles(pStyles, parameterBlockPosition,
+                      parameterBlockPosition+parameterBlockLength,
+                      ParameterBlock);
 
-        startStyling(pBytesEnd);
+            position = parameterBlockPosition+parameterBlockLength;
+            parameterBlock = !parameterBlock;
+        }
     }
+
+    return   (multilineComment?MultilineCommentState:0)
+           | (parameterBlock?ParameterBlockState:0);
 }
 
 //==============================================================================
 
-void CellmlTextViewLexer::doStyleTextPreviousMultilineComment(const int &pPosition,
-                                                              const int &pBytesStart,
-                                                              const int &pBytesEnd,
-                                                              const QString &pText,
-                                                              const bool &pParameterBlock)
+void CellmlTextViewLexer::styleCode(const QString &pText, const int &pStart,
+                                    const int &pEnd,
+                                    const bool &pParameterBlock,
+                                    QByteArray &pStyles) const
 {
-    // A /* XXX */ comment started before or at the beginning of the given text,
-    // so now look for where it ends
+    // Make sure that we are given some code to style
 
-    int multilineCommentEndPosition = findString(EndMultilineCommentString, pPosition, MultilineComment);
+    if (pStart == pEnd)
+        return;
 
-    if (multilineCommentEndPosition == -1)
-        multilineCommentEndPosition = mFullText.length();
+    // Style the given code as a parameter block, if needed
 
-    // Check whether the beginning of the given text is within the /* XXX */
-    // comment
+    if (pParameterBlock)
+        setStyles(pStyles, pStart, pEnd, ParameterBlock);
 
-    int start = fullTextPosition(pBytesStart);
+    // Check whether the given code contains some keywords from various
+    // categories
 
-    if ((pPosition <= start) && (start <= multilineCommentEndPosition)) {
-        // The beginning of the given text is within a /* XXX */ comment, so
-        // style it
+    static const QRegularExpression KeywordsRegEx = QRegularExpression(
+        "\\b("
+            // CellML text keywords
 
-        int realBytesEnd = fullTextBytesPosition(multilineCommentEndPosition)+EndMultilineCommentLength;
-        int bytesEnd = qMin(pBytesEnd, realBytesEnd);
+            "and|as|between|case|comp|def|endcomp|enddef|endsel|for|group|"
+            "import|incl|map|model|otherwise|sel|unit|using|var|vars|"
 
-        startStyling(pBytesStart);
-        setStyling(bytesEnd-pBytesStart, MultilineComment);
+            // MathML arithmetic operators
 
-        // Now, style everything that is behind the /* XXX */ comment, if
-        // anything
+            "abs|ceil|exp|fact|floor|ln|log|pow|root|sqr|sqrt|"
 
-        if (bytesEnd != pBytesEnd) {
-            if (pParameterBlock) {
-                // Our /* XXX */ comment is within a parameter block, so finish
-                // styling our parameter block
+            // MathML logical operators
 
-                doStyleTextPreviousParameterBlock(fullTextPosition(bytesEnd), bytesEnd, pBytesEnd,
-                                                  pText.right(fullTextLength(bytesEnd, pBytesEnd)),
-                                                  false);
-            } else {
-                doStyleText(bytesEnd, pBytesEnd,
-                            pText.right(fullTextLength(bytesEnd, pBytesEnd)),
-                            pParameterBlock);
-            }
-        }
-    } else {
-        // The beginning of the given text is not within a /* XXX */ comment, so
-        // style it
+            "and|or|xor|not|"
 
-        doStyleTextCurrent(pBytesStart, pBytesEnd, pText, pParameterBlock);
-    }
-}
+            // MathML calculus elements
 
-//==============================================================================
+            "ode|"
 
-void CellmlTextViewLexer::doStyleTextPreviousParameterBlock(const int &pPosition,
-                                                            const int &pBytesStart,
-                                                            const int &pBytesEnd,
-                                                            const QString &pText,
-                                                            const bool &pParameterBlock)
-{
-    // A parameter block started before or at the beginning of the given text,
-    // so now look for where it ends
+            // MathML min/max operators
 
-    int parameterBlockEndPosition = findString(EndParameterBlockString, pPosition, ParameterBlock);
+            "min|max|"
 
-    if (parameterBlockEndPosition == -1)
-        parameterBlockEndPosition = mFullText.length();
+            // MathML gcd/lcm operators
 
-    // Check whether the beginning of the given text is within a parameter block
+            "gcd|lcm|"
 
-    int start = fullTextPosition(pBytesStart);
+            // MathML trigonometric operators
 
-    if ((pPosition <= start) && (start <= parameterBlockEndPosition)) {
-        // The beginning of the given text is within a parameter block, so style
-        // it as such
+            "sin|cos|tan|sec|csc|cot|sinh|cosh|tanh|sech|csch|coth|asin|"
+            "acos|atan|asec|acsc|acot|asinh|acosh|atanh|asech|acsch|acoth|"
 
-        int realBytesEnd = fullTextBytesPosition(parameterBlockEndPosition)+EndParameterBlockLength;
-        int bytesEnd = qMin(pBytesEnd, realBytesEnd);
-        bool hasStart =    (pPosition == start)
-                        && !mFullText.mid(pPosition, StartParameterBlockLength).compare(StartParameterBlockString);
-        bool hasEnd = bytesEnd == realBytesEnd;
+            // MathML constants
 
-        // If needed, style the start of the parameter block
+            "true|false|nan|pi|inf|e|"
 
-        if (hasStart) {
-            startStyling(pBytesStart);
-            setStyling(StartParameterBlockLength, ParameterBlock);
-        }
+            // Extra operators
 
-        // Now style the contents of the parameter block itself
+            "rem"
+        ")\\b");
 
-        int newBytesStart = pBytesStart+(hasStart?StartParameterBlockLength:0);
-        int newBytesEnd = bytesEnd-(hasEnd?EndParameterBlockLength:0);
+    static const QRegularExpression CellmlKeywordsRegEx = QRegularExpression(
+        "\\b("
+             // Miscellaneous
 
-        doStyleTextCurrent(newBytesStart, newBytesEnd,
-                           pText.mid(fullTextLength(pBytesStart, newBytesStart),
-                                     fullTextLength(newBytesStart, newBytesEnd)),
-                           true);
+            "base|encapsulation|containment"
+        ")\\b");
 
-        // If needed, style the end of the parameter block, as well as what is
-        // behind it
+    static const QRegularExpression ParameterKeywordsRegEx = QRegularExpression(
+        "\\b("
+            // Unit keywords
 
-        if (hasEnd) {
-            startStyling(bytesEnd-EndParameterBlockLength);
-            setStyling(EndParameterBlockLength, ParameterBlock);
+            "pref|expo|mult|off|"
 
-            doStyleText(bytesEnd, pBytesEnd,
-                        pText.right(fullTextLength(bytesEnd, pBytesEnd)),
-                        pParameterBlock);
-        }
-    } else {
-        // The beginning of the given text is not within a parameter block, so
-        // style it
-
-        doStyleTextCurrent(pBytesStart, pBytesEnd, pText, pParameterBlock);
-    }
-}
-
-//==============================================================================
-
-void CellmlTextViewLexer::doStyleTextString(const int &pPosition,
-                                            const int &pBytesStart,
-                                            const int &pBytesEnd,
-                                            const QString &pText,
-                                            const bool &pParameterBlock)
-{
-    // There is a string to style, so first style everything that is before it
+            // Variable keywords
 
-    int bytesPosition = fullTextBytesPosition(fullTextPosition(pBytesStart)+pPosition);
+            "init|pub|priv"
+        ")\\b");
 
-    doStyleTextCurrent(pBytesStart, bytesPosition, pText.left(pPosition), pParameterBlock);
+    static const QRegularExpression ParameterValueKeywordsRegEx = QRegularExpression(
+        "\\b("
+            // Unit prefixes
 
-    // Now, check where the string ends, if anywhere
+            "yotta|zetta|exa|peta|tera|giga|mega|kilo|hecto|deka|deci|"
+            "centi|milli|micro|nano|pico|femto|atto|zepto|yocto|"
 
-    int nextBytesStart = -1;
-    int stringEndPosition = pText.indexOf(StringString, pPosition+StringLength);
+            // Public/private interfaces
 
-    if (stringEndPosition != -1) {
-        // The string ends somewhere, so compare its line number against that of
-        // where it started
+            "in|out|none"
+        ")\\b");
 
-        int stringStartLineNumber, stringStartColumnNumber;
-        int stringEndLineNumber, stringEndColumnNumber;
-        int stringEndBytesPosition = textBytesPosition(pText, stringEndPosition);
+    static const QRegularExpression SiUnitKeywordsRegEx = QRegularExpression(
+        "\\b("
+            // Standard units
 
-        editor()->lineIndexFromPosition(bytesPosition,
-                                        &stringStartLineNumber, &stringStartColumnNumber);
-        editor()->lineIndexFromPosition(pBytesStart+stringEndBytesPosition,
-                                        &stringEndLineNumber, &stringEndColumnNumber);
+            "ampere|becquerel|candela|celsius|coulomb|dimensionless|farad|"
+            "gram|gray|henry|hertz|joule|katal|kelvin|kilogram|liter|litre|"
+            "lumen|lux|meter|metre|mole|newton|ohm|pascal|radian|second|"
+            "siemens|sievert|steradian|tesla|volt|watt|weber"
+        ")\\b");
 
-        if (stringStartLineNumber == stringEndLineNumber) {
-            // The string starts and ends on the same line, so get ready to
-            // style everything that is after the string
+    QString code = pText.mid(pStart, pEnd-pStart);
 
-            nextBytesStart = pBytesStart+stringEndBytesPosition+StringLength;
-        } else {
-            // The string starts and ends on a different line, so consider that
-            // we couldn't find the end of the string
-
-            stringEndPosition = -1;
-        }
-    }
-
-    if (stringEndPosition == -1) {
-        // The string doesn't end or we found the beginning of another string on
-        // a different line, so get ready to style everything that is after the
-        // end of the line, if anything, on which the string started
-
-        int eolPosition = pText.indexOf(mEolString, pPosition+StringLength);
-        int eolBytesPosition = (eolPosition == -1)?-1:textBytesPosition(pText, eolPosition);
-
-        if (eolBytesPosition != -1)
-            nextBytesStart = pBytesStart+eolBytesPosition+mEolString.length();
+    if (pParameterBlock) {
+        styleRegEx(pStart, code, ParameterKeywordsRegEx, ParameterKeyword, pStyles);
+        styleRegEx(pStart, code, ParameterValueKeywordsRegEx, ParameterCellmlKeyword, pStyles);
+    } else {
+        styleRegEx(pStart, code, KeywordsRegEx, Keyword, pStyles);
+        styleRegEx(pStart, code, CellmlKeywordsRegEx, CellmlKeyword, pStyles);
     }
 
-    // Style the string itself
+    styleRegEx(pStart, code, SiUnitKeywordsRegEx, pParameterBlock?ParameterCellmlKeyword:CellmlKeyword, pStyles);
 
-    startStyling(bytesPosition);
-    setStyling(((nextBytesStart == -1)?pBytesEnd:nextBytesStart)-bytesPosition,
-               pParameterBlock?ParameterString:String);
+    // Check whether the given code contains some numbers
 
-    // Style whatever is after the string
-
-    if (nextBytesStart != -1) {
-        doStyleText(nextBytesStart, pBytesEnd,
-                    pText.right(fullTextLength(nextBytesStart, pBytesEnd)),
-                    pParameterBlock);
-    }
+    styleNumberRegEx(pText, pStart, code, pParameterBlock?ParameterNumber:Number, pStyles);
 }
 
 //==============================================================================
 
-void CellmlTextViewLexer::doStyleTextRegEx(const int &pBytesStart,
-                                           const QString &pText,
-                                           const QRegularExpression &pRegEx,
-                                           const int &pRegExStyle)
+void CellmlTextViewLexer::styleRegEx(const int &pStart, const QString &pCode,
+                                     const QRegularExpression &pRegEx,
+                                     const int &pRegExStyle,
+                                     QByteArray &pStyles) const
 {
-    // Style the given text using the given regular expression
+    // Style the given code, which starts at the given position in our line,
+    // using the given regular expression
 
-    QRegularExpressionMatchIterator regExMatchIter = pRegEx.globalMatch(pText);
+    QRegularExpressionMatchIterator regExMatchIter = pRegEx.globalMatch(pCode);
     QRegularExpressionMatch regExMatch;
 
     while (regExMatchIter.hasNext()) {
@@ -700,28 +494,28 @@ void CellmlTextViewLexer::doStyleTextRegEx(const int &pBytesStart,
 
         // We have a match, so style it
 
-        int matchBytesStart = textBytesPosition(pText, regExMatch.capturedStart());
-
-        startStyling(pBytesStart+matchBytesStart);
-        setStyling(textBytesPosition(pText, regExMatch.capturedStart()+regExMatch.capturedLength())-matchBytesStart,
-                   pRegExStyle);
+        setStyles(pStyles, pStart+regExMatch.capturedStart(),
+                  pStart+regExMatch.capturedEnd(), pRegExStyle);
     }
 }
 
 //==============================================================================
 
-void CellmlTextViewLexer::doStyleTextNumberRegEx(const int &pBytesStart,
-                                                 const QString &pText,
-                                                 const int &pRegExStyle)
+void CellmlTextViewLexer::styleNumberRegEx(const QString &pText,
+                                           const int &pStart,
+                                           const QString &pCode,
+                                           const int &pRegExStyle,
+                                           QByteArray &pStyles) const
 {
-    // Style the given text using the number regular expression
+    // Style the given code, which starts at the given position in the given
+    // text, using the number regular expression
 
     static const QRegularExpression NumberRegEx = QRegularExpression("(\\d+(\\.\\d*)?|\\.\\d+)([eE][+-]?\\d*)?");
     // Note: this regular expression is not aimed at catching valid numbers, but
     //       at catching something that could become a valid number (e.g. we
     //       want to be able to catch "123e")...
 
-    QRegularExpressionMatchIterator regExMatchIter = NumberRegEx.globalMatch(pText);
+    QRegularExpressionMatchIterator regExMatchIter = NumberRegEx.globalMatch(pCode);
     QRegularExpressionMatch regExMatch;
 
     while (regExMatchIter.hasNext()) {
@@ -732,12 +526,14 @@ void CellmlTextViewLexer::doStyleTextNumberRegEx(const int &pBytesStart,
         //    part of the ASCII table
         //  - The character following the match is not in [a-zA-Z_.] and is part
         //    of the ASCII table
+        // Note: a match at the beginning (end) of our line is fine since it is
+        //       preceded (followed) by an EOL (or nothing)...
 
-        int prevCharPos = fullTextPosition(pBytesStart)+regExMatch.capturedStart()-1;
-        int nextCharPos = prevCharPos+regExMatch.capturedLength()+1;
+        int prevCharPos = pStart+regExMatch.capturedStart()-1;
+        int nextCharPos = pStart+regExMatch.capturedEnd();
 
-        ushort prevChar = ((prevCharPos >= 0)?mFullText[prevCharPos]:QChar()).unicode();
-        ushort nextChar = ((nextCharPos < mFullText.length())?mFullText[nextCharPos]:QChar()).unicode();
+        ushort prevChar = ((prevCharPos >= 0)?pText[prevCharPos]:QChar()).unicode();
+        ushort nextChar = ((nextCharPos < pText.length())?pText[nextCharPos]:QChar()).unicode();
 
         if ((       (prevChar  <  48) || ((prevChar  >  57) && (prevChar <  65))
                 || ((prevChar  >  90) &&  (prevChar  <  95))
@@ -745,97 +541,14 @@ void CellmlTextViewLexer::doStyleTextNumberRegEx(const int &pBytesStart,
             && (    (nextChar  <  46) || ((nextChar  >  46) && (nextChar <  65))
                 || ((nextChar  >  90) &&  (nextChar  <  95))
                 ||  (nextChar ==  96) || ((nextChar  > 122) && (nextChar < 128)))) {
-            int matchBytesStart = textBytesPosition(pText, regExMatch.capturedStart());
-
-            startStyling(pBytesStart+matchBytesStart);
-            setStyling(textBytesPosition(pText, regExMatch.capturedStart()+regExMatch.capturedLength())-matchBytesStart,
-                       pRegExStyle);
+            setStyles(pStyles, pStart+regExMatch.capturedStart(),
+                      pStart+regExMatch.capturedEnd(), pRegExStyle);
         }
     }
 }
 
 //==============================================================================
 
-bool CellmlTextViewLexer::validString(const int &pFrom, const int &pTo,
-                                      const int &pStyle) const
-{
-    // Check whether the string, which range is given, is valid, i.e. is either
-    // of the default or given style
-
-    int style;
-
-    for (int i = pFrom; i < pTo; ++i) {
-        style = editor()->SendScintilla(QsciScintilla::SCI_GETSTYLEAT,
-                                        fullTextBytesPosition(i));
-
-        if ((style != Default) && (style != pStyle))
-            return false;
-    }
-
-    return true;
-}
-
-//==============================================================================
-
-int CellmlTextViewLexer::findString(const QString &pString, int pFrom,
-                                    const int &pStyle, const bool &pForward)
-{
-    // Find forward/backward the given string starting from the given position
-
-    int stringLength = pString.length();
-    int res = pForward?pFrom:pFrom+1;
-
-    do {
-        pFrom = pForward?res+stringLength:res-1;
-
-        res = pForward?mFullText.indexOf(pString, pFrom):mFullText.lastIndexOf(pString, pFrom);
-    } while ((res != -1) && !validString(res, res+stringLength, pStyle));
-
-    return res;
-}
-
-//==============================================================================
-
-int CellmlTextViewLexer::fullTextPosition(const int &pBytesPosition) const
-{
-    // Return the corresponding position within mFullText of the given
-    // byte-based position within mFullTextUtf8
-
-    return QString(mFullTextUtf8.left(pBytesPosition)).length();
-}
-
-//==============================================================================
-
-int CellmlTextViewLexer::fullTextLength(const int &pBytesStart,
-                                        const int &pBytesEnd) const
-{
-    // Return the corresponding length within mFullText of the given byte-based
-    // length of a substring within mFullTextUtf8
-
-    return fullTextPosition(pBytesEnd)-fullTextPosition(pBytesStart);
-}
-
-//==============================================================================
-
-int CellmlTextViewLexer::fullTextBytesPosition(const int &pPosition) const
-{
-    // Return the byte-based value of the given position within mFullText
-
-    return mFullText.left(pPosition).toUtf8().length();
-}
-
-//==============================================================================
-
-int CellmlTextViewLexer::textBytesPosition(const QString &pText,
-                                           const int &pPosition) const
-{
-    // Return the byte-based value of the given position within the given text
-
-    return pText.left(pPosition).toUtf8().length();
-}
-
-//==============================================================================
-
 }   // namespace CellMLTextView
 }   // namespace OpenCOR
 
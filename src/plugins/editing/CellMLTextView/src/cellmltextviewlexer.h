@@ -67,43 +67,21 @@ public:
     virtual void styleText(int pBytesStart, int pBytesEnd);
 
 private:
-    QString mFullText;
-    QByteArray mFullTextUtf8;
-
-    QString mEolString;
-
-    void doStyleText(const int &pBytesStart, const int &pBytesEnd,
-                     const QString &pText, const bool &pParameterBlock);
-    void doStyleTextCurrent(const int &pBytesStart, const int &pBytesEnd,
-                            const QString &pText, const bool &pParameterBlock);
-    void doStyleTextPreviousMultilineComment(const int &pPosition,
-                                             const int &pBytesStart,
-                                             const int &pBytesEnd,
-                                             const QString &pText,
-                                             const bool &pParameterBlock);
-    void doStyleTextPreviousParameterBlock(const int &pPosition,
-                                           const int &pBytesStart,
-                                           const int &pBytesEnd,
-                                           const QString &pText,
-                                           const bool &pParameterBlock);
-    void doStyleTextString(const int &pPosition, const int &pBytesStart,
-                           const int &pBytesEnd, const QString &pText,
-                           const bool &pParameterBlock);
-    void doStyleTextRegEx(const int &pBytesStart, const QString &pText,
-                          const QRegularExpression &pRegEx,
-                          const int &pRegExStyle);
-    void doStyleTextNumberRegEx(const int &pBytesStart, const QString &pText,
-                                const int &pRegExStyle);
-
-    bool validString(const int &pFrom, const int &pTo, const int &pStyle) const;
-    int findString(const QString &pString, int pFrom, const int &pStyle,
-                   const bool &pForward = true);
-
-    int fullTextPosition(const int &pBytesPosition) const;
-    int fullTextLength(const int &pBytesStart, const int &pBytesEnd) const;
-
-    int fullTextBytesPosition(const int &pPosition) const;
-    int textBytesPosition(const QString &pText, const int &pPosition) const;
+    enum {
+        MultilineCommentState = 1,
+        ParameterBlockState   = 2
+    };
+
+    int styleLine(const QString &pText, const int &pState,
+                  QByteArray &pStyles) const;
+    void styleCode(const QString &pText, const int &pStart, const int &pEnd,
+                   const bool &pParameterBlock, QByteArray &pStyles) const;
+    void styleRegEx(const int &pStart, const QString &pCode,
+                    const QRegularExpression &pRegEx, const int &pRegExStyle,
+                    QByteArray &pStyles) const;
+    void styleNumberRegEx(const QString &pText, const int &pStart,
+                          const QString &pCode, const int &pRegExStyle,
+                          QByteArray &pStyles) const;
 };
 
 //==============================================================================
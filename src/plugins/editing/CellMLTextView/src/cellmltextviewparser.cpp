@@ -744,15 +744,8 @@ bool CellmlTextViewParser::identifierOrSiUnitToken(QDomNode &pDomNode)
 {
     // Expect an identifier or an SI unit
 
-    static CellmlTextViewScanner::TokenTypes tokenTypes = CellmlTextViewScanner::TokenTypes();
-    static bool needInitializeTokenTypes = true;
-
-    if (needInitializeTokenTypes) {
-        tokenTypes = rangeOfTokenTypes(CellmlTextViewScanner::FirstUnitToken,
-                                       CellmlTextViewScanner::LastUnitToken) << CellmlTextViewScanner::IdentifierOrCmetaIdToken;
-
-        needInitializeTokenTypes = false;
-    }
+    static const CellmlTextViewScanner::TokenTypes tokenTypes = rangeOfTokenTypes(CellmlTextViewScanner::FirstUnitToken,
+                                                                                  CellmlTextViewScanner::LastUnitToken) << CellmlTextViewScanner::IdentifierOrCmetaIdToken;
 
     return tokenType(pDomNode, QObject::tr("An identifier or an SI unit (e.g. 'second')"),
                      tokenTypes);
@@ -1497,15 +1490,8 @@ bool CellmlTextViewParser::parseUnitDefinition(QDomNode &pDomNode)
 
                         // Expect a number or a prefix
 
-                        static CellmlTextViewScanner::TokenTypes tokenTypes = CellmlTextViewScanner::TokenTypes();
-                        static bool needInitializeTokenTypes = true;
-
-                        if (needInitializeTokenTypes) {
-                            tokenTypes = rangeOfTokenTypes(CellmlTextViewScanner::FirstPrefixToken,
-                                                           CellmlTextViewScanner::LastPrefixToken) << CellmlTextViewScanner::NumberToken;
-
-                            needInitializeTokenTypes = false;
-                        }
+                        static const CellmlTextViewScanner::TokenTypes tokenTypes = rangeOfTokenTypes(CellmlTextViewScanner::FirstPrefixToken,
+                                                                                                      CellmlTextViewScanner::LastPrefixToken) << CellmlTextViewScanner::NumberToken;
 
                         if (!tokenType(unitElement, QObject::tr("A number or a prefix (e.g. 'milli')"),
                                        tokenTypes)) {
@@ -2879,27 +2865,20 @@ QDomElement CellmlTextViewParser::parseNormalMathematicalExpression9(QDomNode &p
 
     QDomElement res;
 
-    static CellmlTextViewScanner::TokenTypes mahematicalConstantTokenTypes = CellmlTextViewScanner::TokenTypes();
-    static CellmlTextViewScanner::TokenTypes oneArgumentMathematicalFunctionTokenTypes = CellmlTextViewScanner::TokenTypes();
-    static CellmlTextViewScanner::TokenTypes oneOrTwoArgumentMathematicalFunctionTokenTypes = CellmlTextViewScanner::TokenTypes();
-    static CellmlTextViewScanner::TokenTypes twoArgumentMathematicalFunctionTokenTypes = CellmlTextViewScanner::TokenTypes();
-    static CellmlTextViewScanner::TokenTypes twoOrMoreArgumentMathematicalFunctionTokenTypes = CellmlTextViewScanner::TokenTypes();
-    static bool needInitializeTokenTypes = true;
-
-    if (needInitializeTokenTypes) {
-        mahematicalConstantTokenTypes = rangeOfTokenTypes(CellmlTextViewScanner::FirstMathematicalConstantToken,
-                                                          CellmlTextViewScanner::LastMathematicalConstantToken);
-        oneArgumentMathematicalFunctionTokenTypes = rangeOfTokenTypes(CellmlTextViewScanner::FirstOneArgumentMathematicalFunctionToken,
-                                                                      CellmlTextViewScanner::LastOneArgumentMathematicalFunctionToken);
-        oneOrTwoArgumentMathematicalFunctionTokenTypes = rangeOfTokenTypes(CellmlTextViewScanner::FirstOneOrTwoArgumentMathematicalFunctionToken,
-                                                                           CellmlTextViewScanner::LastOneOrTwoArgumentMathematicalFunctionToken);
-        twoArgumentMathematicalFunctionTokenTypes = rangeOfTokenTypes(CellmlTextViewScanner::FirstTwoArgumentMathematicalFunctionToken,
-                                                                      CellmlTextViewScanner::LastTwoArgumentMathematicalFunctionToken);
-        twoOrMoreArgumentMathematicalFunctionTokenTypes = rangeOfTokenTypes(CellmlTextViewScanner::FirstTwoOrMoreArgumentMathematicalFunctionToken,
-                                                                            CellmlTextViewScanner::LastTwoOrMoreArgumentMathematicalFunctionToken);
-
-        needInitializeTokenTypes = false;
-    }
+    // Note: our token types are initialised only once, and in a thread-safe
+    //       way, since we may be used by several threads at once (e.g. see
+    //       CellmlTextViewWidgetData::parse())...
+
+    static const CellmlTextViewScanner::TokenTypes mahematicalConstantTokenTypes = rangeOfTokenTypes(CellmlTextViewScanner::FirstMathematicalConstantToken,
+                                                                                                     CellmlTextViewScanner::LastMathematicalConstantToken);
+    static const CellmlTextViewScanner::TokenTypes oneArgumentMathematicalFunctionTokenTypes = rangeOfTokenTypes(CellmlTextViewScanner::FirstOneArgumentMathematicalFunctionToken,
+                                                                                                                 CellmlTextViewScanner::LastOneArgumentMathematicalFunctionToken);
+    static const CellmlTextViewScanner::TokenTypes oneOrTwoArgumentMathematicalFunctionTokenTypes = rangeOfTokenTypes(CellmlTextViewScanner::FirstOneOrTwoArgumentMathematicalFunctionToken,
+                                                                                                                      CellmlTextViewScanner::LastOneOrTwoArgumentMathematicalFunctionToken);
+    static const CellmlTextViewScanner::TokenTypes twoArgumentMathematicalFunctionTokenTypes = rangeOfTokenTypes(CellmlTextViewScanner::FirstTwoArgumentMathematicalFunctionToken,
+                                                                                                                 CellmlTextViewScanner::LastTwoArgumentMathematicalFunctionToken);
+    static const CellmlTextViewScanner::TokenTypes twoOrMoreArgumentMathematicalFunctionTokenTypes = rangeOfTokenTypes(CellmlTextViewScanner::FirstTwoOrMoreArgumentMathematicalFunctionToken,
+                                                                                                                       CellmlTextViewScanner::LastTwoOrMoreArgumentMathematicalFunctionToken);
 
     if (mScanner.tokenType() == CellmlTextViewScanner::IdentifierOrCmetaIdToken) {
         // Create an identifier element
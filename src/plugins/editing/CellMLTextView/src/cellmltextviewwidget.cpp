@@ -38,6 +38,7 @@ limitations under the License.
 
 //==============================================================================
 
+#include <QCoreApplication>
 #include <QKeyEvent>
 #include <QLabel>
 #include <QLayout>
@@ -45,6 +46,7 @@ limitations under the License.
 #include <QMessageBox>
 #include <QSettings>
 #include <QTimer>
+#include <QtConcurrentRun>
 
 //==============================================================================
 
@@ -66,7 +68,11 @@ CellmlTextViewWidgetData::CellmlTextViewWidgetData(CellMLEditingView::CellmlEdit
     mSha1(pSha1),
     mValid(pValid),
     mCellmlVersion(pCellmlVersion),
-    mRdfNodes(pRdfNodes)
+    mRdfNodes(pRdfNodes),
+    mParser(CellmlTextViewParser()),
+    mParsingSha1(QString()),
+    mParsingFuture(QFuture<bool>()),
+    mParsingWatcher(new QFutureWatcher<bool>())
 {
 }
 
@@ -74,8 +80,14 @@ CellmlTextViewWidgetData::CellmlTextViewWidgetData(CellMLEditingView::CellmlEdit
 
 CellmlTextViewWidgetData::~CellmlTextViewWidgetData()
 {
+    // Make sure that we are not being parsed in the background, since it
+    // relies on our parser
+
+    mParsingFuture.waitForFinished();
+
     // Delete some internal objects
 
+    delete mParsingWatcher;
     delete mEditingWidget;
 }
 
@@ -138,6 +150,12 @@ CellMLSupport::CellmlFile::Version CellmlTextViewWidgetData::cellmlVersion() con
 void CellmlTextViewWidgetData::setCellmlVersion(const CellMLSupport::CellmlFile::Version &pCellmlVersion)
 {
     // Set our CellML version value
+    // Note: our contents may have been parsed using our previous CellML
+    //       version, in which case the result of that parsing cannot be reused
+    //       anymore...
+
+    if (pCellmlVersion != mCellmlVersion)
+        mParsingSha1 = QString();
 
     mCellmlVersion = pCellmlVersion;
 }
@@ -153,6 +171,96 @@ QDomDocument CellmlTextViewWidgetData::rdfNodes() const
 
 //==============================================================================
 
+QFutureWatcher<bool> * CellmlTextViewWidgetData::parsingWatcher() const
+{
+    // Return our parsing watcher
+
+    return mParsingWatcher;
+}
+
+//==============================================================================
+
+bool CellmlTextViewWidgetData::isParsing() const
+{
+    // Return whether we are being parsed in the background
+
+    return mParsingFuture.isRunning();
+}
+
+//==============================================================================
+
+bool CellmlTextViewWidgetData::isParsed(const QString &pSha1) const
+{
+    // Return whether the contents with the given SHA-1 value have been parsed
+
+    return !isParsing() && !mParsingSha1.compare(pSha1);
+}
+
+//==============================================================================
+
+void CellmlTextViewWidgetData::parse(const QString &pCellmlText,
+                                     const QString &pSha1)
+{
+    // Parse the given CellML text in the background
+    // Note: our caller is expected to have checked that we are not already
+    //       being parsed...
+
+    mParsingSha1 = pSha1;
+    mParsingFuture = QtConcurrent::run(this, &CellmlTextViewWidgetData::doParse,
+                                       pCellmlText, mCellmlVersion);
+
+    mParsingWatcher->setFuture(mParsingFuture);
+}
+
+//==============================================================================
+
+void CellmlTextViewWidgetData::waitForParsing()
+{
+    // Wait for our parsing in the background to be done, if needed
+    // Note: our parsing watcher only gets told that our parsing is done
+    //       through a posted event, so we deliver it straightaway (and only
+    //       it), so that whoever is connected to its finished() signal gets
+    //       to handle it before we return rather than later on...
+
+    if (!isParsing())
+        return;
+
+    mParsingFuture.waitForFinished();
+
+    QCoreApplication::sendPostedEvents(mParsingWatcher);
+}
+
+//==============================================================================
+
+bool CellmlTextViewWidgetData::parsingResult() const
+{
+    // Return the result of our last parsing
+
+    return mParsingFuture.isFinished() && mParsingFuture.result();
+}
+
+//==============================================================================
+
+CellmlTextViewParser CellmlTextViewWidgetData::parser() const
+{
+    // Return our parser
+
+    return mParser;
+}
+
+//==============================================================================
+
+bool CellmlTextViewWidgetData::doParse(const QString &pCellmlText,
+                                       const CellMLSupport::CellmlFile::Version &pCellmlVersion)
+{
+    // Parse the given CellML text
+    // Note: this is done in the background (see parse())...
+
+    return mParser.execute(pCellmlText, pCellmlVersion);
+}
+
+//==============================================================================
+
 CellmlTextViewWidget::CellmlTextViewWidget(QWidget *pParent) :
     ViewWidget(pParent),
     mNeedLoadingSettings(true),
@@ -162,7 +270,7 @@ CellmlTextViewWidget::CellmlTextViewWidget(QWidget *pParent) :
     mConverter(CellMLTextViewConverter()),
     mParser(CellmlTextViewParser()),
     mEditorLists(QList<EditorWidget::EditorListWidget *>()),
-    mPresentationMathmlEquations(QMap<QString, QString>()),
+    mStatement(QString()),
     mContentMathmlEquation(QString())
 {
     // Create our MathML converter and create a connection to retrieve the
@@ -170,6 +278,18 @@ CellmlTextViewWidget::CellmlTextViewWidget(QWidget *pParent) :
 
     connect(&mMathmlConverter, SIGNAL(done(const QString &, const QString &)),
             this, SLOT(mathmlConversionDone(const QString &, const QString &)));
+
+    // Create our parsing timer, which we use to parse the contents of our
+    // current editor in the background, once the user has stopped typing for
+    // a while
+
+    mParsingTimer = new QTimer(this);
+
+    mParsingTimer->setSingleShot(true);
+    mParsingTimer->setInterval(500);
+
+    connect(mParsingTimer, SIGNAL(timeout()),
+            this, SLOT(parseInBackground()));
 }
 
 //==============================================================================
@@ -266,6 +386,11 @@ void CellmlTextViewWidget::initialize(const QString &pFileName,
                     this, SLOT(updateViewer()));
             connect(editingWidget->editorWidget(), SIGNAL(cursorPositionChanged(const int &, const int &)),
                     this, SLOT(updateViewer()));
+
+            // Parse our contents in the background whenever they have changed
+
+            connect(editingWidget->editorWidget(), SIGNAL(textChanged()),
+                    this, SLOT(editorTextChanged()));
         } else {
             // The conversion wasn't successful, so make the editor read-only
             // (since its contents is that of the file itself) and add a couple
@@ -304,6 +429,11 @@ void CellmlTextViewWidget::initialize(const QString &pFileName,
 
         mData.insert(pFileName, data);
 
+        // Publish the result of parsing our contents in the background
+
+        connect(data->parsingWatcher(), SIGNAL(finished()),
+                this, SLOT(backgroundParsingDone()));
+
         // Add support for some key mappings to our editor
 
         connect(editingWidget->editorWidget()->editor(), SIGNAL(keyPressed(QKeyEvent *, bool &)),
@@ -336,6 +466,10 @@ void CellmlTextViewWidget::initialize(const QString &pFileName,
 
         // Update our viewer, if everything is fine, or select the first issue
         // with the current file
+        // Note: we reset our current statement since our viewer is specific
+        //       to our editing widget...
+
+        mStatement = QString();
 
         if (data->isValid()) {
             updateViewer();
@@ -496,16 +630,18 @@ bool CellmlTextViewWidget::saveFile(const QString &pOldFileName,
         // that was in the original CellML file
 
         if (parse(pOldFileName)) {
+            CellmlTextViewParser parser = data->parser();
+
             // Check whether we need a higher version of CellML to save the file
             // and, if so, ask the user whether it's OK to use that higher
             // version
 
             if (   (data->cellmlVersion() != CellMLSupport::CellmlFile::Unknown)
-                && (mParser.cellmlVersion() > data->cellmlVersion())
+                && (parser.cellmlVersion() > data->cellmlVersion())
                 && (QMessageBox::question(Core::mainWindow(), tr("Save File"),
                                           tr("<strong>%1</strong> requires features that are not present in %2 and should therefore be saved as a %3 file. Do you want to proceed?").arg(pNewFileName,
                                                                                                                                                                                          CellMLSupport::CellmlFile::versionAsString(data->cellmlVersion()),
-                                                                                                                                                                                         CellMLSupport::CellmlFile::versionAsString(mParser.cellmlVersion())),
+                                                                                                                                                                                         CellMLSupport::CellmlFile::versionAsString(parser.cellmlVersion())),
                                           QMessageBox::Yes|QMessageBox::No,
                                           QMessageBox::Yes) == QMessageBox::No)) {
                 pNeedFeedback = false;
@@ -513,11 +649,13 @@ bool CellmlTextViewWidget::saveFile(const QString &pOldFileName,
                 return false;
             }
 
-            data->setCellmlVersion(mParser.cellmlVersion());
+            data->setCellmlVersion(parser.cellmlVersion());
 
-            // Add the metadata to our DOM document
+            // Add the metadata to (a copy of) our DOM document
+            // Note: we use a copy since our DOM document may be reused (e.g. if
+            //       we save our file again without modifying it)...
 
-            QDomDocument domDocument = mParser.domDocument();
+            QDomDocument domDocument = parser.domDocument().cloneNode().toDocument();
             QDomElement domElement = domDocument.documentElement();
 
             for (QDomElement childElement = data->rdfNodes().firstChildElement();
@@ -592,7 +730,7 @@ void CellmlTextViewWidget::reformat(const QString &pFileName)
 
         editor->cursorPosition(cursorLine, cursorColumn);
 
-        mConverter.execute(Core::serialiseDomDocument(mParser.domDocument()));
+        mConverter.execute(Core::serialiseDomDocument(data->parser().domDocument()));
 
         editor->setContents(mConverter.output(), true);
         editor->setCursorPosition(cursorLine, cursorColumn);
@@ -665,6 +803,30 @@ void CellmlTextViewWidget::commentOrUncommentLine(QScintillaSupport::QScintillaW
 
 //==============================================================================
 
+void CellmlTextViewWidget::updateEditorList(CellmlTextViewWidgetData *pData,
+                                            const bool &pOnlyErrors)
+{
+    // Replace the contents of the given data's editor list with the messages
+    // that were generated by its parser, if any
+
+    EditorWidget::EditorListWidget *editorList = pData->editingWidget()->editorList();
+
+    editorList->clear();
+
+    foreach (const CellmlTextViewParserMessage &message, pData->parser().messages()) {
+        if (   !pOnlyErrors
+            || (message.type() == CellmlTextViewParserMessage::Error)) {
+            editorList->addItem((message.type() == CellmlTextViewParserMessage::Error)?
+                                    EditorWidget::EditorListItem::Error:
+                                    EditorWidget::EditorListItem::Warning,
+                                message.line(), message.column(),
+                                message.message());
+        }
+    }
+}
+
+//==============================================================================
+
 bool CellmlTextViewWidget::parse(const QString &pFileName,
                                  const bool &pOnlyErrors)
 {
@@ -673,30 +835,30 @@ bool CellmlTextViewWidget::parse(const QString &pFileName,
     CellmlTextViewWidgetData *data = mData.value(pFileName);
 
     if (data) {
-        CellMLEditingView::CellmlEditingViewWidget *editingWidget = data->editingWidget();
+        // Parse the contents of our editor, unless they have already been
+        // parsed in the background
+        // Note: our contents may currently be parsed in the background, in
+        //       which case we wait for it to be done and then check whether it
+        //       was for our current contents...
 
-        editingWidget->editorList()->clear();
+        QString contents = data->editingWidget()->editorWidget()->contents();
+        QString sha1 = Core::sha1(contents.toUtf8());
 
-        bool res = mParser.execute(editingWidget->editorWidget()->contents(),
-                                   data->cellmlVersion());
+        data->waitForParsing();
+
+        if (!data->isParsed(sha1)) {
+            data->parse(contents, sha1);
+            data->waitForParsing();
+        }
 
         // Add the messages that were generated by the parser, if any, and
         // select the first one of them
 
-        foreach (const CellmlTextViewParserMessage &message, mParser.messages()) {
-            if (   !pOnlyErrors
-                || (message.type() == CellmlTextViewParserMessage::Error)) {
-                editingWidget->editorList()->addItem((message.type() == CellmlTextViewParserMessage::Error)?
-                                                         EditorWidget::EditorListItem::Error:
-                                                         EditorWidget::EditorListItem::Warning,
-                                                     message.line(), message.column(),
-                                                     message.message());
-            }
-        }
+        updateEditorList(data, pOnlyErrors);
 
-        selectFirstItemInEditorList(editingWidget->editorList());
+        selectFirstItemInEditorList(data->editingWidget()->editorList());
 
-        return res;
+        return data->parsingResult();
     } else {
         return false;
     }
@@ -852,6 +1014,80 @@ void CellmlTextViewWidget::editorKeyPressed(QKeyEvent *pEvent, bool &pHandled)
 
 //==============================================================================
 
+void CellmlTextViewWidget::editorTextChanged()
+{
+    // The contents of our current editor has changed, so (re)start our parsing
+    // timer, so that we only parse it in the background once the user has
+    // stopped typing for a while
+
+    mParsingTimer->start();
+}
+
+//==============================================================================
+
+void CellmlTextViewWidget::parseInBackground()
+{
+    // Make sure that we still have an editing widget (i.e. it hasn't been
+    // closed since our parsing timer was started)
+
+    if (!mEditingWidget)
+        return;
+
+    // Retrieve the data associated with our current editing widget
+
+    CellmlTextViewWidgetData *data = 0;
+
+    foreach (CellmlTextViewWidgetData *currentData, mData) {
+        if (currentData->editingWidget() == mEditingWidget) {
+            data = currentData;
+
+            break;
+        }
+    }
+
+    if (!data)
+        return;
+
+    // Parse the contents of our editor in the background, unless they have
+    // already been parsed
+    // Note: we can't parse our contents if some (older) contents are still
+    //       being parsed, so try again later in that case...
+
+    if (data->isParsing()) {
+        mParsingTimer->start();
+
+        return;
+    }
+
+    QString contents = mEditingWidget->editorWidget()->contents();
+    QString sha1 = Core::sha1(contents.toUtf8());
+
+    if (!data->isParsed(sha1))
+        data->parse(contents, sha1);
+}
+
+//==============================================================================
+
+void CellmlTextViewWidget::backgroundParsingDone()
+{
+    // Some contents have been parsed in the background, so publish the
+    // messages that were generated by the parser, but only if they are for the
+    // current contents of the corresponding editor
+
+    QFutureWatcher<bool> *parsingWatcher = static_cast<QFutureWatcher<bool> *>(sender());
+
+    foreach (CellmlTextViewWidgetData *data, mData) {
+        if (data->parsingWatcher() == parsingWatcher) {
+            if (data->isParsed(Core::sha1(data->editingWidget()->editorWidget()->contents().toUtf8())))
+                updateEditorList(data);
+
+            break;
+        }
+    }
+}
+
+//==============================================================================
+
 QString CellmlTextViewWidget::partialStatement(const int &pPosition,
                                                int &pFromPosition,
                                                int &pToPosition) const
@@ -1058,6 +1294,15 @@ void CellmlTextViewWidget::updateViewer()
 
     QString currentStatement = statement(mEditingWidget->editorWidget()->currentPosition());
 
+    // Make sure that our current statement is not the one that is already in
+    // our viewer, since there is otherwise no need to parse it again (e.g. our
+    // cursor has moved, but is still within the same statement)
+
+    if (!currentStatement.isEmpty() && !currentStatement.compare(mStatement))
+        return;
+
+    mStatement = currentStatement;
+
     // Update the contents of our viewer
 
     if (currentStatement.isEmpty()) {
@@ -1081,17 +1326,13 @@ void CellmlTextViewWidget::updateViewer()
                                             +"</math>";
 
             if (contentMathmlEquation.compare(mContentMathmlEquation)) {
-                // It's a different one, so check whether we have already
-                // retrieved its Presentation MathML version
+                // It's a different one, so convert it to Presentation MathML
+                // Note: our MathML converter caches its conversions, so this is
+                //       cheap if we have already come across that equation...
 
                 mContentMathmlEquation = contentMathmlEquation;
 
-                QString presentationMathmlEquation = mPresentationMathmlEquations.value(contentMathmlEquation);
-
-                if (!presentationMathmlEquation.isEmpty())
-                    mEditingWidget->mathmlViewer()->setContents(presentationMathmlEquation);
-                else
-                    mMathmlConverter.convert(contentMathmlEquation);
+                mMathmlConverter.convert(contentMathmlEquation);
             }
         } else {
             // The parsing wasn't successful
@@ -1142,8 +1383,7 @@ void CellmlTextViewWidget::mathmlConversionDone(const QString &pContentMathml,
     if (!mEditingWidget)
         return;
 
-    // The XSL transformation is done, so update our viewer and keep track of
-    // the mapping between the Content and Presentation MathML
+    // The MathML conversion is done, so update our viewer
     // Note: before setting the contents of our viewer, we need to make sure
     //       that pInput is still our current Content MathML equation. Indeed,
     //       say that updateViewer() gets called many times in a short period of
@@ -1155,8 +1395,6 @@ void CellmlTextViewWidget::mathmlConversionDone(const QString &pContentMathml,
 
     if (!pContentMathml.compare(mContentMathmlEquation))
         mEditingWidget->mathmlViewer()->setContents(pPresentationMathml);
-
-    mPresentationMathmlEquations.insert(pContentMathml, pPresentationMathml);
 }
 
 //==============================================================================
@@ -33,10 +33,16 @@ limitations under the License.
 
 //==============================================================================
 
+#include <QFuture>
+#include <QFutureWatcher>
 #include <QMap>
 
 //==============================================================================
 
+class QTimer;
+
+//==============================================================================
+
 namespace OpenCOR {
 
 //==============================================================================
@@ -87,12 +93,31 @@ public:
 
     QDomDocument rdfNodes() const;
 
+    QFutureWatcher<bool> * parsingWatcher() const;
+
+    bool isParsing() const;
+    bool isParsed(const QString &pSha1) const;
+
+    void parse(const QString &pCellmlText, const QString &pSha1);
+    void waitForParsing();
+
+    bool parsingResult() const;
+    CellmlTextViewParser parser() const;
+
 private:
     CellMLEditingView::CellmlEditingViewWidget *mEditingWidget;
     QString mSha1;
     bool mValid;
     CellMLSupport::CellmlFile::Version mCellmlVersion;
     QDomDocument mRdfNodes;
+
+    CellmlTextViewParser mParser;
+    QString mParsingSha1;
+    QFuture<bool> mParsingFuture;
+    QFutureWatcher<bool> *mParsingWatcher;
+
+    bool doParse(const QString &pCellmlText,
+                 const CellMLSupport::CellmlFile::Version &pCellmlVersion);
 };
 
 //==============================================================================
@@ -145,16 +170,20 @@ private:
 
     QList<EditorWidget::EditorListWidget *> mEditorLists;
 
-    QMap<QString, QString> mPresentationMathmlEquations;
-
     Core::MathmlConverter mMathmlConverter;
 
+    QString mStatement;
     QString mContentMathmlEquation;
 
+    QTimer *mParsingTimer;
+
     void commentOrUncommentLine(QScintillaSupport::QScintillaWidget *pEditorWidget,
                                 const int &pLineNumber,
                                 const bool &pCommentLine);
 
+    void updateEditorList(CellmlTextViewWidgetData *pData,
+                          const bool &pOnlyErrors = false);
+
     bool parse(const QString &pFileName, const bool &pOnlyErrors = false);
 
     QString partialStatement(const int &pPosition, int &pFromPosition,
@@ -166,6 +195,11 @@ private:
 private slots:
     void editorKeyPressed(QKeyEvent *pEvent, bool &pHandled);
 
+    void editorTextChanged();
+
+    void parseInBackground();
+    void backgroundParsingDone();
+
     void updateViewer();
 
     void selectFirstItemInEditorList(EditorWidget::EditorListWidget *pEditorList = 0);
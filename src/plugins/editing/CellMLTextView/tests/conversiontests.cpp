@@ -573,6 +573,33 @@ void ConversionTests::warningConversionTests()
 
 //==============================================================================
 
+void ConversionTests::conversionBenchmark_data()
+{
+    QTest::addColumn<QString>("fileName");
+
+    QTest::newRow("cellml_cor") << "src/plugins/editing/CellMLTextView/tests/data/conversion/successful/cellml_cor.cellml";
+    QTest::newRow("faville_pacemaker_unit_2008") << "src/plugins/support/CellMLSupport/tests/data/faville_pacemaker_unit_2008.cellml";
+    QTest::newRow("faville_model_2008") << "src/plugins/support/CellMLSupport/tests/data/faville_model_2008.cellml";
+}
+
+//==============================================================================
+
+void ConversionTests::conversionBenchmark()
+{
+    // Measure the time it takes to convert some of our biggest CellML files
+
+    QFETCH(QString, fileName);
+
+    OpenCOR::CellMLTextView::CellMLTextViewConverter converter;
+    QString rawCellml = OpenCOR::fileContents(OpenCOR::fileName(fileName)).join("\n");
+
+    QBENCHMARK {
+        QVERIFY(converter.execute(rawCellml));
+    }
+}
+
+//==============================================================================
+
 QTEST_GUILESS_MAIN(ConversionTests)
 
 //==============================================================================
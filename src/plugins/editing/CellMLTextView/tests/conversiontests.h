@@ -36,6 +36,9 @@ private slots:
     void successfulConversionTests();
     void failingConversionTests();
     void warningConversionTests();
+
+    void conversionBenchmark_data();
+    void conversionBenchmark();
 };
 
 //==============================================================================
@@ -58,7 +58,6 @@ RawCellmlViewWidget::RawCellmlViewWidget(QWidget *pParent) :
     mSettingsGroup(QString()),
     mEditingWidget(0),
     mEditingWidgets(QMap<QString, CellMLEditingView::CellmlEditingViewWidget *>()),
-    mPresentationMathmlEquations(QMap<QString, QString>()),
     mContentMathmlEquation(QString())
 {
     // Create our MathML converter and create a connection to retrieve the
@@ -533,17 +532,15 @@ void RawCellmlViewWidget::updateViewer()
                 // our previous one
 
                 if (contentMathmlEquation.compare(mContentMathmlEquation)) {
-                    // It's a different one, so check whether we have already
-                    // retrieved its Presentation MathML version
+                    // It's a different one, so convert it to Presentation
+                    // MathML
+                    // Note: our MathML converter caches its conversions, so
+                    //       this is cheap if we have already come across that
+                    //       equation...
 
                     mContentMathmlEquation = contentMathmlEquation;
 
-                    QString presentationMathmlEquation = mPresentationMathmlEquations.value(contentMathmlEquation);
-
-                    if (!presentationMathmlEquation.isEmpty())
-                        mEditingWidget->mathmlViewer()->setContents(presentationMathmlEquation);
-                    else
-                        mMathmlConverter.convert(contentMathmlEquation);
+                    mMathmlConverter.convert(contentMathmlEquation);
                 }
             } else {
                 // Our current position is not within a Content MathML equation
@@ -573,8 +570,7 @@ void RawCellmlViewWidget::mathmlConversionDone(const QString &pContentMathml,
     if (!mEditingWidget)
         return;
 
-    // The XSL transformation is done, so update our viewer and keep track of
-    // the mapping between the Content and Presentation MathML
+    // The MathML conversion is done, so update our viewer
     // Note: before setting the contents of our viewer, we need to make sure
     //       that pInput is still our current Content MathML equation. Indeed,
     //       say that updateViewer() gets called many times in a short period of
@@ -586,8 +582,6 @@ void RawCellmlViewWidget::mathmlConversionDone(const QString &pContentMathml,
 
     if (!pContentMathml.compare(mContentMathmlEquation))
         mEditingWidget->mathmlViewer()->setContents(pPresentationMathml);
-
-    mPresentationMathmlEquations.insert(pContentMathml, pPresentationMathml);
 }
 
 //==============================================================================
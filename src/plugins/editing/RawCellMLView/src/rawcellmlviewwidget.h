@@ -91,8 +91,6 @@ private:
     CellMLEditingView::CellmlEditingViewWidget *mEditingWidget;
     QMap<QString, CellMLEditingView::CellmlEditingViewWidget *> mEditingWidgets;
 
-    QMap<QString, QString> mPresentationMathmlEquations;
-
     Core::MathmlConverter mMathmlConverter;
 
     QString mContentMathmlEquation;
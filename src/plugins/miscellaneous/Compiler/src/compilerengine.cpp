@@ -22,12 +22,17 @@ limitations under the License.
 
 #include "compilerengine.h"
 #include "compilermath.h"
+#include "compilerobjectcache.h"
 #include "corecliutils.h"
 
 //==============================================================================
 
 #include "llvmdisablewarnings.h"
+    #include "llvm/ADT/STLExtras.h"
     #include "llvm/IR/LLVMContext.h"
+    #include "llvm/ADT/StringMap.h"
+    #include "llvm/IR/Module.h"
+    #include "llvm/Support/Host.h"
     #include "llvm/Support/TargetSelect.h"
 
     #include "clang/Basic/DiagnosticOptions.h"
@@ -40,6 +45,11 @@ limitations under the License.
 
 //==============================================================================
 
+#include <QMutex>
+#include <QMutexLocker>
+
+//==============================================================================
+
 #include <string>
 
 //==============================================================================
@@ -50,6 +60,7 @@ namespace Compiler {
 //==============================================================================
 
 CompilerEngine::CompilerEngine() :
+    mContext(std::unique_ptr<llvm::LLVMContext>()),
     mExecutionEngine(std::unique_ptr<llvm::ExecutionEngine>()),
     mError(QString())
 {
@@ -98,7 +109,188 @@ QString CompilerEngine::error() const
 
 //==============================================================================
 
-bool CompilerEngine::compileCode(const QString &pCode)
+void CompilerEngine::initializeNativeTarget()
+{
+    // Initialise the native target (and its ASM printer), if it hasn't already
+    // been done
+    // Note: this must be done only once, and not by several threads at once,
+    //       since it registers things with LLVM's (global) target registry...
+
+    static QMutex mutex;
+    static bool initialized = false;
+
+    QMutexLocker locker(&mutex);
+
+    if (!initialized) {
+        llvm::InitializeNativeTarget();
+        llvm::InitializeNativeTargetAsmPrinter();
+
+        initialized = true;
+    }
+}
+
+//==============================================================================
+
+QStringList CompilerEngine::compilerFlags(const bool &pTargetHostCpu)
+{
+    // Return the flags that we use to compile some code
+    // Note #1: by default, we target a generic CPU and don't allow floating
+    //          point contractions (i.e. fused multiply-adds), so that the
+    //          results of a model don't depend on the CPU on which OpenCOR
+    //          happens to run...
+    // Note #2: we may, however, be asked to target the host CPU, so that loops
+    //          over lanes (see CellmlFileRuntime::batchCode()) can be
+    //          vectorised using whatever SIMD instructions it supports. In
+    //          that case, the CPU name ends up in the key of our cached
+    //          objects, as it should...
+
+    QStringList res = QStringList() << "-fsyntax-only" << "-O3" << "-ffast-math"
+                                    << "-Werror";
+
+    if (pTargetHostCpu) {
+        std::string hostCpuName = llvm::sys::getHostCPUName();
+
+        if (!hostCpuName.empty() && hostCpuName.compare("generic"))
+            res << QString("-march=%1").arg(QString::fromStdString(hostCpuName));
+    } else {
+        res << "-ffp-contract=off";
+    }
+
+    return res;
+}
+
+//==============================================================================
+
+int CompilerEngine::vectorWidth()
+{
+    // Return the number of doubles that fit in a SIMD register of the host CPU
+
+    llvm::StringMap<bool> hostCpuFeatures;
+
+    if (llvm::sys::getHostCPUFeatures(hostCpuFeatures)) {
+        if (hostCpuFeatures.lookup("avx512f"))
+            return 8;
+        else if (hostCpuFeatures.lookup("avx"))
+            return 4;
+    }
+
+    return 2;
+}
+
+//==============================================================================
+
+std::unique_ptr<llvm::Module> CompilerEngine::compileModule(const std::string &pTargetTriple,
+                                                            const QByteArray &pCode,
+                                                            const bool &pTargetHostCpu)
+{
+    // Get a driver to compile our code
+
+    llvm::IntrusiveRefCntPtr<clang::DiagnosticOptions> diagnosticOptions = new clang::DiagnosticOptions();
+    clang::DiagnosticsEngine diagnosticsEngine(llvm::IntrusiveRefCntPtr<clang::DiagnosticIDs>(new clang::DiagnosticIDs()),
+                                               &*diagnosticOptions);
+    clang::driver::Driver driver("clang", pTargetTriple, diagnosticsEngine);
+
+    driver.setCheckInputsExist(false);
+
+    // Get a compilation object to which we pass some arguments
+
+    llvm::StringRef dummyFileName("dummyFile.c");
+    llvm::SmallVector<const char *, 16> compilationArguments;
+
+    QList<QByteArray> compilerFlagsByteArrays;
+
+    foreach (const QString &compilerFlag, compilerFlags(pTargetHostCpu))
+        compilerFlagsByteArrays << compilerFlag.toUtf8();
+
+    compilationArguments.push_back("clang");
+
+    foreach (const QByteArray &compilerFlagByteArray, compilerFlagsByteArrays)
+        compilationArguments.push_back(compilerFlagByteArray.constData());
+
+    compilationArguments.push_back(dummyFileName.data());
+
+    std::unique_ptr<clang::driver::Compilation> compilation(driver.BuildCompilation(compilationArguments));
+
+    if (!compilation) {
+        mError = tr("the compilation object could not be created");
+
+        return std::unique_ptr<llvm::Module>();
+    }
+
+    // The compilation object should have only one command, so if it doesn't
+    // then something went wrong
+
+    const clang::driver::JobList &jobList = compilation->getJobs();
+
+    if (    (jobList.size() != 1)
+        || !llvm::isa<clang::driver::Command>(*jobList.begin())) {
+        mError = tr("the compilation object must contain only one command");
+
+        return std::unique_ptr<llvm::Module>();
+    }
+
+    // Retrieve the command job
+
+    const clang::driver::Command &command = llvm::cast<clang::driver::Command>(*jobList.begin());
+    QString commandName = command.getCreator().getName();
+
+    if (commandName.compare("clang")) {
+        mError = tr("a <strong>clang</strong> command was expected, but a <strong>%1</strong> command was found instead").arg(commandName);
+
+        return std::unique_ptr<llvm::Module>();
+    }
+
+    // Create a compiler invocation using our command's arguments
+
+    const clang::driver::ArgStringList &commandArguments = command.getArguments();
+    std::unique_ptr<clang::CompilerInvocation> compilerInvocation(new clang::CompilerInvocation());
+
+    clang::CompilerInvocation::CreateFromArgs(*compilerInvocation,
+                                              commandArguments.data(),
+                                              commandArguments.data()+commandArguments.size(),
+                                              diagnosticsEngine);
+
+    // Map our dummy file to a memory buffer
+
+    compilerInvocation->getPreprocessorOpts().addRemappedFile(dummyFileName, llvm::MemoryBuffer::getMemBuffer(pCode.constData()).release());
+
+    // Create a compiler instance to handle the actual work
+
+    clang::CompilerInstance compilerInstance;
+
+    compilerInstance.setInvocation(compilerInvocation.release());
+
+    // Create the compiler instance's diagnostics engine
+
+    compilerInstance.createDiagnostics();
+
+    if (!compilerInstance.hasDiagnostics()) {
+        mError = tr("the diagnostics engine could not be created");
+
+        return std::unique_ptr<llvm::Module>();
+    }
+
+    // Create and execute the frontend to generate an LLVM bitcode module
+
+    std::unique_ptr<clang::CodeGenAction> codeGenerationAction(new clang::EmitLLVMOnlyAction(mContext.get()));
+
+    if (!compilerInstance.ExecuteAction(*codeGenerationAction)) {
+        mError = tr("the code could not be compiled");
+
+        reset(false);
+
+        return std::unique_ptr<llvm::Module>();
+    }
+
+    // Retrieve and return the LLVM bitcode module
+
+    return codeGenerationAction->takeModule();
+}
+
+//==============================================================================
+
+bool CompilerEngine::compileCode(const QString &pCode,
+                                 const bool &pTargetHostCpu)
 {
     // Prepend all the external functions that may, or not, be needed by the
     // given code
@@ -159,10 +351,15 @@ bool CompilerEngine::compileCode(const QString &pCode)
                     "\n"
                    +pCode;
 
-    // Reset our compiler engine
+    // Reset our compiler engine and create our own LLVM context
+    // Note: we don't use LLVM's global context since it can't be used by
+    //       several threads at once, yet we want to be able to compile
+    //       several models at once (e.g. see CellmlFile::runtimeFuture())...
 
     reset();
 
+    mContext = std::unique_ptr<llvm::LLVMContext>(new llvm::LLVMContext());
+
     // Determine our target triple
     // Note: normally, we would call llvm::sys::getProcessTriple(), but this
     //       returns the information about the system on which LLVM was built.
@@ -187,116 +384,52 @@ bool CompilerEngine::compileCode(const QString &pCode)
     #error Unsupported platform
 #endif
 
-    // Get a driver to compile our code
-
-    llvm::IntrusiveRefCntPtr<clang::DiagnosticOptions> diagnosticOptions = new clang::DiagnosticOptions();
-    clang::DiagnosticsEngine diagnosticsEngine(llvm::IntrusiveRefCntPtr<clang::DiagnosticIDs>(new clang::DiagnosticIDs()),
-                                               &*diagnosticOptions);
-    clang::driver::Driver driver("clang", targetTriple, diagnosticsEngine);
-
-    driver.setCheckInputsExist(false);
-
-    // Get a compilation object to which we pass some arguments
-
-    llvm::StringRef dummyFileName("dummyFile.c");
-    llvm::SmallVector<const char *, 16> compilationArguments;
-
-    compilationArguments.push_back("clang");
-    compilationArguments.push_back("-fsyntax-only");
-    compilationArguments.push_back("-O3");
-    compilationArguments.push_back("-ffast-math");
-    compilationArguments.push_back("-Werror");
-    compilationArguments.push_back(dummyFileName.data());
-
-    std::unique_ptr<clang::driver::Compilation> compilation(driver.BuildCompilation(compilationArguments));
-
-    if (!compilation) {
-        mError = tr("the compilation object could not be created");
-
-        return false;
-    }
-
-    // The compilation object should have only one command, so if it doesn't
-    // then something went wrong
-
-    const clang::driver::JobList &jobList = compilation->getJobs();
-
-    if (    (jobList.size() != 1)
-        || !llvm::isa<clang::driver::Command>(*jobList.begin())) {
-        mError = tr("the compilation object must contain only one command");
-
-        return false;
-    }
-
-    // Retrieve the command job
-
-    const clang::driver::Command &command = llvm::cast<clang::driver::Command>(*jobList.begin());
-    QString commandName = command.getCreator().getName();
-
-    if (commandName.compare("clang")) {
-        mError = tr("a <strong>clang</strong> command was expected, but a <strong>%1</strong> command was found instead").arg(commandName);
-
-        return false;
-    }
-
-    // Create a compiler invocation using our command's arguments
-
-    const clang::driver::ArgStringList &commandArguments = command.getArguments();
-    std::unique_ptr<clang::CompilerInvocation> compilerInvocation(new clang::CompilerInvocation());
-
-    clang::CompilerInvocation::CreateFromArgs(*compilerInvocation,
-                                              commandArguments.data(),
-                                              commandArguments.data()+commandArguments.size(),
-                                              diagnosticsEngine);
-
-    // Map our dummy file to a memory buffer
+    // Check whether we have already compiled the given code, in which case we
+    // can skip its compilation altogether and use an empty module (to create
+    // our execution engine), to which we will add our cached object
+    // Note: the key of our cached object also acts as the identifier of our
+    //       module, so that our object cache knows where to store the object
+    //       that will be generated for it...
 
     QByteArray codeByteArray = code.toUtf8();
+    CompilerObjectCache *objectCache = CompilerObjectCache::instance();
+    QString objectKey = CompilerObjectCache::key(codeByteArray,
+                                                 QString::fromStdString(targetTriple),
+                                                 compilerFlags(pTargetHostCpu));
+    llvm::object::OwningBinary<llvm::object::ObjectFile> object = objectCache->object(objectKey);
+    std::unique_ptr<llvm::Module> module;
 
-    compilerInvocation->getPreprocessorOpts().addRemappedFile(dummyFileName, llvm::MemoryBuffer::getMemBuffer(codeByteArray.constData()).release());
-
-    // Create a compiler instance to handle the actual work
-
-    clang::CompilerInstance compilerInstance;
-
-    compilerInstance.setInvocation(compilerInvocation.release());
-
-    // Create the compiler instance's diagnostics engine
-
-    compilerInstance.createDiagnostics();
-
-    if (!compilerInstance.hasDiagnostics()) {
-        mError = tr("the diagnostics engine could not be created");
-
-        return false;
-    }
-
-    // Create and execute the frontend to generate an LLVM bitcode module
+    if (object.getBinary()) {
+        module = llvm::make_unique<llvm::Module>(objectKey.toStdString(),
+                                                 *mContext);
 
-    std::unique_ptr<clang::CodeGenAction> codeGenerationAction(new clang::EmitLLVMOnlyAction(&llvm::getGlobalContext()));
+        module->setTargetTriple(targetTriple);
+    } else {
+        module = compileModule(targetTriple, codeByteArray, pTargetHostCpu);
 
-    if (!compilerInstance.ExecuteAction(*codeGenerationAction)) {
-        mError = tr("the code could not be compiled");
-
-        reset(false);
+        if (!module)
+            return false;
 
-        return false;
+        module->setModuleIdentifier(objectKey.toStdString());
     }
 
-    // Retrieve the LLVM bitcode module
-
-    std::unique_ptr<llvm::Module> module = codeGenerationAction->takeModule();
-
     // Initialise the native target (and its ASM printer), so not only can we
     // then create an execution engine, but more importantly its data layout
     // will match that of our target platform
 
-    llvm::InitializeNativeTarget();
-    llvm::InitializeNativeTargetAsmPrinter();
+    initializeNativeTarget();
 
-    // Create and keep track of an execution engine
+    // Create and keep track of an execution engine, making sure that it only
+    // targets the host CPU if we were asked to (see compilerFlags())
 
-    mExecutionEngine = std::unique_ptr<llvm::ExecutionEngine>(llvm::EngineBuilder(std::move(module)).setEngineKind(llvm::EngineKind::JIT).create());
+    llvm::EngineBuilder engineBuilder(std::move(module));
+
+    engineBuilder.setEngineKind(llvm::EngineKind::JIT);
+
+    if (pTargetHostCpu)
+        engineBuilder.setMCPU(llvm::sys::getHostCPUName());
+
+    mExecutionEngine = std::unique_ptr<llvm::ExecutionEngine>(engineBuilder.create());
 
     if (!mExecutionEngine) {
         mError = tr("the execution engine could not be created");
@@ -367,6 +500,17 @@ bool CompilerEngine::compileCode(const QString &pCode)
     mExecutionEngine->addGlobalMapping(FUNCTION_NAME("gcd_multi"), (uint64_t) compiler_gcd_multi);
     mExecutionEngine->addGlobalMapping(FUNCTION_NAME("lcm_multi"), (uint64_t) compiler_lcm_multi);
 
+    // Either add our cached object to our execution engine or let our object
+    // cache know about the object that is to be generated for our module
+    // Note: in the former case, the relocations of our cached object, including
+    //       those to the external functions above, get resolved the first time
+    //       we retrieve one of its functions...
+
+    if (object.getBinary())
+        mExecutionEngine->addObjectFile(std::move(object));
+    else
+        mExecutionEngine->setObjectCache(objectCache);
+
     return true;
 }
 
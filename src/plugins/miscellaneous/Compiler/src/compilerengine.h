@@ -30,11 +30,13 @@ limitations under the License.
 
 #include <QObject>
 #include <QString>
+#include <QStringList>
 
 //==============================================================================
 
 #include "llvmdisablewarnings.h"
     #include "llvm/ExecutionEngine/ExecutionEngine.h"
+    #include "llvm/IR/LLVMContext.h"
 #include "llvmenablewarnings.h"
 
 //==============================================================================
@@ -55,16 +57,28 @@ public:
     bool hasError() const;
     QString error() const;
 
-    bool compileCode(const QString &pCode);
+    bool compileCode(const QString &pCode,
+                     const bool &pTargetHostCpu = false);
 
     void * getFunction(const QString &pFunctionName);
 
+    static int vectorWidth();
+
 private:
+    std::unique_ptr<llvm::LLVMContext> mContext;
     std::unique_ptr<llvm::ExecutionEngine> mExecutionEngine;
 
     QString mError;
 
     void reset(const bool &pResetError = true);
+
+    static QStringList compilerFlags(const bool &pTargetHostCpu);
+
+    static void initializeNativeTarget();
+
+    std::unique_ptr<llvm::Module> compileModule(const std::string &pTargetTriple,
+                                                const QByteArray &pCode,
+                                                const bool &pTargetHostCpu);
 };
 
 //==============================================================================
@@ -0,0 +1,369 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Compiler object cache
+//==============================================================================
+
+#include "compilerobjectcache.h"
+#include "corecliutils.h"
+
+//==============================================================================
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+//==============================================================================
+
+#include "llvmdisablewarnings.h"
+    #include "llvm/IR/Module.h"
+    #include "llvm/Support/FileSystem.h"
+    #include "llvm/Support/MemoryBuffer.h"
+    #include "llvm/Support/Process.h"
+#include "llvmenablewarnings.h"
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace Compiler {
+
+//==============================================================================
+
+static const auto CacheFormatVersion = QStringLiteral("1");
+static const auto ObjectFileExtension = QStringLiteral(".o");
+
+//==============================================================================
+
+CompilerObjectCache::CompilerObjectCache() :
+    mMutex(),
+    mEnabled(true),
+    mDirectory(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)+QDir::separator()+"Compiler"),
+    mMaximumSize(DefaultMaximumCacheSize),
+    mHits(0),
+    mMisses(0)
+{
+}
+
+//==============================================================================
+
+CompilerObjectCache * CompilerObjectCache::instance()
+{
+    // Return the 'global' instance of our compiler object cache class
+
+    static CompilerObjectCache instance;
+
+    return static_cast<CompilerObjectCache *>(Core::globalInstance("OpenCOR::Compiler::CompilerObjectCache::instance()",
+                                                                   &instance));
+}
+
+//==============================================================================
+
+QString CompilerObjectCache::key(const QByteArray &pCode,
+                                 const QString &pTargetTriple,
+                                 const QStringList &pCompilerFlags)
+{
+    // Return the key for the given code, target triple and compiler flags
+    // Note: we include the version of our cache format, so that we don't end
+    //       up using an object that was cached by an incompatible version of
+    //       OpenCOR...
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    hash.addData(CacheFormatVersion.toUtf8());
+    hash.addData("\n");
+    hash.addData(pTargetTriple.toUtf8());
+    hash.addData("\n");
+    hash.addData(pCompilerFlags.join(" ").toUtf8());
+    hash.addData("\n");
+    hash.addData(pCode);
+
+    return hash.result().toHex();
+}
+
+//==============================================================================
+
+bool CompilerObjectCache::isEnabled() const
+{
+    // Return whether we are enabled
+
+    QMutexLocker locker(&mMutex);
+
+    return mEnabled;
+}
+
+//==============================================================================
+
+void CompilerObjectCache::setEnabled(const bool &pEnabled)
+{
+    // Enable/disable ourselves
+
+    QMutexLocker locker(&mMutex);
+
+    mEnabled = pEnabled;
+}
+
+//==============================================================================
+
+QString CompilerObjectCache::directory() const
+{
+    // Return our directory
+
+    QMutexLocker locker(&mMutex);
+
+    return mDirectory;
+}
+
+//==============================================================================
+
+void CompilerObjectCache::setDirectory(const QString &pDirectory)
+{
+    // Set our directory
+
+    QMutexLocker locker(&mMutex);
+
+    mDirectory = pDirectory;
+}
+
+//==============================================================================
+
+qint64 CompilerObjectCache::maximumSize() const
+{
+    // Return our maximum size
+
+    QMutexLocker locker(&mMutex);
+
+    return mMaximumSize;
+}
+
+//==============================================================================
+
+void CompilerObjectCache::setMaximumSize(const qint64 &pMaximumSize)
+{
+    // Set our maximum size and evict whatever objects no longer fit in it
+
+    QMutexLocker locker(&mMutex);
+
+    mMaximumSize = pMaximumSize;
+
+    evict();
+}
+
+//==============================================================================
+
+qint64 CompilerObjectCache::size() const
+{
+    // Return the size of all the objects we currently hold
+
+    QMutexLocker locker(&mMutex);
+
+    qint64 res = 0;
+
+    foreach (const QFileInfo &fileInfo,
+             QDir(mDirectory).entryInfoList(QStringList() << "*"+ObjectFileExtension,
+                                            QDir::Files)) {
+        res += fileInfo.size();
+    }
+
+    return res;
+}
+
+//==============================================================================
+
+quint64 CompilerObjectCache::hits() const
+{
+    // Return our number of hits
+
+    QMutexLocker locker(&mMutex);
+
+    return mHits;
+}
+
+//==============================================================================
+
+quint64 CompilerObjectCache::misses() const
+{
+    // Return our number of misses
+
+    QMutexLocker locker(&mMutex);
+
+    return mMisses;
+}
+
+//==============================================================================
+
+void CompilerObjectCache::resetStatistics()
+{
+    // Reset our statistics
+
+    QMutexLocker locker(&mMutex);
+
+    mHits = 0;
+    mMisses = 0;
+}
+
+//==============================================================================
+
+void CompilerObjectCache::clear()
+{
+    // Remove all the objects we currently hold
+
+    QMutexLocker locker(&mMutex);
+
+    foreach (const QFileInfo &fileInfo,
+             QDir(mDirectory).entryInfoList(QStringList() << "*"+ObjectFileExtension,
+                                            QDir::Files)) {
+        QFile::remove(fileInfo.absoluteFilePath());
+    }
+}
+
+//==============================================================================
+
+QString CompilerObjectCache::fileName(const QString &pKey) const
+{
+    // Return the name of the file that holds (or would hold) the object for
+    // the given key
+
+    return mDirectory+QDir::separator()+pKey+ObjectFileExtension;
+}
+
+//==============================================================================
+
+llvm::object::OwningBinary<llvm::object::ObjectFile> CompilerObjectCache::object(const QString &pKey)
+{
+    // Retrieve and return the object for the given key, if any
+
+    QMutexLocker locker(&mMutex);
+
+    if (!mEnabled)
+        return llvm::object::OwningBinary<llvm::object::ObjectFile>();
+
+    QString objectFileName = fileName(pKey);
+    std::string nativeObjectFileName = QDir::toNativeSeparators(objectFileName).toStdString();
+    llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> buffer = llvm::MemoryBuffer::getFile(nativeObjectFileName);
+
+    if (!buffer) {
+        ++mMisses;
+
+        return llvm::object::OwningBinary<llvm::object::ObjectFile>();
+    }
+
+    // Make sure that our object is valid and, if not, then get rid of it
+    // Note: an invalid object could, for example, be the result of OpenCOR
+    //       crashing while we were storing it...
+
+    llvm::ErrorOr<std::unique_ptr<llvm::object::ObjectFile>> objectFile = llvm::object::ObjectFile::createObjectFile((*buffer)->getMemBufferRef());
+
+    if (!objectFile) {
+        QFile::remove(objectFileName);
+
+        ++mMisses;
+
+        return llvm::object::OwningBinary<llvm::object::ObjectFile>();
+    }
+
+    // Update the modification time of our object, so that it is considered as
+    // recently used when it comes to evicting objects
+
+    int fileDescriptor;
+
+    if (!llvm::sys::fs::openFileForWrite(nativeObjectFileName, fileDescriptor,
+                                         llvm::sys::fs::F_Append)) {
+        llvm::sys::fs::setLastModificationAndAccessTime(fileDescriptor,
+                                                        llvm::sys::TimeValue::now());
+        llvm::sys::Process::SafelyCloseFileDescriptor(fileDescriptor);
+    }
+
+    ++mHits;
+
+    return llvm::object::OwningBinary<llvm::object::ObjectFile>(std::move(*objectFile),
+                                                                std::move(*buffer));
+}
+
+//==============================================================================
+
+void CompilerObjectCache::notifyObjectCompiled(const llvm::Module *pModule,
+                                               llvm::MemoryBufferRef pObject)
+{
+    // Store the object that has just been compiled for the given module
+    // Note: the identifier of the module is the key that was used to retrieve
+    //       its object in the first place. We use a QSaveFile object so that
+    //       the object is either fully stored or not at all...
+
+    QMutexLocker locker(&mMutex);
+
+    if (!mEnabled || !QDir().mkpath(mDirectory))
+        return;
+
+    QSaveFile file(fileName(QString::fromStdString(pModule->getModuleIdentifier())));
+
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+
+    file.write(pObject.getBufferStart(), pObject.getBufferSize());
+
+    if (file.commit())
+        evict();
+}
+
+//==============================================================================
+
+std::unique_ptr<llvm::MemoryBuffer> CompilerObjectCache::getObject(const llvm::Module *pModule)
+{
+    Q_UNUSED(pModule);
+
+    // We don't provide any object through this method since our compiler
+    // engine retrieves an object (using object()) before even bothering to
+    // generate a module for it, meaning that if we get here then there is no
+    // object for the given module
+
+    return std::unique_ptr<llvm::MemoryBuffer>();
+}
+
+//==============================================================================
+
+void CompilerObjectCache::evict()
+{
+    // Evict our least recently used objects until our size is within our
+    // maximum size
+    // Note: our caller is expected to have locked our mutex...
+
+    qint64 size = 0;
+
+    foreach (const QFileInfo &fileInfo,
+             QDir(mDirectory).entryInfoList(QStringList() << "*"+ObjectFileExtension,
+                                            QDir::Files, QDir::Time)) {
+        size += fileInfo.size();
+
+        if (size > mMaximumSize)
+            QFile::remove(fileInfo.absoluteFilePath());
+    }
+}
+
+//==============================================================================
+
+}   // namespace Compiler
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
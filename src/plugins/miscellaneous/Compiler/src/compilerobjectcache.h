@@ -0,0 +1,110 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Compiler object cache
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include "compilerglobal.h"
+
+//==============================================================================
+
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+
+//==============================================================================
+
+#include "llvmdisablewarnings.h"
+    #include "llvm/ExecutionEngine/ObjectCache.h"
+    #include "llvm/Object/ObjectFile.h"
+#include "llvmenablewarnings.h"
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace Compiler {
+
+//==============================================================================
+
+static const qint64 DefaultMaximumCacheSize = 64*1024*1024;
+
+//==============================================================================
+
+class COMPILER_EXPORT CompilerObjectCache : public llvm::ObjectCache
+{
+public:
+    explicit CompilerObjectCache();
+
+    static CompilerObjectCache * instance();
+
+    static QString key(const QByteArray &pCode, const QString &pTargetTriple,
+                       const QStringList &pCompilerFlags);
+
+    bool isEnabled() const;
+    void setEnabled(const bool &pEnabled);
+
+    QString directory() const;
+    void setDirectory(const QString &pDirectory);
+
+    qint64 maximumSize() const;
+    void setMaximumSize(const qint64 &pMaximumSize);
+
+    qint64 size() const;
+
+    quint64 hits() const;
+    quint64 misses() const;
+
+    void resetStatistics();
+
+    void clear();
+
+    llvm::object::OwningBinary<llvm::object::ObjectFile> object(const QString &pKey);
+
+    virtual void notifyObjectCompiled(const llvm::Module *pModule,
+                                      llvm::MemoryBufferRef pObject);
+    virtual std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module *pModule);
+
+private:
+    mutable QMutex mMutex;
+
+    bool mEnabled;
+
+    QString mDirectory;
+    qint64 mMaximumSize;
+
+    quint64 mHits;
+    quint64 mMisses;
+
+    QString fileName(const QString &pKey) const;
+
+    void evict();
+};
+
+//==============================================================================
+
+}   // namespace Compiler
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
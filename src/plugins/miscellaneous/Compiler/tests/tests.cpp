@@ -22,6 +22,7 @@ limitations under the License.
 
 #include "compilerengine.h"
 #include "compilermath.h"
+#include "compilerobjectcache.h"
 #include "tests.h"
 
 //==============================================================================
@@ -42,6 +43,11 @@ void Tests::initTestCase()
 
     mCompilerEngine = new OpenCOR::Compiler::CompilerEngine();
 
+    // Disable our object cache, so that our tests always compile their code
+    // (our object cache gets tested separately)
+
+    OpenCOR::Compiler::CompilerObjectCache::instance()->setEnabled(false);
+
     // Initialise some values
 
     mA = 5.0;
@@ -1062,6 +1068,77 @@ void Tests::lcmFunctionTests()
 
 //==============================================================================
 
+void Tests::objectCacheTests()
+{
+    // Use a temporary directory for our object cache and enable it
+
+    QTemporaryDir objectCacheDirectory;
+    OpenCOR::Compiler::CompilerObjectCache *objectCache = OpenCOR::Compiler::CompilerObjectCache::instance();
+
+    QVERIFY(objectCacheDirectory.isValid());
+
+    objectCache->setDirectory(objectCacheDirectory.path());
+    objectCache->setEnabled(true);
+    objectCache->resetStatistics();
+
+    // Compile some code for the first time, which should result in a miss and
+    // in its object being cached once one of its functions has been retrieved
+
+    QString code = "double function(double pNb1, double pNb2)\n"
+                   "{\n"
+                   "    return pow(pNb1, pNb2);\n"
+                   "}";
+
+    QVERIFY(mCompilerEngine->compileCode(code));
+    QCOMPARE(((double (*)(double, double)) (intptr_t) mCompilerEngine->getFunction("function"))(2.0, 3.0),
+             8.0);
+
+    QCOMPARE(objectCache->hits(), quint64(0));
+    QCOMPARE(objectCache->misses(), quint64(1));
+    QVERIFY(objectCache->size() > 0);
+
+    // Compile the same code again, which should result in a hit, and make sure
+    // that the cached object, including its call to an external function,
+    // works as expected
+
+    QVERIFY(mCompilerEngine->compileCode(code));
+    QCOMPARE(((double (*)(double, double)) (intptr_t) mCompilerEngine->getFunction("function"))(2.0, 3.0),
+             8.0);
+
+    QCOMPARE(objectCache->hits(), quint64(1));
+    QCOMPARE(objectCache->misses(), quint64(1));
+
+    // Make sure that code that cannot be compiled doesn't get cached
+
+    qint64 size = objectCache->size();
+
+    QVERIFY(!mCompilerEngine->compileCode("double function() { return 3.0*/a; }"));
+
+    QCOMPARE(objectCache->misses(), quint64(2));
+    QCOMPARE(objectCache->size(), size);
+
+    // Reduce the maximum size of our object cache, which should result in all
+    // of its objects being evicted
+
+    objectCache->setMaximumSize(0);
+
+    QCOMPARE(objectCache->size(), qint64(0));
+
+    QVERIFY(mCompilerEngine->compileCode(code));
+    QCOMPARE(((double (*)(double, double)) (intptr_t) mCompilerEngine->getFunction("function"))(2.0, 3.0),
+             8.0);
+
+    QCOMPARE(objectCache->misses(), quint64(3));
+    QCOMPARE(objectCache->size(), qint64(0));
+
+    // Restore and disable our object cache
+
+    objectCache->setMaximumSize(OpenCOR::Compiler::DefaultMaximumCacheSize);
+    objectCache->setEnabled(false);
+}
+
+//==============================================================================
+
 QTEST_GUILESS_MAIN(Tests)
 
 //==============================================================================
@@ -123,6 +123,8 @@ private slots:
 
     void gcdFunctionTests();
     void lcmFunctionTests();
+
+    void objectCacheTests();
 };
 
 //==============================================================================
@@ -142,6 +142,7 @@ void CORE_EXPORT checkFileNameOrUrl(const QString &pInFileNameOrUrl,
 QString CORE_EXPORT formatXml(const QString &pXml);
 
 QString CORE_EXPORT cleanContentMathml(const QString &pContentMathml);
+void CORE_EXPORT cleanPresentationMathml(QDomElement pDomElement);
 QString CORE_EXPORT cleanPresentationMathml(const QString &pPresentationMathml);
 
 QString CORE_EXPORT newFileName(const QString &pFileName,
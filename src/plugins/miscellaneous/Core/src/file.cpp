@@ -25,9 +25,17 @@ limitations under the License.
 
 //==============================================================================
 
+#include <QDateTime>
 #include <QFile>
 #include <QFileDevice>
 #include <QFileInfo>
+#include <QMap>
+
+//==============================================================================
+
+#ifndef Q_OS_WIN
+    #include <sys/stat.h>
+#endif
 
 //==============================================================================
 
@@ -40,6 +48,93 @@ static int gNewIndex = 0;
 
 //==============================================================================
 
+struct FileSha1
+{
+    qint64 size;
+    QDateTime lastModified;
+    quint64 inode;
+
+    QString sha1;
+};
+
+//==============================================================================
+
+static QMap<QString, FileSha1> gFilesSha1 = QMap<QString, FileSha1>();
+
+//==============================================================================
+
+static QString fileSha1(const QString &pFileName, const bool &pUseCache,
+                        QSet<QString> *pCheckedFileNames = 0)
+{
+    // Return the SHA-1 value of the given file, if it still exists and can be
+    // opened
+    // Note #1: to compute the SHA-1 value of a file means reading all of its
+    //          contents, so when checking for external changes, we only do
+    //          that if its size, last modified time or inode (on non-Windows
+    //          systems) has changed since we last computed its SHA-1 value...
+    // Note #2: the last modified time of a file may only be precise to the
+    //          second, so a file saved twice within the same second and with
+    //          the same size would look unchanged. Hence, we only rely on our
+    //          cache when asked to (i.e. when checking for external changes)
+    //          and otherwise always compute the SHA-1 value from the file's
+    //          contents, which also refreshes our cache...
+    // Note #3: a file may be checked several times in a row (e.g. a file that
+    //          is a dependency of several other files), in which case we only
+    //          want to retrieve its metadata once...
+
+    if (pCheckedFileNames && pCheckedFileNames->contains(pFileName))
+        return gFilesSha1.value(pFileName).sha1;
+
+    if (pCheckedFileNames)
+        pCheckedFileNames->insert(pFileName);
+
+    QFileInfo fileInfo = QFileInfo(pFileName);
+
+    if (!fileInfo.exists()) {
+        gFilesSha1.remove(pFileName);
+
+        return QString();
+    }
+
+    FileSha1 newFileSha1;
+
+    newFileSha1.size = fileInfo.size();
+    newFileSha1.lastModified = fileInfo.lastModified();
+    newFileSha1.inode = 0;
+
+#ifndef Q_OS_WIN
+    struct stat fileStat;
+
+    if (!stat(QFile::encodeName(pFileName).constData(), &fileStat))
+        newFileSha1.inode = fileStat.st_ino;
+#endif
+
+    QMap<QString, FileSha1>::const_iterator iter = gFilesSha1.constFind(pFileName);
+
+    if (   pUseCache && (iter != gFilesSha1.constEnd())
+        && (iter.value().size == newFileSha1.size)
+        && (iter.value().lastModified == newFileSha1.lastModified)
+        && (iter.value().inode == newFileSha1.inode)) {
+        return iter.value().sha1;
+    }
+
+    QByteArray fileContents;
+
+    if (readFileContentsFromFile(pFileName, fileContents)) {
+        newFileSha1.sha1 = Core::sha1(fileContents);
+
+        gFilesSha1.insert(pFileName, newFileSha1);
+
+        return newFileSha1.sha1;
+    } else {
+        gFilesSha1.remove(pFileName);
+
+        return QString();
+    }
+}
+
+//==============================================================================
+
 File::File(const QString &pFileName, const Type &pType, const QString &pUrl) :
     mFileName(nativeCanonicalFileName(pFileName)),
     mUrl(pUrl)
@@ -98,7 +193,7 @@ bool File::setFileName(const QString &pFileName)
 
 //==============================================================================
 
-File::Status File::check()
+File::Status File::check(QSet<QString> *pCheckedFileNames)
 {
     // Always consider ourselves unchanged if we are a remote file
 
@@ -116,11 +211,11 @@ File::Status File::check()
     // Retrieve our 'new' SHA-1 value and that of our dependencies (if any), and
     // check whether they are different from the one(s) we currently have
 
-    QString newSha1 = sha1();
+    QString newSha1 = fileSha1(mFileName, true, pCheckedFileNames);
     QStringList newDependenciesSha1 = QStringList();
 
     foreach (const QString &dependency, mDependencies)
-        newDependenciesSha1 << sha1(dependency);
+        newDependenciesSha1 << fileSha1(dependency, true, pCheckedFileNames);
 
     bool dependenciesChanged = !qSameStringLists(newDependenciesSha1, mDependenciesSha1);
 
@@ -145,15 +240,23 @@ File::Status File::check()
 
 QString File::sha1(const QString &pFileName) const
 {
-    // Compute the SHA-1 value for the given file or ourselves (if no file is
+    // Return the SHA-1 value for the given file or ourselves (if no file is
     // given), if it/we still exist/s and can be opened
 
-    QByteArray fileContents;
+    return fileSha1(pFileName.isEmpty()?mFileName:pFileName, false);
+}
 
-    if (readFileContentsFromFile(pFileName.isEmpty()?mFileName:pFileName, fileContents))
-        return Core::sha1(fileContents);
-    else
-        return QString();
+//==============================================================================
+
+void File::resetSha1(const QString &pFileName)
+{
+    // Forget about the SHA-1 value of the given file, so that it gets computed
+    // again the next time it is needed
+    // Note: this is for when we know that a file has changed, but that its
+    //       metadata may not reflect it (e.g. the file has been modified twice
+    //       within the resolution of its last modified time)...
+
+    gFilesSha1.remove(pFileName);
 }
 
 //==============================================================================
@@ -161,6 +264,11 @@ QString File::sha1(const QString &pFileName) const
 void File::reset(const bool &pResetDependencies)
 {
     // Reset our modified state, new index and SHA-1 value
+    // Note: we may have just been saved, in which case our metadata may not
+    //       reflect it (see fileSha1()), so we forget about our cached SHA-1
+    //       value before recomputing it...
+
+    resetSha1(mFileName);
 
     mSha1 = sha1();
 
@@ -28,6 +28,7 @@ limitations under the License.
 
 //==============================================================================
 
+#include <QSet>
 #include <QStringList>
 
 //==============================================================================
@@ -72,10 +73,12 @@ public:
     QString fileName() const;
     bool setFileName(const QString &pFileName);
 
-    Status check();
+    Status check(QSet<QString> *pCheckedFileNames = 0);
 
     QString sha1(const QString &pFileName = QString()) const;
 
+    static void resetSha1(const QString &pFileName);
+
     void reset(const bool &pResetDependencies = true);
 
     bool isDifferent() const;
@@ -27,6 +27,8 @@ limitations under the License.
 
 #include <QApplication>
 #include <QFile>
+#include <QFileSystemWatcher>
+#include <QSet>
 #include <QTimer>
 
 //==============================================================================
@@ -49,6 +51,27 @@ FileManager::FileManager() :
 
     connect(mTimer, SIGNAL(timeout()),
             this, SLOT(checkFiles()));
+
+    // Create our file system watcher, as well as a single-shot timer that we
+    // use to check our files once the file system has settled down
+    // Note: our file system watcher is what normally lets us know about our
+    //       files having changed. Our (periodic) timer is only there as a
+    //       fallback, i.e. for changes that our file system watcher may not
+    //       report (e.g. on some network file systems)...
+
+    mFileSystemWatcher = new QFileSystemWatcher(this);
+    mFileSystemWatcherTimer = new QTimer(this);
+
+    mFileSystemWatcherTimer->setSingleShot(true);
+    mFileSystemWatcherTimer->setInterval(100);
+
+    // Some connections to handle changes to our files
+
+    connect(mFileSystemWatcher, SIGNAL(fileChanged(const QString &)),
+            this, SLOT(fileSystemWatcherFileChanged(const QString &)));
+
+    connect(mFileSystemWatcherTimer, SIGNAL(timeout()),
+            this, SLOT(checkFiles()));
 }
 
 //==============================================================================
@@ -59,6 +82,9 @@ FileManager::~FileManager()
 
     delete mTimer;
 
+    delete mFileSystemWatcher;
+    delete mFileSystemWatcherTimer;
+
     // Remove all the managed files
 
     foreach (File *file, mFiles)
@@ -96,8 +122,10 @@ FileManager::Status FileManager::manage(const QString &pFileName,
 
             mFiles.insert(nativeFileName, new File(nativeFileName, pType, pUrl));
 
+            updateWatchedFiles();
+
             if (!mTimer->isActive())
-                mTimer->start(1000);
+                mTimer->start(5000);
 
             emit fileManaged(nativeFileName);
 
@@ -124,6 +152,8 @@ FileManager::Status FileManager::unmanage(const QString &pFileName)
 
         delete nativeFile;
 
+        updateWatchedFiles();
+
         if (mFiles.isEmpty())
             mTimer->stop();
 
@@ -166,8 +196,11 @@ void FileManager::reset(const QString &pFileName)
 
     File *nativeFile = file(nativeCanonicalFileName(pFileName));
 
-    if (nativeFile)
+    if (nativeFile) {
         nativeFile->reset();
+
+        updateWatchedFiles();
+    }
 }
 
 //==============================================================================
@@ -301,8 +334,11 @@ void FileManager::makeNew(const QString &pFileName)
     if (nativeFile) {
         QString fileName;
 
-        if (newFile(fileName))
+        if (newFile(fileName)) {
             nativeFile->makeNew(fileName);
+
+            updateWatchedFiles();
+        }
     }
 }
 
@@ -436,8 +472,8 @@ void FileManager::setDependencies(const QString &pFileName,
 
     File *nativeFile = file(nativeCanonicalFileName(pFileName));
 
-    if (nativeFile)
-        nativeFile->setDependencies(pDependencies);
+    if (nativeFile && nativeFile->setDependencies(pDependencies))
+        updateWatchedFiles();
 }
 
 //==============================================================================
@@ -459,6 +495,8 @@ void FileManager::reload(const QString &pFileName,
 
         nativeFile->reset();
 
+        updateWatchedFiles();
+
         emit fileReloaded(nativeFileName,
                               pForceFileChanged
                           || (nativeFileStatus == File::Changed) || (nativeFileStatus == File::AllChanged));
@@ -488,6 +526,40 @@ bool FileManager::newFile(QString &pFileName, const QByteArray &pContents)
 
 //==============================================================================
 
+void FileManager::updateWatchedFiles()
+{
+    // Make sure that our file system watcher watches our local files and their
+    // dependencies, and nothing else
+
+    QSet<QString> fileNames = QSet<QString>();
+
+    foreach (File *file, mFiles) {
+        if (file->isLocal()) {
+            fileNames << file->fileName();
+
+            foreach (const QString &dependency, file->dependencies())
+                fileNames << dependency;
+        }
+    }
+
+    QSet<QString> watchedFileNames = mFileSystemWatcher->files().toSet();
+    QStringList oldFileNames = (watchedFileNames-fileNames).toList();
+    QStringList newFileNames = QStringList();
+
+    foreach (const QString &fileName, fileNames-watchedFileNames) {
+        if (QFile::exists(fileName))
+            newFileNames << fileName;
+    }
+
+    if (!oldFileNames.isEmpty())
+        mFileSystemWatcher->removePaths(oldFileNames);
+
+    if (!newFileNames.isEmpty())
+        mFileSystemWatcher->addPaths(newFileNames);
+}
+
+//==============================================================================
+
 FileManager::Status FileManager::create(const QString &pUrl,
                                         const QByteArray &pContents)
 {
@@ -525,6 +597,8 @@ FileManager::Status FileManager::rename(const QString &pOldFileName,
             mFiles.insert(newNativeFileName, mFiles.value(oldNativeFileName));
             mFiles.remove(oldNativeFileName);
 
+            updateWatchedFiles();
+
             emit fileRenamed(oldNativeFileName, newNativeFileName);
 
             return Renamed;
@@ -619,10 +693,14 @@ void FileManager::checkFiles()
 {
     // Check our various files, as well as their locked status, but only if they
     // are not being ignored
+    // Note: we keep track of the files we have checked, so that a dependency
+    //       shared by several of our files only gets checked once...
+
+    QSet<QString> checkedFileNames = QSet<QString>();
 
     foreach (File *file, mFiles) {
         QString fileName = file->fileName();
-        File::Status fileStatus = file->check();
+        File::Status fileStatus = file->check(&checkedFileNames);
 
         switch (fileStatus) {
         case File::Changed:
@@ -660,6 +738,27 @@ void FileManager::checkFiles()
             ;
         }
     }
+
+    // Make sure that we watch the files that may have been (re)created since
+    // we last checked our files
+
+    updateWatchedFiles();
+}
+
+//==============================================================================
+
+void FileManager::fileSystemWatcherFileChanged(const QString &pFileName)
+{
+    // The given file has changed, so make sure that its SHA-1 value gets
+    // recomputed and that we are still watching it (it may have been replaced
+    // by another file, e.g. if it was saved by writing to a temporary file that
+    // was then renamed), and check our files once things have settled down
+
+    File::resetSha1(pFileName);
+
+    updateWatchedFiles();
+
+    mFileSystemWatcherTimer->start();
 }
 
 //==============================================================================
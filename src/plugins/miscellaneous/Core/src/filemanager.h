@@ -34,6 +34,7 @@ limitations under the License.
 
 //==============================================================================
 
+class QFileSystemWatcher;
 class QTimer;
 
 //==============================================================================
@@ -150,6 +151,9 @@ private:
 
     QTimer *mTimer;
 
+    QFileSystemWatcher *mFileSystemWatcher;
+    QTimer *mFileSystemWatcherTimer;
+
     QMap<QString, File *> mFiles;
 
     QMap<QString, bool> mFilesReadable;
@@ -157,6 +161,8 @@ private:
 
     bool newFile(QString &pFileName, const QByteArray &pContents = QByteArray());
 
+    void updateWatchedFiles();
+
 signals:
     void fileManaged(const QString &pFileName);
     void fileUnmanaged(const QString &pFileName);
@@ -178,6 +184,8 @@ signals:
 
 private slots:
     void checkFiles();
+
+    void fileSystemWatcherFileChanged(const QString &pFileName);
 };
 
 //==============================================================================
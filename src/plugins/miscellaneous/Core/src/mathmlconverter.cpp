@@ -26,43 +26,1147 @@ limitations under the License.
 
 //==============================================================================
 
+#include <QCache>
+#include <QDomDocument>
+#include <QStringList>
+#include <QtNumeric>
+#include <QXmlInputSource>
+#include <QXmlSimpleReader>
+
+//==============================================================================
+
 namespace OpenCOR {
 namespace Core {
 
 //==============================================================================
 
-MathmlConverter::MathmlConverter()
+static const auto MathmlNamespace = QStringLiteral("http://www.w3.org/1998/Math/MathML");
+
+//==============================================================================
+
+static const int PresentationMathmlCacheSize = 1024;
+
+//==============================================================================
+
+typedef QCache<QString, QString> PresentationMathmlCache;
+
+//==============================================================================
+
+static PresentationMathmlCache * presentationMathmlCache()
 {
-    // Create our XSL transformer and create a connection to retrieve the result
-    // of its XSL transformations
+    // Return the 'global' cache of Presentation MathML equations, which is
+    // shared by all our MathML converters
+    // Note: a QCache object discards its least recently used objects first,
+    //       which is exactly what we want...
 
-    mXslTransformer = new XslTransformer();
+    static PresentationMathmlCache instance(PresentationMathmlCacheSize);
 
-    connect(mXslTransformer, SIGNAL(done(const QString &, const QString &)),
-            this, SLOT(xslTransformationDone(const QString &, const QString &)));
+    return static_cast<PresentationMathmlCache *>(globalInstance("OpenCOR::Core::presentationMathmlCache()",
+                                                                 &instance));
+}
+
+//==============================================================================
+
+MathmlConverter::MathmlConverter() :
+    mXslTransformer(0)
+{
 }
 
 //==============================================================================
 
 MathmlConverter::~MathmlConverter()
 {
-    // Stop our XSL transformer
+    // Stop our XSL transformer, if any
     // Note: we don't need to delete it since it will be done as part of its
     //       thread being stopped...
 
-    mXslTransformer->stop();
+    if (mXslTransformer)
+        mXslTransformer->stop();
 }
 
 //==============================================================================
 
 void MathmlConverter::convert(const QString &pContentMathml)
 {
-    // Convert the given Content MathML to Presentation MathML through an XSL
-    // transformation
+    // Convert the given Content MathML to Presentation MathML, using (in order
+    // of preference) our cache of Presentation MathML equations, our native
+    // converter or an XSL transformation
+    // Note: our cache is not thread-safe, but this is fine since it is only
+    //       ever used from the thread in which our MathML converters live...
+
+    QString *cachedPresentationMathml = presentationMathmlCache()->object(pContentMathml);
+    QString presentationMathml = QString();
+
+    if (cachedPresentationMathml) {
+        // Note: we emit a copy of our cached Presentation MathML since our
+        //       cache may get updated (and therefore our cached Presentation
+        //       MathML deleted) as a result of our signal being handled...
+
+        presentationMathml = *cachedPresentationMathml;
+
+        emit done(pContentMathml, presentationMathml);
+    } else if (convert(pContentMathml, presentationMathml)) {
+        presentationMathmlCache()->insert(pContentMathml, new QString(presentationMathml));
+
+        emit done(pContentMathml, presentationMathml);
+    } else {
+        // Our native converter doesn't support the given Content MathML, so use
+        // an XSL transformation instead, creating our XSL transformer and a
+        // connection to retrieve the result of its XSL transformations, if
+        // needed
+
+        static const QString CtopXsl = resource(":/Core/web-xslt/ctopff.xsl");
+
+        if (!mXslTransformer) {
+            mXslTransformer = new XslTransformer();
+
+            connect(mXslTransformer, SIGNAL(done(const QString &, const QString &)),
+                    this, SLOT(xslTransformationDone(const QString &, const QString &)));
+        }
+
+        mXslTransformer->transform(pContentMathml, CtopXsl);
+    }
+}
+
+//==============================================================================
+
+static bool isWhitespace(const QString &pString)
+{
+    // Return whether the given string only consists of XML whitespace
+    // characters
+    // Note: we can't use QString::trimmed() since it would also consider
+    //       characters like &#160; as whitespace characters...
+
+    foreach (const QChar &character, pString) {
+        if (   (character != ' ') && (character != '\t')
+            && (character != '\n') && (character != '\r')) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//==============================================================================
+
+static double number(const QString &pString)
+{
+    // Return the given string as a number, like the XPath number() function
+    // would do
+
+    bool ok;
+    double res = pString.trimmed().toDouble(&ok);
+
+    return ok?res:qQNaN();
+}
+
+//==============================================================================
+
+static QString numberAsString(const double &pNumber)
+{
+    // Return the given number as a string, like XPath 2.0 would do when
+    // casting an xs:double value to an xs:string value, i.e. using the
+    // shortest representation that can be read back and the decimal notation
+    // for numbers between 1e-6 and 1e6 and the scientific notation otherwise
+
+    if (qIsNaN(pNumber))
+        return "NaN";
+    else if (qIsInf(pNumber))
+        return (pNumber < 0.0)?"-INF":"INF";
+    else if (pNumber == 0.0)
+        return "0";
+
+    double absNumber = qAbs(pNumber);
+    QString mantissaAndExponent = QString();
+
+    for (int precision = 0; precision < 17; ++precision) {
+        mantissaAndExponent = QString::number(absNumber, 'e', precision);
+
+        if (mantissaAndExponent.toDouble() == absNumber)
+            break;
+    }
+
+    int exponentPosition = mantissaAndExponent.indexOf('e');
+    QString digits = mantissaAndExponent.left(exponentPosition).remove('.');
+    int exponent = mantissaAndExponent.mid(exponentPosition+1).toInt();
+    QString res = QString();
+
+    if ((absNumber >= 1e-6) && (absNumber < 1e6)) {
+        if (exponent < 0)
+            res = "0."+QString(-exponent-1, '0')+digits;
+        else if (digits.length() <= exponent+1)
+            res = digits+QString(exponent+1-digits.length(), '0');
+        else
+            res = digits.left(exponent+1)+"."+digits.mid(exponent+1);
+    } else {
+        res = digits.left(1)+"."+((digits.length() == 1)?QString("0"):digits.mid(1))+"E"+QString::number(exponent);
+    }
+
+    return (pNumber < 0.0)?"-"+res:res;
+}
+
+//==============================================================================
+
+static QList<QDomElement> childElements(const QDomElement &pElement)
+{
+    // Return the child elements of the given element
+
+    QList<QDomElement> res = QList<QDomElement>();
+
+    for (QDomElement childElement = pElement.firstChildElement();
+         !childElement.isNull(); childElement = childElement.nextSiblingElement()) {
+        res << childElement;
+    }
+
+    return res;
+}
+
+//==============================================================================
+
+static QString operatorName(const QDomElement &pElement)
+{
+    // Return the name of the first child element of the given element, i.e.
+    // the name of its operator if it is an apply element
+
+    return pElement.firstChildElement().localName();
+}
+
+//==============================================================================
+
+static bool isApply(const QDomElement &pElement,
+                    const QString &pOperatorName = QString())
+{
+    // Return whether the given element is an apply element, optionally using
+    // the given operator
+
+    return    !pElement.localName().compare("apply")
+           && (pOperatorName.isEmpty() || !operatorName(pElement).compare(pOperatorName));
+}
+
+//==============================================================================
+
+static bool isUnaryMinus(const QDomElement &pElement)
+{
+    // Return whether the given element is a unary minus
+
+    return isApply(pElement, "minus") && (childElements(pElement).count() == 2);
+}
+
+//==============================================================================
+
+static bool isNegativeNumber(const QDomElement &pElement)
+{
+    // Return whether the given element is a negative number (with no
+    // separator)
+
+    return    !pElement.localName().compare("cn")
+           &&  pElement.firstChildElement("sep").isNull()
+           && (number(pElement.text()) < 0.0);
+}
+
+//==============================================================================
+
+static bool isMathmlElement(const QDomElement &pElement)
+{
+    // Check that the given element and all of its attributes and descendants
+    // are in the (default) MathML namespace, i.e. that the XSL transformation
+    // would recognise them
 
-    static const QString CtopXsl = resource(":/Core/web-xslt/ctopff.xsl");
+    if (   pElement.namespaceURI().compare(MathmlNamespace)
+        || !pElement.prefix().isEmpty()) {
+        return false;
+    }
 
-    mXslTransformer->transform(pContentMathml, CtopXsl);
+    QDomNamedNodeMap attributes = pElement.attributes();
+
+    for (int i = 0, iMax = attributes.count(); i < iMax; ++i) {
+        if (!attributes.item(i).prefix().isEmpty())
+            return false;
+    }
+
+    for (QDomElement childElement = pElement.firstChildElement();
+         !childElement.isNull(); childElement = childElement.nextSiblingElement()) {
+        if (!isMathmlElement(childElement))
+            return false;
+    }
+
+    return true;
+}
+
+//==============================================================================
+
+static QDomElement newElement(QDomElement &pParentElement,
+                              const QString &pName,
+                              const QString &pText = QString())
+{
+    // Create a new element with the given name and text, and append it to the
+    // given parent element
+
+    QDomDocument domDocument = pParentElement.ownerDocument();
+    QDomElement res = domDocument.createElement(pName);
+
+    if (!isWhitespace(pText))
+        res.appendChild(domDocument.createTextNode(pText));
+
+    pParentElement.appendChild(res);
+
+    return res;
+}
+
+//==============================================================================
+
+static bool convertNode(const QDomElement &pElement,
+                        QDomElement &pParentElement, const int &pPrecedence = 0,
+                        const int &pFirst = 1);
+
+//==============================================================================
+
+static bool convertChildNodes(const QDomElement &pElement,
+                              QDomElement &pParentElement)
+{
+    // Convert the child nodes of the given element, copying the text ones as
+    // is
+
+    for (QDomNode childNode = pElement.firstChild();
+         !childNode.isNull(); childNode = childNode.nextSibling()) {
+        if (childNode.isText()) {
+            QString text = childNode.toText().data();
+
+            if (!isWhitespace(text)) {
+                pParentElement.appendChild(pParentElement.ownerDocument().createTextNode(text));
+            }
+        } else if (   childNode.isElement()
+                   && !convertNode(childNode.toElement(), pParentElement)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//==============================================================================
+
+static bool convertText(const QDomElement &pElement,
+                        QDomElement &pParentElement)
+{
+    // Copy the text of the given element, making sure that it doesn't have any
+    // child elements
+
+    if (!pElement.firstChildElement().isNull())
+        return false;
+
+    QString text = pElement.text();
+
+    if (!isWhitespace(text))
+        pParentElement.appendChild(pParentElement.ownerDocument().createTextNode(text));
+
+    return true;
+}
+
+//==============================================================================
+
+static bool convertInfix(const QDomElement &pElement,
+                         QDomElement &pParentElement, const int &pPrecedence,
+                         const int &pOperatorPrecedence,
+                         const QString &pOperator)
+{
+    // Convert an n-ary operator (e.g. eq, and), bracketing it if its
+    // precedence is lower than the one of its context
+
+    QList<QDomElement> elements = childElements(pElement);
+    QDomElement mrowElement = newElement(pParentElement, "mrow");
+
+    if (pOperatorPrecedence < pPrecedence)
+        newElement(mrowElement, "mo", "(");
+
+    for (int i = 1, iMax = elements.count(); i < iMax; ++i) {
+        if (i > 1)
+            newElement(mrowElement, "mo", pOperator);
+
+        if (!convertNode(elements[i], mrowElement, pOperatorPrecedence))
+            return false;
+    }
+
+    if (pOperatorPrecedence < pPrecedence)
+        newElement(mrowElement, "mo", ")");
+
+    return true;
+}
+
+//==============================================================================
+
+static bool convertBinaryMinus(const QDomElement &pElement,
+                               QDomElement &pParentElement,
+                               const int &pPrecedence)
+{
+    // Convert a binary minus, bracketing it if its precedence is lower than
+    // the one of its context or if it is the right-hand side of another binary
+    // minus (e.g. 1-(9-2))
+
+    static const int MinusPrecedence = 2;
+
+    QList<QDomElement> elements = childElements(pElement);
+    QDomElement parentElement = pElement.parentNode().toElement();
+    QList<QDomElement> parentElements = childElements(parentElement);
+    bool brackets =    (MinusPrecedence < pPrecedence)
+                    || (   (MinusPrecedence == pPrecedence)
+                        && !operatorName(parentElement).compare("minus")
+                        && (   ((parentElements.count() > 1) && pElement.text().compare(parentElements[1].text()))
+                            || (parentElements.count() == 2))
+                        && (elements.count() != 2));
+    QDomElement mrowElement = newElement(pParentElement, "mrow");
+
+    if (brackets)
+        newElement(mrowElement, "mo", "(");
+
+    if (!convertNode(elements[1], mrowElement, MinusPrecedence))
+        return false;
+
+    newElement(mrowElement, "mo", QChar(0x2212));
+
+    if (!convertNode(elements[2], mrowElement, MinusPrecedence))
+        return false;
+
+    if (brackets)
+        newElement(mrowElement, "mo", ")");
+
+    return true;
+}
+
+//==============================================================================
+
+static bool convertPlus(const QDomElement &pElement,
+                        QDomElement &pParentElement, const int &pPrecedence)
+{
+    // Convert a plus, bracketing it if its precedence is lower than the one of
+    // its context or if it is the right-hand side of a binary minus, and
+    // making the most of the negative numbers and unary minuses that it may
+    // have as operands
+
+    QList<QDomElement> elements = childElements(pElement);
+    QDomElement parentElement = pElement.parentNode().toElement();
+    QList<QDomElement> parentElements = childElements(parentElement);
+    bool parentIsMinus = !operatorName(parentElement).compare("minus");
+    bool brackets =    ((pPrecedence > 2) && !parentIsMinus)
+                    || (    parentIsMinus
+                        && (   ((parentElements.count() > 1) && pElement.text().compare(parentElements[1].text()))
+                            || (parentElements.count() == 2))
+                        && (elements.count() != 2));
+    QDomElement mrowElement = newElement(pParentElement, "mrow");
+
+    if (brackets)
+        newElement(mrowElement, "mo", "(");
+
+    for (int i = 1, iMax = elements.count(); i < iMax; ++i) {
+        QDomElement element = elements[i];
+        bool negativeNumber = isNegativeNumber(element);
+        bool unaryMinus = isUnaryMinus(element);
+
+        if (negativeNumber || unaryMinus)
+            newElement(mrowElement, "mo", QChar(0x2212));
+        else if (i > 1)
+            newElement(mrowElement, "mo", "+");
+
+        QList<QDomElement> operandElements = childElements(element);
+
+        if (negativeNumber) {
+            newElement(mrowElement, "mn", numberAsString(-number(element.text())));
+        } else if (unaryMinus) {
+            if (!convertNode(operandElements[1], mrowElement, 2))
+                return false;
+        } else if (   isApply(element, "times") && (operandElements.count() > 1)
+                   && isNegativeNumber(operandElements[1])) {
+            QDomElement timesMrowElement = newElement(mrowElement, "mrow");
+
+            newElement(timesMrowElement, "mn", numberAsString(-number(operandElements[1].text())));
+            newElement(timesMrowElement, "mo", QChar(0x2062));
+
+            if (!convertNode(element, timesMrowElement, 2, 2))
+                return false;
+        } else if (   isApply(element, "times") && (operandElements.count() > 1)
+                   && isApply(operandElements[1], "minus")
+                   && (childElements(operandElements[1]).count() > 3)) {
+            QDomElement timesMrowElement = newElement(mrowElement, "mrow");
+
+            if (   !convertNode(childElements(operandElements[1])[1], timesMrowElement)
+                || !convertNode(element, timesMrowElement, 2, 2)) {
+                return false;
+            }
+        } else if (!convertNode(element, mrowElement, 2)) {
+            return false;
+        }
+    }
+
+    if (brackets)
+        newElement(mrowElement, "mo", ")");
+
+    return true;
+}
+
+//==============================================================================
+
+static bool convertTimes(const QDomElement &pElement,
+                         QDomElement &pParentElement, const int &pPrecedence,
+                         const int &pFirst)
+{
+    // Convert a times, bracketing it if its precedence is lower than the one
+    // of its context, and skipping the operands that come before the given
+    // first one (since they have already been converted by our caller)
+
+    QList<QDomElement> elements = childElements(pElement);
+    bool brackets = (pPrecedence > 3) && operatorName(pElement.parentNode().toElement()).compare("minus");
+    QDomElement mrowElement = newElement(pParentElement, "mrow");
+
+    if (brackets)
+        newElement(mrowElement, "mo", "(");
+
+    for (int i = 1, iMax = elements.count(); i < iMax; ++i) {
+        if (i > 1)
+            newElement(mrowElement, "mo", QChar(0x00B7));
+
+        if ((i >= pFirst) && !convertNode(elements[i], mrowElement, 3))
+            return false;
+    }
+
+    if (brackets)
+        newElement(mrowElement, "mo", ")");
+
+    return true;
+}
+
+//==============================================================================
+
+static bool convertFunction(const QDomElement &pElement,
+                            QDomElement &pParentElement,
+                            const int &pPrecedence, const QString &pName)
+{
+    // Convert a function (e.g. sin, ln, log), bracketing its argument if it is
+    // an expression and bracketing the function itself if needed
+
+    QList<QDomElement> elements = childElements(pElement);
+    bool hasApply = false;
+
+    foreach (const QDomElement &element, elements)
+        hasApply = hasApply || isApply(element);
+
+    bool brackets =    (pPrecedence >= 5) && !hasApply
+                    && operatorName(pElement.parentNode().toElement()).compare("minus");
+    QDomElement mrowElement = newElement(pParentElement, "mrow");
+
+    if (brackets)
+        newElement(mrowElement, "mo", "(");
+
+    if (!pName.compare("log")) {
+        QDomElement logbaseElement = pElement.firstChildElement("logbase");
+
+        if (logbaseElement.isNull() || (number(logbaseElement.text()) == 10.0)) {
+            newElement(mrowElement, "mi", "log");
+        } else {
+            QDomElement msubElement = newElement(mrowElement, "msub");
+
+            newElement(msubElement, "mi", "log");
+
+            QDomElement logbaseMrowElement = newElement(msubElement, "mrow");
+
+            if (!convertChildNodes(logbaseElement, logbaseMrowElement))
+                return false;
+        }
+    } else {
+        newElement(mrowElement, "mi", pName);
+    }
+
+    newElement(mrowElement, "mo", QChar(0x2061));
+
+    if (hasApply)
+        newElement(mrowElement, "mo", "(");
+
+    if (   (elements.count() > 1)
+        && !convertNode(pName.compare("log")?elements[1]:elements.last(), mrowElement)) {
+        return false;
+    }
+
+    if (hasApply)
+        newElement(mrowElement, "mo", ")");
+
+    if (brackets)
+        newElement(mrowElement, "mo", ")");
+
+    return true;
+}
+
+//==============================================================================
+
+static bool convertDiff(const QDomElement &pElement,
+                        QDomElement &pParentElement)
+{
+    // Convert a derivative, using Leibniz's notation
+
+    QList<QDomElement> elements = childElements(pElement);
+    QList<QDomElement> bvarElements = QList<QDomElement>();
+    QList<QDomElement> degreeElements = QList<QDomElement>();
+
+    foreach (const QDomElement &element, elements) {
+        if (!element.localName().compare("bvar")) {
+            bvarElements << element;
+
+            foreach (const QDomElement &bvarElement, childElements(element)) {
+                if (!bvarElement.localName().compare("degree"))
+                    degreeElements << bvarElement;
+            }
+        }
+    }
+
+    if (bvarElements.isEmpty()) {
+        QDomElement msupElement = newElement(pParentElement, "msup");
+        QDomElement mrowElement = newElement(msupElement, "mrow");
+
+        if (!convertNode(elements[1], mrowElement))
+            return false;
+
+        newElement(msupElement, "mo", QChar(0x2032));
+
+        return true;
+    }
+
+    QDomElement mfracElement = newElement(pParentElement, "mfrac");
+    QDomElement numeratorElement = newElement(mfracElement, "mrow");
+    QDomElement denominatorElement = newElement(mfracElement, "mrow");
+
+    if (degreeElements.isEmpty()) {
+        newElement(numeratorElement, "mi", "d").setAttribute("mathvariant", "normal");
+
+        if (!convertNode(elements.last(), numeratorElement))
+            return false;
+
+        newElement(denominatorElement, "mi", "d").setAttribute("mathvariant", "normal");
+
+        foreach (const QDomElement &bvarElement, bvarElements) {
+            if (!convertNode(bvarElement, denominatorElement))
+                return false;
+        }
+    } else {
+        QDomElement numeratorMsupElement = newElement(numeratorElement, "msup");
+
+        newElement(numeratorMsupElement, "mi", "d").setAttribute("mathvariant", "normal");
+
+        foreach (const QDomElement &degreeElement, degreeElements) {
+            if (!convertChildNodes(degreeElement, numeratorMsupElement))
+                return false;
+        }
+
+        if (!convertNode(elements.last(), numeratorElement))
+            return false;
+
+        newElement(denominatorElement, "mi", "d").setAttribute("mathvariant", "normal");
+
+        QDomElement denominatorMsupElement = newElement(denominatorElement, "msup");
+
+        foreach (const QDomElement &bvarElement, bvarElements) {
+            if (!convertChildNodes(bvarElement, denominatorMsupElement))
+                return false;
+        }
+
+        foreach (const QDomElement &degreeElement, degreeElements) {
+            if (!convertChildNodes(degreeElement, denominatorMsupElement))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+//==============================================================================
+
+static bool convertApply(const QDomElement &pElement,
+                         QDomElement &pParentElement, const int &pPrecedence,
+                         const int &pFirst)
+{
+    // Convert an apply element, based on its operator
+
+    static const QStringList Functions = QStringList() << "sin" << "cos" << "tan" << "sec" << "csc" << "cot"
+                                                       << "sinh" << "cosh" << "tanh" << "sech" << "csch" << "coth"
+                                                       << "arcsin" << "arccos" << "arctan" << "arcsec" << "arccsc" << "arccot"
+                                                       << "arcsinh" << "arccosh" << "arctanh" << "arcsech" << "arccsch" << "arccoth"
+                                                       << "ln";
+
+    QList<QDomElement> elements = childElements(pElement);
+
+    if (elements.isEmpty())
+        return false;
+
+    foreach (const QDomElement &element, elements) {
+        if (   !element.localName().compare("condition")
+            || !element.localName().compare("domainofapplication")) {
+            return false;
+        }
+    }
+
+    QString parentOperatorName = operatorName(pElement.parentNode().toElement());
+    QString name = elements.first().localName();
+    int elementsCount = elements.count();
+    QDomElement degreeElement = pElement.firstChildElement("degree");
+
+    if (   (!name.compare("root") && degreeElement.isNull())
+        || (!degreeElement.isNull() && (number(degreeElement.text()) == 2.0))) {
+        QDomElement msqrtElement = newElement(pParentElement, "msqrt");
+
+        for (int i = 1; i < elementsCount; ++i) {
+            if (!convertNode(elements[i], msqrtElement))
+                return false;
+        }
+
+        return true;
+    } else if (!name.compare("root")) {
+        QDomElement mrootElement = newElement(pParentElement, "mroot");
+
+        for (int i = 1; i < elementsCount; ++i) {
+            if (   elements[i].localName().compare("degree")
+                && !convertNode(elements[i], mrootElement)) {
+                return false;
+            }
+        }
+
+        QDomElement mrowElement = newElement(mrootElement, "mrow");
+
+        foreach (const QDomElement &element, childElements(degreeElement)) {
+            if (!convertNode(element, mrowElement))
+                return false;
+        }
+
+        return true;
+    } else if (!name.compare("diff") && (elementsCount > 1)) {
+        return convertDiff(pElement, pParentElement);
+    } else if (!name.compare("eq")) {
+        return convertInfix(pElement, pParentElement, pPrecedence, 1, "=");
+    } else if (!name.compare("neq")) {
+        return convertInfix(pElement, pParentElement, pPrecedence, 1, QChar(0x2260));
+    } else if (!name.compare("gt")) {
+        return convertInfix(pElement, pParentElement, pPrecedence, 1, ">");
+    } else if (!name.compare("lt")) {
+        return convertInfix(pElement, pParentElement, pPrecedence, 1, "<");
+    } else if (!name.compare("geq")) {
+        return convertInfix(pElement, pParentElement, pPrecedence, 1, QChar(0x2265));
+    } else if (!name.compare("leq")) {
+        return convertInfix(pElement, pParentElement, pPrecedence, 1, QChar(0x2264));
+    } else if (!name.compare("and")) {
+        return convertInfix(pElement, pParentElement, pPrecedence, 2, "and");
+    } else if (!name.compare("or")) {
+        return convertInfix(pElement, pParentElement, pPrecedence, 3, "or");
+    } else if (!name.compare("xor")) {
+        return convertInfix(pElement, pParentElement, pPrecedence, 3, "xor");
+    } else if (!name.compare("minus") && (elementsCount == 2)) {
+        QDomElement mrowElement = newElement(pParentElement, "mrow");
+
+        if (pPrecedence >= 5)
+            newElement(mrowElement, "mo", "(");
+
+        newElement(mrowElement, "mo", QChar(0x2212));
+
+        if (!convertNode(elements[1], mrowElement, 5))
+            return false;
+
+        if (pPrecedence >= 5)
+            newElement(mrowElement, "mo", ")");
+
+        return true;
+    } else if (!name.compare("minus") && (elementsCount == 3)) {
+        return convertBinaryMinus(pElement, pParentElement, pPrecedence);
+    } else if (!name.compare("plus")) {
+        return convertPlus(pElement, pParentElement, pPrecedence);
+    } else if (!name.compare("times")) {
+        return convertTimes(pElement, pParentElement, pPrecedence, pFirst);
+    } else if (!name.compare("divide")) {
+        QDomElement parentElement = pParentElement;
+
+        if ((pPrecedence >= 5) && !parentOperatorName.compare("power")) {
+            parentElement = newElement(pParentElement, "mrow");
+
+            newElement(parentElement, "mo", "(");
+        }
+
+        QDomElement mfracElement = newElement(parentElement, "mfrac");
+
+        for (int i = 1; i < elementsCount; ++i) {
+            if (!convertNode(elements[i], mfracElement))
+                return false;
+        }
+
+        if ((pPrecedence >= 5) && !parentOperatorName.compare("power"))
+            newElement(parentElement, "mo", ")");
+
+        return true;
+    } else if (!name.compare("power") && (elementsCount == 3)) {
+        bool brackets = !parentOperatorName.compare("power") && isApply(elements[2]);
+        QDomElement parentElement = pParentElement;
+
+        if (brackets) {
+            parentElement = newElement(pParentElement, "mrow");
+
+            newElement(parentElement, "mo", "(");
+        }
+
+        QDomElement msupElement = newElement(parentElement, "msup");
+
+        if (   !convertNode(elements[1], msupElement, 5)
+            || !convertNode(elements[2], msupElement)) {
+            return false;
+        }
+
+        if (brackets)
+            newElement(parentElement, "mo", ")");
+
+        return true;
+    } else if (   !name.compare("rem")
+               || !name.compare("min") || !name.compare("max")
+               || !name.compare("gcd") || !name.compare("lcm")) {
+        QDomElement mrowElement = newElement(pParentElement, "mrow");
+
+        newElement(mrowElement, "mi", name);
+
+        QDomElement argumentsMrowElement = newElement(mrowElement, "mrow");
+
+        newElement(argumentsMrowElement, "mo", "(");
+
+        for (int i = 1; i < elementsCount; ++i) {
+            if (i > 1)
+                newElement(argumentsMrowElement, "mo", ",");
+
+            if (!convertNode(elements[i], argumentsMrowElement))
+                return false;
+        }
+
+        newElement(argumentsMrowElement, "mo", ")");
+
+        return true;
+    } else if (   (   !name.compare("abs")
+                   || !name.compare("floor")
+                   || !name.compare("ceiling"))
+               && (elementsCount == 2)) {
+        QDomElement mrowElement = newElement(pParentElement, "mrow");
+
+        newElement(mrowElement, "mo", !name.compare("abs")?
+                                          QString("|"):
+                                          !name.compare("floor")?
+                                              QString(QChar(0x230A)):
+                                              QString(QChar(0x2308)));
+
+        if (!convertNode(elements[1], mrowElement))
+            return false;
+
+        newElement(mrowElement, "mo", !name.compare("abs")?
+                                          QString("|"):
+                                          !name.compare("floor")?
+                                              QString(QChar(0x230B)):
+                                              QString(QChar(0x2309)));
+
+        return true;
+    } else if (!name.compare("factorial") && (elementsCount == 2)) {
+        QDomElement mrowElement = newElement(pParentElement, "mrow");
+
+        if (!convertNode(elements[1], mrowElement, 7))
+            return false;
+
+        newElement(mrowElement, "mo", "!");
+
+        return true;
+    } else if (!name.compare("not") && (elementsCount == 2)) {
+        QDomElement mrowElement = newElement(pParentElement, "mrow");
+
+        newElement(mrowElement, "mo", "not");
+
+        return convertNode(elements[1], mrowElement, 7);
+    } else if (!name.compare("exp") && (elementsCount == 2)) {
+        bool brackets = !parentOperatorName.compare("power") && isApply(elements[1]);
+        QDomElement parentElement = pParentElement;
+
+        if (brackets) {
+            parentElement = newElement(pParentElement, "mrow");
+
+            newElement(parentElement, "mo", "(");
+        }
+
+        QDomElement msupElement = newElement(parentElement, "msup");
+
+        newElement(msupElement, "mi", "e");
+
+        QDomElement mrowElement = newElement(msupElement, "mrow");
+
+        if (!convertNode(elements[1], mrowElement))
+            return false;
+
+        if (brackets)
+            newElement(parentElement, "mo", ")");
+
+        return true;
+    } else if (   (!name.compare("log") && (elementsCount > 1))
+               || Functions.contains(name)) {
+        return convertFunction(pElement, pParentElement, pPrecedence, name);
+    }
+
+    return false;
+}
+
+//==============================================================================
+
+static bool convertPiecewise(const QDomElement &pElement,
+                             QDomElement &pParentElement)
+{
+    // Convert a piecewise element, using a table
+
+    QDomElement mrowElement = newElement(pParentElement, "mrow");
+
+    newElement(mrowElement, "mo", "{");
+
+    QDomElement mtableElement = newElement(mrowElement, "mtable");
+
+    foreach (const QDomElement &element, childElements(pElement)) {
+        bool piece = !element.localName().compare("piece");
+
+        if (!piece && element.localName().compare("otherwise"))
+            continue;
+
+        QList<QDomElement> pieceElements = childElements(element);
+        QDomElement mtrElement = newElement(mtableElement, "mtr");
+        QDomElement mtdElement = newElement(mtrElement, "mtd");
+
+        if (!pieceElements.isEmpty() && !convertNode(pieceElements[0], mtdElement))
+            return false;
+
+        if (piece) {
+            QDomElement ifMtdElement = newElement(mtrElement, "mtd");
+
+            ifMtdElement.setAttribute("columnalign", "left");
+
+            newElement(ifMtdElement, "mtext", QString(QChar(0x00A0))+" if "+QChar(0x00A0));
+
+            mtdElement = newElement(mtrElement, "mtd");
+
+            if ((pieceElements.count() > 1) && !convertNode(pieceElements[1], mtdElement))
+                return false;
+        } else {
+            QDomElement otherwiseMtdElement = newElement(mtrElement, "mtd");
+
+            otherwiseMtdElement.setAttribute("columnspan", "2");
+            otherwiseMtdElement.setAttribute("columnalign", "left");
+
+            newElement(otherwiseMtdElement, "mtext", QString(QChar(0x00A0))+" otherwise");
+        }
+    }
+
+    return true;
+}
+
+//==============================================================================
+
+static bool convertCn(const QDomElement &pElement,
+                      QDomElement &pParentElement)
+{
+    // Convert a cn element, based on its type
+
+    QString type = pElement.attribute("type");
+
+    if (type.isEmpty() || !type.compare("integer")) {
+        if (   !pElement.hasAttribute("base")
+            || (number(pElement.attribute("base")) == 10.0)) {
+            QDomElement mnElement = newElement(pParentElement, "mn");
+
+            return convertText(pElement, mnElement);
+        } else {
+            QDomElement msubElement = newElement(pParentElement, "msub");
+            QDomElement mnElement = newElement(msubElement, "mn");
+
+            newElement(msubElement, "mn", pElement.attribute("base"));
+
+            return convertText(pElement, mnElement);
+        }
+    } else if (!type.compare("e-notation") || !type.compare("rational")) {
+        // Note: both an e-notation and a rational number consist of two parts
+        //       that are separated by a sep element...
+
+        QList<QDomElement> elements = childElements(pElement);
+
+        if ((elements.count() != 1) || elements[0].localName().compare("sep"))
+            return false;
+
+        QString firstPart = QString();
+        QString secondPart = QString();
+        bool beforeSep = true;
+
+        for (QDomNode childNode = pElement.firstChild();
+             !childNode.isNull(); childNode = childNode.nextSibling()) {
+            if (childNode.isElement())
+                beforeSep = false;
+            else if (childNode.isText() && beforeSep)
+                firstPart += childNode.toText().data();
+            else if (childNode.isText())
+                secondPart += childNode.toText().data();
+        }
+
+        QDomElement mrowElement = newElement(pParentElement, "mrow");
+
+        newElement(mrowElement, "mn", firstPart);
+
+        if (!type.compare("e-notation")) {
+            newElement(mrowElement, "mo", QChar(0x00B7));
+
+            QDomElement msupElement = newElement(mrowElement, "msup");
+
+            newElement(msupElement, "mn", "10");
+            newElement(msupElement, "mn", secondPart);
+        } else {
+            newElement(mrowElement, "mo", "/");
+            newElement(mrowElement, "mn", secondPart);
+        }
+
+        return true;
+    } else if (   !type.compare("complex-cartesian")
+               || !type.compare("complex-polar")
+               || !type.compare("hexdouble")) {
+        return false;
+    } else {
+        QDomElement mnElement = newElement(pParentElement, "mn");
+
+        return convertText(pElement, mnElement);
+    }
+}
+
+//==============================================================================
+
+static bool convertNode(const QDomElement &pElement,
+                        QDomElement &pParentElement, const int &pPrecedence,
+                        const int &pFirst)
+{
+    // Convert the given element, using the given precedence of its context to
+    // determine whether it needs to be bracketed
+
+    QString name = pElement.localName();
+
+    if (!name.compare("apply")) {
+        return convertApply(pElement, pParentElement, pPrecedence, pFirst);
+    } else if (!name.compare("ci")) {
+        if (!pElement.firstChildElement().isNull())
+            return false;
+
+        for (QDomNode childNode = pElement.firstChild();
+             !childNode.isNull(); childNode = childNode.nextSibling()) {
+            if (childNode.isText())
+                newElement(pParentElement, "mi", childNode.toText().data()).setAttribute("mathvariant", "italic");
+        }
+
+        return true;
+    } else if (!name.compare("cn")) {
+        return convertCn(pElement, pParentElement);
+    } else if (!name.compare("bvar")) {
+        if (!convertChildNodes(pElement, pParentElement))
+            return false;
+
+        for (QDomElement siblingElement = pElement.nextSiblingElement();
+             !siblingElement.isNull(); siblingElement = siblingElement.nextSiblingElement()) {
+            if (!siblingElement.localName().compare("bvar")) {
+                newElement(pParentElement, "mo", ",");
+
+                break;
+            }
+        }
+
+        return true;
+    } else if (!name.compare("degree")) {
+        return true;
+    } else if (!name.compare("piecewise")) {
+        return convertPiecewise(pElement, pParentElement);
+    } else if (!name.compare("exponentiale")) {
+        newElement(pParentElement, "mi", "e");
+    } else if (!name.compare("imaginaryi")) {
+        newElement(pParentElement, "mi", "i");
+    } else if (!name.compare("notanumber")) {
+        newElement(pParentElement, "mi", "NaN");
+    } else if (!name.compare("true") || !name.compare("false")) {
+        newElement(pParentElement, "mi", name);
+    } else if (!name.compare("emptyset")) {
+        newElement(pParentElement, "mi", QChar(0x2205));
+    } else if (!name.compare("pi")) {
+        newElement(pParentElement, "mi", QChar(0x03C0));
+    } else if (!name.compare("eulergamma")) {
+        newElement(pParentElement, "mi", QChar(0x03B3));
+    } else if (!name.compare("infinity")) {
+        newElement(pParentElement, "mi", QChar(0x221E));
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+//==============================================================================
+
+bool MathmlConverter::convert(const QString &pContentMathml,
+                              QString &pPresentationMathml)
+{
+    // Natively convert the given Content MathML to Presentation MathML, making
+    // sure that we get the same result as with ctopff.xsl
+    // Note #1: we only support the subset of Content MathML that is used by
+    //          CellML, so we return false for anything else, in which case our
+    //          caller should fall back on an XSL transformation...
+    // Note #2: we need to keep whitespace-only text nodes since ctopff.xsl
+    //          compares the string value of some elements to determine whether
+    //          some brackets are needed...
+
+    QXmlInputSource xmlInputSource;
+    QXmlSimpleReader xmlSimpleReader;
+    QDomDocument contentDomDocument;
+
+    xmlInputSource.setData(pContentMathml);
+
+    xmlSimpleReader.setFeature("http://xml.org/sax/features/namespaces", true);
+    xmlSimpleReader.setFeature("http://xml.org/sax/features/namespace-prefixes", false);
+    xmlSimpleReader.setFeature("http://qt-project.org/xml/features/report-whitespace-only-CharData", true);
+
+    if (!contentDomDocument.setContent(&xmlInputSource, &xmlSimpleReader))
+        return false;
+
+    QDomElement contentMathElement = contentDomDocument.documentElement();
+
+    if (   contentMathElement.localName().compare("math")
+        || !isMathmlElement(contentMathElement)) {
+        return false;
+    }
+
+    // Create our Presentation MathML document, which root element is a copy of
+    // our Content MathML one
+
+    QDomDocument presentationDomDocument;
+    QDomElement presentationMathElement = presentationDomDocument.createElement("math");
+    QDomNamedNodeMap attributes = contentMathElement.attributes();
+
+    presentationMathElement.setAttribute("xmlns", MathmlNamespace);
+
+    for (int i = 0, iMax = attributes.count(); i < iMax; ++i) {
+        QDomAttr attribute = attributes.item(i).toAttr();
+
+        presentationMathElement.setAttribute(attribute.name(), attribute.value());
+    }
+
+    presentationDomDocument.appendChild(presentationMathElement);
+
+    // Convert our Content MathML equations
+
+    for (QDomNode childNode = contentMathElement.firstChild();
+         !childNode.isNull(); childNode = childNode.nextSibling()) {
+        if (childNode.isElement()) {
+            if (!convertNode(childNode.toElement(), presentationMathElement))
+                return false;
+        } else if (childNode.isText() && !isWhitespace(childNode.toText().data())) {
+            return false;
+        }
+    }
+
+    // Clean up and return our Presentation MathML
+
+    cleanPresentationMathml(presentationMathElement);
+
+    pPresentationMathml = presentationDomDocument.toString(-1);
+
+    return true;
 }
 
 //==============================================================================
@@ -71,9 +1175,14 @@ void MathmlConverter::xslTransformationDone(const QString &pInput,
                                             const QString &pOutput)
 {
     // Let people know that our MathML conversion has been performed (after
-    // having cleaned up its output)
+    // having cleaned up its output and cached it)
+
+    QString presentationMathml = cleanPresentationMathml(pOutput);
+
+    if (!presentationMathml.isEmpty())
+        presentationMathmlCache()->insert(pInput, new QString(presentationMathml));
 
-    emit done(pInput, cleanPresentationMathml(pOutput));
+    emit done(pInput, presentationMathml);
 }
 
 //==============================================================================
@@ -52,6 +52,9 @@ public:
 
     void convert(const QString &pContentMathml);
 
+    static bool convert(const QString &pContentMathml,
+                        QString &pPresentationMathml);
+
 private:
     XslTransformer *mXslTransformer;
 
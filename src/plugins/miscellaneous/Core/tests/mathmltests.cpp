@@ -25,6 +25,7 @@ limitations under the License.
 //==============================================================================
 
 #include "corecliutils.h"
+#include "mathmlconverter.h"
 #include "mathmltests.h"
 
 //==============================================================================
@@ -78,11 +79,14 @@ void MathmlTests::initTestCase()
 
 void MathmlTests::tests(const QString &pCategory)
 {
-    // Convert some Content MathML to Presentation MathML
+    // Convert some Content MathML to Presentation MathML, both through an XSL
+    // transformation and natively, making sure that we get the expected output
+    // in both cases
 
     QString dirName = OpenCOR::dirName("src/plugins/miscellaneous/Core/tests/data")+QDir::separator()+pCategory+QDir::separator();
     QXmlQuery xmlQuery(QXmlQuery::XSLT20);
     DummyMessageHandler dummyMessageHandler;
+    QString input;
     QString actualOutput;
     QString expectedOutput;
     QString failMessage = QString();
@@ -90,18 +94,20 @@ void MathmlTests::tests(const QString &pCategory)
     xmlQuery.setMessageHandler(&dummyMessageHandler);
 
     foreach (const QString &fileName, QDir(dirName).entryList(QStringList() << "*.in")) {
-        xmlQuery.setFocus(OpenCOR::rawFileContents(dirName+fileName));
+        input = OpenCOR::rawFileContents(dirName+fileName);
+        expectedOutput = OpenCOR::rawFileContents(QString(dirName+fileName).replace(".in", ".out"));
+
+        xmlQuery.setFocus(input);
         xmlQuery.setQuery(OpenCOR::rawFileContents(":/Core/web-xslt/ctopff.xsl"));
 
         if (xmlQuery.evaluateTo(&actualOutput)) {
             actualOutput = OpenCOR::Core::formatXml(OpenCOR::Core::cleanPresentationMathml(actualOutput));
-            expectedOutput = OpenCOR::rawFileContents(QString(dirName+fileName).replace(".in", ".out"));
 
             if (actualOutput.compare(expectedOutput)) {
                 if (!failMessage.isEmpty())
                     failMessage += QString("\nFAIL!  : MathmlTests::%1Tests() ").arg(pCategory);
 
-                failMessage += QString("Failed to convert '%1/%2'\n%3\n%4\n%5").arg(pCategory, fileName, OpenCOR::rawFileContents(dirName+fileName), actualOutput, expectedOutput);
+                failMessage += QString("Failed to convert '%1/%2'\n%3\n%4\n%5").arg(pCategory, fileName, input, actualOutput, expectedOutput);
             }
         } else {
             if (!failMessage.isEmpty())
@@ -109,6 +115,22 @@ void MathmlTests::tests(const QString &pCategory)
 
             failMessage += QString("Could not convert '%1/%2'").arg(pCategory, fileName);
         }
+
+        if (OpenCOR::Core::MathmlConverter::convert(input, actualOutput)) {
+            actualOutput = OpenCOR::Core::formatXml(actualOutput);
+
+            if (actualOutput.compare(expectedOutput)) {
+                if (!failMessage.isEmpty())
+                    failMessage += QString("\nFAIL!  : MathmlTests::%1Tests() ").arg(pCategory);
+
+                failMessage += QString("Failed to natively convert '%1/%2'\n%3\n%4\n%5").arg(pCategory, fileName, input, actualOutput, expectedOutput);
+            }
+        } else {
+            if (!failMessage.isEmpty())
+                failMessage += QString("\nFAIL!  : MathmlTests::%1Tests() ").arg(pCategory);
+
+            failMessage += QString("Could not natively convert '%1/%2'").arg(pCategory, fileName);
+        }
     }
 
     if (!failMessage.isEmpty())
@@ -288,6 +310,60 @@ void MathmlTests::trigonometricTests()
 
 //==============================================================================
 
+void MathmlTests::diffTests()
+{
+    // Run some tests for our diff category
+
+    tests("diff");
+}
+
+//==============================================================================
+
+void MathmlTests::piecewiseTests()
+{
+    // Run some tests for our piecewise category
+
+    tests("piecewise");
+}
+
+//==============================================================================
+
+void MathmlTests::relationalTests()
+{
+    // Run some tests for our relational category
+
+    tests("relational");
+}
+
+//==============================================================================
+
+void MathmlTests::logicalTests()
+{
+    // Run some tests for our logical category
+
+    tests("logical");
+}
+
+//==============================================================================
+
+void MathmlTests::constantsTests()
+{
+    // Run some tests for our constants category
+
+    tests("constants");
+}
+
+//==============================================================================
+
+void MathmlTests::cnTests()
+{
+    // Run some tests for our cn category
+
+    tests("cn");
+}
+
+//==============================================================================
+
 QTEST_GUILESS_MAIN(MathmlTests)
 
 //==============================================================================
@@ -80,6 +80,16 @@ private slots:
     void lcmTests();
 
     void trigonometricTests();
+
+    void diffTests();
+
+    void piecewiseTests();
+
+    void relationalTests();
+    void logicalTests();
+
+    void constantsTests();
+    void cnTests();
 };
 
 //==============================================================================
@@ -364,24 +364,24 @@ void Plugin::setLoad(const QString &pName, const bool &pToBeLoaded)
 
 //==============================================================================
 
-QStringList Plugin::fullDependencies(const QString &pPluginsDir,
+QStringList Plugin::fullDependencies(const QMap<QString, PluginInfo *> &pPluginsInfo,
                                      const QString &pName, const int &pLevel)
 {
     // Return the given plugin's full dependencies
+    // Note: we rely on the given plugins information rather than on
+    //       Plugin::info() since the latter requires loading the plugin...
 
     QStringList res = QStringList();
 
     // Recursively look for the plugin's full dependencies
 
-    PluginInfo *pluginInfo = Plugin::info(Plugin::fileName(pPluginsDir, pName));
+    PluginInfo *pluginInfo = pPluginsInfo.value(pName);
 
     if (!pluginInfo)
         return res;
 
     foreach (const QString &plugin, pluginInfo->dependencies())
-        res << fullDependencies(pPluginsDir, plugin, pLevel+1);
-
-    delete pluginInfo;
+        res << fullDependencies(pPluginsInfo, plugin, pLevel+1);
 
     // Add the current plugin to the list, but only if it is not the original
     // plugin, otherwise remove any duplicates
@@ -25,6 +25,7 @@ limitations under the License.
 //==============================================================================
 
 #include <QList>
+#include <QMap>
 #include <QObject>
 #include <QString>
 #include <QStringList>
@@ -107,7 +108,7 @@ public:
     static bool load(const QString &pName);
     static void setLoad(const QString &pName, const bool &pToBeLoaded);
 
-    static QStringList fullDependencies(const QString &pPluginsDir,
+    static QStringList fullDependencies(const QMap<QString, PluginInfo *> &pPluginsInfo,
                                         const QString &pName,
                                         const int &pLevel = 0);
 
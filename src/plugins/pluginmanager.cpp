@@ -31,7 +31,13 @@ limitations under the License.
 //==============================================================================
 
 #include <QCoreApplication>
+#include <QDataStream>
+#include <QDateTime>
 #include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
 
 //==============================================================================
 
@@ -39,6 +45,120 @@ namespace OpenCOR {
 
 //==============================================================================
 
+static const auto PluginsManifestVersion = QStringLiteral("1");
+
+//==============================================================================
+
+struct PluginManifestEntry
+{
+    qint64 size;
+    qint64 lastModified;
+
+    QString category;
+
+    bool selectable;
+    bool cliSupport;
+
+    QStringList dependencies;
+
+    Descriptions descriptions;
+
+    QStringList loadBefore;
+};
+
+//==============================================================================
+
+typedef QMap<QString, PluginManifestEntry> PluginsManifest;
+
+//==============================================================================
+
+static QString pluginsManifestFileName()
+{
+    // Return the name of the file that holds (or would hold) our plugins
+    // manifest
+
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation)+QDir::separator()+"Plugins.manifest";
+}
+
+//==============================================================================
+
+static PluginsManifest pluginsManifest(const QString &pPluginsDir)
+{
+    // Retrieve our plugins manifest, but only if it was created by a compatible
+    // version of OpenCOR and for the given plugins directory
+
+    PluginsManifest res = PluginsManifest();
+    QFile file(pluginsManifestFileName());
+
+    if (!file.open(QIODevice::ReadOnly))
+        return res;
+
+    QDataStream stream(&file);
+    QString pluginsManifestVersion;
+    QString pluginsDir;
+    int pluginsCount;
+
+    stream >> pluginsManifestVersion >> pluginsDir >> pluginsCount;
+
+    if (   (stream.status() != QDataStream::Ok)
+        || pluginsManifestVersion.compare(PluginsManifestVersion)
+        || pluginsDir.compare(pPluginsDir)) {
+        return res;
+    }
+
+    for (int i = 0; i < pluginsCount; ++i) {
+        QString fileName;
+        PluginManifestEntry entry;
+
+        stream >> fileName >> entry.size >> entry.lastModified
+               >> entry.category >> entry.selectable >> entry.cliSupport
+               >> entry.dependencies >> entry.descriptions >> entry.loadBefore;
+
+        if (stream.status() != QDataStream::Ok)
+            return PluginsManifest();
+
+        res.insert(fileName, entry);
+    }
+
+    return res;
+}
+
+//==============================================================================
+
+static void setPluginsManifest(const QString &pPluginsDir,
+                               const PluginsManifest &pPluginsManifest)
+{
+    // Keep track of our plugins manifest
+    // Note: we use a QSaveFile object so that our plugins manifest is either
+    //       fully stored or not at all...
+
+    QString fileName = pluginsManifestFileName();
+
+    if (!QDir().mkpath(QFileInfo(fileName).absolutePath()))
+        return;
+
+    QSaveFile file(fileName);
+
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+
+    QDataStream stream(&file);
+
+    stream << PluginsManifestVersion << pPluginsDir << pPluginsManifest.count();
+
+    foreach (const QString &pluginFileName, pPluginsManifest.keys()) {
+        PluginManifestEntry entry = pPluginsManifest.value(pluginFileName);
+
+        stream << pluginFileName << entry.size << entry.lastModified
+               << entry.category << entry.selectable << entry.cliSupport
+               << entry.dependencies << entry.descriptions << entry.loadBefore;
+    }
+
+    file.commit();
+}
+
+//==============================================================================
+
 PluginManager::PluginManager(const bool &pGuiMode) :
     mPlugins(Plugins()),
     mLoadedPlugins(Plugins()),
@@ -64,25 +184,90 @@ PluginManager::PluginManager(const bool &pGuiMode) :
 #endif
 
     // Retrieve and initialise some information about the plugins
-
+    // Note: retrieving a plugin's information normally requires loading the
+    //       plugin, which is expensive (especially for plugins that rely on big
+    //       libraries, e.g. LLVM) and pointless for plugins that are not going
+    //       to be loaded. So, we keep track of the information of our plugins
+    //       in a manifest, which we only update for the plugins that are not
+    //       listed in it or that have changed (based on their size and last
+    //       modified time) since it was last updated...
+
+    PluginsManifest oldPluginsManifest = pluginsManifest(mPluginsDir);
+    PluginsManifest newPluginsManifest = PluginsManifest();
     QMap<QString, PluginInfo *> pluginsInfo = QMap<QString, PluginInfo *>();
     QMap<QString, QString> pluginsError = QMap<QString, QString>();
+    bool pluginsManifestChanged = false;
 
     foreach (const QString &fileName, fileNames) {
-        QString pluginError;
-        PluginInfo *pluginInfo = Plugin::info(fileName, &pluginError);
+        QFileInfo fileInfo = QFileInfo(fileName);
+        qint64 fileSize = fileInfo.size();
+        qint64 fileLastModified = fileInfo.lastModified().toMSecsSinceEpoch();
+        QString pluginName = Plugin::name(fileName);
+        QString pluginError = QString();
+        PluginInfo *pluginInfo;
         // Note: if there is some plugin information, then it will get owned by
         //       the plugin itself. So, it's the plugin's responsibility to
         //       delete it (see Plugin::~Plugin())...
-        QString pluginName = Plugin::name(fileName);
+
+        PluginsManifest::const_iterator iter = oldPluginsManifest.constFind(fileName);
+
+        if (   (iter != oldPluginsManifest.constEnd())
+            && (iter.value().size == fileSize)
+            && (iter.value().lastModified == fileLastModified)) {
+            PluginManifestEntry entry = iter.value();
+
+            pluginInfo = new PluginInfo(entry.category, entry.selectable,
+                                        entry.cliSupport, entry.dependencies,
+                                        entry.descriptions, entry.loadBefore);
+
+            newPluginsManifest.insert(fileName, entry);
+        } else {
+            pluginInfo = Plugin::info(fileName, &pluginError);
+
+            // Keep track of the plugin's information in our manifest, if
+            // possible
+            // Note: we don't keep track of a failure to retrieve a plugin's
+            //       information since it may be due to one of its external
+            //       dependencies being missing, something that might get
+            //       fixed without the plugin itself changing...
+
+            if (pluginInfo) {
+                PluginManifestEntry entry;
+
+                entry.size = fileSize;
+                entry.lastModified = fileLastModified;
+                entry.category = pluginInfo->category();
+                entry.selectable = pluginInfo->isSelectable();
+                entry.cliSupport = pluginInfo->hasCliSupport();
+                entry.dependencies = pluginInfo->dependencies();
+                entry.descriptions = pluginInfo->descriptions();
+                entry.loadBefore = pluginInfo->loadBefore();
+
+                newPluginsManifest.insert(fileName, entry);
+
+                pluginsManifestChanged = true;
+            }
+        }
 
         pluginsInfo.insert(pluginName, pluginInfo);
         pluginsError.insert(pluginName, pluginError);
+    }
+
+    // Update our plugins manifest, if needed (i.e. if some plugins have been
+    // added, changed or removed)
 
-        // Keep track of the plugin's full dependencies, if possible
+    if (   pluginsManifestChanged
+        || (newPluginsManifest.count() != oldPluginsManifest.count())) {
+        setPluginsManifest(mPluginsDir, newPluginsManifest);
+    }
+
+    // Keep track of the plugins' full dependencies, if possible
+
+    foreach (const QString &pluginName, pluginsInfo.keys()) {
+        PluginInfo *pluginInfo = pluginsInfo.value(pluginName);
 
         if (pluginInfo)
-            pluginInfo->setFullDependencies(Plugin::fullDependencies(mPluginsDir, pluginName));
+            pluginInfo->setFullDependencies(Plugin::fullDependencies(pluginsInfo, pluginName));
     }
 
     // Determine in which order the plugins files should be analysed (i.e. take
@@ -120,10 +305,12 @@ PluginManager::PluginManager(const bool &pGuiMode) :
         if (pluginInfo) {
             // Keep track of the plugin itself, should it be selectable and
             // requested by the user (if we are in GUI mode) or have CLI support
-            // (if we are in CLI mode)
+            // or be a solver (if we are in CLI mode)
+            // Note: solvers are needed by CLI plugins that run simulations...
 
             if (   ( pGuiMode && pluginInfo->isSelectable() && Plugin::load(pluginName))
-                || (!pGuiMode && pluginInfo->hasCliSupport())) {
+                || (!pGuiMode && (   pluginInfo->hasCliSupport()
+                                  || !pluginInfo->category().compare(SolverCategory)))) {
                 // Keep track of the plugin's dependencies
 
                 neededPlugins << pluginsInfo.value(pluginName)->fullDependencies();
@@ -0,0 +1,1041 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Single Cell view CLI simulation
+//==============================================================================
+
+#include "cellmlfilemanager.h"
+#include "cellmlfileruntime.h"
+#include "combinefilemanager.h"
+#include "corecliutils.h"
+#include "filemanager.h"
+#include "sedmlfilemanager.h"
+#include "singlecellviewclisimulation.h"
+#include "singlecellviewsimulation.h"
+#include "singlecellviewsimulationensemble.h"
+
+//==============================================================================
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QIODevice>
+#include <QMap>
+#include <QRegularExpression>
+
+//==============================================================================
+
+#include "sedmlapidisablewarnings.h"
+    #include "sedml/SedAlgorithm.h"
+    #include "sedml/SedDocument.h"
+    #include "sedml/SedOneStep.h"
+    #include "sedml/SedSimulation.h"
+    #include "sedml/SedUniformTimeCourse.h"
+#include "sedmlapienablewarnings.h"
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace SingleCellView {
+
+//==============================================================================
+
+SingleCellViewCliSimulation::SingleCellViewCliSimulation(const QString &pFileName,
+                                                         const QString &pUrl,
+                                                         const SolverInterfaces &pSolverInterfaces) :
+    mFileName(pFileName),
+    mUrl(pUrl),
+    mSolverInterfaces(pSolverInterfaces),
+    mCellmlFile(0),
+    mSedmlFile(0),
+    mCombineArchive(0),
+    mManagedFileNames(QStringList()),
+    mTemporaryFileNames(QStringList()),
+    mSimulation(0),
+    mError(false),
+    mErrorMessage(QString())
+{
+}
+
+//==============================================================================
+
+SingleCellViewCliSimulation::~SingleCellViewCliSimulation()
+{
+    // Delete some internal objects
+    // Note: our simulation must be deleted before our CellML file since it
+    //       uses the latter's runtime...
+
+    delete mSimulation;
+
+    delete mCellmlFile;
+    delete mSedmlFile;
+    delete mCombineArchive;
+
+    // Unmanage the files we managed and delete the temporary files we created
+
+    Core::FileManager *fileManagerInstance = Core::FileManager::instance();
+
+    foreach (const QString &managedFileName, mManagedFileNames)
+        fileManagerInstance->unmanage(managedFileName);
+
+    foreach (const QString &temporaryFileName, mTemporaryFileNames)
+        QFile::remove(temporaryFileName);
+}
+
+//==============================================================================
+
+bool SingleCellViewCliSimulation::manageFile(const QString &pFileName,
+                                             const QString &pUrl,
+                                             QString &pErrorMessage)
+{
+    // Ask our file manager to manage the given file (so that, for example,
+    // CellML 1.1 files can be properly instantiated) and keep track of it, so
+    // that we can unmanage it later on
+
+    if (Core::FileManager::instance()->manage(pFileName,
+                                              pUrl.isEmpty()?
+                                                  Core::File::Local:
+                                                  Core::File::Remote,
+                                              pUrl) != Core::FileManager::Added) {
+        pErrorMessage = "The file could not be managed.";
+
+        return false;
+    }
+
+    mManagedFileNames << pFileName;
+
+    return true;
+}
+
+//==============================================================================
+
+bool SingleCellViewCliSimulation::retrieveSedmlFile(QString &pErrorMessage)
+{
+    // Load and make sure that our COMBINE archive is valid
+
+    if (!mCombineArchive->load() || !mCombineArchive->isValid()) {
+        COMBINESupport::CombineArchiveIssues issues = mCombineArchive->issues();
+
+        pErrorMessage = "The COMBINE archive could not be loaded";
+
+        if (issues.count())
+            pErrorMessage += " ("+Core::formatMessage(issues.first().message())+")";
+
+        pErrorMessage += ".";
+
+        return false;
+    }
+
+    // Make sure that there is only one master file in our COMBINE archive
+
+    if (mCombineArchive->masterFiles().count() != 1) {
+        pErrorMessage = "Only COMBINE archives with one master file are supported.";
+
+        return false;
+    }
+
+    // Create a SED-ML file object for our COMBINE archive's master file
+
+    mSedmlFile = new SEDMLSupport::SedmlFile(mCombineArchive->masterFiles().first().fileName());
+
+    return true;
+}
+
+//==============================================================================
+
+bool SingleCellViewCliSimulation::retrieveCellmlFile(QString &pErrorMessage)
+{
+    // Load our SED-ML file and make sure that it references one CellML file
+
+    if (!mSedmlFile->load()) {
+        pErrorMessage = "The SED-ML file could not be loaded.";
+
+        return false;
+    }
+
+    libsedml::SedDocument *sedmlDocument = mSedmlFile->sedmlDocument();
+
+    if (sedmlDocument->getNumModels() != 1) {
+        pErrorMessage = "Only SED-ML files with one model are supported.";
+
+        return false;
+    }
+
+    libsedml::SedModel *model = sedmlDocument->getModel(0);
+    QString language = QString::fromStdString(model->getLanguage());
+
+    if (   language.compare(SEDMLSupport::Language::Cellml)
+        && language.compare(SEDMLSupport::Language::Cellml_1_0)
+        && language.compare(SEDMLSupport::Language::Cellml_1_1)) {
+        pErrorMessage = "Only SED-ML files with a CellML file are supported.";
+
+        return false;
+    }
+
+    // Check whether our model source is a local file (which location is
+    // relative to that of our SED-ML file) or a remote file
+
+    QString modelSource = QString::fromStdString(model->getSource());
+    bool isLocalFile;
+    QString dummy;
+
+    Core::checkFileNameOrUrl(modelSource, isLocalFile, dummy);
+
+    QString cellmlFileName = QString();
+    QString cellmlUrl = QString();
+
+    if (isLocalFile && mUrl.isEmpty()) {
+        cellmlFileName = Core::nativeCanonicalFileName(QFileInfo(mSedmlFile->fileName()).path()+QDir::separator()+modelSource);
+
+#ifdef Q_OS_WIN
+        // On Windows, if our model source exists, it means that it refers to a
+        // file on a different drive rather than to a file name relative to our
+        // SED-ML file
+
+        if (QFile::exists(modelSource))
+            cellmlFileName = modelSource;
+#endif
+
+        if (!QFile::exists(cellmlFileName)) {
+            pErrorMessage = QString("%1 could not be found.").arg(modelSource);
+
+            return false;
+        }
+    } else {
+        // Handle the case where our model source is a relative remote file
+
+        static const QRegularExpression FileNameRegEx = QRegularExpression("/[^/]*$");
+
+        if (isLocalFile)
+            modelSource = QString(mUrl).remove(FileNameRegEx)+"/"+modelSource;
+
+        // Retrieve the contents of our model source and save it to a local
+        // file
+
+        QByteArray fileContents;
+        QString errorMessage;
+
+        if (!Core::readFileContentsFromUrl(modelSource, fileContents, &errorMessage)) {
+            pErrorMessage = QString("%1 could not be retrieved (%2).").arg(modelSource, Core::formatMessage(errorMessage));
+
+            return false;
+        }
+
+        cellmlFileName = Core::temporaryFileName();
+        cellmlUrl = modelSource;
+
+        if (!Core::writeFileContentsToFile(cellmlFileName, fileContents)) {
+            pErrorMessage = QString("%1 could not be saved.").arg(modelSource);
+
+            return false;
+        }
+
+        mTemporaryFileNames << cellmlFileName;
+    }
+
+    if (!manageFile(cellmlFileName, cellmlUrl, pErrorMessage))
+        return false;
+
+    mCellmlFile = new CellMLSupport::CellmlFile(cellmlFileName);
+
+    return true;
+}
+
+//==============================================================================
+
+SolverInterface * SingleCellViewCliSimulation::solverInterface(const Solver::Type &pSolverType,
+                                                               const QString &pSolverName) const
+{
+    // Return the solver interface which type and name are the given ones or,
+    // if no name is given, the first solver interface (in alphabetical order)
+    // which type is the given one, just like in the GUI
+
+    QMap<QString, SolverInterface *> solverInterfaces = QMap<QString, SolverInterface *>();
+
+    foreach (SolverInterface *solverInterface, mSolverInterfaces) {
+        if (solverInterface->solverType() == pSolverType)
+            solverInterfaces.insert(solverInterface->solverName(), solverInterface);
+    }
+
+    if (pSolverName.isEmpty())
+        return solverInterfaces.isEmpty()?0:solverInterfaces.first();
+    else
+        return solverInterfaces.value(pSolverName);
+}
+
+//==============================================================================
+
+void SingleCellViewCliSimulation::setSolver(const Solver::Type &pSolverType,
+                                            SolverInterface *pSolverInterface)
+{
+    // Use the given solver and initialise its properties to their default value
+
+    SingleCellViewSimulationData *data = mSimulation->data();
+
+    if (pSolverType == Solver::Ode)
+        data->setOdeSolverName(pSolverInterface->solverName());
+    else if (pSolverType == Solver::Dae)
+        data->setDaeSolverName(pSolverInterface->solverName());
+    else
+        data->setNlaSolverName(pSolverInterface->solverName(), false);
+
+    foreach (const Solver::Property &solverProperty,
+             pSolverInterface->solverProperties()) {
+        setSolverProperty(pSolverType, pSolverInterface, solverProperty.id(),
+                          solverProperty.defaultValue().toString());
+    }
+}
+
+//==============================================================================
+
+bool SingleCellViewCliSimulation::setSolverProperty(const Solver::Type &pSolverType,
+                                                    SolverInterface *pSolverInterface,
+                                                    const QString &pId,
+                                                    const QString &pValue)
+{
+    // Set the given solver property, after having converted its value to the
+    // type expected by the solver
+
+    foreach (const Solver::Property &solverProperty,
+             pSolverInterface->solverProperties()) {
+        if (solverProperty.id().compare(pId))
+            continue;
+
+        QVariant stringValue = pValue;
+        QVariant value;
+
+        switch (solverProperty.type()) {
+        case Solver::Property::Boolean:
+            value = stringValue.toBool();
+
+            break;
+        case Solver::Property::Integer:
+            value = stringValue.toInt();
+
+            break;
+        case Solver::Property::Double:
+            value = stringValue.toDouble();
+
+            break;
+        case Solver::Property::List:
+            value = pValue;
+
+            break;
+        }
+
+        SingleCellViewSimulationData *data = mSimulation->data();
+
+        if (pSolverType == Solver::Ode)
+            data->addOdeSolverProperty(pId, value);
+        else if (pSolverType == Solver::Dae)
+            data->addDaeSolverProperty(pId, value);
+        else
+            data->addNlaSolverProperty(pId, value, false);
+
+        return true;
+    }
+
+    return false;
+}
+
+//==============================================================================
+
+bool SingleCellViewCliSimulation::setDefaultSolvers(QString &pErrorMessage)
+{
+    // Use the same default solvers as in the GUI
+
+    CellMLSupport::CellmlFileRuntime *runtime = mSimulation->runtime();
+    Solver::Type voiSolverType = runtime->needOdeSolver()?Solver::Ode:Solver::Dae;
+    SolverInterface *voiSolverInterface = solverInterface(voiSolverType);
+
+    if (!voiSolverInterface) {
+        pErrorMessage = QString("No %1 solver could be found.").arg(runtime->needOdeSolver()?"ODE":"DAE");
+
+        return false;
+    }
+
+    setSolver(voiSolverType, voiSolverInterface);
+
+    if (runtime->needNlaSolver()) {
+        SolverInterface *nlaSolverInterface = solverInterface(Solver::Nla);
+
+        if (!nlaSolverInterface) {
+            pErrorMessage = "No NLA solver could be found.";
+
+            return false;
+        }
+
+        setSolver(Solver::Nla, nlaSolverInterface);
+    }
+
+    return true;
+}
+
+//==============================================================================
+
+bool SingleCellViewCliSimulation::applySedmlSettings(QString &pErrorMessage)
+{
+    // Retrieve our simulation settings from our SED-ML file, which must have a
+    // uniform time course as a first simulation and, optionally, a one-step as
+    // a second simulation
+
+    libsedml::SedDocument *sedmlDocument = mSedmlFile->sedmlDocument();
+    libsedml::SedSimulation *firstSimulation = sedmlDocument->getSimulation(0);
+    libsedml::SedSimulation *secondSimulation = sedmlDocument->getSimulation(1);
+
+    if (   !firstSimulation
+        || (firstSimulation->getTypeCode() != libsedml::SEDML_SIMULATION_UNIFORMTIMECOURSE)) {
+        pErrorMessage = "Only SED-ML files with a uniform time course as a (first) simulation are supported.";
+
+        return false;
+    }
+
+    if (   secondSimulation
+        && (secondSimulation->getTypeCode() != libsedml::SEDML_SIMULATION_ONESTEP)) {
+        pErrorMessage = "Only SED-ML files with a one-step as a second simulation are supported.";
+
+        return false;
+    }
+
+    libsedml::SedUniformTimeCourse *uniformTimeCourseSimulation = static_cast<libsedml::SedUniformTimeCourse *>(firstSimulation);
+    libsedml::SedOneStep *oneStepSimulation = static_cast<libsedml::SedOneStep *>(secondSimulation);
+
+    if (uniformTimeCourseSimulation->getNumberOfPoints() <= 0) {
+        pErrorMessage = "The value for numberOfPoints must be greater than zero.";
+
+        return false;
+    }
+
+    double startingPoint = uniformTimeCourseSimulation->getOutputStartTime();
+    double endingPoint = uniformTimeCourseSimulation->getOutputEndTime();
+    double pointInterval = (endingPoint-startingPoint)/uniformTimeCourseSimulation->getNumberOfPoints();
+
+    if (oneStepSimulation)
+        endingPoint += oneStepSimulation->getStep();
+
+    SingleCellViewSimulationData *data = mSimulation->data();
+
+    data->setStartingPoint(startingPoint, false);
+    data->setEndingPoint(endingPoint);
+    data->setPointInterval(pointInterval);
+
+    // Retrieve the ODE/DAE solver to use, as well as its properties for which
+    // we have a KiSAO id
+
+    const libsedml::SedAlgorithm *algorithm = uniformTimeCourseSimulation->getAlgorithm();
+
+    if (!algorithm) {
+        pErrorMessage = "Only SED-ML files with one or two simulations with an algorithm are supported.";
+
+        return false;
+    }
+
+    CellMLSupport::CellmlFileRuntime *runtime = mSimulation->runtime();
+    Solver::Type voiSolverType = runtime->needOdeSolver()?Solver::Ode:Solver::Dae;
+    QString kisaoId = QString::fromStdString(algorithm->getKisaoID());
+    SolverInterface *usedSolverInterface = 0;
+
+    foreach (SolverInterface *solverInterface, mSolverInterfaces) {
+        if (   (solverInterface->solverType() == voiSolverType)
+            && !solverInterface->id(kisaoId).compare(solverInterface->solverName())) {
+            usedSolverInterface = solverInterface;
+
+            break;
+        }
+    }
+
+    if (!usedSolverInterface) {
+        pErrorMessage = QString("The requested solver (%1) could not be found.").arg(kisaoId);
+
+        return false;
+    }
+
+    setSolver(voiSolverType, usedSolverInterface);
+
+    for (int i = 0, iMax = algorithm->getNumAlgorithmParameters(); i < iMax; ++i) {
+        const libsedml::SedAlgorithmParameter *algorithmParameter = algorithm->getAlgorithmParameter(i);
+        QString kisaoId = QString::fromStdString(algorithmParameter->getKisaoID());
+
+        if (!setSolverProperty(voiSolverType, usedSolverInterface,
+                               usedSolverInterface->id(kisaoId),
+                               QString::fromStdString(algorithmParameter->getValue()))) {
+            pErrorMessage = QString("The requested property (%1) could not be set.").arg(kisaoId);
+
+            return false;
+        }
+    }
+
+    // Retrieve the ODE/DAE solver properties for which we don't have a KiSAO
+    // id
+
+    libsbml::XMLNode *annotation = algorithm->getAnnotation();
+
+    if (annotation) {
+        for (uint i = 0, iMax = annotation->getNumChildren(); i < iMax; ++i) {
+            const libsbml::XMLNode &node = annotation->getChild(i);
+
+            if (   QString::fromStdString(node.getURI()).compare(SEDMLSupport::OpencorNamespace)
+                || QString::fromStdString(node.getName()).compare(SEDMLSupport::SolverProperties)) {
+                continue;
+            }
+
+            for (uint j = 0, jMax = node.getNumChildren(); j < jMax; ++j) {
+                const libsbml::XMLNode &solverPropertyNode = node.getChild(j);
+
+                if (   QString::fromStdString(solverPropertyNode.getURI()).compare(SEDMLSupport::OpencorNamespace)
+                    || QString::fromStdString(solverPropertyNode.getName()).compare(SEDMLSupport::SolverProperty)) {
+                    continue;
+                }
+
+                QString id = QString::fromStdString(solverPropertyNode.getAttrValue(solverPropertyNode.getAttrIndex(SEDMLSupport::SolverPropertyId.toStdString())));
+                QString value = QString::fromStdString(solverPropertyNode.getAttrValue(solverPropertyNode.getAttrIndex(SEDMLSupport::SolverPropertyValue.toStdString())));
+
+                if (!setSolverProperty(voiSolverType, usedSolverInterface, id, value)) {
+                    pErrorMessage = QString("The requested property (%1) could not be set.").arg(id);
+
+                    return false;
+                }
+            }
+        }
+    }
+
+    // Retrieve the NLA solver to use, if any
+
+    annotation = uniformTimeCourseSimulation->getAnnotation();
+
+    if (annotation) {
+        for (uint i = 0, iMax = annotation->getNumChildren(); i < iMax; ++i) {
+            const libsbml::XMLNode &node = annotation->getChild(i);
+
+            if (   QString::fromStdString(node.getURI()).compare(SEDMLSupport::OpencorNamespace)
+                || QString::fromStdString(node.getName()).compare(SEDMLSupport::NlaSolver)) {
+                continue;
+            }
+
+            QString nlaSolverName = QString::fromStdString(node.getAttrValue(node.getAttrIndex(SEDMLSupport::NlaSolverName.toStdString())));
+            SolverInterface *nlaSolverInterface = solverInterface(Solver::Nla, nlaSolverName);
+
+            if (!nlaSolverInterface) {
+                pErrorMessage = QString("The requested NLA solver (%1) could not be found.").arg(nlaSolverName);
+
+                return false;
+            }
+
+            if (runtime->needNlaSolver())
+                setSolver(Solver::Nla, nlaSolverInterface);
+
+            for (uint j = 0, jMax = node.getNumChildren(); j < jMax; ++j) {
+                const libsbml::XMLNode &solverPropertyNode = node.getChild(j);
+
+                if (   QString::fromStdString(solverPropertyNode.getURI()).compare(SEDMLSupport::OpencorNamespace)
+                    || QString::fromStdString(solverPropertyNode.getName()).compare(SEDMLSupport::SolverProperty)) {
+                    continue;
+                }
+
+                QString id = QString::fromStdString(solverPropertyNode.getAttrValue(solverPropertyNode.getAttrIndex(SEDMLSupport::SolverPropertyId.toStdString())));
+                QString value = QString::fromStdString(solverPropertyNode.getAttrValue(solverPropertyNode.getAttrIndex(SEDMLSupport::SolverPropertyValue.toStdString())));
+
+                if (   runtime->needNlaSolver()
+                    && !setSolverProperty(Solver::Nla, nlaSolverInterface, id, value)) {
+                    pErrorMessage = QString("The requested property (%1) could not be set.").arg(id);
+
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+//==============================================================================
+
+bool SingleCellViewCliSimulation::load(QString &pErrorMessage)
+{
+    // Manage our file and determine its type
+
+    if (!manageFile(mFileName, mUrl, pErrorMessage))
+        return false;
+
+    if (CellMLSupport::CellmlFileManager::instance()->isCellmlFile(mFileName)) {
+        mCellmlFile = new CellMLSupport::CellmlFile(mFileName);
+    } else if (SEDMLSupport::SedmlFileManager::instance()->isSedmlFile(mFileName)) {
+        mSedmlFile = new SEDMLSupport::SedmlFile(mFileName);
+    } else if (COMBINESupport::CombineFileManager::instance()->isCombineArchive(mFileName)) {
+        mCombineArchive = new COMBINESupport::CombineArchive(mFileName);
+    } else {
+        pErrorMessage = "The file is not a CellML file, a SED-ML file or a COMBINE archive.";
+
+        return false;
+    }
+
+    // In the case of a COMBINE archive, we need to retrieve the corresponding
+    // SED-ML file while, in the case of a SED-ML file, we need to retrieve the
+    // corresponding CellML file
+
+    if (mCombineArchive && !retrieveSedmlFile(pErrorMessage))
+        return false;
+
+    if (mSedmlFile && !retrieveCellmlFile(pErrorMessage))
+        return false;
+
+    // Retrieve the runtime of our CellML file and make sure that it is valid
+
+    if (!mCellmlFile->load()) {
+        pErrorMessage = "The CellML file could not be loaded.";
+
+        return false;
+    }
+
+    CellMLSupport::CellmlFileRuntime *runtime = mCellmlFile->runtime();
+
+    if (!runtime || !runtime->isValid()) {
+        CellMLSupport::CellmlFileIssues issues = runtime?runtime->issues():mCellmlFile->issues();
+
+        pErrorMessage = "The CellML file could not be compiled";
+
+        if (issues.count())
+            pErrorMessage += " ("+Core::formatMessage(issues.first().message())+")";
+
+        pErrorMessage += ".";
+
+        return false;
+    }
+
+    // Create our simulation, keeping track of any error it might report, and
+    // customise it using either our default settings or those from our SED-ML
+    // file
+
+    mSimulation = new SingleCellViewSimulation(runtime, mSolverInterfaces);
+
+    connect(mSimulation, SIGNAL(error(const QString &)),
+            this, SLOT(simulationError(const QString &)));
+
+    if (!setDefaultSolvers(pErrorMessage))
+        return false;
+
+    if (mSedmlFile && !applySedmlSettings(pErrorMessage))
+        return false;
+
+    return true;
+}
+
+//==============================================================================
+
+SingleCellViewSimulation * SingleCellViewCliSimulation::simulation() const
+{
+    // Return our simulation
+
+    return mSimulation;
+}
+
+//==============================================================================
+
+bool SingleCellViewCliSimulation::setRecordedVariables(const QStringList &pVariables,
+                                                       QString &pErrorMessage)
+{
+    // Only record (i.e. output) the given variables, which are identified by
+    // their component hierarchy and name (e.g. membrane/V or membrane/V'), in
+    // addition to our variable of integration
+
+    CellMLSupport::CellmlFileRuntimeParameters recordedParameters = CellMLSupport::CellmlFileRuntimeParameters();
+
+    foreach (const QString &variable, pVariables) {
+        CellMLSupport::CellmlFileRuntimeParameter *recordedParameter = parameter(variable);
+
+        if (!recordedParameter) {
+            pErrorMessage = QString("The variable '%1' could not be found.").arg(variable);
+
+            return false;
+        }
+
+        recordedParameters << recordedParameter;
+    }
+
+    mSimulation->results()->setRecordedParameters(recordedParameters);
+
+    return true;
+}
+
+//==============================================================================
+
+CellMLSupport::CellmlFileRuntimeParameter * SingleCellViewCliSimulation::parameter(const QString &pVariable) const
+{
+    // Return the parameter that corresponds to the given variable, which is
+    // identified by its component hierarchy and name (e.g. membrane/V or
+    // membrane/V'), if any
+
+    foreach (CellMLSupport::CellmlFileRuntimeParameter *parameter, mSimulation->runtime()->parameters()) {
+        if (   (parameter->type() != CellMLSupport::CellmlFileRuntimeParameter::Voi)
+            && !SingleCellViewSimulationResults::uri(parameter->componentHierarchy(),
+                                                     parameter->formattedName()).replace("/prime", "'").compare(pVariable)) {
+            return parameter;
+        }
+    }
+
+    return 0;
+}
+
+//==============================================================================
+
+CellMLSupport::CellmlFileRuntimeParameters SingleCellViewCliSimulation::outputParameters() const
+{
+    // Return the parameters that are to be output, sorted by URI as is done by
+    // our CSV data store
+    // Note: our CSV data store sorts its variables in a case insensitive way...
+
+    QMap<QString, CellMLSupport::CellmlFileRuntimeParameter *> parameters = QMap<QString, CellMLSupport::CellmlFileRuntimeParameter *>();
+
+    foreach (CellMLSupport::CellmlFileRuntimeParameter *parameter, mSimulation->runtime()->parameters()) {
+        if (   parameterValue(mSimulation->data(), parameter)
+            && mSimulation->results()->isRecorded(parameter)) {
+            parameters.insert(SingleCellViewSimulationResults::uri(parameter->componentHierarchy(),
+                                                                   parameter->formattedName()).toLower(),
+                              parameter);
+        }
+    }
+
+    return parameters.values();
+}
+
+//==============================================================================
+
+double * SingleCellViewCliSimulation::parameterValue(SingleCellViewSimulationData *pData,
+                                                     CellMLSupport::CellmlFileRuntimeParameter *pParameter)
+{
+    // Return where the value of the given parameter can be found in the given
+    // simulation data, if anywhere
+
+    switch (pParameter->type()) {
+    case CellMLSupport::CellmlFileRuntimeParameter::Constant:
+    case CellMLSupport::CellmlFileRuntimeParameter::ComputedConstant:
+        return pData->constants()+pParameter->index();
+    case CellMLSupport::CellmlFileRuntimeParameter::Rate:
+        return pData->rates()+pParameter->index();
+    case CellMLSupport::CellmlFileRuntimeParameter::State:
+        return pData->states()+pParameter->index();
+    case CellMLSupport::CellmlFileRuntimeParameter::Algebraic:
+        return pData->algebraic()+pParameter->index();
+    default:
+        // Not a relevant type
+
+        return 0;
+    }
+}
+
+//==============================================================================
+
+QByteArray SingleCellViewCliSimulation::header(CellMLSupport::CellmlFileRuntimeParameter *pParameter) const
+{
+    // Return the CSV header for the given parameter
+
+    static const QString Header = "%1 (%2)";
+
+    CellMLSupport::CellmlFileRuntimeParameter *voi = mSimulation->runtime()->variableOfIntegration();
+
+    if (pParameter == voi) {
+        return Header.arg(SingleCellViewSimulationResults::uri(voi->componentHierarchy(), voi->name()).replace("/prime", "'").replace("/", " | "),
+                          voi->unit()).toUtf8();
+    } else {
+        return Header.arg(SingleCellViewSimulationResults::uri(pParameter->componentHierarchy(),
+                                                               pParameter->formattedName()).replace("/prime", "'").replace("/", " | "),
+                          pParameter->formattedUnit(voi->unit())).toUtf8();
+    }
+}
+
+//==============================================================================
+
+bool SingleCellViewCliSimulation::run(QIODevice *pOutput,
+                                      QString &pErrorMessage)
+{
+    // Make sure that our simulation settings are sound and initialise our
+    // simulation data
+
+    mError = false;
+
+    if (!mSimulation->simulationSettingsOk()) {
+        pErrorMessage = QString("The simulation settings are not valid (%1).").arg(mErrorMessage);
+
+        return false;
+    }
+
+    SingleCellViewSimulationData *data = mSimulation->data();
+
+    data->reset();
+
+    if (mError) {
+        pErrorMessage = QString("The simulation could not be initialised (%1).").arg(mErrorMessage);
+
+        return false;
+    }
+
+    // Determine the columns that are to be output and output our header
+
+    CellMLSupport::CellmlFileRuntime *runtime = mSimulation->runtime();
+    CellMLSupport::CellmlFileRuntimeParameters parameters = outputParameters();
+    QList<double *> columns = QList<double *>();
+
+    foreach (CellMLSupport::CellmlFileRuntimeParameter *parameter, parameters)
+        columns << parameterValue(data, parameter);
+
+    QByteArray line = header(runtime->variableOfIntegration());
+
+    foreach (CellMLSupport::CellmlFileRuntimeParameter *parameter, parameters)
+        line += ","+header(parameter);
+
+    line += "\n";
+
+    pOutput->write(line);
+
+    // Set up our ODE/DAE solver
+
+    Solver::VoiSolver *voiSolver = 0;
+    Solver::OdeSolver *odeSolver = 0;
+    Solver::DaeSolver *daeSolver = 0;
+
+    if (runtime->needOdeSolver())
+        voiSolver = odeSolver = static_cast<Solver::OdeSolver *>(data->odeSolverInterface()->solverInstance());
+    else
+        voiSolver = daeSolver = static_cast<Solver::DaeSolver *>(data->daeSolverInterface()->solverInstance());
+
+    connect(voiSolver, SIGNAL(error(const QString &)),
+            this, SLOT(simulationError(const QString &)));
+
+    // Set our NLA solver, if needed
+    // Note: we unset it at the end of this method...
+
+    Solver::NlaSolver *nlaSolver = 0;
+
+    if (runtime->needNlaSolver()) {
+        nlaSolver = static_cast<Solver::NlaSolver *>(data->nlaSolverInterface()->solverInstance());
+
+        runtime->nlaSolverRegistry()->setNlaSolver(nlaSolver);
+
+        connect(nlaSolver, SIGNAL(error(const QString &)),
+                this, SLOT(simulationError(const QString &)));
+
+        nlaSolver->setProperties(data->nlaSolverProperties());
+    }
+
+    // Retrieve our simulation properties and initialise our ODE/DAE solver
+
+    double startingPoint = data->startingPoint();
+    double endingPoint = data->endingPoint();
+    double pointInterval = data->pointInterval();
+
+    bool increasingPoints = endingPoint > startingPoint;
+    quint64 pointCounter = 0;
+
+    double currentPoint = startingPoint;
+
+    if (odeSolver) {
+        odeSolver->setProperties(data->odeSolverProperties());
+        odeSolver->setComputeJacobian(runtime->computeOdeJacobian(),
+                                      runtime->algebraicCount());
+
+        odeSolver->initialize(currentPoint,
+                              runtime->statesCount(),
+                              data->constants(), data->rates(),
+                              data->states(), data->algebraic(),
+                              runtime->computeOdeRates());
+    } else {
+        daeSolver->setProperties(data->daeSolverProperties());
+
+        daeSolver->initialize(currentPoint, endingPoint,
+                              runtime->statesCount(),
+                              runtime->condVarCount(),
+                              data->constants(), data->rates(),
+                              data->states(), data->algebraic(),
+                              data->condVar(),
+                              runtime->computeDaeEssentialVariables(),
+                              runtime->computeDaeResiduals(),
+                              runtime->computeDaeRootInformation(),
+                              runtime->computeDaeStateInformation());
+    }
+
+    // Compute our model and output our points as we go along, i.e. without
+    // keeping them in memory
+
+    if (!mError) {
+        forever {
+            // Output our current point after making sure that all the variables
+            // are up to date
+
+            data->recomputeVariables(currentPoint);
+
+            line = DataStore::formatValue(currentPoint);
+
+            foreach (double *column, columns)
+                line += ","+DataStore::formatValue(*column);
+
+            line += "\n";
+
+            pOutput->write(line);
+
+            // Check whether we are done
+
+            if (currentPoint == endingPoint)
+                break;
+
+            // Determine our next point and compute our model up to it
+
+            ++pointCounter;
+
+            voiSolver->solve(currentPoint,
+                             increasingPoints?
+                                 qMin(endingPoint, startingPoint+pointCounter*pointInterval):
+                                 qMax(endingPoint, startingPoint+pointCounter*pointInterval));
+
+            // Make sure that no error occurred
+
+            if (mError)
+                break;
+        }
+    }
+
+    // Delete our solver(s)
+
+    delete voiSolver;
+
+    if (nlaSolver) {
+        delete nlaSolver;
+
+        runtime->nlaSolverRegistry()->unsetNlaSolver();
+    }
+
+    // Let the user know if something went wrong
+
+    if (mError) {
+        pErrorMessage = QString("The simulation failed (%1).").arg(mErrorMessage);
+
+        return false;
+    } else {
+        return true;
+    }
+}
+
+//==============================================================================
+
+bool SingleCellViewCliSimulation::runSweep(const QString &pConstant,
+                                           const QList<double> &pValues,
+                                           const bool &pSpecializeOdeRates,
+                                           QIODevice *pOutput,
+                                           QString &pErrorMessage)
+{
+    // Make sure that the given constant exists and that our simulation settings
+    // are sound
+
+    CellMLSupport::CellmlFileRuntimeParameter *constant = parameter(pConstant);
+
+    if (   !constant
+        || (constant->type() != CellMLSupport::CellmlFileRuntimeParameter::Constant)) {
+        pErrorMessage = QString("The constant '%1' could not be found.").arg(pConstant);
+
+        return false;
+    }
+
+    mError = false;
+
+    if (!mSimulation->simulationSettingsOk()) {
+        pErrorMessage = QString("The simulation settings are not valid (%1).").arg(mErrorMessage);
+
+        return false;
+    }
+
+    // Create an ensemble with one run for each of the given values of our
+    // constant, and run it
+
+    SingleCellViewSimulationEnsemble ensemble(mSimulation, mSolverInterfaces);
+
+    ensemble.setSpecializeOdeRates(pSpecializeOdeRates);
+
+    foreach (double value, pValues) {
+        SingleCellViewSimulationEnsembleValues constants = SingleCellViewSimulationEnsembleValues();
+
+        constants.insert(constant->index(), value);
+
+        ensemble.addRun(constants);
+    }
+
+    if (!ensemble.run()) {
+        for (int i = 0, iMax = ensemble.runsCount(); i < iMax; ++i) {
+            SingleCellViewSimulationEnsembleRun *run = ensemble.ensembleRun(i);
+
+            if (!run->isSuccessful()) {
+                pErrorMessage = QString("The simulation failed for %1 = %2 (%3).").arg(pConstant,
+                                                                                      QString::number(pValues[i]),
+                                                                                      run->errorMessage());
+
+                break;
+            }
+        }
+
+        return false;
+    }
+
+    // Output our header, followed by the final values of the variables of each
+    // of our runs, which simulation data is left as it was at the end of its
+    // run
+
+    CellMLSupport::CellmlFileRuntimeParameters parameters = outputParameters();
+    QByteArray line = header(constant)+","+header(mSimulation->runtime()->variableOfIntegration());
+
+    foreach (CellMLSupport::CellmlFileRuntimeParameter *parameter, parameters)
+        line += ","+header(parameter);
+
+    line += "\n";
+
+    pOutput->write(line);
+
+    double endingPoint = mSimulation->data()->endingPoint();
+
+    for (int i = 0, iMax = ensemble.runsCount(); i < iMax; ++i) {
+        SingleCellViewSimulationData *data = ensemble.ensembleRun(i)->simulation()->data();
+
+        line = DataStore::formatValue(pValues[i])+","+DataStore::formatValue(endingPoint);
+
+        foreach (CellMLSupport::CellmlFileRuntimeParameter *parameter, parameters)
+            line += ","+DataStore::formatValue(*parameterValue(data, parameter));
+
+        line += "\n";
+
+        pOutput->write(line);
+    }
+
+    return true;
+}
+
+//==============================================================================
+
+void SingleCellViewCliSimulation::simulationError(const QString &pMessage)
+{
+    // An error occurred, so keep track of it
+
+    mError = true;
+    mErrorMessage = pMessage;
+}
+
+//==============================================================================
+
+}   // namespace SingleCellView
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -0,0 +1,144 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Single Cell view CLI simulation
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include "cellmlfileruntime.h"
+#include "solverinterface.h"
+
+//==============================================================================
+
+#include <QList>
+#include <QObject>
+#include <QStringList>
+
+//==============================================================================
+
+class QIODevice;
+
+//==============================================================================
+
+namespace OpenCOR {
+
+//==============================================================================
+
+namespace COMBINESupport {
+    class CombineArchive;
+}   // namespace COMBINESupport
+
+//==============================================================================
+
+namespace SEDMLSupport {
+    class SedmlFile;
+}   // namespace SEDMLSupport
+
+//==============================================================================
+
+namespace SingleCellView {
+
+//==============================================================================
+
+class SingleCellViewSimulation;
+class SingleCellViewSimulationData;
+
+//==============================================================================
+
+class SingleCellViewCliSimulation : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SingleCellViewCliSimulation(const QString &pFileName,
+                                         const QString &pUrl,
+                                         const SolverInterfaces &pSolverInterfaces);
+    ~SingleCellViewCliSimulation();
+
+    bool load(QString &pErrorMessage);
+
+    SingleCellViewSimulation * simulation() const;
+
+    bool setRecordedVariables(const QStringList &pVariables,
+                              QString &pErrorMessage);
+
+    bool run(QIODevice *pOutput, QString &pErrorMessage);
+    bool runSweep(const QString &pConstant, const QList<double> &pValues,
+                  const bool &pSpecializeOdeRates, QIODevice *pOutput,
+                  QString &pErrorMessage);
+
+private:
+    QString mFileName;
+    QString mUrl;
+
+    SolverInterfaces mSolverInterfaces;
+
+    CellMLSupport::CellmlFile *mCellmlFile;
+    SEDMLSupport::SedmlFile *mSedmlFile;
+    COMBINESupport::CombineArchive *mCombineArchive;
+
+    QStringList mManagedFileNames;
+    QStringList mTemporaryFileNames;
+
+    SingleCellViewSimulation *mSimulation;
+
+    bool mError;
+    QString mErrorMessage;
+
+    bool manageFile(const QString &pFileName, const QString &pUrl,
+                    QString &pErrorMessage);
+
+    bool retrieveSedmlFile(QString &pErrorMessage);
+    bool retrieveCellmlFile(QString &pErrorMessage);
+
+    SolverInterface * solverInterface(const Solver::Type &pSolverType,
+                                      const QString &pSolverName = QString()) const;
+
+    void setSolver(const Solver::Type &pSolverType,
+                   SolverInterface *pSolverInterface);
+    bool setSolverProperty(const Solver::Type &pSolverType,
+                           SolverInterface *pSolverInterface,
+                           const QString &pId, const QString &pValue);
+
+    bool setDefaultSolvers(QString &pErrorMessage);
+    bool applySedmlSettings(QString &pErrorMessage);
+
+    CellMLSupport::CellmlFileRuntimeParameter * parameter(const QString &pVariable) const;
+    CellMLSupport::CellmlFileRuntimeParameters outputParameters() const;
+
+    static double * parameterValue(SingleCellViewSimulationData *pData,
+                                   CellMLSupport::CellmlFileRuntimeParameter *pParameter);
+
+    QByteArray header(CellMLSupport::CellmlFileRuntimeParameter *pParameter) const;
+
+private slots:
+    void simulationError(const QString &pMessage);
+};
+
+//==============================================================================
+
+}   // namespace SingleCellView
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
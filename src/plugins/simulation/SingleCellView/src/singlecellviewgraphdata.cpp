@@ -0,0 +1,139 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Single Cell view graph data
+//==============================================================================
+
+#include "datastoreinterface.h"
+#include "singlecellviewgraphdata.h"
+
+//==============================================================================
+
+#include <QtNumeric>
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace SingleCellView {
+
+//==============================================================================
+
+SingleCellViewGraphData::SingleCellViewGraphData(DataStore::DataStoreVariable *pVariableX,
+                                                 DataStore::DataStoreVariable *pVariableY,
+                                                 const qulonglong &pSize) :
+    mVariableX(pVariableX),
+    mVariableY(pVariableY),
+    mSize((    pVariableX && pVariableX->isRecorded()
+           && pVariableY && pVariableY->isRecorded())?pSize:0),
+    mChunkIndex(-1),
+    mChunkX(0),
+    mChunkY(0),
+    mSingleValueX(0.0),
+    mSingleValueY(0.0)
+{
+    // Note: a variable that is not recorded doesn't hold any value, so there
+    //       is nothing for us to plot...
+}
+
+//==============================================================================
+
+size_t SingleCellViewGraphData::size() const
+{
+    // Return our size
+
+    return mSize;
+}
+
+//==============================================================================
+
+void SingleCellViewGraphData::retrieveChunk(const int &pIndex) const
+{
+    // Retrieve the chunk of values at the given index for both of our variables
+    // Note: a variable that holds a single value doesn't have any chunk, in
+    //       which case we keep track of that value instead...
+
+    qulonglong chunkSize;
+
+    mChunkIndex = pIndex;
+
+    mChunkX = mVariableX->chunk(pIndex, chunkSize);
+    mChunkY = mVariableY->chunk(pIndex, chunkSize);
+
+    if (!mChunkX)
+        mSingleValueX = mVariableX->value(0);
+
+    if (!mChunkY)
+        mSingleValueY = mVariableY->value(0);
+}
+
+//==============================================================================
+
+QPointF SingleCellViewGraphData::sample(size_t pIndex) const
+{
+    // Return our sample at the given index
+    // Note: our samples are normally retrieved one after the other, so we keep
+    //       track of the chunk that contains the current one rather than
+    //       retrieve each of our values through DataStoreVariable::value()...
+
+    Q_ASSERT(pIndex < mSize);
+
+    int chunkIndex = int(pIndex >> DataStore::ChunkShift);
+
+    if (chunkIndex != mChunkIndex)
+        retrieveChunk(chunkIndex);
+
+    size_t offset = pIndex & DataStore::ChunkMask;
+
+    return QPointF(mChunkX?mChunkX[offset]:mSingleValueX,
+                   mChunkY?mChunkY[offset]:mSingleValueY);
+}
+
+//==============================================================================
+
+QRectF SingleCellViewGraphData::boundingRect() const
+{
+    // Return our bounding rectangle, which we get from the minimum and maximum
+    // values of our variables rather than by going through all our samples
+    // Note: our variables may hold more values than our size (e.g. if our
+    //       simulation is still running), in which case our bounding rectangle
+    //       will be slightly bigger than it would otherwise be, but this is not
+    //       an issue...
+
+    double minX = mVariableX?mVariableX->minimum():qQNaN();
+    double maxX = mVariableX?mVariableX->maximum():qQNaN();
+    double minY = mVariableY?mVariableY->minimum():qQNaN();
+    double maxY = mVariableY?mVariableY->maximum():qQNaN();
+
+    if (   !mSize
+        || qIsNaN(minX) || qIsNaN(maxX) || qIsNaN(minY) || qIsNaN(maxY)) {
+        return QRectF(1.0, 1.0, -2.0, -2.0);
+        // Note: this is what Qwt uses for an invalid bounding rectangle...
+    }
+
+    return QRectF(minX, minY, maxX-minX, maxY-minY);
+}
+
+//==============================================================================
+
+}   // namespace SingleCellView
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -0,0 +1,79 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Single Cell view graph data
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include "qwt_series_data.h"
+
+//==============================================================================
+
+namespace OpenCOR {
+
+//==============================================================================
+
+namespace DataStore {
+    class DataStoreVariable;
+}   // namespace DataStore
+
+//==============================================================================
+
+namespace SingleCellView {
+
+//==============================================================================
+
+class SingleCellViewGraphData : public QwtSeriesData<QPointF>
+{
+public:
+    explicit SingleCellViewGraphData(DataStore::DataStoreVariable *pVariableX,
+                                     DataStore::DataStoreVariable *pVariableY,
+                                     const qulonglong &pSize);
+
+    virtual size_t size() const;
+    virtual QPointF sample(size_t pIndex) const;
+
+    virtual QRectF boundingRect() const;
+
+private:
+    DataStore::DataStoreVariable *mVariableX;
+    DataStore::DataStoreVariable *mVariableY;
+
+    qulonglong mSize;
+
+    mutable int mChunkIndex;
+    mutable const double *mChunkX;
+    mutable const double *mChunkY;
+    mutable double mSingleValueX;
+    mutable double mSingleValueY;
+
+    void retrieveChunk(const int &pIndex) const;
+};
+
+//==============================================================================
+
+}   // namespace SingleCellView
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -24,20 +24,29 @@ limitations under the License.
 #include "cellmlsupportplugin.h"
 #include "combinefilemanager.h"
 #include "combinesupportplugin.h"
+#include "corecliutils.h"
 #include "coreguiutils.h"
 #include "sedmlfilemanager.h"
 #include "sedmlsupportplugin.h"
+#include "singlecellviewclisimulation.h"
 #include "singlecellviewplugin.h"
+#include "singlecellviewsimulation.h"
 #include "singlecellviewsimulationwidget.h"
 #include "singlecellviewwidget.h"
 
 //==============================================================================
 
+#include <QFile>
 #include <QMainWindow>
+#include <QRegularExpression>
 #include <QSettings>
 
 //==============================================================================
 
+#include <iostream>
+
+//==============================================================================
+
 namespace OpenCOR {
 namespace SingleCellView {
 
@@ -50,7 +59,7 @@ PLUGININFO_FUNC SingleCellViewPluginInfo()
     descriptions.insert("en", QString::fromUtf8("a plugin to run single cell simulations."));
     descriptions.insert("fr", QString::fromUtf8("une extension pour exécuter des simulations unicellulaires."));
 
-    return new PluginInfo("Simulation", true, false,
+    return new PluginInfo("Simulation", true, true,
                           QStringList() << "COMBINESupport"<< "GraphPanelWidget" << "Qwt" << "SEDMLSupport",
                           descriptions);
 }
@@ -66,6 +75,34 @@ SingleCellViewPlugin::SingleCellViewPlugin() :
 {
 }
 
+//==============================================================================
+// CLI interface
+//==============================================================================
+
+int SingleCellViewPlugin::executeCommand(const QString &pCommand,
+                                         const QStringList &pArguments)
+{
+    // Run the given CLI command
+
+    if (!pCommand.compare("help")) {
+        // Display the commands that we support
+
+        runHelpCommand();
+
+        return 0;
+    } else if (!pCommand.compare("simulate")) {
+        // Run a simulation
+
+        return runSimulateCommand(pArguments);
+    } else {
+        // Not a CLI command that we support
+
+        runHelpCommand();
+
+        return -1;
+    }
+}
+
 //==============================================================================
 // File handling interface
 //==============================================================================
@@ -364,6 +401,201 @@ QIcon SingleCellViewPlugin::fileTabIcon(const QString &pFileName) const
 // Plugin specific
 //==============================================================================
 
+void SingleCellViewPlugin::runHelpCommand()
+{
+    // Output the commands we support
+
+    std::cout << "Commands supported by SingleCellView:" << std::endl;
+    std::cout << " * Display the commands supported by SingleCellView:" << std::endl;
+    std::cout << "      help" << std::endl;
+    std::cout << " * Simulate <file> and output the results to <csv_file> (or to the console):" << std::endl;
+    std::cout << "      simulate [-s <starting_point>] [-e <ending_point>] [-i <point_interval>] [-v <variable>]... [-p <constant>=<value>[,<value>]... [-S]] <file> [<csv_file>]" << std::endl;
+    std::cout << "   <file> can be a CellML file, a SED-ML file or a COMBINE archive" << std::endl;
+    std::cout << "   <variable> (e.g. membrane/V or membrane/V') is a variable to output (by default, all of them are)" << std::endl;
+    std::cout << "   -p runs <file> for each <value> of <constant> (e.g. membrane/Cm) and outputs the final value of the variables for each of them" << std::endl;
+    std::cout << "   -S specialises the model for <constant>, i.e. inlines all the other constants" << std::endl;
+}
+
+//==============================================================================
+
+int SingleCellViewPlugin::runSimulateCommand(const QStringList &pArguments)
+{
+    // Simulate an existing file and output its results to a CSV file or to the
+    // console
+
+    // Retrieve our options and arguments
+
+    QMap<QString, double> options = QMap<QString, double>();
+    QStringList variables = QStringList();
+    QString sweptConstant = QString();
+    QList<double> sweptValues = QList<double>();
+    bool specializeOdeRates = false;
+    QStringList arguments = QStringList();
+
+    for (int i = 0, iMax = pArguments.count(); i < iMax; ++i) {
+        QString argument = pArguments[i];
+
+        if (   !argument.compare("-s") || !argument.compare("-e")
+            || !argument.compare("-i")) {
+            bool validValue = false;
+
+            if (i+1 < iMax)
+                options.insert(argument, pArguments[++i].toDouble(&validValue));
+
+            if (!validValue) {
+                runHelpCommand();
+
+                return -1;
+            }
+        } else if (!argument.compare("-v")) {
+            if (i+1 == iMax) {
+                runHelpCommand();
+
+                return -1;
+            }
+
+            variables << pArguments[++i];
+        } else if (!argument.compare("-p")) {
+            // Retrieve the constant to sweep and its values
+
+            static const QRegularExpression SweepRegEx = QRegularExpression("^([^=]+)=(.+)$");
+
+            QRegularExpressionMatch match = SweepRegEx.match((i+1 < iMax)?pArguments[++i]:QString());
+
+            if (!match.hasMatch() || !sweptConstant.isEmpty()) {
+                runHelpCommand();
+
+                return -1;
+            }
+
+            sweptConstant = match.captured(1);
+
+            foreach (const QString &value, match.captured(2).split(",")) {
+                bool validValue;
+
+                sweptValues << value.toDouble(&validValue);
+
+                if (!validValue) {
+                    runHelpCommand();
+
+                    return -1;
+                }
+            }
+        } else if (!argument.compare("-S")) {
+            specializeOdeRates = true;
+        } else {
+            arguments << argument;
+        }
+    }
+
+    if (   ((arguments.count() != 1) && (arguments.count() != 2))
+        || (specializeOdeRates && sweptConstant.isEmpty())) {
+        runHelpCommand();
+
+        return -1;
+    }
+
+    // Check whether we are dealing with a local or a remote file
+
+    QString errorMessage = QString();
+    bool isLocalFile;
+    QString fileNameOrUrl;
+
+    Core::checkFileNameOrUrl(arguments[0], isLocalFile, fileNameOrUrl);
+
+    QString fileName = fileNameOrUrl;
+
+    if (!isLocalFile) {
+        // We are dealing with a remote file, so try to get a local copy of it
+
+        QByteArray fileContents;
+
+        if (Core::readFileContentsFromUrl(fileNameOrUrl, fileContents, &errorMessage)) {
+            // We were able to retrieve the contents of the remote file, so save
+            // it locally to a 'temporary' file
+
+            fileName = Core::temporaryFileName();
+
+            if (!Core::writeFileContentsToFile(fileName, fileContents))
+                errorMessage = "The file could not be saved locally.";
+        } else {
+            errorMessage = QString("The file could not be opened (%1).").arg(Core::formatMessage(errorMessage));
+        }
+    }
+
+    // At this stage, we should have a real file (be it originally local or
+    // remote), so carry on with the simulation
+
+    if (errorMessage.isEmpty()) {
+        if (!QFile::exists(fileName)) {
+            errorMessage = "The file could not be found.";
+        } else {
+            SingleCellViewCliSimulation *cliSimulation = new SingleCellViewCliSimulation(fileName,
+                                                                                         isLocalFile?QString():fileNameOrUrl,
+                                                                                         mSolverInterfaces);
+
+            // Load our simulation and make sure that only the requested
+            // variables, if any, get output
+
+            if (   cliSimulation->load(errorMessage)
+                && (   variables.isEmpty()
+                    || cliSimulation->setRecordedVariables(variables, errorMessage))) {
+                // Override our simulation settings, if requested
+
+                SingleCellViewSimulationData *data = cliSimulation->simulation()->data();
+
+                if (options.contains("-s"))
+                    data->setStartingPoint(options.value("-s"), false);
+
+                if (options.contains("-e"))
+                    data->setEndingPoint(options.value("-e"));
+
+                if (options.contains("-i"))
+                    data->setPointInterval(options.value("-i"));
+
+                // Run our simulation and output its results as we go along, or
+                // run it for each of the values of our swept constant and
+                // output its final results for each of them
+
+                bool hasOutputFile = arguments.count() == 2;
+                QFile output(hasOutputFile?arguments[1]:QString());
+                bool outputOpened = hasOutputFile?
+                                        output.open(QIODevice::WriteOnly|QIODevice::Truncate):
+                                        output.open(stdout, QIODevice::WriteOnly);
+
+                if (!outputOpened)
+                    errorMessage = "The output file could not be created.";
+                else if (sweptConstant.isEmpty())
+                    cliSimulation->run(&output, errorMessage);
+                else
+                    cliSimulation->runSweep(sweptConstant, sweptValues, specializeOdeRates, &output, errorMessage);
+
+                output.close();
+            }
+
+            delete cliSimulation;
+        }
+    }
+
+    // Delete the temporary file, if any, i.e. we are dealing with a remote file
+    // and it has a temporay file associated with it
+
+    if (!isLocalFile && QFile::exists(fileName))
+        QFile::remove(fileName);
+
+    // Let the user know if something went wrong at some point and then leave
+
+    if (errorMessage.isEmpty()) {
+        return 0;
+    } else {
+        std::cout << errorMessage.toStdString() << std::endl;
+
+        return -1;
+    }
+}
+
+//==============================================================================
+
 SingleCellViewWidget * SingleCellViewPlugin::viewWidget() const
 {
     // Return our view widget
@@ -24,6 +24,7 @@ limitations under the License.
 
 //==============================================================================
 
+#include "cliinterface.h"
 #include "datastoreinterface.h"
 #include "filehandlinginterface.h"
 #include "filetypeinterface.h"
@@ -48,7 +49,8 @@ class SingleCellViewWidget;
 
 //==============================================================================
 
-class SingleCellViewPlugin : public QObject, public FileHandlingInterface,
+class SingleCellViewPlugin : public QObject, public CliInterface,
+                             public FileHandlingInterface,
                              public I18nInterface, public PluginInterface,
                              public ViewInterface
 {
@@ -56,6 +58,7 @@ class SingleCellViewPlugin : public QObject, public FileHandlingInterface,
 
     Q_PLUGIN_METADATA(IID "OpenCOR.SingleCellViewPlugin" FILE "singlecellviewplugin.json")
 
+    Q_INTERFACES(OpenCOR::CliInterface)
     Q_INTERFACES(OpenCOR::FileHandlingInterface)
     Q_INTERFACES(OpenCOR::I18nInterface)
     Q_INTERFACES(OpenCOR::PluginInterface)
@@ -64,6 +67,7 @@ class SingleCellViewPlugin : public QObject, public FileHandlingInterface,
 public:
     explicit SingleCellViewPlugin();
 
+#include "cliinterface.inl"
 #include "filehandlinginterface.inl"
 #include "i18ninterface.inl"
 #include "plugininterface.inl"
@@ -87,6 +91,9 @@ private:
 
     FileTypes mSedmlFileTypes;
     FileTypes mCombineFileTypes;
+
+    void runHelpCommand();
+    int runSimulateCommand(const QStringList &pArguments);
 };
 
 //==============================================================================
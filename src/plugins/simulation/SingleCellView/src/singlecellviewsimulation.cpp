@@ -49,7 +49,9 @@ SingleCellViewSimulationData::SingleCellViewSimulationData(SingleCellViewSimulat
     mDaeSolverName(QString()),
     mDaeSolverProperties(Solver::Solver::Properties()),
     mNlaSolverName(QString()),
-    mNlaSolverProperties(Solver::Solver::Properties())
+    mNlaSolverProperties(Solver::Solver::Properties()),
+    mComputeOdeVariables(0),
+    mComputeDaeVariables(0)
 {
     // Create our various arrays
 
@@ -74,6 +76,8 @@ void SingleCellViewSimulationData::update()
 
     mRuntime = mSimulation->runtime();
 
+    unsliceVariables();
+
     deleteArrays();
     createArrays();
 }
@@ -445,12 +449,17 @@ void SingleCellViewSimulationData::reset(const bool &pInitialize)
 
         nlaSolver = static_cast<Solver::NlaSolver *>(nlaSolverInterface()->solverInstance());
 
-        Solver::setNlaSolver(mRuntime->address(), nlaSolver);
+        mRuntime->nlaSolverRegistry()->setNlaSolver(nlaSolver);
 
         // Keep track of any error that might be reported by our NLA solver
+        // Note: we may be reset from a thread other than ours (e.g. as part of
+        //       a simulation ensemble), in which case our NLA solver lives in
+        //       that thread, hence we need a direct connection for its errors
+        //       to be forwarded straightaway...
 
         connect(nlaSolver, SIGNAL(error(const QString &)),
-                this, SIGNAL(error(const QString &)));
+                this, SIGNAL(error(const QString &)),
+                Qt::DirectConnection);
 
         // Initialise our NLA solver
 
@@ -476,7 +485,7 @@ void SingleCellViewSimulationData::reset(const bool &pInitialize)
     if (nlaSolver) {
         delete nlaSolver;
 
-        Solver::unsetNlaSolver(mRuntime->address());
+        mRuntime->nlaSolverRegistry()->unsetNlaSolver();
     }
 
     // Keep track of our various initial values
@@ -531,12 +540,51 @@ void SingleCellViewSimulationData::recomputeVariables(const double &pCurrentPoin
     if (!mRuntime)
         return;
 
-    // Recompute our 'variables'
+    // Recompute our 'variables', using our sliced functions, if any
+
+    if (mRuntime->modelType() == CellMLSupport::CellmlFileRuntime::Ode) {
+        if (mComputeOdeVariables)
+            mComputeOdeVariables(pCurrentPoint, mConstants, mRates, mStates, mAlgebraic);
+        else
+            mRuntime->computeOdeVariables()(pCurrentPoint, mConstants, mRates, mStates, mAlgebraic);
+    } else {
+        if (mComputeDaeVariables)
+            mComputeDaeVariables(pCurrentPoint, mConstants, mRates, mStates, mAlgebraic, mCondVar);
+        else
+            mRuntime->computeDaeVariables()(pCurrentPoint, mConstants, mRates, mStates, mAlgebraic, mCondVar);
+    }
+}
+
+//==============================================================================
+
+void SingleCellViewSimulationData::sliceVariables(const QList<int> &pAlgebraic)
+{
+    // Only compute the given algebraic variables (and the ones they depend on)
+    // when recomputing our 'variables', if our runtime can generate such a
+    // sliced version of its functions, otherwise compute all of them
+    // Note: this is only meant to be used when not all of our algebraic
+    //       variables are of interest to us (e.g. when only some of them are
+    //       recorded), since the other ones won't get updated anymore...
+
+    unsliceVariables();
+
+    if (!mRuntime || !mRuntime->isValid())
+        return;
 
     if (mRuntime->modelType() == CellMLSupport::CellmlFileRuntime::Ode)
-        mRuntime->computeOdeVariables()(pCurrentPoint, mConstants, mRates, mStates, mAlgebraic);
+        mComputeOdeVariables = mRuntime->slicedComputeOdeVariables(pAlgebraic);
     else
-        mRuntime->computeDaeVariables()(pCurrentPoint, mConstants, mRates, mStates, mAlgebraic, mCondVar);
+        mComputeDaeVariables = mRuntime->slicedComputeDaeVariables(pAlgebraic);
+}
+
+//==============================================================================
+
+void SingleCellViewSimulationData::unsliceVariables()
+{
+    // Compute all our algebraic variables when recomputing our 'variables'
+
+    mComputeOdeVariables = 0;
+    mComputeDaeVariables = 0;
 }
 
 //==============================================================================
@@ -621,6 +669,8 @@ SingleCellViewSimulationResults::SingleCellViewSimulationResults(SingleCellViewS
     mSimulation(pSimulation),
     mRuntime(pSimulation->runtime()),
     mSize(0),
+    mRecordedParameters(CellMLSupport::CellmlFileRuntimeParameters()),
+    mScratchDirName(QString()),
     mDataStore(0),
     mPoints(0),
     mConstants(DataStore::DataStoreVariables()),
@@ -678,10 +728,14 @@ bool SingleCellViewSimulationResults::createDataStore()
 
     // Create our data store and populate it with a variable of integration, as
     // well as with constant, rate, state and algebraic variables
+    // Note: our data store only allocates the memory it needs as data gets
+    //       added to it, so all that we allocate here is a table of chunks
+    //       for each of our variables. That memory may also be memory-mapped
+    //       from files in our scratch directory, if we have one...
 
     try {
         mDataStore = new DataStore::DataStore(mRuntime->cellmlFile()->xmlBase(),
-                                              simulationSize);
+                                              simulationSize, mScratchDirName);
 
         mPoints = mDataStore->addVoi();
         mConstants = mDataStore->addVariables(mRuntime->constantsCount(), mSimulation->data()->constants());
@@ -696,6 +750,19 @@ bool SingleCellViewSimulationResults::createDataStore()
 
     // Customise our variable of integration, as well as our constant, rate,
     // state and algebraic variables
+    // Note #1: we only record the variables that are associated with a
+    //          parameter that is to be recorded, i.e. not the ones that are
+    //          hidden from the user (see DataStoreVariable::isValid()) or not
+    //          part of our recorded parameters, if any...
+    // Note #2: our constants, including our computed constants, are only
+    //          stored once, unless their value changes during the
+    //          simulation...
+
+    foreach (DataStore::DataStoreVariable *variable, mDataStore->variables())
+        variable->setRecorded(false);
+
+    foreach (DataStore::DataStoreVariable *variable, mConstants)
+        variable->setConstant(true);
 
     mPoints->setUri(uri(mRuntime->variableOfIntegration()->componentHierarchy(),
                         mRuntime->variableOfIntegration()->name()));
@@ -731,6 +798,7 @@ bool SingleCellViewSimulationResults::createDataStore()
         }
 
         if (variable) {
+            variable->setRecorded(isRecorded(parameter));
             variable->setUri(uri(parameter->componentHierarchy(),
                                  parameter->formattedName()));
             variable->setLabel(parameter->formattedName());
@@ -756,10 +824,14 @@ void SingleCellViewSimulationResults::deleteDataStore()
 
 void SingleCellViewSimulationResults::update()
 {
-    // Update ourselves by updating our runtime and deleting our data store
+    // Update ourselves by updating our runtime, forgetting about our recorded
+    // parameters (since they belong to our old runtime) and deleting our data
+    // store
 
     mRuntime = mSimulation->runtime();
 
+    mRecordedParameters.clear();
+
     deleteDataStore();
 }
 
@@ -769,7 +841,7 @@ bool SingleCellViewSimulationResults::reset(const bool &pCreateDataStore)
 {
     // Reset our size
 
-    mSize = 0;
+    mSize.storeRelease(0);
 
     // Reset our data store
 
@@ -784,16 +856,30 @@ bool SingleCellViewSimulationResults::reset(const bool &pCreateDataStore)
 
 //==============================================================================
 
-void SingleCellViewSimulationResults::addPoint(const double &pPoint)
+bool SingleCellViewSimulationResults::addPoint(const double &pPoint)
 {
     // Add the data to our data store
+    // Note: our data store allocates its memory as data gets added to it, so
+    //       we may run out of memory, in which case we let our caller know...
 
-    mDataStore->setValues(mSize, pPoint);
+    qulonglong size = mSize.load();
 
-    ++mSize;
-    // Note: we want to do this after the call to DataStore::setValues() since
-    //       it may otherwise mess up our plotting of simulation data (see issue
-    //       #636)...
+    try {
+        mDataStore->setValues(size, pPoint);
+    } catch (...) {
+        return false;
+    }
+
+    mSize.storeRelease(size+1);
+    // Note #1: we want to do this after the call to DataStore::setValues()
+    //          since it may otherwise mess up our plotting of simulation data
+    //          (see issue #636)...
+    // Note #2: our size is published with release semantics and retrieved
+    //          with acquire semantics (see size()), so that whoever sees our
+    //          new size from another thread (e.g. the GUI thread) is also
+    //          guaranteed to see the data we have just added...
+
+    return true;
 }
 
 //==============================================================================
@@ -802,7 +888,74 @@ qulonglong SingleCellViewSimulationResults::size() const
 {
     // Return our size
 
-    return mSize;
+    return mSize.loadAcquire();
+}
+
+//==============================================================================
+
+CellMLSupport::CellmlFileRuntimeParameters SingleCellViewSimulationResults::recordedParameters() const
+{
+    // Return our recorded parameters
+
+    return mRecordedParameters;
+}
+
+//==============================================================================
+
+void SingleCellViewSimulationResults::setRecordedParameters(const CellMLSupport::CellmlFileRuntimeParameters &pRecordedParameters)
+{
+    // Set our recorded parameters
+    // Note #1: an empty list means that all of our parameters are to be
+    //          recorded. Also, this only affects our next data store, i.e. our
+    //          next call to reset()...
+    // Note #2: if only some of our parameters are to be recorded, then our
+    //          simulation data only needs to compute the algebraic variables
+    //          that are to be recorded...
+
+    mRecordedParameters = pRecordedParameters;
+
+    if (mRecordedParameters.isEmpty()) {
+        mSimulation->data()->unsliceVariables();
+    } else {
+        QList<int> algebraic = QList<int>();
+
+        foreach (CellMLSupport::CellmlFileRuntimeParameter *parameter, mRecordedParameters) {
+            if (parameter->type() == CellMLSupport::CellmlFileRuntimeParameter::Algebraic)
+                algebraic << parameter->index();
+        }
+
+        mSimulation->data()->sliceVariables(algebraic);
+    }
+}
+
+//==============================================================================
+
+bool SingleCellViewSimulationResults::isRecorded(CellMLSupport::CellmlFileRuntimeParameter *pParameter) const
+{
+    // Return whether the given parameter is to be recorded
+
+    return mRecordedParameters.isEmpty() || mRecordedParameters.contains(pParameter);
+}
+
+//==============================================================================
+
+QString SingleCellViewSimulationResults::scratchDirName() const
+{
+    // Return the name of our scratch directory
+
+    return mScratchDirName;
+}
+
+//==============================================================================
+
+void SingleCellViewSimulationResults::setScratchDirName(const QString &pScratchDirName)
+{
+    // Set the name of our scratch directory, i.e. the directory where our data
+    // is to be stored (rather than in memory), if not empty
+    // Note: this only affects our next data store, i.e. our next call to
+    //       reset()...
+
+    mScratchDirName = pScratchDirName;
 }
 
 //==============================================================================
@@ -816,47 +969,47 @@ DataStore::DataStore * SingleCellViewSimulationResults::dataStore() const
 
 //==============================================================================
 
-double * SingleCellViewSimulationResults::points() const
+DataStore::DataStoreVariable * SingleCellViewSimulationResults::points() const
 {
     // Return our points
 
-    return mPoints?mPoints->values():0;
+    return mPoints;
 }
 
 //==============================================================================
 
-double * SingleCellViewSimulationResults::constants(const int &pIndex) const
+DataStore::DataStoreVariable * SingleCellViewSimulationResults::constants(const int &pIndex) const
 {
     // Return our constants data at the given index
 
-    return mConstants.isEmpty()?0:mConstants[pIndex]->values();
+    return mConstants.isEmpty()?0:mConstants[pIndex];
 }
 
 //==============================================================================
 
-double * SingleCellViewSimulationResults::rates(const int &pIndex) const
+DataStore::DataStoreVariable * SingleCellViewSimulationResults::rates(const int &pIndex) const
 {
     // Return our rates data at the given index
 
-    return mRates.isEmpty()?0:mRates[pIndex]->values();
+    return mRates.isEmpty()?0:mRates[pIndex];
 }
 
 //==============================================================================
 
-double * SingleCellViewSimulationResults::states(const int &pIndex) const
+DataStore::DataStoreVariable * SingleCellViewSimulationResults::states(const int &pIndex) const
 {
     // Return our states data at the given index
 
-    return mStates.isEmpty()?0:mStates[pIndex]->values();
+    return mStates.isEmpty()?0:mStates[pIndex];
 }
 
 //==============================================================================
 
-double * SingleCellViewSimulationResults::algebraic(const int &pIndex) const
+DataStore::DataStoreVariable * SingleCellViewSimulationResults::algebraic(const int &pIndex) const
 {
     // Return our algebraic data at the given index
 
-    return mAlgebraic.isEmpty()?0:mAlgebraic[pIndex]->values();
+    return mAlgebraic.isEmpty()?0:mAlgebraic[pIndex];
 }
 
 //==============================================================================
@@ -988,15 +1141,40 @@ double SingleCellViewSimulation::requiredMemory()
     //          see [OpenCOR]/src/plugins/miscellaneous/Core/src/guiutils.cpp)
     //          in case a simulation requires an insane amount of memory...
     // Note #2: the 1.0 is for mPoints in SingleCellViewSimulationResults...
+    // Note #3: this is the amount of memory needed to complete our simulation,
+    //          but it gets allocated as our simulation progresses...
+    // Note #4: we only account for the parameters that are to be recorded,
+    //          with our constants being stored only once (assuming that they
+    //          don't get modified during our simulation)...
 
     if (mRuntime) {
-        return  size()
-               *( 1.0
-                 +mRuntime->constantsCount()
-                 +mRuntime->ratesCount()
-                 +mRuntime->statesCount()
-                 +mRuntime->algebraicCount())
-               *Solver::SizeOfDouble;
+        double constantsCount = 0.0;
+        double variablesCount = 1.0;
+
+        foreach (CellMLSupport::CellmlFileRuntimeParameter *parameter, mRuntime->parameters()) {
+            if (!mResults->isRecorded(parameter))
+                continue;
+
+            switch (parameter->type()) {
+            case CellMLSupport::CellmlFileRuntimeParameter::Constant:
+            case CellMLSupport::CellmlFileRuntimeParameter::ComputedConstant:
+                ++constantsCount;
+
+                break;
+            case CellMLSupport::CellmlFileRuntimeParameter::Rate:
+            case CellMLSupport::CellmlFileRuntimeParameter::State:
+            case CellMLSupport::CellmlFileRuntimeParameter::Algebraic:
+                ++variablesCount;
+
+                break;
+            default:
+                // Not a relevant type, so do nothing
+
+                ;
+            }
+        }
+
+        return (constantsCount+size()*variablesCount)*Solver::SizeOfDouble;
     } else {
         return 0.0;
     }
@@ -24,12 +24,14 @@ limitations under the License.
 
 //==============================================================================
 
+#include "cellmlfileruntime.h"
 #include "datastoreinterface.h"
 #include "singlecellviewsimulationworker.h"
 #include "solverinterface.h"
 
 //==============================================================================
 
+#include <QAtomicInteger>
 #include <QObject>
 
 //==============================================================================
@@ -38,12 +40,6 @@ namespace OpenCOR {
 
 //==============================================================================
 
-namespace CellMLSupport {
-    class CellmlFileRuntime;
-}   // namespace CellMLSupport
-
-//==============================================================================
-
 namespace SingleCellView {
 
 //==============================================================================
@@ -116,6 +112,9 @@ public:
                                                 const bool &pInitialize = true);
     void recomputeVariables(const double &pCurrentPoint);
 
+    void sliceVariables(const QList<int> &pAlgebraic);
+    void unsliceVariables();
+
     bool isModified() const;
     void checkForModifications();
 
@@ -151,6 +150,9 @@ private:
     double *mInitialConstants;
     double *mInitialStates;
 
+    CellMLSupport::CellmlFileRuntime::ComputeOdeVariablesFunction mComputeOdeVariables;
+    CellMLSupport::CellmlFileRuntime::ComputeDaeVariablesFunction mComputeDaeVariables;
+
     void createArrays();
     void deleteArrays();
 
@@ -175,25 +177,40 @@ public:
 
     bool reset(const bool &pCreateDataStore = true);
 
-    void addPoint(const double &pPoint);
+    bool addPoint(const double &pPoint);
 
     qulonglong size() const;
 
+    CellMLSupport::CellmlFileRuntimeParameters recordedParameters() const;
+    void setRecordedParameters(const CellMLSupport::CellmlFileRuntimeParameters &pRecordedParameters);
+
+    bool isRecorded(CellMLSupport::CellmlFileRuntimeParameter *pParameter) const;
+
+    QString scratchDirName() const;
+    void setScratchDirName(const QString &pScratchDirName);
+
     DataStore::DataStore * dataStore() const;
 
-    double * points() const;
+    DataStore::DataStoreVariable * points() const;
+
+    DataStore::DataStoreVariable * constants(const int &pIndex) const;
+    DataStore::DataStoreVariable * rates(const int &pIndex) const;
+    DataStore::DataStoreVariable * states(const int &pIndex) const;
+    DataStore::DataStoreVariable * algebraic(const int &pIndex) const;
 
-    double * constants(const int &pIndex) const;
-    double * rates(const int &pIndex) const;
-    double * states(const int &pIndex) const;
-    double * algebraic(const int &pIndex) const;
+    static QString uri(const QStringList &pComponentHierarchy,
+                       const QString &pName);
 
 private:
     SingleCellViewSimulation *mSimulation;
 
     CellMLSupport::CellmlFileRuntime *mRuntime;
 
-    qulonglong mSize;
+    QAtomicInteger<qulonglong> mSize;
+
+    CellMLSupport::CellmlFileRuntimeParameters mRecordedParameters;
+
+    QString mScratchDirName;
 
     DataStore::DataStore *mDataStore;
 
@@ -206,8 +223,6 @@ private:
 
     bool createDataStore();
     void deleteDataStore();
-
-    QString uri(const QStringList &pComponentHierarchy, const QString &pName);
 };
 
 //==============================================================================
@@ -216,6 +231,7 @@ class SingleCellViewSimulation : public QObject
 {
     Q_OBJECT
 
+    friend class SingleCellViewCliSimulation;
     friend class SingleCellViewSimulationWorker;
 
 public:
@@ -0,0 +1,854 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Single Cell view simulation ensemble
+//==============================================================================
+
+#include "cellmlfileruntime.h"
+#include "singlecellviewsimulation.h"
+#include "singlecellviewsimulationensemble.h"
+
+//==============================================================================
+
+#include <QElapsedTimer>
+#include <QThread>
+#include <QThreadPool>
+#include <QtNumeric>
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace SingleCellView {
+
+//==============================================================================
+
+SingleCellViewSimulationEnsembleRun::SingleCellViewSimulationEnsembleRun(SingleCellViewSimulation *pSimulation,
+                                                                         const SingleCellViewSimulationEnsembleValues &pConstants,
+                                                                         const SingleCellViewSimulationEnsembleValues &pStates) :
+    mSimulation(pSimulation),
+    mConstants(pConstants),
+    mStates(pStates),
+    mComputeOdeRates(0),
+    mError(false),
+    mErrorMessage(QString()),
+    mElapsedTime(-1),
+    mFinalStates(QVector<double>())
+{
+    // We are owned by our ensemble, so make sure that our thread pool doesn't
+    // delete us once we have run
+
+    setAutoDelete(false);
+
+    // Keep track of any error that might be reported by our simulation data
+    // Note #1: our simulation data lives in the main thread while we are run
+    //          in one of our thread pool's threads, hence we need a direct
+    //          connection...
+    // Note #2: we connect to our simulation data rather than to our
+    //          simulation since the latter only forwards the errors of the
+    //          former through an automatic connection, i.e. a queued one when
+    //          they are reported from one of our thread pool's threads...
+
+    connect(mSimulation->data(), SIGNAL(error(const QString &)),
+            this, SLOT(emitError(const QString &)),
+            Qt::DirectConnection);
+}
+
+//==============================================================================
+
+SingleCellViewSimulationEnsembleRun::~SingleCellViewSimulationEnsembleRun()
+{
+    // Delete some internal objects
+
+    delete mSimulation;
+}
+
+//==============================================================================
+
+void SingleCellViewSimulationEnsembleRun::run()
+{
+    // Start our timer
+
+    QElapsedTimer timer;
+
+    timer.start();
+
+    // Initialise our simulation data
+
+    CellMLSupport::CellmlFileRuntime *runtime = mSimulation->runtime();
+    SingleCellViewSimulationData *data = mSimulation->data();
+
+    resetData();
+
+    // Set up our ODE/DAE solver and our NLA solver, if needed
+    // Note: the solvers are created in our thread, so that they get deleted in
+    //       it too...
+
+    Solver::VoiSolver *voiSolver = 0;
+    Solver::OdeSolver *odeSolver = 0;
+    Solver::DaeSolver *daeSolver = 0;
+    Solver::NlaSolver *nlaSolver = 0;
+
+    if (!mError) {
+        if (runtime->needOdeSolver())
+            voiSolver = odeSolver = static_cast<Solver::OdeSolver *>(data->odeSolverInterface()->solverInstance());
+        else
+            voiSolver = daeSolver = static_cast<Solver::DaeSolver *>(data->daeSolverInterface()->solverInstance());
+
+        connect(voiSolver, SIGNAL(error(const QString &)),
+                this, SLOT(emitError(const QString &)),
+                Qt::DirectConnection);
+
+        if (runtime->needNlaSolver()) {
+            nlaSolver = static_cast<Solver::NlaSolver *>(data->nlaSolverInterface()->solverInstance());
+
+            runtime->nlaSolverRegistry()->setNlaSolver(nlaSolver);
+
+            connect(nlaSolver, SIGNAL(error(const QString &)),
+                    this, SLOT(emitError(const QString &)),
+                    Qt::DirectConnection);
+
+            nlaSolver->setProperties(data->nlaSolverProperties());
+        }
+    }
+
+    // Recompute our 'computed constants' and 'variables'
+    // Note: we do this now that our NLA solver, if any, has been set for our
+    //       thread. Also, we recompute things without initialisation, so that
+    //       our overridden states don't get reset...
+
+    data->recomputeComputedConstantsAndVariables(data->startingPoint(), false);
+
+    // Create our own data store
+
+    resetResults();
+
+    // Initialise our ODE/DAE solver and compute our model
+
+    if (voiSolver) {
+        double startingPoint = data->startingPoint();
+        double endingPoint = data->endingPoint();
+        double pointInterval = data->pointInterval();
+
+        bool increasingPoints = endingPoint > startingPoint;
+        quint64 pointCounter = 0;
+
+        double currentPoint = startingPoint;
+
+        if (odeSolver) {
+            odeSolver->setProperties(data->odeSolverProperties());
+            odeSolver->setComputeJacobian(runtime->computeOdeJacobian(),
+                                          runtime->algebraicCount());
+
+            odeSolver->initialize(currentPoint,
+                                  runtime->statesCount(),
+                                  data->constants(), data->rates(),
+                                  data->states(), data->algebraic(),
+                                  mComputeOdeRates?
+                                      mComputeOdeRates:
+                                      runtime->computeOdeRates());
+        } else {
+            daeSolver->setProperties(data->daeSolverProperties());
+
+            daeSolver->initialize(currentPoint, endingPoint,
+                                  runtime->statesCount(),
+                                  runtime->condVarCount(),
+                                  data->constants(), data->rates(),
+                                  data->states(), data->algebraic(),
+                                  data->condVar(),
+                                  runtime->computeDaeEssentialVariables(),
+                                  runtime->computeDaeResiduals(),
+                                  runtime->computeDaeRootInformation(),
+                                  runtime->computeDaeStateInformation());
+        }
+
+        if (!mError) {
+            addPoint(currentPoint);
+
+            while (!mError && (currentPoint != endingPoint)) {
+                ++pointCounter;
+
+                voiSolver->solve(currentPoint,
+                                 increasingPoints?
+                                     qMin(endingPoint, startingPoint+pointCounter*pointInterval):
+                                     qMax(endingPoint, startingPoint+pointCounter*pointInterval));
+
+                addPoint(currentPoint);
+            }
+        }
+
+        // Delete our solver(s)
+
+        delete voiSolver;
+
+        if (nlaSolver) {
+            delete nlaSolver;
+
+            runtime->nlaSolverRegistry()->unsetNlaSolver();
+        }
+    }
+
+    // Keep track of our final states and of how long we took
+
+    finalize(timer.elapsed());
+}
+
+//==============================================================================
+
+void SingleCellViewSimulationEnsembleRun::resetData()
+{
+    // Reset our simulation data and override some of our constants and states
+
+    CellMLSupport::CellmlFileRuntime *runtime = mSimulation->runtime();
+    SingleCellViewSimulationData *data = mSimulation->data();
+
+    data->reset();
+
+    for (auto constant = mConstants.constBegin(), constantEnd = mConstants.constEnd();
+         constant != constantEnd; ++constant) {
+        if ((constant.key() >= 0) && (constant.key() < runtime->constantsCount()))
+            data->constants()[constant.key()] = constant.value();
+    }
+
+    for (auto state = mStates.constBegin(), stateEnd = mStates.constEnd();
+         state != stateEnd; ++state) {
+        if ((state.key() >= 0) && (state.key() < runtime->statesCount()))
+            data->states()[state.key()] = state.value();
+    }
+}
+
+//==============================================================================
+
+void SingleCellViewSimulationEnsembleRun::resetResults()
+{
+    // Create our own data store
+
+    if (!mError && !mSimulation->results()->reset())
+        emitError(tr("the memory required for the simulation could not be allocated"));
+}
+
+//==============================================================================
+
+void SingleCellViewSimulationEnsembleRun::addPoint(const double &pPoint)
+{
+    // Recompute our variables and add the given point to our results, unless
+    // an error occurred
+
+    if (mError)
+        return;
+
+    mSimulation->data()->recomputeVariables(pPoint);
+
+    if (!mSimulation->results()->addPoint(pPoint))
+        emitError(tr("the memory required for the simulation could not be allocated"));
+}
+
+//==============================================================================
+
+void SingleCellViewSimulationEnsembleRun::finalize(const qint64 &pElapsedTime)
+{
+    // Keep track of our final states and of how long we took
+
+    if (!mError) {
+        int statesCount = mSimulation->runtime()->statesCount();
+
+        mFinalStates = QVector<double>(statesCount);
+
+        memcpy(mFinalStates.data(), mSimulation->data()->states(), statesCount*Solver::SizeOfDouble);
+    }
+
+    mElapsedTime = pElapsedTime;
+}
+
+//==============================================================================
+
+SingleCellViewSimulation * SingleCellViewSimulationEnsembleRun::simulation() const
+{
+    // Return our simulation, which gives access to our data and results
+
+    return mSimulation;
+}
+
+//==============================================================================
+
+bool SingleCellViewSimulationEnsembleRun::isSuccessful() const
+{
+    // Return whether we ran successfully
+
+    return !mError && (mElapsedTime != -1);
+}
+
+//==============================================================================
+
+QString SingleCellViewSimulationEnsembleRun::errorMessage() const
+{
+    // Return our error message, if any
+
+    return mErrorMessage;
+}
+
+//==============================================================================
+
+qint64 SingleCellViewSimulationEnsembleRun::elapsedTime() const
+{
+    // Return the time it took us to run
+
+    return mElapsedTime;
+}
+
+//==============================================================================
+
+QVector<double> SingleCellViewSimulationEnsembleRun::finalStates() const
+{
+    // Return our final states
+
+    return mFinalStates;
+}
+
+//==============================================================================
+
+void SingleCellViewSimulationEnsembleRun::emitError(const QString &pMessage)
+{
+    // An error occurred, so keep track of it
+    // Note: we only keep track of the first error since the other ones are
+    //       likely to be a consequence of it...
+
+    if (!mError) {
+        mError = true;
+        mErrorMessage = pMessage;
+    }
+}
+
+//==============================================================================
+
+SingleCellViewSimulationEnsembleBatch::SingleCellViewSimulationEnsembleBatch(const SingleCellViewSimulationEnsembleRuns &pRuns,
+                                                                             const int &pLanesCount) :
+    mRuns(pRuns),
+    mLanesCount(pLanesCount),
+    mError(false)
+{
+    // We are owned by our ensemble, so make sure that our thread pool doesn't
+    // delete us once we have run
+
+    setAutoDelete(false);
+}
+
+//==============================================================================
+
+void SingleCellViewSimulationEnsembleBatch::run()
+{
+    // Start our timer
+
+    QElapsedTimer timer;
+
+    timer.start();
+
+    // Initialise the simulation data of our runs
+    // Note: we are only used for ODE models that don't need an NLA solver, so
+    //       there is no NLA solver to set for our thread...
+
+    SingleCellViewSimulation *simulation = mRuns.first()->simulation();
+    CellMLSupport::CellmlFileRuntime *runtime = simulation->runtime();
+    SingleCellViewSimulationData *data = simulation->data();
+
+    double startingPoint = data->startingPoint();
+    double endingPoint = data->endingPoint();
+    double pointInterval = data->pointInterval();
+
+    foreach (SingleCellViewSimulationEnsembleRun *run, mRuns) {
+        run->resetData();
+
+        run->simulation()->data()->recomputeComputedConstantsAndVariables(startingPoint, false);
+
+        run->resetResults();
+    }
+
+    // Interleave the constants, rates, states and algebraic variables of our
+    // runs, so that they can be integrated in lockstep
+    // Note: if we have fewer runs than lanes, then our extra lanes replicate
+    //       our last run, and their results are simply ignored...
+
+    int constantsCount = runtime->constantsCount();
+    int statesCount = runtime->statesCount();
+    int algebraicCount = runtime->algebraicCount();
+    int runsCount = mRuns.count();
+
+    QVector<double> constants = QVector<double>(qMax(1, constantsCount*mLanesCount));
+    QVector<double> rates = QVector<double>(qMax(1, statesCount*mLanesCount));
+    QVector<double> states = QVector<double>(qMax(1, statesCount*mLanesCount));
+    QVector<double> algebraic = QVector<double>(qMax(1, algebraicCount*mLanesCount));
+
+    for (int l = 0; l < mLanesCount; ++l) {
+        SingleCellViewSimulationData *laneData = mRuns[qMin(l, runsCount-1)]->simulation()->data();
+
+        for (int i = 0; i < constantsCount; ++i)
+            constants[i*mLanesCount+l] = laneData->constants()[i];
+
+        for (int i = 0; i < statesCount; ++i) {
+            rates[i*mLanesCount+l] = laneData->rates()[i];
+            states[i*mLanesCount+l] = laneData->states()[i];
+        }
+
+        for (int i = 0; i < algebraicCount; ++i)
+            algebraic[i*mLanesCount+l] = laneData->algebraic()[i];
+    }
+
+    // Set up and initialise our ODE solver, and compute our model
+
+    Solver::OdeSolver *odeSolver = static_cast<Solver::OdeSolver *>(data->odeSolverInterface()->solverInstance());
+
+    connect(odeSolver, SIGNAL(error(const QString &)),
+            this, SLOT(emitError(const QString &)),
+            Qt::DirectConnection);
+
+    bool increasingPoints = endingPoint > startingPoint;
+    quint64 pointCounter = 0;
+
+    double currentPoint = startingPoint;
+
+    odeSolver->setProperties(data->odeSolverProperties());
+    odeSolver->setLanesCount(mLanesCount);
+
+    odeSolver->initialize(currentPoint, statesCount,
+                          constants.data(), rates.data(), states.data(),
+                          algebraic.data(), runtime->computeOdeRatesBatch());
+
+    if (!mError) {
+        foreach (SingleCellViewSimulationEnsembleRun *run, mRuns)
+            run->addPoint(currentPoint);
+
+        while (isRunning() && (currentPoint != endingPoint)) {
+            ++pointCounter;
+
+            odeSolver->solve(currentPoint,
+                             increasingPoints?
+                                 qMin(endingPoint, startingPoint+pointCounter*pointInterval):
+                                 qMax(endingPoint, startingPoint+pointCounter*pointInterval));
+
+            if (mError)
+                break;
+
+            // Hand their new rates and states back to our runs, so that they
+            // can recompute their variables and update their results
+
+            for (int l = 0; l < runsCount; ++l) {
+                double *runRates = mRuns[l]->simulation()->data()->rates();
+                double *runStates = mRuns[l]->simulation()->data()->states();
+
+                for (int i = 0; i < statesCount; ++i) {
+                    runRates[i] = rates[i*mLanesCount+l];
+                    runStates[i] = states[i*mLanesCount+l];
+                }
+
+                mRuns[l]->addPoint(currentPoint);
+            }
+        }
+    }
+
+    delete odeSolver;
+
+    // Let our runs keep track of their final states and of how long they took,
+    // i.e. their share of the time we took
+
+    qint64 elapsedTime = timer.elapsed()/runsCount;
+
+    foreach (SingleCellViewSimulationEnsembleRun *run, mRuns)
+        run->finalize(elapsedTime);
+}
+
+//==============================================================================
+
+bool SingleCellViewSimulationEnsembleBatch::isRunning() const
+{
+    // We are running as long as at least one of our runs is still fine
+
+    if (mError)
+        return false;
+
+    foreach (SingleCellViewSimulationEnsembleRun *run, mRuns) {
+        if (!run->mError)
+            return true;
+    }
+
+    return false;
+}
+
+//==============================================================================
+
+void SingleCellViewSimulationEnsembleBatch::emitError(const QString &pMessage)
+{
+    // Our ODE solver reported an error, which affects all our runs
+
+    mError = true;
+
+    foreach (SingleCellViewSimulationEnsembleRun *run, mRuns)
+        run->emitError(pMessage);
+}
+
+//==============================================================================
+
+SingleCellViewSimulationEnsembleSummary::SingleCellViewSimulationEnsembleSummary() :
+    mRunsCount(0),
+    mSuccessfulRunsCount(0),
+    mElapsedTime(0),
+    mTotalRunsTime(0),
+    mFinalStatesMinimum(QVector<double>()),
+    mFinalStatesMaximum(QVector<double>()),
+    mFinalStatesMean(QVector<double>())
+{
+}
+
+//==============================================================================
+
+int SingleCellViewSimulationEnsembleSummary::runsCount() const
+{
+    // Return our number of runs
+
+    return mRunsCount;
+}
+
+//==============================================================================
+
+int SingleCellViewSimulationEnsembleSummary::successfulRunsCount() const
+{
+    // Return our number of successful runs
+
+    return mSuccessfulRunsCount;
+}
+
+//==============================================================================
+
+qint64 SingleCellViewSimulationEnsembleSummary::elapsedTime() const
+{
+    // Return the time it took to run our ensemble
+
+    return mElapsedTime;
+}
+
+//==============================================================================
+
+qint64 SingleCellViewSimulationEnsembleSummary::totalRunsTime() const
+{
+    // Return the sum of the time it took to run each of our runs
+
+    return mTotalRunsTime;
+}
+
+//==============================================================================
+
+QVector<double> SingleCellViewSimulationEnsembleSummary::finalStatesMinimum() const
+{
+    // Return the minimum of our final states over our successful runs
+
+    return mFinalStatesMinimum;
+}
+
+//==============================================================================
+
+QVector<double> SingleCellViewSimulationEnsembleSummary::finalStatesMaximum() const
+{
+    // Return the maximum of our final states over our successful runs
+
+    return mFinalStatesMaximum;
+}
+
+//==============================================================================
+
+QVector<double> SingleCellViewSimulationEnsembleSummary::finalStatesMean() const
+{
+    // Return the mean of our final states over our successful runs
+
+    return mFinalStatesMean;
+}
+
+//==============================================================================
+
+SingleCellViewSimulationEnsemble::SingleCellViewSimulationEnsemble(SingleCellViewSimulation *pSimulation,
+                                                                   const SolverInterfaces &pSolverInterfaces) :
+    mSimulation(pSimulation),
+    mSolverInterfaces(pSolverInterfaces),
+    mMaximumThreadCount(QThread::idealThreadCount()),
+    mSpecializeOdeRates(false),
+    mRuns(SingleCellViewSimulationEnsembleRuns()),
+    mSummary(SingleCellViewSimulationEnsembleSummary())
+{
+}
+
+//==============================================================================
+
+SingleCellViewSimulationEnsemble::~SingleCellViewSimulationEnsemble()
+{
+    // Delete some internal objects
+
+    foreach (SingleCellViewSimulationEnsembleRun *run, mRuns)
+        delete run;
+}
+
+//==============================================================================
+
+int SingleCellViewSimulationEnsemble::addRun(const SingleCellViewSimulationEnsembleValues &pConstants,
+                                             const SingleCellViewSimulationEnsembleValues &pStates)
+{
+    // Create a simulation that shares the runtime (and therefore the compiled
+    // code) of our reference simulation, but that has its own data and
+    // results, and customise it using the settings of our reference simulation
+
+    SingleCellViewSimulation *simulation = new SingleCellViewSimulation(mSimulation->runtime(),
+                                                                        mSolverInterfaces);
+    SingleCellViewSimulationData *referenceData = mSimulation->data();
+    SingleCellViewSimulationData *data = simulation->data();
+
+    data->setStartingPoint(referenceData->startingPoint(), false);
+    data->setEndingPoint(referenceData->endingPoint());
+    data->setPointInterval(referenceData->pointInterval());
+
+    data->setOdeSolverName(referenceData->odeSolverName());
+    data->setDaeSolverName(referenceData->daeSolverName());
+    data->setNlaSolverName(referenceData->nlaSolverName(), false);
+
+    Solver::Solver::Properties properties = referenceData->odeSolverProperties();
+
+    for (auto property = properties.constBegin(), propertyEnd = properties.constEnd();
+         property != propertyEnd; ++property) {
+        data->addOdeSolverProperty(property.key(), property.value());
+    }
+
+    properties = referenceData->daeSolverProperties();
+
+    for (auto property = properties.constBegin(), propertyEnd = properties.constEnd();
+         property != propertyEnd; ++property) {
+        data->addDaeSolverProperty(property.key(), property.value());
+    }
+
+    properties = referenceData->nlaSolverProperties();
+
+    for (auto property = properties.constBegin(), propertyEnd = properties.constEnd();
+         property != propertyEnd; ++property) {
+        data->addNlaSolverProperty(property.key(), property.value(), false);
+    }
+
+    // Only record the parameters that our reference simulation records
+
+    simulation->results()->setRecordedParameters(mSimulation->results()->recordedParameters());
+
+    // Keep track of our new run
+
+    mRuns << new SingleCellViewSimulationEnsembleRun(simulation, pConstants, pStates);
+
+    return mRuns.count()-1;
+}
+
+//==============================================================================
+
+int SingleCellViewSimulationEnsemble::runsCount() const
+{
+    // Return our number of runs
+
+    return mRuns.count();
+}
+
+//==============================================================================
+
+SingleCellViewSimulationEnsembleRun * SingleCellViewSimulationEnsemble::ensembleRun(const int &pIndex) const
+{
+    // Return the requested run
+
+    return ((pIndex >= 0) && (pIndex < mRuns.count()))?mRuns[pIndex]:0;
+}
+
+//==============================================================================
+
+int SingleCellViewSimulationEnsemble::maximumThreadCount() const
+{
+    // Return our maximum number of threads
+
+    return mMaximumThreadCount;
+}
+
+//==============================================================================
+
+void SingleCellViewSimulationEnsemble::setMaximumThreadCount(const int &pMaximumThreadCount)
+{
+    // Set our maximum number of threads
+
+    mMaximumThreadCount = qMax(1, pMaximumThreadCount);
+}
+
+//==============================================================================
+
+bool SingleCellViewSimulationEnsemble::specializeOdeRates() const
+{
+    // Return whether our runs use a version of computeOdeRates() that is
+    // specialised for them
+
+    return mSpecializeOdeRates;
+}
+
+//==============================================================================
+
+void SingleCellViewSimulationEnsemble::setSpecializeOdeRates(const bool &pSpecializeOdeRates)
+{
+    // Set whether our runs use a version of computeOdeRates() that is
+    // specialised for them, i.e. where all the constants that are not
+    // overridden by any of our runs are inlined
+
+    mSpecializeOdeRates = pSpecializeOdeRates;
+}
+
+//==============================================================================
+
+bool SingleCellViewSimulationEnsemble::run()
+{
+    // Run all our runs using a thread pool, which threads pick up the next
+    // pending run as soon as they are done with their current one, and wait for
+    // all of them to be done
+
+    QElapsedTimer timer;
+
+    timer.start();
+
+    // Note: if possible, our runs are grouped in batches, which runs are
+    //       integrated in lockstep...
+
+    QThreadPool threadPool;
+
+    threadPool.setMaxThreadCount(mMaximumThreadCount);
+
+    // Specialise computeOdeRates() for our runs, if requested and possible,
+    // i.e. inline all the constants that are not overridden by any of our runs
+    // Note #1: this is done before starting any of our runs since it involves
+    //          compiling some code, and our runtime is shared by all of them...
+    // Note #2: a specialised function takes precedence over batches, which
+    //          would otherwise use our generic computeOdeRatesBatch()...
+
+    CellMLSupport::CellmlFileRuntime::ComputeOdeRatesFunction computeOdeRates = 0;
+
+    if (mSpecializeOdeRates && mSimulation->runtime()->needOdeSolver()) {
+        QList<int> varyingConstants = QList<int>();
+
+        foreach (SingleCellViewSimulationEnsembleRun *run, mRuns)
+            varyingConstants << run->mConstants.keys();
+
+        computeOdeRates = mSimulation->runtime()->specializedComputeOdeRates(varyingConstants);
+    }
+
+    foreach (SingleCellViewSimulationEnsembleRun *run, mRuns)
+        run->mComputeOdeRates = computeOdeRates;
+
+    int lanesCount = computeOdeRates?1:this->lanesCount();
+    QList<SingleCellViewSimulationEnsembleBatch *> batches = QList<SingleCellViewSimulationEnsembleBatch *>();
+
+    if (lanesCount > 1) {
+        for (int i = 0, iMax = mRuns.count(); i < iMax; i += lanesCount) {
+            batches << new SingleCellViewSimulationEnsembleBatch(mRuns.mid(i, lanesCount), lanesCount);
+
+            threadPool.start(batches.last());
+        }
+    } else {
+        foreach (SingleCellViewSimulationEnsembleRun *run, mRuns)
+            threadPool.start(run);
+    }
+
+    threadPool.waitForDone();
+
+    qDeleteAll(batches);
+
+    // Aggregate the summaries of our runs
+
+    int statesCount = mSimulation->runtime()->statesCount();
+
+    mSummary = SingleCellViewSimulationEnsembleSummary();
+
+    mSummary.mRunsCount = mRuns.count();
+    mSummary.mElapsedTime = timer.elapsed();
+    mSummary.mFinalStatesMinimum = QVector<double>(statesCount, qInf());
+    mSummary.mFinalStatesMaximum = QVector<double>(statesCount, -qInf());
+    mSummary.mFinalStatesMean = QVector<double>(statesCount, 0.0);
+
+    foreach (SingleCellViewSimulationEnsembleRun *run, mRuns) {
+        mSummary.mTotalRunsTime += qMax(qint64(0), run->elapsedTime());
+
+        if (!run->isSuccessful())
+            continue;
+
+        ++mSummary.mSuccessfulRunsCount;
+
+        QVector<double> finalStates = run->finalStates();
+
+        for (int i = 0; i < statesCount; ++i) {
+            mSummary.mFinalStatesMinimum[i] = qMin(mSummary.mFinalStatesMinimum[i], finalStates[i]);
+            mSummary.mFinalStatesMaximum[i] = qMax(mSummary.mFinalStatesMaximum[i], finalStates[i]);
+            mSummary.mFinalStatesMean[i] += finalStates[i];
+        }
+    }
+
+    if (mSummary.mSuccessfulRunsCount) {
+        for (int i = 0; i < statesCount; ++i)
+            mSummary.mFinalStatesMean[i] /= mSummary.mSuccessfulRunsCount;
+    } else {
+        mSummary.mFinalStatesMinimum.clear();
+        mSummary.mFinalStatesMaximum.clear();
+        mSummary.mFinalStatesMean.clear();
+    }
+
+    return mSummary.mSuccessfulRunsCount == mSummary.mRunsCount;
+}
+
+//==============================================================================
+
+SingleCellViewSimulationEnsembleSummary SingleCellViewSimulationEnsemble::summary() const
+{
+    // Return the summary of our last run
+
+    return mSummary;
+}
+
+//==============================================================================
+
+int SingleCellViewSimulationEnsemble::lanesCount() const
+{
+    // Determine the number of lanes to use to run our runs, i.e. more than one
+    // only if we have several runs of an ODE model that doesn't need an NLA
+    // solver, which code could be generated for several lanes, and if our ODE
+    // solver supports lanes
+
+    CellMLSupport::CellmlFileRuntime *runtime = mSimulation->runtime();
+    SolverInterface *odeSolverInterface = mSimulation->data()->odeSolverInterface();
+
+    if (   (mRuns.count() < 2) || !runtime->needOdeSolver()
+        || runtime->needNlaSolver() || !runtime->computeOdeRatesBatch()
+        || !odeSolverInterface) {
+        return 1;
+    }
+
+    Solver::OdeSolver *odeSolver = static_cast<Solver::OdeSolver *>(odeSolverInterface->solverInstance());
+    bool supportsLanes = odeSolver->supportsLanes();
+
+    delete odeSolver;
+
+    return supportsLanes?runtime->odeBatchLanesCount():1;
+}
+
+//==============================================================================
+
+}   // namespace SingleCellView
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -0,0 +1,216 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Single Cell view simulation ensemble
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include "cellmlfileruntime.h"
+#include "solverinterface.h"
+
+//==============================================================================
+
+#include <QList>
+#include <QMap>
+#include <QObject>
+#include <QRunnable>
+#include <QVector>
+
+//==============================================================================
+
+namespace OpenCOR {
+
+//==============================================================================
+
+namespace SingleCellView {
+
+//==============================================================================
+
+class SingleCellViewSimulation;
+
+//==============================================================================
+
+typedef QMap<int, double> SingleCellViewSimulationEnsembleValues;
+
+//==============================================================================
+
+class SingleCellViewSimulationEnsembleRun : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+    friend class SingleCellViewSimulationEnsemble;
+    friend class SingleCellViewSimulationEnsembleBatch;
+
+public:
+    explicit SingleCellViewSimulationEnsembleRun(SingleCellViewSimulation *pSimulation,
+                                                 const SingleCellViewSimulationEnsembleValues &pConstants,
+                                                 const SingleCellViewSimulationEnsembleValues &pStates);
+    ~SingleCellViewSimulationEnsembleRun();
+
+    virtual void run();
+
+    SingleCellViewSimulation * simulation() const;
+
+    bool isSuccessful() const;
+    QString errorMessage() const;
+
+    qint64 elapsedTime() const;
+
+    QVector<double> finalStates() const;
+
+private:
+    SingleCellViewSimulation *mSimulation;
+
+    SingleCellViewSimulationEnsembleValues mConstants;
+    SingleCellViewSimulationEnsembleValues mStates;
+
+    CellMLSupport::CellmlFileRuntime::ComputeOdeRatesFunction mComputeOdeRates;
+
+    bool mError;
+    QString mErrorMessage;
+
+    qint64 mElapsedTime;
+
+    QVector<double> mFinalStates;
+
+    void resetData();
+    void resetResults();
+
+    void addPoint(const double &pPoint);
+
+    void finalize(const qint64 &pElapsedTime);
+
+private slots:
+    void emitError(const QString &pMessage);
+};
+
+//==============================================================================
+
+typedef QList<SingleCellViewSimulationEnsembleRun *> SingleCellViewSimulationEnsembleRuns;
+
+//==============================================================================
+
+class SingleCellViewSimulationEnsembleBatch : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    explicit SingleCellViewSimulationEnsembleBatch(const SingleCellViewSimulationEnsembleRuns &pRuns,
+                                                   const int &pLanesCount);
+
+    virtual void run();
+
+private:
+    SingleCellViewSimulationEnsembleRuns mRuns;
+
+    int mLanesCount;
+
+    bool mError;
+
+    bool isRunning() const;
+
+private slots:
+    void emitError(const QString &pMessage);
+};
+
+//==============================================================================
+
+class SingleCellViewSimulationEnsembleSummary
+{
+public:
+    explicit SingleCellViewSimulationEnsembleSummary();
+
+    int runsCount() const;
+    int successfulRunsCount() const;
+
+    qint64 elapsedTime() const;
+    qint64 totalRunsTime() const;
+
+    QVector<double> finalStatesMinimum() const;
+    QVector<double> finalStatesMaximum() const;
+    QVector<double> finalStatesMean() const;
+
+private:
+    friend class SingleCellViewSimulationEnsemble;
+
+    int mRunsCount;
+    int mSuccessfulRunsCount;
+
+    qint64 mElapsedTime;
+    qint64 mTotalRunsTime;
+
+    QVector<double> mFinalStatesMinimum;
+    QVector<double> mFinalStatesMaximum;
+    QVector<double> mFinalStatesMean;
+};
+
+//==============================================================================
+
+class SingleCellViewSimulationEnsemble : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SingleCellViewSimulationEnsemble(SingleCellViewSimulation *pSimulation,
+                                              const SolverInterfaces &pSolverInterfaces);
+    ~SingleCellViewSimulationEnsemble();
+
+    int addRun(const SingleCellViewSimulationEnsembleValues &pConstants,
+               const SingleCellViewSimulationEnsembleValues &pStates = SingleCellViewSimulationEnsembleValues());
+
+    int runsCount() const;
+    SingleCellViewSimulationEnsembleRun * ensembleRun(const int &pIndex) const;
+
+    int maximumThreadCount() const;
+    void setMaximumThreadCount(const int &pMaximumThreadCount);
+
+    bool specializeOdeRates() const;
+    void setSpecializeOdeRates(const bool &pSpecializeOdeRates);
+
+    bool run();
+
+    SingleCellViewSimulationEnsembleSummary summary() const;
+
+private:
+    SingleCellViewSimulation *mSimulation;
+
+    SolverInterfaces mSolverInterfaces;
+
+    int mMaximumThreadCount;
+
+    bool mSpecializeOdeRates;
+
+    SingleCellViewSimulationEnsembleRuns mRuns;
+
+    SingleCellViewSimulationEnsembleSummary mSummary;
+
+    int lanesCount() const;
+};
+
+//==============================================================================
+
+}   // namespace SingleCellView
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
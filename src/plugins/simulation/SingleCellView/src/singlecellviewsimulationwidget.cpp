@@ -27,6 +27,7 @@ limitations under the License.
 #include "progressbarwidget.h"
 #include "sedmlsupportplugin.h"
 #include "singlecellviewcontentswidget.h"
+#include "singlecellviewgraphdata.h"
 #include "singlecellviewinformationgraphswidget.h"
 #include "singlecellviewinformationparameterswidget.h"
 #include "singlecellviewinformationsimulationwidget.h"
@@ -45,6 +46,7 @@ limitations under the License.
 #include <QDesktopServices>
 #include <QDesktopWidget>
 #include <QDir>
+#include <QFutureWatcher>
 #include <QLabel>
 #include <QLayout>
 #include <QMainWindow>
@@ -52,6 +54,7 @@ limitations under the License.
 #include <QMessageBox>
 #include <QSettings>
 #include <QSplitter>
+#include <QStorageInfo>
 #include <QTextEdit>
 #include <QTimer>
 #include <QToolButton>
@@ -90,6 +93,7 @@ SingleCellViewSimulationWidget::SingleCellViewSimulationWidget(SingleCellViewPlu
                                                                const QString &pFileName,
                                                                QWidget *pParent) :
     Widget(pParent),
+    BusySupportWidget(),
     mPlugin(pPlugin),
     mFileName(pFileName),
     mDataStoreInterfaces(QMap<QAction *, DataStoreInterface *>()),
@@ -102,7 +106,11 @@ SingleCellViewSimulationWidget::SingleCellViewSimulationWidget(SingleCellViewPlu
     mCanUpdatePlotsForUpdatedGraphs(true),
     mNeedReloadView(false),
     mNeedUpdatePlots(false),
-    mOldDataSizes(QMap<GraphPanelWidget::GraphPanelPlotGraph *, qulonglong>())
+    mOldDataSizes(QMap<GraphPanelWidget::GraphPanelPlotGraph *, qulonglong>()),
+    mCellmlFileRuntimeWatcher(new QFutureWatcher<CellMLSupport::CellmlFileRuntime *>(this)),
+    mReloadingView(false),
+    mInitializationPending(false),
+    mBusyWidgetShown(false)
 {
     // Create our layout and actions
 
@@ -432,8 +440,11 @@ SingleCellViewSimulationWidget::SingleCellViewSimulationWidget(SingleCellViewPlu
                                                mSedmlFileIssues,
                                                mCombineArchiveIssues);
 
-    mSimulation = new SingleCellViewSimulation(mCellmlFile?mCellmlFile->runtime():0,
-                                               pPlugin->solverInterfaces());
+    // Note: our simulation doesn't get a runtime until we get initialised
+    //       since our runtime may have to be updated in the background (see
+    //       initialize())...
+
+    mSimulation = new SingleCellViewSimulation(0, pPlugin->solverInterfaces());
 
     connect(mSimulation, SIGNAL(running(const bool &)),
             this, SLOT(simulationRunning(const bool &)));
@@ -448,6 +459,12 @@ SingleCellViewSimulationWidget::SingleCellViewSimulationWidget(SingleCellViewPlu
     connect(mSimulation->data(), SIGNAL(modified(const bool &)),
             this, SLOT(simulationDataModified(const bool &)));
 
+    // Keep track of when the runtime of our CellML file has been updated in
+    // the background
+
+    connect(mCellmlFileRuntimeWatcher, SIGNAL(finished()),
+            this, SLOT(continueInitialization()));
+
     // Some further initialisations that are done as part of retranslating the
     // GUI (so that they can be updated when changing languages)
 
@@ -661,23 +678,33 @@ static const auto OutputBrLn = QStringLiteral("<br/>\n");
 
 //==============================================================================
 
+void SingleCellViewSimulationWidget::resizeEvent(QResizeEvent *pEvent)
+{
+    // Default handling of the event
+
+    Widget::resizeEvent(pEvent);
+
+    // (Re)size our busy widget
+
+    resizeBusyWidget();
+}
+
+//==============================================================================
+
 void SingleCellViewSimulationWidget::initialize(const bool &pReloadingView)
 {
     // Stop keeping track of certain things (so that updatePlot() doesn't get
     // called unnecessarily)
-    // Note: see the corresponding code towards the end of this method...
-
-    SingleCellViewInformationWidget *informationWidget = mContentsWidget->informationWidget();
-    SingleCellViewInformationSimulationWidget *simulationWidget = informationWidget->simulationWidget();
+    // Note: see the corresponding code towards the end of doInitialize()...
 
-    disconnect(simulationWidget, SIGNAL(propertyChanged(Core::Property *)),
+    disconnect(mContentsWidget->informationWidget()->simulationWidget(), SIGNAL(propertyChanged(Core::Property *)),
                this, SLOT(simulationPropertyChanged(Core::Property *)));
 
     // Reset our progress
 
     mProgress = -1;
 
-    // Retrieve our file details and update our simulation object, if needed
+    // Retrieve our file details, if needed
 
     if (pReloadingView) {
         mPlugin->viewWidget()->retrieveFileDetails(mFileName, mCellmlFile,
@@ -686,16 +713,84 @@ void SingleCellViewSimulationWidget::initialize(const bool &pReloadingView)
                                                    mCombineArchiveIssues);
     }
 
-    CellMLSupport::CellmlFileRuntime *cellmlFileRuntime = mCellmlFile?mCellmlFile->runtime():0;
+    // Carry on with our initialisation, once the runtime of our CellML file, if
+    // any, is up to date
 
-    if (pReloadingView)
-        mSimulation->update(cellmlFileRuntime);
+    mReloadingView = pReloadingView;
+    mInitializationPending = true;
+
+    continueInitialization();
+}
+
+//==============================================================================
+
+void SingleCellViewSimulationWidget::continueInitialization()
+{
+    // Make sure that we are expecting to be initialised
+    // Note: we may have already been initialised if we were asked to
+    //       (re)initialise ourselves while our runtime was being updated...
+
+    if (!mInitializationPending)
+        return;
+
+    // Retrieve the runtime of our CellML file, if any
+    // Note: our runtime may have to be updated, which involves compiling our
+    //       model and may therefore take a while, so we have it done in the
+    //       background and come back here once it is done. In the meantime, we
+    //       show ourselves as busy, which also disables us, so that we can't be
+    //       interacted with while we are only partially initialised. Also, we
+    //       don't rely on the result of the future we were watching since our
+    //       CellML file may have been reset in the meantime, in which case our
+    //       runtime needs updating again...
+
+    CellMLSupport::CellmlFileRuntime *cellmlFileRuntime = 0;
+
+    if (mCellmlFile) {
+        QFuture<CellMLSupport::CellmlFileRuntime *> cellmlFileRuntimeFuture = mCellmlFile->runtimeFuture();
+
+        if (!cellmlFileRuntimeFuture.isFinished()) {
+            if (!mBusyWidgetShown) {
+                showBusyWidget(this);
+
+                mBusyWidgetShown = true;
+            }
+
+            mCellmlFileRuntimeWatcher->setFuture(cellmlFileRuntimeFuture);
+
+            return;
+        }
+
+        cellmlFileRuntime = cellmlFileRuntimeFuture.result();
+    }
+
+    // Now, we can carry on with our initialisation
+
+    if (mBusyWidgetShown) {
+        hideBusyWidget();
+
+        mBusyWidgetShown = false;
+    }
+
+    mInitializationPending = false;
+
+    doInitialize(cellmlFileRuntime, mReloadingView);
+}
+
+//==============================================================================
+
+void SingleCellViewSimulationWidget::doInitialize(CellMLSupport::CellmlFileRuntime *pCellmlFileRuntime,
+                                                  const bool &pReloadingView)
+{
+    // Update our simulation object, if needed
+
+    if (pReloadingView || (pCellmlFileRuntime != mSimulation->runtime()))
+        mSimulation->update(pCellmlFileRuntime);
 
     // Retrieve our variable of integration, if possible
 
-    bool validCellmlFileRuntime = cellmlFileRuntime && cellmlFileRuntime->isValid();
+    bool validCellmlFileRuntime = pCellmlFileRuntime && pCellmlFileRuntime->isValid();
 
-    CellMLSupport::CellmlFileRuntimeParameter *variableOfIntegration = validCellmlFileRuntime?cellmlFileRuntime->variableOfIntegration():0;
+    CellMLSupport::CellmlFileRuntimeParameter *variableOfIntegration = validCellmlFileRuntime?pCellmlFileRuntime->variableOfIntegration():0;
 
     // Clean up our output, if needed
 
@@ -776,11 +871,11 @@ void SingleCellViewSimulationWidget::initialize(const bool &pReloadingView)
 
             QString additionalInformation = QString();
 
-            if (cellmlFileRuntime->needNlaSolver())
+            if (pCellmlFileRuntime->needNlaSolver())
                 additionalInformation = " + "+tr("NLA system(s)");
 
             information += "<span"+OutputGood+">"+tr("valid")+"</span>."+OutputBrLn;
-            information += QString(OutputTab+"<strong>"+tr("Model type:")+"</strong> <span"+OutputInfo+">%1%2</span>."+OutputBrLn).arg((cellmlFileRuntime->modelType() == CellMLSupport::CellmlFileRuntime::Ode)?tr("ODE"):tr("DAE"),
+            information += QString(OutputTab+"<strong>"+tr("Model type:")+"</strong> <span"+OutputInfo+">%1%2</span>."+OutputBrLn).arg((pCellmlFileRuntime->modelType() == CellMLSupport::CellmlFileRuntime::Ode)?tr("ODE"):tr("DAE"),
                                                                                                                                        additionalInformation);
         } else {
             // We couldn't retrieve a variable of integration, which means that
@@ -794,7 +889,7 @@ void SingleCellViewSimulationWidget::initialize(const bool &pReloadingView)
 
             updateInvalidModelMessageWidget();
 
-            information += "<span"+OutputBad+">"+(cellmlFileRuntime?tr("invalid"):tr("none"))+"</span>."+OutputBrLn;
+            information += "<span"+OutputBad+">"+(pCellmlFileRuntime?tr("invalid"):tr("none"))+"</span>."+OutputBrLn;
 
             if (validCellmlFileRuntime) {
                 // We have a valid runtime, but no variable of integration,
@@ -806,7 +901,7 @@ void SingleCellViewSimulationWidget::initialize(const bool &pReloadingView)
                 // problems with the CellML file or its runtime
 
                 foreach (const CellMLSupport::CellmlFileIssue &issue,
-                         cellmlFileRuntime?cellmlFileRuntime->issues():mCellmlFile->issues()) {
+                         pCellmlFileRuntime?pCellmlFileRuntime->issues():mCellmlFile->issues()) {
                     information += QString(OutputTab+"<span"+OutputBad+"><strong>%1</strong> %2.</span>"+OutputBrLn).arg((issue.type() == CellMLSupport::CellmlFileIssue::Error)?tr("Error:"):tr("Warning:"),
                                                                                                                          issue.message());
                 }
@@ -835,6 +930,8 @@ void SingleCellViewSimulationWidget::initialize(const bool &pReloadingView)
     // type(s) of solvers
 
     bool validSimulationEnvironment = false;
+    SingleCellViewInformationWidget *informationWidget = mContentsWidget->informationWidget();
+    SingleCellViewInformationSimulationWidget *simulationWidget = informationWidget->simulationWidget();
     SingleCellViewInformationSolversWidget *solversWidget = informationWidget->solversWidget();
 
     if (variableOfIntegration) {
@@ -851,9 +948,9 @@ void SingleCellViewSimulationWidget::initialize(const bool &pReloadingView)
         // Check whether we have at least one ODE or DAE solver and, if needed,
         // at least one NLA solver
 
-        if (cellmlFileRuntime->needNlaSolver()) {
+        if (pCellmlFileRuntime->needNlaSolver()) {
             if (solversWidget->nlaSolvers().isEmpty()) {
-                if (cellmlFileRuntime->needOdeSolver()) {
+                if (pCellmlFileRuntime->needOdeSolver()) {
                     if (solversWidget->odeSolvers().isEmpty()) {
                         simulationError(tr("the model needs both an ODE and an NLA solver, but none are available"),
                                         InvalidSimulationEnvironment);
@@ -870,22 +967,22 @@ void SingleCellViewSimulationWidget::initialize(const bool &pReloadingView)
                                         InvalidSimulationEnvironment);
                     }
                 }
-            } else if (   cellmlFileRuntime->needOdeSolver()
+            } else if (   pCellmlFileRuntime->needOdeSolver()
                        && solversWidget->odeSolvers().isEmpty()) {
                 simulationError(tr("the model needs both an ODE and an NLA solver, but no ODE solver is available"),
                                 InvalidSimulationEnvironment);
-            } else if (   cellmlFileRuntime->needDaeSolver()
+            } else if (   pCellmlFileRuntime->needDaeSolver()
                        && solversWidget->daeSolvers().isEmpty()) {
                     simulationError(tr("the model needs both a DAE and an NLA solver, but no DAE solver is available"),
                                     InvalidSimulationEnvironment);
             } else {
                 validSimulationEnvironment = true;
             }
-        } else if (   cellmlFileRuntime->needOdeSolver()
+        } else if (   pCellmlFileRuntime->needOdeSolver()
                    && solversWidget->odeSolvers().isEmpty()) {
             simulationError(tr("the model needs an ODE solver, but none is available"),
                             InvalidSimulationEnvironment);
-        } else if (   cellmlFileRuntime->needDaeSolver()
+        } else if (   pCellmlFileRuntime->needDaeSolver()
                    && solversWidget->daeSolvers().isEmpty()) {
             simulationError(tr("the model needs a DAE solver, but none is available"),
                             InvalidSimulationEnvironment);
@@ -951,7 +1048,7 @@ void SingleCellViewSimulationWidget::initialize(const bool &pReloadingView)
     }
 
     // Resume the tracking of certain things
-    // Note: see the corresponding code at the beginning of this method...
+    // Note: see the corresponding code at the beginning of initialize()...
 
     connect(mContentsWidget->informationWidget()->simulationWidget(), SIGNAL(propertyChanged(Core::Property *)),
             this, SLOT(simulationPropertyChanged(Core::Property *)));
@@ -970,6 +1067,12 @@ void SingleCellViewSimulationWidget::initialize(const bool &pReloadingView)
         && (mFileType != SingleCellViewWidget::CellmlFile)) {
         QTimer::singleShot(0, this, SLOT(furtherInitialize()));
     }
+    // Let people know that we have been initialised
+    // Note: our initialisation may have been delayed (see
+    //       continueInitialization()), so people cannot rely on us being
+    //       initialised once initialize() returns...
+
+    emit initialized();
 }
 
 //==============================================================================
@@ -1222,6 +1325,35 @@ SingleCellViewSimulation * SingleCellViewSimulationWidget::simulation() const
 
 //==============================================================================
 
+CellMLSupport::CellmlFileRuntimeParameters SingleCellViewSimulationWidget::graphParameters(const QString &pFileName) const
+{
+    // Return the parameters used by our valid graphs that are associated with
+    // the given file name
+
+    CellMLSupport::CellmlFileRuntimeParameters res = CellMLSupport::CellmlFileRuntimeParameters();
+
+    foreach (GraphPanelWidget::GraphPanelWidget *graphPanel,
+             mContentsWidget->graphPanelsWidget()->graphPanels()) {
+        foreach (GraphPanelWidget::GraphPanelPlotGraph *graph, graphPanel->graphs()) {
+            if (!graph->isValid() || graph->fileName().compare(pFileName))
+                continue;
+
+            CellMLSupport::CellmlFileRuntimeParameter *parameterX = static_cast<CellMLSupport::CellmlFileRuntimeParameter *>(graph->parameterX());
+            CellMLSupport::CellmlFileRuntimeParameter *parameterY = static_cast<CellMLSupport::CellmlFileRuntimeParameter *>(graph->parameterY());
+
+            if (!res.contains(parameterX))
+                res << parameterX;
+
+            if (!res.contains(parameterY))
+                res << parameterY;
+        }
+    }
+
+    return res;
+}
+
+//==============================================================================
+
 QVariant SingleCellViewSimulationWidget::value(Core::Property *pProperty) const
 {
     switch (pProperty->type()) {
@@ -1268,6 +1400,7 @@ void SingleCellViewSimulationWidget::runPauseResumeSimulation()
         if (!mSimulation->isPaused()) {
             updateSimulationProperties();
             updateSolversProperties();
+            updateRecordedParameters();
         }
 
         // Run or resume our simulation
@@ -1275,20 +1408,38 @@ void SingleCellViewSimulationWidget::runPauseResumeSimulation()
         if (mSimulation->isPaused()) {
             mSimulation->resume();
         } else {
-            // Check that we have enough memory to run our simulation
+            // Check whether we have enough memory to complete our simulation
+            // and, if not, whether we have enough disk space to store its
+            // results in a scratch directory instead. If we have neither, then
+            // ask the user whether the simulation should be run nonetheless
+            // Note: the memory needed by our simulation gets allocated as it
+            //       progresses, so it is fine to run a simulation that would
+            //       require more memory than we have, should the user intend
+            //       to stop it early. Should we run out of memory, then the
+            //       simulation will stop with an error...
 
             bool runSimulation = true;
 
             double freeMemory = Core::freeMemory();
             double requiredMemory = mSimulation->requiredMemory();
+            QString scratchDirName = QString();
 
-            if (requiredMemory > freeMemory) {
-                QMessageBox::warning(Core::mainWindow(), tr("Run Simulation"),
-                                     tr("The simulation requires %1 of memory and you have only %2 left.").arg(Core::sizeAsString(requiredMemory), Core::sizeAsString(freeMemory)));
+            if (   (requiredMemory > freeMemory)
+                && (QStorageInfo(QDir::tempPath()).bytesAvailable() > requiredMemory)) {
+                scratchDirName = QDir::tempPath();
+            }
+
+            mSimulation->results()->setScratchDirName(scratchDirName);
+
+            if (   (requiredMemory > freeMemory) && scratchDirName.isEmpty()
+                && (QMessageBox::question(Core::mainWindow(), tr("Run Simulation"),
+                                          tr("The simulation requires up to %1 of memory and you have only %2 left (and not enough disk space either). Do you want to run it anyway?").arg(Core::sizeAsString(requiredMemory), Core::sizeAsString(freeMemory)),
+                                          QMessageBox::Yes|QMessageBox::No,
+                                          QMessageBox::No) == QMessageBox::No)) {
+                runSimulation = false;
             } else {
-                // Theoretically speaking, we have enough memory to run the
-                // simulation, so try to allocate all the memory we need for the
-                // simulation by resetting its settings
+                // Reset our simulation results, which allocates the memory we
+                // need to start our simulation
 
                 runSimulation = mSimulation->results()->reset();
 
@@ -1296,13 +1447,13 @@ void SingleCellViewSimulationWidget::runPauseResumeSimulation()
                 // Note: this will, among other things, clear our plots...
 
                 // Effectively run our simulation in case we were able to
-                // allocate all the memory we need to run the simulation
+                // allocate the memory we need to start the simulation
 
                 if (runSimulation) {
                     mSimulation->run();
                 } else {
                     QMessageBox::warning(Core::mainWindow(), tr("Run Simulation"),
-                                         tr("We could not allocate the %1 of memory required for the simulation.").arg(Core::sizeAsString(requiredMemory)));
+                                         tr("We could not allocate the memory required to start the simulation."));
                 }
             }
 
@@ -2711,6 +2862,10 @@ void SingleCellViewSimulationWidget::graphAdded(OpenCOR::GraphPanelWidget::Graph
 
     if (!mPlots.contains(plot))
         mPlots << plot;
+
+    // Our new graph may need some parameters to be recorded
+
+    updateRecordedParameters();
 }
 
 //==============================================================================
@@ -2735,6 +2890,10 @@ void SingleCellViewSimulationWidget::graphsRemoved(OpenCOR::GraphPanelWidget::Gr
 
     if (plot->graphs().isEmpty())
         mPlots.removeOne(plot);
+
+    // Some parameters may not need to be recorded anymore
+
+    updateRecordedParameters();
 }
 
 //==============================================================================
@@ -2781,6 +2940,10 @@ void SingleCellViewSimulationWidget::graphsUpdated(OpenCOR::GraphPanelWidget::Gr
         QCoreApplication::processEvents();
         // Note: this ensures that our plots are all updated at once...
     }
+
+    // Our updated graphs may need some other parameters to be recorded
+
+    updateRecordedParameters();
 }
 
 //==============================================================================
@@ -2924,10 +3087,10 @@ bool SingleCellViewSimulationWidget::updatePlot(GraphPanelWidget::GraphPanelPlot
 
 //==============================================================================
 
-double * SingleCellViewSimulationWidget::dataPoints(SingleCellViewSimulation *pSimulation,
-                                                    CellMLSupport::CellmlFileRuntimeParameter *pParameter) const
+DataStore::DataStoreVariable * SingleCellViewSimulationWidget::dataPoints(SingleCellViewSimulation *pSimulation,
+                                                                          CellMLSupport::CellmlFileRuntimeParameter *pParameter) const
 {
-    // Return the array of data points associated with the given parameter
+    // Return the data store variable associated with the given parameter
 
     switch (pParameter->type()) {
     case CellMLSupport::CellmlFileRuntimeParameter::Voi:
@@ -2959,14 +3122,61 @@ void SingleCellViewSimulationWidget::updateGraphData(GraphPanelWidget::GraphPane
     if (pGraph->isValid()) {
         SingleCellViewSimulation *simulation = mPlugin->viewWidget()->simulation(pGraph->fileName());
 
-        pGraph->setRawSamples(dataPoints(simulation, static_cast<CellMLSupport::CellmlFileRuntimeParameter *>(pGraph->parameterX())),
-                              dataPoints(simulation, static_cast<CellMLSupport::CellmlFileRuntimeParameter *>(pGraph->parameterY())),
-                              pSize);
+        pGraph->setData(new SingleCellViewGraphData(dataPoints(simulation, static_cast<CellMLSupport::CellmlFileRuntimeParameter *>(pGraph->parameterX())),
+                                                    dataPoints(simulation, static_cast<CellMLSupport::CellmlFileRuntimeParameter *>(pGraph->parameterY())),
+                                                    pSize));
     }
 }
 
 //==============================================================================
 
+void SingleCellViewSimulationWidget::updateRecordedParameters()
+{
+    // Only record the parameters that are plotted (be it in one of our graph
+    // panels or in one of the graph panels of another file) or that are used
+    // by the data generators of our SED-ML file, if any, so that our simulation
+    // only needs to compute and store what is actually of interest to us
+    // Note #1: we must not change our recorded parameters while our simulation
+    //          is running (or paused), since our data store has already been
+    //          created and since our simulation data is being used by our
+    //          worker...
+    // Note #2: an empty list means that all our parameters are to be recorded,
+    //          which is what we want if nothing is plotted and we don't have a
+    //          SED-ML file (e.g. so that the user can still export all of our
+    //          simulation data)...
+    // Note #3: a graph that is added once our simulation has been run won't
+    //          have any data to show if its parameters were not recorded, in
+    //          which case the user will need to rerun our simulation...
+
+    CellMLSupport::CellmlFileRuntime *runtime = mSimulation->runtime();
+
+    if (   !runtime || !runtime->isValid()
+        || mSimulation->isRunning() || mSimulation->isPaused()) {
+        return;
+    }
+
+    CellMLSupport::CellmlFileRuntimeParameters recordedParameters = mPlugin->viewWidget()->graphParameters(mFileName);
+
+    if (mSedmlFile && mSedmlFile->sedmlDocument()) {
+        libsedml::SedDocument *sedmlDocument = mSedmlFile->sedmlDocument();
+
+        for (uint i = 0, iMax = sedmlDocument->getNumDataGenerators(); i < iMax; ++i) {
+            libsedml::SedDataGenerator *sedmlDataGenerator = sedmlDocument->getDataGenerator(i);
+
+            for (uint j = 0, jMax = sedmlDataGenerator->getNumVariables(); j < jMax; ++j) {
+                CellMLSupport::CellmlFileRuntimeParameter *parameter = runtimeParameter(sedmlDataGenerator->getVariable(j));
+
+                if (parameter && !recordedParameters.contains(parameter))
+                    recordedParameters << parameter;
+            }
+        }
+    }
+
+    mSimulation->results()->setRecordedParameters(recordedParameters);
+}
+
+//==============================================================================
+
 void SingleCellViewSimulationWidget::updateGui()
 {
     // Make sure that our graphs widget's GUI is up to date
@@ -3043,9 +3253,12 @@ void SingleCellViewSimulationWidget::updateSimulationResults(SingleCellViewSimul
 
         foreach (GraphPanelWidget::GraphPanelPlotGraph *graph, plot->graphs()) {
             if (!graph->fileName().compare(pSimulationWidget->fileName())) {
-                if (pClearGraphs)
+                if (pClearGraphs) {
                     mOldDataSizes.remove(graph);
 
+                    graph->resetLevelsOfDetail();
+                }
+
                 // Update our graph's data and keep track of our new old data
                 // size, if we are visible
                 // Note: indeed, to update our graph's old data size if we are
@@ -3080,27 +3293,20 @@ void SingleCellViewSimulationWidget::updateSimulationResults(SingleCellViewSimul
                     // the plot's contents)
 
                     if (mUpdatablePlotViewports.value(plot)) {
-                        double minX = plotMinX;
-                        double maxX = plotMaxX;
-                        double minY = plotMinY;
-                        double maxY = plotMaxY;
-
-                        for (qulonglong i = oldDataSize?oldDataSize-1:0;
-                             i < pSimulationResultsSize; ++i) {
-                            double valX = graph->data()->sample(i).x();
-                            double valY = graph->data()->sample(i).y();
-
-                            minX = qMin(minX, valX);
-                            maxX = qMax(maxX, valX);
-                            minY = qMin(minY, valY);
-                            maxY = qMax(maxY, valY);
-                        }
+                        // Note: our plot's viewport was set so that our graph's
+                        //       old segments fit within it, so our graph's new
+                        //       segment fits within it if our graph's bounding
+                        //       rectangle, which is readily available, does...
+
+                        QRectF boundingRect = graph->boundingRect();
 
                         // Update our plot, if our graph segment cannot fit
                         // within our plot's current viewport
 
-                        needUpdatePlot =    (minX < plotMinX) || (maxX > plotMaxX)
-                                         || (minY < plotMinY) || (maxY > plotMaxY);
+                        needUpdatePlot =    (boundingRect.left() < plotMinX)
+                                         || (boundingRect.right() > plotMaxX)
+                                         || (boundingRect.top() < plotMinY)
+                                         || (boundingRect.bottom() > plotMaxY);
                     }
 
                     if (!needUpdatePlot) {
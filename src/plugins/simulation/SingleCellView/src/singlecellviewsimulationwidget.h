@@ -24,6 +24,7 @@ limitations under the License.
 
 //==============================================================================
 
+#include "busysupportwidget.h"
 #include "cellmlfileruntime.h"
 #include "corecliutils.h"
 #include "graphpanelplotwidget.h"
@@ -33,6 +34,10 @@ limitations under the License.
 
 //==============================================================================
 
+#include <QFutureWatcher>
+
+//==============================================================================
+
 class QFrame;
 class QLabel;
 class QMenu;
@@ -70,6 +75,12 @@ namespace COMBINESupport {
 
 //==============================================================================
 
+namespace DataStore {
+    class DataStoreVariable;
+}   // namespace DataStore
+
+//==============================================================================
+
 namespace Core {
     class Property;
     class ProgressBarWidget;
@@ -101,7 +112,8 @@ class SingleCellViewSimulation;
 
 //==============================================================================
 
-class SingleCellViewSimulationWidget : public Core::Widget
+class SingleCellViewSimulationWidget : public Core::Widget,
+                                       public Core::BusySupportWidget
 {
     Q_OBJECT
 
@@ -137,6 +149,8 @@ public:
 
     SingleCellViewSimulation *simulation() const;
 
+    CellMLSupport::CellmlFileRuntimeParameters graphParameters(const QString &pFileName) const;
+
     void updateGui();
     void updateSimulationResults(SingleCellViewSimulationWidget *pSimulationWidget,
                                  const qulonglong &pSimulationResultsSize,
@@ -146,6 +160,9 @@ public:
 
     static QIcon parameterIcon(const CellMLSupport::CellmlFileRuntimeParameter::ParameterType &pParameterType);
 
+protected:
+    virtual void resizeEvent(QResizeEvent *pEvent);
+
 private:
     enum ErrorType {
         General,
@@ -225,6 +242,11 @@ private:
 
     QMap<GraphPanelWidget::GraphPanelPlotGraph *, qulonglong> mOldDataSizes;
 
+    QFutureWatcher<CellMLSupport::CellmlFileRuntime *> *mCellmlFileRuntimeWatcher;
+    bool mReloadingView;
+    bool mInitializationPending;
+    bool mBusyWidgetShown;
+
     void reloadView();
 
     void output(const QString &pMessage);
@@ -245,12 +267,14 @@ private:
     bool updatePlot(GraphPanelWidget::GraphPanelPlotWidget *pPlot,
                     const bool &pForceReplot = false);
 
-    double * dataPoints(SingleCellViewSimulation *pSimulation,
-                        CellMLSupport::CellmlFileRuntimeParameter *pParameter) const;
+    DataStore::DataStoreVariable * dataPoints(SingleCellViewSimulation *pSimulation,
+                                              CellMLSupport::CellmlFileRuntimeParameter *pParameter) const;
 
     void updateGraphData(GraphPanelWidget::GraphPanelPlotGraph *pGraph,
                          const qulonglong &pSize);
 
+    void updateRecordedParameters();
+
     QVariant value(Core::Property *pProperty) const;
 
     void updateSimulationProperties(Core::Property *pProperty = 0);
@@ -258,6 +282,9 @@ private:
 
     CellMLSupport::CellmlFileRuntimeParameter * runtimeParameter(libsedml::SedVariable *pSedmlVariable);
 
+    void doInitialize(CellMLSupport::CellmlFileRuntime *pCellmlFileRuntime,
+                      const bool &pReloadingView);
+
     bool doFurtherInitialize();
     void initializeGui(const bool &pValidSimulationEnvironment);
     void initializeSimulation();
@@ -277,7 +304,11 @@ private:
 signals:
     void splitterMoved(const QIntList &pSizes);
 
+    void initialized();
+
 private slots:
+    void continueInitialization();
+
     void runPauseResumeSimulation();
     void stopSimulation();
     void developmentMode();
@@ -220,7 +220,7 @@ void SingleCellViewSimulationWorker::started()
     if (mRuntime->needNlaSolver()) {
         nlaSolver = static_cast<Solver::NlaSolver *>(mSimulation->data()->nlaSolverInterface()->solverInstance());
 
-        Solver::setNlaSolver(mRuntime->address(), nlaSolver);
+        mRuntime->nlaSolverRegistry()->setNlaSolver(nlaSolver);
     }
 
     // Keep track of any error that might be reported by any of our solvers
@@ -256,6 +256,8 @@ void SingleCellViewSimulationWorker::started()
 
     if (odeSolver) {
         odeSolver->setProperties(mSimulation->data()->odeSolverProperties());
+        odeSolver->setComputeJacobian(mRuntime->computeOdeJacobian(),
+                                      mRuntime->algebraicCount());
 
         odeSolver->initialize(mCurrentPoint,
                               mRuntime->statesCount(),
@@ -305,7 +307,8 @@ void SingleCellViewSimulationWorker::started()
 
         mSimulation->data()->recomputeVariables(mCurrentPoint);
 
-        mSimulation->results()->addPoint(mCurrentPoint);
+        if (!mSimulation->results()->addPoint(mCurrentPoint))
+            emitError(tr("the memory required for the simulation could not be allocated"));
 
         // Our main work loop
         // Note: for performance reasons, it is essential that the following
@@ -316,7 +319,7 @@ void SingleCellViewSimulationWorker::started()
 
         QMutex pausedMutex;
 
-        forever {
+        while (!mError) {
             // Determine our next point and compute our model up to it
 
             ++pointCounter;
@@ -336,7 +339,11 @@ void SingleCellViewSimulationWorker::started()
 
             mSimulation->data()->recomputeVariables(mCurrentPoint);
 
-            mSimulation->results()->addPoint(mCurrentPoint);
+            if (!mSimulation->results()->addPoint(mCurrentPoint)) {
+                emitError(tr("the memory required for the simulation could not be allocated"));
+
+                break;
+            }
 
             // Check whether we are done or whether we have been asked to stop
 
@@ -427,7 +434,7 @@ void SingleCellViewSimulationWorker::started()
     if (nlaSolver) {
         delete nlaSolver;
 
-        Solver::unsetNlaSolver(mRuntime->address());
+        mRuntime->nlaSolverRegistry()->unsetNlaSolver();
     }
 
     // Reset our simulation owner's knowledge of us
@@ -71,6 +71,16 @@ namespace SingleCellView {
 
 //==============================================================================
 
+// Rates (in Hz) at which we update the results of our running simulations
+
+enum {
+    MinimumSimulationResultsUpdateRate = 1,
+    SimulationResultsUpdateRateDefaultValue = 30,
+    MaximumSimulationResultsUpdateRate = 120
+};
+
+//==============================================================================
+
 SingleCellViewWidget::SingleCellViewWidget(SingleCellViewPlugin *pPlugin,
                                            QWidget *pParent) :
     ViewWidget(pParent),
@@ -86,10 +96,22 @@ SingleCellViewWidget::SingleCellViewWidget(SingleCellViewPlugin *pPlugin,
     mSimulationWidget(0),
     mSimulationWidgets(QMap<QString, SingleCellViewSimulationWidget *>()),
     mFileNames(QStringList()),
+    mSimulationResultsUpdateRate(SimulationResultsUpdateRateDefaultValue),
     mSimulationResultsSizes(QMap<QString, qulonglong>()),
     mSimulationCheckResults(QStringList()),
     mLocallyManagedCellmlFiles(QMap<QString, QString>())
 {
+    // Create our simulation results timer, which we use to check, at a given
+    // rate, the results of all our running simulations
+
+    mSimulationResultsTimer = new QTimer(this);
+
+    mSimulationResultsTimer->setInterval(1000/mSimulationResultsUpdateRate);
+
+    // A connection to handle the timing out of our simulation results timer
+
+    connect(mSimulationResultsTimer, SIGNAL(timeout()),
+            this, SLOT(checkAllSimulationResults()));
 }
 
 //==============================================================================
@@ -101,6 +123,7 @@ static const auto SettingsSimulationColumnWidths = QStringLiteral("SimulationCol
 static const auto SettingsSolversColumnWidths = QStringLiteral("SolversColumnWidths");
 static const auto SettingsGraphsColumnWidths = QStringLiteral("GraphsColumnWidths");
 static const auto SettingsParametersColumnWidths = QStringLiteral("ParametersColumnWidths");
+static const auto SettingsSimulationResultsUpdateRate = QStringLiteral("SimulationResultsUpdateRate");
 
 //==============================================================================
 
@@ -135,6 +158,15 @@ void SingleCellViewWidget::loadSettings(QSettings *pSettings)
     mSolversWidgetColumnWidths = qVariantListToIntList(pSettings->value(SettingsSolversColumnWidths, defaultColumnWidths).toList());
     mGraphsWidgetColumnWidths = qVariantListToIntList(pSettings->value(SettingsGraphsColumnWidths, defaultColumnWidths).toList());
     mParametersWidgetColumnWidths = qVariantListToIntList(pSettings->value(SettingsParametersColumnWidths, defaultColumnWidths).toList());
+
+    // Retrieve the rate (in Hz) at which we update the results of our running
+    // simulations
+
+    mSimulationResultsUpdateRate = qBound(int(MinimumSimulationResultsUpdateRate),
+                                          pSettings->value(SettingsSimulationResultsUpdateRate, SimulationResultsUpdateRateDefaultValue).toInt(),
+                                          int(MaximumSimulationResultsUpdateRate));
+
+    mSimulationResultsTimer->setInterval(1000/mSimulationResultsUpdateRate);
 }
 
 //==============================================================================
@@ -157,6 +189,11 @@ void SingleCellViewWidget::saveSettings(QSettings *pSettings) const
     pSettings->setValue(SettingsSolversColumnWidths, qIntListToVariantList(mSolversWidgetColumnWidths));
     pSettings->setValue(SettingsGraphsColumnWidths, qIntListToVariantList(mGraphsWidgetColumnWidths));
     pSettings->setValue(SettingsParametersColumnWidths, qIntListToVariantList(mParametersWidgetColumnWidths));
+
+    // Keep track of the rate at which we update the results of our running
+    // simulations
+
+    pSettings->setValue(SettingsSimulationResultsUpdateRate, mSimulationResultsUpdateRate);
 }
 
 //==============================================================================
@@ -229,16 +266,8 @@ void SingleCellViewWidget::initialize(const QString &pFileName)
 
     SingleCellViewSimulationWidget *oldSimulationWidget = mSimulationWidget;
 
-    if (oldSimulationWidget) {
-        disconnect(oldSimulationWidget->contentsWidget()->informationWidget()->simulationWidget()->header(), SIGNAL(sectionResized(int, int, int)),
-                   this, SLOT(simulationWidgetHeaderSectionResized(const int &, const int &, const int &)));
-        disconnect(oldSimulationWidget->contentsWidget()->informationWidget()->solversWidget()->header(), SIGNAL(sectionResized(int, int, int)),
-                   this, SLOT(solversWidgetHeaderSectionResized(const int &, const int &, const int &)));
-        disconnect(oldSimulationWidget->contentsWidget()->informationWidget()->graphsWidget(), SIGNAL(headerSectionResized(int, int, int)),
-                   this, SLOT(graphsWidgetHeaderSectionResized(const int &, const int &, const int &)));
-        disconnect(oldSimulationWidget->contentsWidget()->informationWidget()->parametersWidget()->header(), SIGNAL(sectionResized(int, int, int)),
-                   this, SLOT(parametersWidgetHeaderSectionResized(const int &, const int &, const int &)));
-    }
+    if (oldSimulationWidget)
+        stopTrackingColumnWidths(oldSimulationWidget);
 
     // Retrieve the simulation widget associated with the given file, if any
 
@@ -253,7 +282,11 @@ void SingleCellViewWidget::initialize(const QString &pFileName)
 
         mSimulationWidgets.insert(pFileName, mSimulationWidget);
 
-        // Initialise our simulation widget
+        // Initialise our simulation widget, making sure that we know when it
+        // has effectively been initialised (see simulationWidgetInitialized())
+
+        connect(mSimulationWidget, SIGNAL(initialized()),
+                this, SLOT(simulationWidgetInitialized()));
 
         mSimulationWidget->initialize();
 
@@ -270,9 +303,14 @@ void SingleCellViewWidget::initialize(const QString &pFileName)
                 this, SLOT(collapsibleWidgetCollapsed(const int &, const bool &)));
     } else {
         // We already have a simulation widget, so just make sure that its GUI
-        // is up to date
+        // is up to date, including some of its contents' information GUI
+        // Note: for a new simulation widget, this gets done once it has
+        //       effectively been initialised (see
+        //       simulationWidgetInitialized())...
 
         mSimulationWidget->updateGui();
+
+        updateContentsInformationGui(mSimulationWidget);
     }
 
     // Update our new simualtion widget and its children, if needed
@@ -280,21 +318,10 @@ void SingleCellViewWidget::initialize(const QString &pFileName)
     mSimulationWidget->setSizes(mSimulationWidgetSizes);
     mSimulationWidget->contentsWidget()->setSizes(mContentsWidgetSizes);
 
-    // Update some of our simulation's contents' information GUI
-
-    updateContentsInformationGui(mSimulationWidget);
-
     // Keep track of changes in our 'new' simulation widget's property editors'
     // columns' width
 
-    connect(mSimulationWidget->contentsWidget()->informationWidget()->simulationWidget()->header(), SIGNAL(sectionResized(int, int, int)),
-            this, SLOT(simulationWidgetHeaderSectionResized(const int &, const int &, const int &)));
-    connect(mSimulationWidget->contentsWidget()->informationWidget()->solversWidget()->header(), SIGNAL(sectionResized(int, int, int)),
-            this, SLOT(solversWidgetHeaderSectionResized(const int &, const int &, const int &)));
-    connect(mSimulationWidget->contentsWidget()->informationWidget()->graphsWidget(), SIGNAL(headerSectionResized(int, int, int)),
-            this, SLOT(graphsWidgetHeaderSectionResized(const int &, const int &, const int &)));
-    connect(mSimulationWidget->contentsWidget()->informationWidget()->parametersWidget()->header(), SIGNAL(sectionResized(int, int, int)),
-            this, SLOT(parametersWidgetHeaderSectionResized(const int &, const int &, const int &)));
+    startTrackingColumnWidths(mSimulationWidget);
 
     // Set our focus proxy to our 'new' simulation widget and make sure that the
     // latter immediately gets the focus
@@ -424,13 +451,11 @@ void SingleCellViewWidget::fileReloaded(const QString &pFileName)
 
     if (simulationWidget) {
         simulationWidget->fileReloaded();
-
-        // Make sure that our simulation's contents' information GUI is up to
-        // date
-        // Note: this is, at least, necessary for our paramaters widget since we
-        //       repopulate it, meaning that its columns' width will be reset...
-
-        updateContentsInformationGui(simulationWidget);
+        // Note: our simulation's contents' information GUI will be updated
+        //       once our simulation widget has effectively been reinitialised
+        //       (see simulationWidgetInitialized()), which is, at least,
+        //       necessary for our parameters widget since it gets repopulated,
+        //       meaning that its columns' width gets reset...
 
         // Make sure that the GUI of our simulation widgets is up to date
 
@@ -461,6 +486,17 @@ void SingleCellViewWidget::fileRenamed(const QString &pOldFileName,
         mSimulationWidgets.remove(pOldFileName);
     }
 
+    // Keep checking the simulation results of the given file, if needed
+
+    if (mSimulationCheckResults.contains(pOldFileName)) {
+        mSimulationCheckResults.removeOne(pOldFileName);
+
+        mSimulationCheckResults << pNewFileName;
+    }
+
+    if (mSimulationResultsSizes.contains(pOldFileName))
+        mSimulationResultsSizes.insert(pNewFileName, mSimulationResultsSizes.take(pOldFileName));
+
     // Make sure that the GUI of our simulation widgets is up to date
 
     foreach (SingleCellViewSimulationWidget *simulationWidget, mSimulationWidgets.values())
@@ -529,6 +565,27 @@ CellMLSupport::CellmlFileRuntime * SingleCellViewWidget::runtime(const QString &
 
 //==============================================================================
 
+CellMLSupport::CellmlFileRuntimeParameters SingleCellViewWidget::graphParameters(const QString &pFileName) const
+{
+    // Return the parameters that are plotted against one another for the given
+    // file name, be it in its own simulation widget or in the simulation widget
+    // of another file
+
+    CellMLSupport::CellmlFileRuntimeParameters res = CellMLSupport::CellmlFileRuntimeParameters();
+
+    foreach (SingleCellViewSimulationWidget *simulationWidget, mSimulationWidgets) {
+        foreach (CellMLSupport::CellmlFileRuntimeParameter *parameter,
+                 simulationWidget->graphParameters(pFileName)) {
+            if (!res.contains(parameter))
+                res << parameter;
+        }
+    }
+
+    return res;
+}
+
+//==============================================================================
+
 qulonglong SingleCellViewWidget::simulationResultsSize(const QString &pFileName) const
 {
     // Return the results size for the given file name
@@ -549,59 +606,107 @@ void SingleCellViewWidget::checkSimulationResults(const QString &pFileName,
     if (!simulationWidget)
         return;
 
-    // Update all of our simulation widgets' results, but only if needed
-    // Note: to update only the given simulation widget's results is not enough
-    //       since another simulation widget may have graphs that refer to the
-    //       given simulation widget...
+    // Update our simulation widgets' results straightaway and, if the
+    // simulation is still running, have its results checked with every tick of
+    // our simulation results timer
+    // Note: all our running simulations are checked in one tick, which means
+    //       that we update our GUI at a fixed rate rather than as fast as our
+    //       event loop allows, something that would otherwise compete with our
+    //       simulation workers...
 
-    SingleCellViewSimulation *simulation = simulationWidget->simulation();
+    if (updateSimulationResults(pFileName, simulationWidget, pClearGraphs)) {
+        if (!mSimulationCheckResults.contains(pFileName))
+            mSimulationCheckResults << pFileName;
+
+        if (!mSimulationResultsTimer->isActive())
+            mSimulationResultsTimer->start();
+    } else {
+        mSimulationCheckResults.removeOne(pFileName);
+    }
+}
+
+//==============================================================================
+
+bool SingleCellViewWidget::updateSimulationResults(const QString &pFileName,
+                                                   SingleCellViewSimulationWidget *pSimulationWidget,
+                                                   const bool &pClearGraphs)
+{
+    // Update all of our simulation widgets' results, but only if needed
+    // Note #1: to update only the given simulation widget's results is not
+    //          enough since another simulation widget may have graphs that
+    //          refer to the given simulation widget...
+    // Note #2: we retrieve the size of our simulation results only once since
+    //          it is published by our simulation worker, which runs in its own
+    //          thread...
+
+    SingleCellViewSimulation *simulation = pSimulationWidget->simulation();
     qulonglong simulationResultsSize = simulation->results()->size();
 
     if (   pClearGraphs
         || (simulationResultsSize != mSimulationResultsSizes.value(pFileName))) {
         mSimulationResultsSizes.insert(pFileName, simulationResultsSize);
 
-        foreach (SingleCellViewSimulationWidget *currentSimulationWidget, mSimulationWidgets)
-            currentSimulationWidget->updateSimulationResults(simulationWidget, simulationResultsSize, pClearGraphs);
+        foreach (SingleCellViewSimulationWidget *simulationWidget, mSimulationWidgets)
+            simulationWidget->updateSimulationResults(pSimulationWidget, simulationResultsSize, pClearGraphs);
     }
 
-    // Ask to recheck our simulation widget's results, but only if its
-    // simulation is still running
+    // Let our caller know whether the simulation results need to be checked
+    // again, i.e. the simulation is still running or some results have yet to
+    // be processed
 
     if (   simulation->isRunning()
         || (simulationResultsSize != simulation->results()->size())) {
-        // Note: we cannot ask QTimer::singleShot() to call
-        //       callCheckSimulationResults() since it expects a simulation
-        //       widget as a parameter, so instead we call a method with no
-        //       arguments that will make use of our list to know which
-        //       simulation should be passed as an argument to
-        //       checkSimulationResults()...
-
-        mSimulationCheckResults << pFileName;
-
-        QTimer::singleShot(0, this, SLOT(callCheckSimulationResults()));
-    } else if (!simulation->isRunning() && !simulation->isPaused()) {
+        return true;
+    } else if (!simulation->isPaused()) {
         // The simulation is over, so stop tracking the result's size and reset
         // the simulation progress of the given file
 
         mSimulationResultsSizes.remove(pFileName);
 
-        simulationWidget->resetSimulationProgress();
+        pSimulationWidget->resetSimulationProgress();
+    }
+
+    return false;
+}
+
+//==============================================================================
+
+void SingleCellViewWidget::checkAllSimulationResults()
+{
+    // Check the results of all our running simulations and stop our simulation
+    // results timer if there are no running simulations left
+
+    foreach (const QString &fileName, mSimulationCheckResults) {
+        SingleCellViewSimulationWidget *simulationWidget = mSimulationWidgets.value(fileName);
+
+        if (!simulationWidget || !updateSimulationResults(fileName, simulationWidget, false))
+            mSimulationCheckResults.removeOne(fileName);
     }
+
+    if (mSimulationCheckResults.isEmpty())
+        mSimulationResultsTimer->stop();
 }
 
 //==============================================================================
 
-void SingleCellViewWidget::callCheckSimulationResults()
+void SingleCellViewWidget::simulationWidgetInitialized()
 {
-    // Retrieve the simulation widget for which we want to call checkResults()
-    // and then call checkResults() for it
+    // One of our simulation widgets has effectively been (re)initialised, so
+    // make sure that some of its contents' information GUI is up to date
+    // Note: we don't want to keep track of the columns' width that we are
+    //       about to set (see initialize()), hence we temporarily stop tracking
+    //       them, if needed...
 
-    QString fileName = mSimulationCheckResults.first();
+    SingleCellViewSimulationWidget *simulationWidget = qobject_cast<SingleCellViewSimulationWidget *>(sender());
+    bool currentSimulationWidget = simulationWidget == mSimulationWidget;
 
-    mSimulationCheckResults.removeFirst();
+    if (currentSimulationWidget)
+        stopTrackingColumnWidths(simulationWidget);
 
-    checkSimulationResults(fileName);
+    updateContentsInformationGui(simulationWidget);
+
+    if (currentSimulationWidget)
+        startTrackingColumnWidths(simulationWidget);
 }
 
 //==============================================================================
@@ -693,6 +798,44 @@ void SingleCellViewWidget::parametersWidgetHeaderSectionResized(const int &pInde
 
 //==============================================================================
 
+void SingleCellViewWidget::startTrackingColumnWidths(SingleCellViewSimulationWidget *pSimulationWidget)
+{
+    // Keep track of changes in the given simulation widget's property editors'
+    // columns' width
+
+    connect(pSimulationWidget->contentsWidget()->informationWidget()->simulationWidget()->header(), SIGNAL(sectionResized(int, int, int)),
+            this, SLOT(simulationWidgetHeaderSectionResized(const int &, const int &, const int &)),
+            Qt::UniqueConnection);
+    connect(pSimulationWidget->contentsWidget()->informationWidget()->solversWidget()->header(), SIGNAL(sectionResized(int, int, int)),
+            this, SLOT(solversWidgetHeaderSectionResized(const int &, const int &, const int &)),
+            Qt::UniqueConnection);
+    connect(pSimulationWidget->contentsWidget()->informationWidget()->graphsWidget(), SIGNAL(headerSectionResized(int, int, int)),
+            this, SLOT(graphsWidgetHeaderSectionResized(const int &, const int &, const int &)),
+            Qt::UniqueConnection);
+    connect(pSimulationWidget->contentsWidget()->informationWidget()->parametersWidget()->header(), SIGNAL(sectionResized(int, int, int)),
+            this, SLOT(parametersWidgetHeaderSectionResized(const int &, const int &, const int &)),
+            Qt::UniqueConnection);
+}
+
+//==============================================================================
+
+void SingleCellViewWidget::stopTrackingColumnWidths(SingleCellViewSimulationWidget *pSimulationWidget)
+{
+    // Stop tracking changes in the given simulation widget's property editors'
+    // columns' width
+
+    disconnect(pSimulationWidget->contentsWidget()->informationWidget()->simulationWidget()->header(), SIGNAL(sectionResized(int, int, int)),
+               this, SLOT(simulationWidgetHeaderSectionResized(const int &, const int &, const int &)));
+    disconnect(pSimulationWidget->contentsWidget()->informationWidget()->solversWidget()->header(), SIGNAL(sectionResized(int, int, int)),
+               this, SLOT(solversWidgetHeaderSectionResized(const int &, const int &, const int &)));
+    disconnect(pSimulationWidget->contentsWidget()->informationWidget()->graphsWidget(), SIGNAL(headerSectionResized(int, int, int)),
+               this, SLOT(graphsWidgetHeaderSectionResized(const int &, const int &, const int &)));
+    disconnect(pSimulationWidget->contentsWidget()->informationWidget()->parametersWidget()->header(), SIGNAL(sectionResized(int, int, int)),
+               this, SLOT(parametersWidgetHeaderSectionResized(const int &, const int &, const int &)));
+}
+
+//==============================================================================
+
 void SingleCellViewWidget::updateContentsInformationGui(SingleCellViewSimulationWidget *pSimulationWidget)
 {
     // Update some of our simulation's contents' information GUI
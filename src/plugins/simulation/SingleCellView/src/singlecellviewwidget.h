@@ -32,6 +32,10 @@ limitations under the License.
 
 //==============================================================================
 
+class QTimer;
+
+//==============================================================================
+
 namespace libsedml {
     class SedAlgorithm;
 }   // namespace libsedml
@@ -92,6 +96,8 @@ public:
     SingleCellViewSimulation * simulation(const QString &pFileName) const;
     CellMLSupport::CellmlFileRuntime * runtime(const QString &pFileName) const;
 
+    CellMLSupport::CellmlFileRuntimeParameters graphParameters(const QString &pFileName) const;
+
     qulonglong simulationResultsSize(const QString &pFileName) const;
 
     void checkSimulationResults(const QString &pFileName,
@@ -126,12 +132,22 @@ private:
 
     QStringList mFileNames;
 
+    int mSimulationResultsUpdateRate;
+    QTimer *mSimulationResultsTimer;
+
     QMap<QString, qulonglong> mSimulationResultsSizes;
     QStringList mSimulationCheckResults;
 
     QMap<QString, QString> mLocallyManagedCellmlFiles;
     QMap<QString, QString> mLocallyManagedSedmlFiles;
 
+    bool updateSimulationResults(const QString &pFileName,
+                                 SingleCellViewSimulationWidget *pSimulationWidget,
+                                 const bool &pClearGraphs);
+
+    void startTrackingColumnWidths(SingleCellViewSimulationWidget *pSimulationWidget);
+    void stopTrackingColumnWidths(SingleCellViewSimulationWidget *pSimulationWidget);
+
     void updateContentsInformationGui(SingleCellViewSimulationWidget *pSimulationWidget);
 
     bool sedmlAlgorithmSupported(const libsedml::SedAlgorithm *pSedmlAlgorithm,
@@ -153,6 +169,8 @@ private:
                            COMBINESupport::CombineArchiveIssues &pCombineArchiveIssues);
 
 private slots:
+    void simulationWidgetInitialized();
+
     void simulationWidgetSplitterMoved(const QIntList &pSizes);
     void contentsWidgetSplitterMoved(const QIntList &pSizes);
 
@@ -171,7 +189,7 @@ private slots:
                                               const int &pOldSize,
                                               const int &pNewSize);
 
-    void callCheckSimulationResults();
+    void checkAllSimulationResults();
 };
 
 //==============================================================================
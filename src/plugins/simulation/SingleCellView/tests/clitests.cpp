@@ -0,0 +1,163 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+//==============================================================================
+// Single Cell view CLI tests
+//==============================================================================
+
+#include "../../../../tests/src/testsutils.h"
+
+//==============================================================================
+
+#include "clitests.h"
+
+//==============================================================================
+
+#include <QtTest/QtTest>
+
+//==============================================================================
+
+QList<double> CliTests::values(const QString &pLine)
+{
+    // Return the values in the given CSV line
+
+    QList<double> res = QList<double>();
+
+    foreach (const QString &value, pLine.split(","))
+        res << value.toDouble();
+
+    return res;
+}
+
+//==============================================================================
+
+void CliTests::compareValues(const QList<double> &pValues,
+                             const QList<double> &pExpectedValues)
+{
+    // Make sure that the given values are the same as the expected ones, give
+    // or take the precision with which they were output
+
+    QCOMPARE(pValues.count(), pExpectedValues.count());
+
+    for (int i = 0, iMax = pValues.count(); i < iMax; ++i) {
+        QVERIFY2(qAbs(pValues[i]-pExpectedValues[i]) <= 1.0e-5*qMax(1.0, qAbs(pExpectedValues[i])),
+                 qPrintable(QString("%1 vs. %2 (column %3)").arg(pValues[i]).arg(pExpectedValues[i]).arg(i+1)));
+    }
+}
+
+//==============================================================================
+
+void CliTests::sweepTests(const QString &pFileName, const QStringList &pOptions)
+{
+    // Sweep the epsilon constant of the van der Pol model
+
+    static const QList<double> Epsilons = QList<double>() << 0.5 << 1.0 << 2.0;
+
+    QStringList output = OpenCOR::runCli(QStringList() << "-c" << "SingleCellView::simulate" << pOptions << "-p" << "main/epsilon=0.5,1,2" << pFileName);
+
+    QCOMPARE(output.count(), Epsilons.count()+2);
+    QVERIFY(output.first().startsWith("main | epsilon (dimensionless),main | time (second),"));
+    QVERIFY(output.last().isEmpty());
+
+    // Check each member of our sweep against an independent run of a version
+    // of the model that uses the corresponding value of epsilon
+
+    QByteArray cellmlContents = OpenCOR::rawFileContents(OpenCOR::fileName("models/van_der_pol_model_1928.cellml"));
+    QByteArray sedmlContents = pFileName.endsWith(".sedml")?
+                                   OpenCOR::rawFileContents(pFileName):
+                                   QByteArray();
+    QStringList options = pOptions;
+
+    options.removeAll("-S");
+
+    for (int i = 0, iMax = Epsilons.count(); i < iMax; ++i) {
+        QTemporaryDir temporaryDir;
+        QString cellmlFileName = temporaryDir.path()+"/model.cellml";
+        QFile cellmlFile(cellmlFileName);
+
+        QVERIFY(cellmlFile.open(QIODevice::WriteOnly));
+
+        cellmlFile.write(QByteArray(cellmlContents).replace("initial_value=\"1\" name=\"epsilon\"",
+                                                            "initial_value=\""+QByteArray::number(Epsilons[i])+"\" name=\"epsilon\""));
+        cellmlFile.close();
+
+        QString fileName = cellmlFileName;
+
+        if (!sedmlContents.isEmpty()) {
+            fileName = temporaryDir.path()+"/model.sedml";
+
+            QFile sedmlFile(fileName);
+
+            QVERIFY(sedmlFile.open(QIODevice::WriteOnly));
+
+            sedmlFile.write(QByteArray(sedmlContents).replace("../../../../../../models/van_der_pol_model_1928.cellml",
+                                                              "model.cellml"));
+            sedmlFile.close();
+        }
+
+        QStringList singleOutput = OpenCOR::runCli(QStringList() << "-c" << "SingleCellView::simulate" << options << fileName);
+
+        QVERIFY(singleOutput.count() > 2);
+
+        QList<double> memberValues = values(output[i+1]);
+
+        QCOMPARE(memberValues.first(), Epsilons[i]);
+
+        compareValues(memberValues.mid(1), values(singleOutput[singleOutput.count()-2]));
+    }
+}
+
+//==============================================================================
+
+void CliTests::cellmlSweepTests()
+{
+    // Sweep a CellML file, which uses CVODE, i.e. a solver that doesn't
+    // support lanes, so that each member is run on its own
+
+    sweepTests(OpenCOR::fileName("models/van_der_pol_model_1928.cellml"),
+               QStringList() << "-e" << "5" << "-i" << "0.01");
+}
+
+//==============================================================================
+
+void CliTests::specializedCellmlSweepTests()
+{
+    // Sweep a CellML file using a version of the model that is specialised for
+    // the swept constant
+
+    sweepTests(OpenCOR::fileName("models/van_der_pol_model_1928.cellml"),
+               QStringList() << "-e" << "5" << "-i" << "0.01" << "-S");
+}
+
+//==============================================================================
+
+void CliTests::sedmlSweepTests()
+{
+    // Sweep a SED-ML file, which uses the fourth-order Runge-Kutta solver, i.e.
+    // a solver that supports lanes, so that our members are run in lockstep
+
+    sweepTests(OpenCOR::fileName("src/plugins/simulation/SingleCellView/tests/data/van_der_pol_model_1928.sedml"),
+               QStringList());
+}
+
+//==============================================================================
+
+QTEST_GUILESS_MAIN(CliTests)
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -0,0 +1,51 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+//==============================================================================
+// Single Cell view CLI tests
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include <QObject>
+#include <QStringList>
+
+//==============================================================================
+
+class CliTests : public QObject
+{
+    Q_OBJECT
+
+private:
+    QList<double> values(const QString &pLine);
+
+    void compareValues(const QList<double> &pValues,
+                       const QList<double> &pExpectedValues);
+
+    void sweepTests(const QString &pFileName, const QStringList &pOptions);
+
+private slots:
+    void cellmlSweepTests();
+    void specializedCellmlSweepTests();
+    void sedmlSweepTests();
+};
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -56,6 +56,57 @@ int rhsFunction(double pVoi, N_Vector pStates, N_Vector pRates, void *pUserData)
 
 //==============================================================================
 
+int denseJacobianFunction(long int pN, double pVoi, N_Vector pStates,
+                          N_Vector pRates, DlsMat pJacobian, void *pUserData,
+                          N_Vector pTemp1, N_Vector pTemp2, N_Vector pTemp3)
+{
+    Q_UNUSED(pRates);
+    Q_UNUSED(pTemp2);
+    Q_UNUSED(pTemp3);
+
+    // Compute the Jacobian of our ODE system and copy it to CVODE's dense
+    // matrix
+    // Note: we use pTemp1 as our rates array since we don't want to overwrite
+    //       the rates computed by CVODE...
+
+    double *jacobian = static_cast<CvodeSolverUserData *>(pUserData)->computeJacobian(pVoi, N_VGetArrayPointer_Serial(pTemp1),
+                                                                                      N_VGetArrayPointer_Serial(pStates));
+
+    for (long int i = 0; i < pN; ++i) {
+        for (long int j = 0; j < pN; ++j)
+            DENSE_ELEM(pJacobian, i, j) = jacobian[i*pN+j];
+    }
+
+    return 0;
+}
+
+//==============================================================================
+
+int bandJacobianFunction(long int pN, long int pMUpper, long int pMLower,
+                         double pVoi, N_Vector pStates, N_Vector pRates,
+                         DlsMat pJacobian, void *pUserData, N_Vector pTemp1,
+                         N_Vector pTemp2, N_Vector pTemp3)
+{
+    Q_UNUSED(pRates);
+    Q_UNUSED(pTemp2);
+    Q_UNUSED(pTemp3);
+
+    // Compute the Jacobian of our ODE system and copy the part of it that is
+    // within the band to CVODE's banded matrix
+
+    double *jacobian = static_cast<CvodeSolverUserData *>(pUserData)->computeJacobian(pVoi, N_VGetArrayPointer_Serial(pTemp1),
+                                                                                      N_VGetArrayPointer_Serial(pStates));
+
+    for (long int j = 0; j < pN; ++j) {
+        for (long int i = qMax(0L, j-pMUpper), iMax = qMin(pN-1, j+pMLower); i <= iMax; ++i)
+            BAND_ELEM(pJacobian, i, j) = jacobian[i*pN+j];
+    }
+
+    return 0;
+}
+
+//==============================================================================
+
 void errorHandler(int pErrorCode, const char *pModule, const char *pFunction,
                   char *pErrorMessage, void *pUserData)
 {
@@ -72,11 +123,33 @@ void errorHandler(int pErrorCode, const char *pModule, const char *pFunction,
 //==============================================================================
 
 CvodeSolverUserData::CvodeSolverUserData(double *pConstants, double *pAlgebraic,
-                                         Solver::OdeSolver::ComputeRatesFunction pComputeRates) :
+                                         Solver::OdeSolver::ComputeRatesFunction pComputeRates,
+                                         Solver::OdeSolver::ComputeJacobianFunction pComputeJacobian,
+                                         const int &pRatesStatesCount,
+                                         const int &pAlgebraicCount) :
     mConstants(pConstants),
     mAlgebraic(pAlgebraic),
-    mComputeRates(pComputeRates)
+    mComputeRates(pComputeRates),
+    mComputeJacobian(pComputeJacobian),
+    mJacobian(0),
+    mDAlgebraic(0)
+{
+    // Create the arrays needed to compute our Jacobian, if needed
+
+    if (mComputeJacobian) {
+        mJacobian = new double[pRatesStatesCount*pRatesStatesCount];
+        mDAlgebraic = new double[qMax(1, pAlgebraicCount*pRatesStatesCount)];
+    }
+}
+
+//==============================================================================
+
+CvodeSolverUserData::~CvodeSolverUserData()
 {
+    // Delete some internal objects
+
+    delete[] mJacobian;
+    delete[] mDAlgebraic;
 }
 
 //==============================================================================
@@ -108,6 +181,20 @@ Solver::OdeSolver::ComputeRatesFunction CvodeSolverUserData::computeRates() cons
 
 //==============================================================================
 
+double * CvodeSolverUserData::computeJacobian(const double &pVoi,
+                                              double *pRates,
+                                              double *pStates) const
+{
+    // Compute and return our Jacobian, which is stored in row-major order
+
+    mComputeJacobian(pVoi, mConstants, pRates, pStates, mAlgebraic,
+                     mJacobian, mDAlgebraic);
+
+    return mJacobian;
+}
+
+//==============================================================================
+
 CvodeSolver::CvodeSolver() :
     mSolver(0),
     mStatesVector(0),
@@ -150,6 +237,7 @@ void CvodeSolver::initialize(const double &pVoiStart,
         QString integrationMethod = IntegrationMethodDefaultValue;
         QString iterationType = IterationTypeDefaultValue;
         QString linearSolver = LinearSolverDefaultValue;
+        QString jacobian = JacobianDefaultValue;
         QString preconditioner = PreconditionerDefaultValue;
         int upperHalfBandwidth = UpperHalfBandwidthDefaultValue;
         int lowerHalfBandwidth = LowerHalfBandwidthDefaultValue;
@@ -221,6 +309,20 @@ void CvodeSolver::initialize(const double &pVoiStart,
                         }
                     }
 
+                    if (   !linearSolver.compare(DenseLinearSolver)
+                        || !linearSolver.compare(BandedLinearSolver)) {
+                        // We are dealing with a dense/banded linear solver, so
+                        // retrieve the way its Jacobian is to be computed
+
+                        if (mProperties.contains(JacobianId)) {
+                            jacobian = mProperties.value(JacobianId).toString();
+                        } else {
+                            emit error(QObject::tr("the 'Jacobian' property value could not be retrieved"));
+
+                            return;
+                        }
+                    }
+
                     if (needUpperAndLowerHalfBandwidths) {
                         if (mProperties.contains(UpperHalfBandwidthId)) {
                             upperHalfBandwidth = mProperties.value(UpperHalfBandwidthId).toInt();
@@ -327,8 +429,18 @@ void CvodeSolver::initialize(const double &pVoiStart,
 
         // Set some user data
 
+        // Note: we only use our analytic Jacobian, if any, with a dense or
+        //       banded linear solver...
+
+        bool analyticJacobian =    newtonIteration && mComputeJacobian
+                                && !jacobian.compare(AnalyticJacobian)
+                                && (   !linearSolver.compare(DenseLinearSolver)
+                                    || !linearSolver.compare(BandedLinearSolver));
+
         mUserData = new CvodeSolverUserData(pConstants, pAlgebraic,
-                                            pComputeRates);
+                                            pComputeRates,
+                                            analyticJacobian?mComputeJacobian:0,
+                                            pRatesStatesCount, mAlgebraicCount);
 
         CVodeSetUserData(mSolver, mUserData);
 
@@ -345,8 +457,14 @@ void CvodeSolver::initialize(const double &pVoiStart,
         if (newtonIteration) {
             if (!linearSolver.compare(DenseLinearSolver)) {
                 CVDense(mSolver, pRatesStatesCount);
+
+                if (analyticJacobian)
+                    CVDlsSetDenseJacFn(mSolver, denseJacobianFunction);
             } else if (!linearSolver.compare(BandedLinearSolver)) {
                 CVBand(mSolver, pRatesStatesCount, upperHalfBandwidth, lowerHalfBandwidth);
+
+                if (analyticJacobian)
+                    CVDlsSetBandJacFn(mSolver, bandJacobianFunction);
             } else if (!linearSolver.compare(DiagonalLinearSolver)) {
                 CVDiag(mSolver);
             } else {
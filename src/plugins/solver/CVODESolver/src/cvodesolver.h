@@ -42,6 +42,7 @@ static const auto MaximumNumberOfStepsId = QStringLiteral("MaximumNumberOfSteps"
 static const auto IntegrationMethodId    = QStringLiteral("IntegrationMethod");
 static const auto IterationTypeId        = QStringLiteral("IterationType");
 static const auto LinearSolverId         = QStringLiteral("LinearSolver");
+static const auto JacobianId             = QStringLiteral("Jacobian");
 static const auto PreconditionerId       = QStringLiteral("Preconditioner");
 static const auto UpperHalfBandwidthId   = QStringLiteral("UpperHalfBandwidth");
 static const auto LowerHalfBandwidthId   = QStringLiteral("LowerHalfBandwidth");
@@ -75,11 +76,18 @@ static const auto BandedPreconditioner = QStringLiteral("Banded");
 
 //==============================================================================
 
+static const auto AnalyticJacobian         = QStringLiteral("Analytic");
+static const auto FiniteDifferenceJacobian = QStringLiteral("Finite difference");
+
+//==============================================================================
+
 // Default CVODE parameter values
 // Note #1: a maximum step of 0 means that there is no maximum step as such and
 //          that CVODE can use whatever step it sees fit...
 // Note #2: CVODE's default maximum number of steps is 500 which ought to be big
 //          enough in most cases...
+// Note #3: our analytic Jacobian is opt-in, so by default we let CVODE compute
+//          the Jacobian using finite differences, as it has always done...
 
 static const double MaximumStepDefaultValue = 0.0;
 
@@ -90,6 +98,7 @@ enum {
 static const auto IntegrationMethodDefaultValue = BdfMethod;
 static const auto IterationTypeDefaultValue = NewtonIteration;
 static const auto LinearSolverDefaultValue = DenseLinearSolver;
+static const auto JacobianDefaultValue = FiniteDifferenceJacobian;
 static const auto PreconditionerDefaultValue = BandedPreconditioner;
 static const int UpperHalfBandwidthDefaultValue = 0;
 static const int LowerHalfBandwidthDefaultValue = 0;
@@ -105,18 +114,29 @@ class CvodeSolverUserData
 {
 public:
     explicit CvodeSolverUserData(double *pConstants, double *pAlgebraic,
-                                 Solver::OdeSolver::ComputeRatesFunction pComputeRates);
+                                 Solver::OdeSolver::ComputeRatesFunction pComputeRates,
+                                 Solver::OdeSolver::ComputeJacobianFunction pComputeJacobian = 0,
+                                 const int &pRatesStatesCount = 0,
+                                 const int &pAlgebraicCount = 0);
+    ~CvodeSolverUserData();
 
     double * constants() const;
     double * algebraic() const;
 
     Solver::OdeSolver::ComputeRatesFunction computeRates() const;
 
+    double * computeJacobian(const double &pVoi, double *pRates,
+                             double *pStates) const;
+
 private:
     double *mConstants;
     double *mAlgebraic;
 
     Solver::OdeSolver::ComputeRatesFunction mComputeRates;
+    Solver::OdeSolver::ComputeJacobianFunction mComputeJacobian;
+
+    double *mJacobian;
+    double *mDAlgebraic;
 };
 
 //==============================================================================
@@ -162,6 +162,7 @@ Solver::Properties CVODESolverPlugin::solverProperties() const
     Descriptions IntegrationMethodDescriptions;
     Descriptions IterationTypeDescriptions;
     Descriptions LinearSolverDescriptions;
+    Descriptions JacobianDescriptions;
     Descriptions PreconditionerDescriptions;
     Descriptions UpperHalfBandwidthDescriptions;
     Descriptions LowerHalfBandwidthDescriptions;
@@ -184,6 +185,9 @@ Solver::Properties CVODESolverPlugin::solverProperties() const
     LinearSolverDescriptions.insert("en", QString::fromUtf8("Linear solver"));
     LinearSolverDescriptions.insert("fr", QString::fromUtf8("Solveur linéaire"));
 
+    JacobianDescriptions.insert("en", QString::fromUtf8("Jacobian"));
+    JacobianDescriptions.insert("fr", QString::fromUtf8("Jacobienne"));
+
     PreconditionerDescriptions.insert("en", QString::fromUtf8("Preconditioner"));
     PreconditionerDescriptions.insert("fr", QString::fromUtf8("Préconditionneur"));
 
@@ -215,6 +219,9 @@ Solver::Properties CVODESolverPlugin::solverProperties() const
                                                        << BiCgStabLinearSolver
                                                        << TfqmrLinearSolver;
 
+    QStringList JacobianListValues = QStringList() << AnalyticJacobian
+                                                   << FiniteDifferenceJacobian;
+
     QStringList PreconditionerListValues = QStringList() << NoPreconditioner
                                                          << BandedPreconditioner;
 
@@ -223,6 +230,7 @@ Solver::Properties CVODESolverPlugin::solverProperties() const
                                 << Solver::Property(Solver::Property::List, IntegrationMethodId, IntegrationMethodDescriptions, IntegrationMethodListValues, IntegrationMethodDefaultValue, false)
                                 << Solver::Property(Solver::Property::List, IterationTypeId, IterationTypeDescriptions, IterationTypeListValues, IterationTypeDefaultValue, false)
                                 << Solver::Property(Solver::Property::List, LinearSolverId, LinearSolverDescriptions, LinearSolverListValues, LinearSolverDefaultValue, false)
+                                << Solver::Property(Solver::Property::List, JacobianId, JacobianDescriptions, JacobianListValues, JacobianDefaultValue, false)
                                 << Solver::Property(Solver::Property::List, PreconditionerId, PreconditionerDescriptions, PreconditionerListValues, PreconditionerDefaultValue, false)
                                 << Solver::Property(Solver::Property::Integer, UpperHalfBandwidthId, UpperHalfBandwidthDescriptions, QStringList(), UpperHalfBandwidthDefaultValue, false)
                                 << Solver::Property(Solver::Property::Integer, LowerHalfBandwidthId, LowerHalfBandwidthDescriptions, QStringList(), LowerHalfBandwidthDefaultValue, false)
@@ -247,22 +255,31 @@ QMap<QString, bool> CVODESolverPlugin::solverPropertiesVisibility(const QMap<QSt
 
         QString linearSolver = pSolverPropertiesValues.value(LinearSolverId);
 
-        if (   !linearSolver.compare(DenseLinearSolver)
-            || !linearSolver.compare(DiagonalLinearSolver)) {
-            // Dense/diagonal linear solver
+        if (!linearSolver.compare(DenseLinearSolver)) {
+            // Dense linear solver
+
+            res.insert(JacobianId, true);
+            res.insert(PreconditionerId, false);
+            res.insert(UpperHalfBandwidthId, false);
+            res.insert(LowerHalfBandwidthId, false);
+        } else if (!linearSolver.compare(DiagonalLinearSolver)) {
+            // Diagonal linear solver
 
+            res.insert(JacobianId, false);
             res.insert(PreconditionerId, false);
             res.insert(UpperHalfBandwidthId, false);
             res.insert(LowerHalfBandwidthId, false);
         } else if (!linearSolver.compare(BandedLinearSolver)) {
             // Banded linear solver
 
+            res.insert(JacobianId, true);
             res.insert(PreconditionerId, false);
             res.insert(UpperHalfBandwidthId, true);
             res.insert(LowerHalfBandwidthId, true);
         } else {
             // GMRES/Bi-CGStab/TFQMR linear solver
 
+            res.insert(JacobianId, false);
             res.insert(PreconditionerId, true);
 
             if (!pSolverPropertiesValues.value(PreconditionerId).compare(BandedPreconditioner)) {
@@ -281,6 +298,7 @@ QMap<QString, bool> CVODESolverPlugin::solverPropertiesVisibility(const QMap<QSt
         // Functional iteration
 
         res.insert(LinearSolverId, false);
+        res.insert(JacobianId, false);
         res.insert(PreconditionerId, false);
         res.insert(UpperHalfBandwidthId, false);
         res.insert(LowerHalfBandwidthId, false);
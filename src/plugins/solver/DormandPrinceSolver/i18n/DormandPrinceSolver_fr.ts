@@ -0,0 +1,43 @@
+<?xml version="1.0" encoding="utf-8"?>
+<!DOCTYPE TS>
+<TS version="2.1" language="fr_FR" sourcelanguage="en_GB">
+<context>
+    <name>QObject</name>
+    <message>
+        <source>the &apos;maximum step&apos; property must have a value greater than or equal to 0</source>
+        <translation>la propriété &apos;pas maximum&apos; doit avoir une valeur plus grande que ou égale à 0</translation>
+    </message>
+    <message>
+        <source>the &apos;maximum step&apos; property value could not be retrieved</source>
+        <translation>la valeur de la propriété &apos;pas maximum&apos; n&apos;a pas pu être retrouvée</translation>
+    </message>
+    <message>
+        <source>the &apos;relative tolerance&apos; property must have a value greater than or equal to 0</source>
+        <translation>la propriété &apos;tolérance relative&apos; doit avoir une valeur plus grande que ou égale à 0</translation>
+    </message>
+    <message>
+        <source>the &apos;relative tolerance&apos; property value could not be retrieved</source>
+        <translation>la valeur de la propriété &apos;tolérance relative&apos; n&apos;a pas pu être retrouvée</translation>
+    </message>
+    <message>
+        <source>the &apos;absolute tolerance&apos; property must have a value greater than or equal to 0</source>
+        <translation>la propriété &apos;tolérance absolue&apos; doit avoir une valeur plus grande que ou égale à 0</translation>
+    </message>
+    <message>
+        <source>the &apos;absolute tolerance&apos; property value could not be retrieved</source>
+        <translation>la valeur de la propriété &apos;tolérance absolue&apos; n&apos;a pas pu être retrouvée</translation>
+    </message>
+    <message>
+        <source>the &apos;relative tolerance&apos; and &apos;absolute tolerance&apos; properties cannot both be equal to zero</source>
+        <translation>les propriétés &apos;tolérance relative&apos; et &apos;tolérance absolue&apos; ne peuvent pas toutes les deux être égales à zéro</translation>
+    </message>
+    <message>
+        <source>the &apos;interpolate solution&apos; property value could not be retrieved</source>
+        <translation>la valeur de la propriété &apos;interpoler solution&apos; n&apos;a pas pu être retrouvée</translation>
+    </message>
+    <message>
+        <source>the step size became too small</source>
+        <translation>la taille du pas est devenue trop petite</translation>
+    </message>
+</context>
+</TS>
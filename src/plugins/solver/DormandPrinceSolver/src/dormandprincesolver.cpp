@@ -0,0 +1,533 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Dormand-Prince solver
+//==============================================================================
+
+#include "dormandprincesolver.h"
+
+//==============================================================================
+
+#include <QtNumeric>
+
+//==============================================================================
+
+#include <cfloat>
+#include <cmath>
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace DormandPrinceSolver {
+
+//==============================================================================
+
+// Dormand-Prince 5(4) coefficients, as given by Hairer et al. in their DOPRI5
+// implementation
+
+static const double C2 = 1.0/5.0;
+static const double C3 = 3.0/10.0;
+static const double C4 = 4.0/5.0;
+static const double C5 = 8.0/9.0;
+
+static const double A21 = 1.0/5.0;
+static const double A31 = 3.0/40.0;
+static const double A32 = 9.0/40.0;
+static const double A41 = 44.0/45.0;
+static const double A42 = -56.0/15.0;
+static const double A43 = 32.0/9.0;
+static const double A51 = 19372.0/6561.0;
+static const double A52 = -25360.0/2187.0;
+static const double A53 = 64448.0/6561.0;
+static const double A54 = -212.0/729.0;
+static const double A61 = 9017.0/3168.0;
+static const double A62 = -355.0/33.0;
+static const double A63 = 46732.0/5247.0;
+static const double A64 = 49.0/176.0;
+static const double A65 = -5103.0/18656.0;
+static const double A71 = 35.0/384.0;
+static const double A73 = 500.0/1113.0;
+static const double A74 = 125.0/192.0;
+static const double A75 = -2187.0/6784.0;
+static const double A76 = 11.0/84.0;
+
+static const double E1 = 71.0/57600.0;
+static const double E3 = -71.0/16695.0;
+static const double E4 = 71.0/1920.0;
+static const double E5 = -17253.0/339200.0;
+static const double E6 = 22.0/525.0;
+static const double E7 = -1.0/40.0;
+
+static const double D1 = -12715105075.0/11282082432.0;
+static const double D3 = 87487479700.0/32700410799.0;
+static const double D4 = -10690763975.0/1880347072.0;
+static const double D5 = 701980252875.0/199316789632.0;
+static const double D6 = -1453857185.0/822651844.0;
+static const double D7 = 69997945.0/29380423.0;
+
+//==============================================================================
+
+// Step size control parameters
+
+static const double SafetyFactor = 0.9;
+static const double MinimumStepFactor = 0.2;
+static const double MaximumStepFactor = 10.0;
+
+//==============================================================================
+
+DormandPrinceSolver::DormandPrinceSolver() :
+    mMaximumStep(MaximumStepDefaultValue),
+    mRelativeTolerance(RelativeToleranceDefaultValue),
+    mAbsoluteTolerance(AbsoluteToleranceDefaultValue),
+    mInterpolateSolution(InterpolateSolutionDefaultValue),
+    mVoi(0.0),
+    mVoiOld(0.0),
+    mStep(0.0),
+    mHasStep(false),
+    mStepRejected(false),
+    mY(0),
+    mYNew(0),
+    mYTemp(0),
+    mK1(0),
+    mK2(0),
+    mK3(0),
+    mK4(0),
+    mK5(0),
+    mK6(0),
+    mK7(0),
+    mRCont1(0),
+    mRCont2(0),
+    mRCont3(0),
+    mRCont4(0),
+    mRCont5(0)
+{
+}
+
+//==============================================================================
+
+DormandPrinceSolver::~DormandPrinceSolver()
+{
+    // Delete some internal objects
+
+    deleteArrays();
+}
+
+//==============================================================================
+
+void DormandPrinceSolver::deleteArrays()
+{
+    // Delete our various arrays
+
+    delete[] mY;
+    delete[] mYNew;
+    delete[] mYTemp;
+
+    delete[] mK1;
+    delete[] mK2;
+    delete[] mK3;
+    delete[] mK4;
+    delete[] mK5;
+    delete[] mK6;
+    delete[] mK7;
+
+    delete[] mRCont1;
+    delete[] mRCont2;
+    delete[] mRCont3;
+    delete[] mRCont4;
+    delete[] mRCont5;
+}
+
+//==============================================================================
+
+void DormandPrinceSolver::initialize(const double &pVoiStart,
+                                     const int &pRatesStatesCount,
+                                     double *pConstants, double *pRates,
+                                     double *pStates, double *pAlgebraic,
+                                     ComputeRatesFunction pComputeRates)
+{
+    // Retrieve the solver's properties
+
+    if (mProperties.contains(MaximumStepId)) {
+        mMaximumStep = mProperties.value(MaximumStepId).toDouble();
+
+        if (mMaximumStep < 0.0) {
+            emit error(QObject::tr("the 'maximum step' property must have a value greater than or equal to 0"));
+
+            return;
+        }
+    } else {
+        emit error(QObject::tr("the 'maximum step' property value could not be retrieved"));
+
+        return;
+    }
+
+    if (mProperties.contains(RelativeToleranceId)) {
+        mRelativeTolerance = mProperties.value(RelativeToleranceId).toDouble();
+
+        if (mRelativeTolerance < 0.0) {
+            emit error(QObject::tr("the 'relative tolerance' property must have a value greater than or equal to 0"));
+
+            return;
+        }
+    } else {
+        emit error(QObject::tr("the 'relative tolerance' property value could not be retrieved"));
+
+        return;
+    }
+
+    if (mProperties.contains(AbsoluteToleranceId)) {
+        mAbsoluteTolerance = mProperties.value(AbsoluteToleranceId).toDouble();
+
+        if (mAbsoluteTolerance < 0.0) {
+            emit error(QObject::tr("the 'absolute tolerance' property must have a value greater than or equal to 0"));
+
+            return;
+        }
+    } else {
+        emit error(QObject::tr("the 'absolute tolerance' property value could not be retrieved"));
+
+        return;
+    }
+
+    if (!mRelativeTolerance && !mAbsoluteTolerance) {
+        emit error(QObject::tr("the 'relative tolerance' and 'absolute tolerance' properties cannot both be equal to zero"));
+
+        return;
+    }
+
+    if (mProperties.contains(InterpolateSolutionId)) {
+        mInterpolateSolution = mProperties.value(InterpolateSolutionId).toBool();
+    } else {
+        emit error(QObject::tr("the 'interpolate solution' property value could not be retrieved"));
+
+        return;
+    }
+
+    // Initialise the ODE solver itself
+
+    OpenCOR::Solver::OdeSolver::initialize(pVoiStart, pRatesStatesCount,
+                                           pConstants, pRates, pStates,
+                                           pAlgebraic, pComputeRates);
+
+    // (Re)create our various arrays
+
+    deleteArrays();
+
+    mY     = new double[pRatesStatesCount];
+    mYNew  = new double[pRatesStatesCount];
+    mYTemp = new double[pRatesStatesCount];
+
+    mK1 = new double[pRatesStatesCount];
+    mK2 = new double[pRatesStatesCount];
+    mK3 = new double[pRatesStatesCount];
+    mK4 = new double[pRatesStatesCount];
+    mK5 = new double[pRatesStatesCount];
+    mK6 = new double[pRatesStatesCount];
+    mK7 = new double[pRatesStatesCount];
+
+    mRCont1 = new double[pRatesStatesCount];
+    mRCont2 = new double[pRatesStatesCount];
+    mRCont3 = new double[pRatesStatesCount];
+    mRCont4 = new double[pRatesStatesCount];
+    mRCont5 = new double[pRatesStatesCount];
+
+    // Keep track of our initial conditions and compute the corresponding rates,
+    // which we need for our first step
+    // Note: our step size is computed upon our first step since it depends on
+    //       the direction of integration...
+
+    memcpy(mY, pStates, pRatesStatesCount*OpenCOR::Solver::SizeOfDouble);
+
+    mComputeRates(pVoiStart, mConstants, mK1, mY, mAlgebraic);
+
+    mVoi = mVoiOld = pVoiStart;
+    mStep = 0.0;
+
+    mHasStep = false;
+    mStepRejected = false;
+}
+
+//==============================================================================
+
+void DormandPrinceSolver::solve(double &pVoi, const double &pVoiEnd) const
+{
+    // Integrate our model from our current point until pVoiEnd is reached
+    // Note: if we are to interpolate our solution, then we never truncate a
+    //       step to reach pVoiEnd. Instead, we let our error control choose our
+    //       steps and use the dense output of our last step to compute our
+    //       solution at pVoiEnd. Since our steps may overshoot pVoiEnd, our
+    //       internal state (mVoi, mY, etc.) may be ahead of pVoi...
+
+    double direction = (pVoiEnd >= pVoi)?1.0:-1.0;
+
+    if (!mStep)
+        mStep = initialStep(direction);
+
+    forever {
+        // Check whether our last step covers pVoiEnd, in which case we can
+        // interpolate our solution, or whether we have reached pVoiEnd
+
+        if (   mInterpolateSolution && mHasStep
+            && ((pVoiEnd-mVoiOld)*direction >= 0.0)
+            && ((mVoi-pVoiEnd)*direction >= 0.0)) {
+            interpolate(pVoiEnd);
+
+            break;
+        } else if (mVoi == pVoiEnd) {
+            memcpy(mStates, mY, mRatesStatesCount*OpenCOR::Solver::SizeOfDouble);
+
+            break;
+        }
+
+        // Determine the step to take, making sure that we don't go past pVoiEnd
+        // if we are not to interpolate our solution
+
+        double realStep = mStep;
+
+        if (mMaximumStep && (realStep > mMaximumStep))
+            realStep = mMaximumStep;
+
+        realStep *= direction;
+
+        bool lastStep = !mInterpolateSolution && ((mVoi+realStep-pVoiEnd)*direction >= 0.0);
+
+        if (lastStep)
+            realStep = pVoiEnd-mVoi;
+
+        // Make sure that our step is not too small
+
+        if (fabs(realStep) <= 10.0*DBL_EPSILON*fabs(mVoi)) {
+            // Note: solve() is const while emitError() is not, hence we need
+            //       to cast away our constness...
+
+            const_cast<DormandPrinceSolver *>(this)->emitError(QObject::tr("the step size became too small"));
+
+            return;
+        }
+
+        // Take our step and, if it was a truncated last step that got accepted,
+        // make sure that we are exactly at pVoiEnd
+        // Note: a truncated step tells us nothing about the step that our error
+        //       control would otherwise have taken, hence we only ever reduce
+        //       our step size in that case...
+
+        double stepSize = mStep;
+
+        if (step(realStep) && lastStep) {
+            mVoi = pVoiEnd;
+            mStep = stepSize*qMin(1.0, mStep/fabs(realStep));
+        }
+    }
+
+    pVoi = pVoiEnd;
+
+    // Compute our rates one more time to get up to date values for our rates
+    // and algebraic variables at pVoiEnd
+    // Note: our stages only ever compute rates into our internal arrays, and
+    //       our algebraic variables are otherwise left with their values for
+    //       our last stage, which is not at pVoiEnd if we interpolated our
+    //       solution...
+
+    mComputeRates(pVoiEnd, mConstants, mRates, mStates, mAlgebraic);
+}
+
+//==============================================================================
+
+double DormandPrinceSolver::initialStep(const double &pDirection) const
+{
+    // Compute an initial step size, following Hairer et al.'s approach
+
+    double dnf = 0.0;
+    double dny = 0.0;
+
+    for (int i = 0; i < mRatesStatesCount; ++i) {
+        double scale = mAbsoluteTolerance+mRelativeTolerance*fabs(mY[i]);
+        double f = mK1[i]/scale;
+        double y = mY[i]/scale;
+
+        dnf += f*f;
+        dny += y*y;
+    }
+
+    double res = ((dnf <= 1.0e-10) || (dny <= 1.0e-10))?
+                     1.0e-6:
+                     0.01*sqrt(dny/dnf);
+
+    if (mMaximumStep && (res > mMaximumStep))
+        res = mMaximumStep;
+
+    // Take an explicit Euler step and use it to estimate our second derivative
+
+    for (int i = 0; i < mRatesStatesCount; ++i)
+        mYTemp[i] = mY[i]+pDirection*res*mK1[i];
+
+    mComputeRates(mVoi+pDirection*res, mConstants, mK2, mYTemp, mAlgebraic);
+
+    double der2 = 0.0;
+
+    for (int i = 0; i < mRatesStatesCount; ++i) {
+        double scale = mAbsoluteTolerance+mRelativeTolerance*fabs(mY[i]);
+        double d = (mK2[i]-mK1[i])/scale;
+
+        der2 += d*d;
+    }
+
+    der2 = sqrt(der2)/res;
+
+    double der12 = qMax(der2, sqrt(dnf));
+    double h1 = (der12 <= 1.0e-15)?
+                    qMax(1.0e-6, 1.0e-3*res):
+                    pow(0.01/der12, 0.2);
+
+    res = qMin(100.0*res, h1);
+
+    if (mMaximumStep && (res > mMaximumStep))
+        res = mMaximumStep;
+
+    return res;
+}
+
+//==============================================================================
+
+bool DormandPrinceSolver::step(const double &pStep) const
+{
+    // Compute our different stages
+    // Note: mK1 already contains the rates at mVoi, either from our
+    //       initialisation or from the last stage of our previous step (i.e.
+    //       First Same As Last)...
+
+    double voiNew = mVoi+pStep;
+
+    for (int i = 0; i < mRatesStatesCount; ++i)
+        mYTemp[i] = mY[i]+pStep*A21*mK1[i];
+
+    mComputeRates(mVoi+C2*pStep, mConstants, mK2, mYTemp, mAlgebraic);
+
+    for (int i = 0; i < mRatesStatesCount; ++i)
+        mYTemp[i] = mY[i]+pStep*(A31*mK1[i]+A32*mK2[i]);
+
+    mComputeRates(mVoi+C3*pStep, mConstants, mK3, mYTemp, mAlgebraic);
+
+    for (int i = 0; i < mRatesStatesCount; ++i)
+        mYTemp[i] = mY[i]+pStep*(A41*mK1[i]+A42*mK2[i]+A43*mK3[i]);
+
+    mComputeRates(mVoi+C4*pStep, mConstants, mK4, mYTemp, mAlgebraic);
+
+    for (int i = 0; i < mRatesStatesCount; ++i)
+        mYTemp[i] = mY[i]+pStep*(A51*mK1[i]+A52*mK2[i]+A53*mK3[i]+A54*mK4[i]);
+
+    mComputeRates(mVoi+C5*pStep, mConstants, mK5, mYTemp, mAlgebraic);
+
+    for (int i = 0; i < mRatesStatesCount; ++i)
+        mYTemp[i] = mY[i]+pStep*(A61*mK1[i]+A62*mK2[i]+A63*mK3[i]+A64*mK4[i]+A65*mK5[i]);
+
+    mComputeRates(voiNew, mConstants, mK6, mYTemp, mAlgebraic);
+
+    for (int i = 0; i < mRatesStatesCount; ++i)
+        mYNew[i] = mY[i]+pStep*(A71*mK1[i]+A73*mK3[i]+A74*mK4[i]+A75*mK5[i]+A76*mK6[i]);
+
+    mComputeRates(voiNew, mConstants, mK7, mYNew, mAlgebraic);
+
+    // Estimate our local error
+
+    double error = 0.0;
+
+    for (int i = 0; i < mRatesStatesCount; ++i) {
+        double scale = mAbsoluteTolerance+mRelativeTolerance*qMax(fabs(mY[i]), fabs(mYNew[i]));
+        double e = pStep*(E1*mK1[i]+E3*mK3[i]+E4*mK4[i]+E5*mK5[i]+E6*mK6[i]+E7*mK7[i])/scale;
+
+        error += e*e;
+    }
+
+    if (mRatesStatesCount)
+        error = sqrt(error/mRatesStatesCount);
+
+    // Determine by how much our step size should change
+
+    double factor;
+
+    if (!qIsFinite(error))
+        factor = MinimumStepFactor;
+    else if (!error)
+        factor = MaximumStepFactor;
+    else
+        factor = qBound(MinimumStepFactor, SafetyFactor*pow(error, -0.2), MaximumStepFactor);
+
+    if (!qIsFinite(error) || (error > 1.0)) {
+        // Our step is rejected, so reduce our step size and try again
+        // Note: a NaN error would compare as false against 1.0, hence we need
+        //       to reject non-finite errors explicitly...
+
+        mStep = fabs(pStep)*qMin(factor, 1.0);
+        mStepRejected = true;
+
+        return false;
+    }
+
+    // Our step is accepted, so compute our dense output coefficients, if
+    // needed, and advance through time
+
+    if (mInterpolateSolution) {
+        for (int i = 0; i < mRatesStatesCount; ++i) {
+            double yDiff = mYNew[i]-mY[i];
+            double bSpl = pStep*mK1[i]-yDiff;
+
+            mRCont1[i] = mY[i];
+            mRCont2[i] = yDiff;
+            mRCont3[i] = bSpl;
+            mRCont4[i] = yDiff-pStep*mK7[i]-bSpl;
+            mRCont5[i] = pStep*(D1*mK1[i]+D3*mK3[i]+D4*mK4[i]+D5*mK5[i]+D6*mK6[i]+D7*mK7[i]);
+        }
+    }
+
+    memcpy(mY, mYNew, mRatesStatesCount*OpenCOR::Solver::SizeOfDouble);
+    memcpy(mK1, mK7, mRatesStatesCount*OpenCOR::Solver::SizeOfDouble);
+
+    mVoiOld = mVoi;
+    mVoi = voiNew;
+
+    mStep = fabs(pStep)*(mStepRejected?qMin(factor, 1.0):factor);
+
+    mHasStep = true;
+    mStepRejected = false;
+
+    return true;
+}
+
+//==============================================================================
+
+void DormandPrinceSolver::interpolate(const double &pVoi) const
+{
+    // Use the dense output of our last step to compute our solution at pVoi
+
+    double theta = (pVoi-mVoiOld)/(mVoi-mVoiOld);
+    double theta1 = 1.0-theta;
+
+    for (int i = 0; i < mRatesStatesCount; ++i)
+        mStates[i] = mRCont1[i]+theta*(mRCont2[i]+theta1*(mRCont3[i]+theta*(mRCont4[i]+theta1*mRCont5[i])));
+}
+
+//==============================================================================
+
+}   // namespace DormandPrinceSolver
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -0,0 +1,113 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Dormand-Prince solver
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include "solverinterface.h"
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace DormandPrinceSolver {
+
+//==============================================================================
+
+static const auto MaximumStepId         = QStringLiteral("MaximumStep");
+static const auto RelativeToleranceId   = QStringLiteral("RelativeTolerance");
+static const auto AbsoluteToleranceId   = QStringLiteral("AbsoluteTolerance");
+static const auto InterpolateSolutionId = QStringLiteral("InterpolateSolution");
+
+//==============================================================================
+
+// Default Dormand-Prince parameter values
+// Note: a maximum step of 0 means that there is no maximum step as such and
+//       that we can use whatever step our error control sees fit...
+
+static const double MaximumStepDefaultValue = 0.0;
+
+static const double RelativeToleranceDefaultValue = 1.0e-7;
+static const double AbsoluteToleranceDefaultValue = 1.0e-7;
+
+static const bool InterpolateSolutionDefaultValue = true;
+
+//==============================================================================
+
+class DormandPrinceSolver : public Solver::OdeSolver
+{
+public:
+    explicit DormandPrinceSolver();
+    ~DormandPrinceSolver();
+
+    virtual void initialize(const double &pVoiStart,
+                            const int &pRatesStatesCount, double *pConstants,
+                            double *pRates, double *pStates, double *pAlgebraic,
+                            ComputeRatesFunction pComputeRates);
+
+    virtual void solve(double &pVoi, const double &pVoiEnd) const;
+
+private:
+    double mMaximumStep;
+    double mRelativeTolerance;
+    double mAbsoluteTolerance;
+    bool mInterpolateSolution;
+
+    mutable double mVoi;
+    mutable double mVoiOld;
+    mutable double mStep;
+    mutable bool mHasStep;
+    mutable bool mStepRejected;
+
+    double *mY;
+    double *mYNew;
+    double *mYTemp;
+
+    double *mK1;
+    double *mK2;
+    double *mK3;
+    double *mK4;
+    double *mK5;
+    double *mK6;
+    double *mK7;
+
+    double *mRCont1;
+    double *mRCont2;
+    double *mRCont3;
+    double *mRCont4;
+    double *mRCont5;
+
+    void deleteArrays();
+
+    double initialStep(const double &pDirection) const;
+    bool step(const double &pStep) const;
+    void interpolate(const double &pVoi) const;
+};
+
+//==============================================================================
+
+}   // namespace DormandPrinceSolver
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -0,0 +1,175 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Dormand-Prince solver plugin
+//==============================================================================
+
+#include "dormandprincesolver.h"
+#include "dormandprincesolverplugin.h"
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace DormandPrinceSolver {
+
+//==============================================================================
+
+PLUGININFO_FUNC DormandPrinceSolverPluginInfo()
+{
+    Descriptions descriptions;
+
+    descriptions.insert("en", QString::fromUtf8("a plugin that implements the <a href=\"https://en.wikipedia.org/wiki/Dormand–Prince_method\">Dormand-Prince method</a> to solve ODEs."));
+    descriptions.insert("fr", QString::fromUtf8("une extension qui implémente la <a href=\"https://en.wikipedia.org/wiki/Dormand–Prince_method\">méthode de Dormand-Prince</a> pour résoudre des EDOs."));
+
+    return new PluginInfo("Solver", true, false,
+                          QStringList(),
+                          descriptions);
+}
+
+//==============================================================================
+// I18n interface
+//==============================================================================
+
+
+void DormandPrinceSolverPlugin::retranslateUi()
+{
+    // We don't handle this interface...
+    // Note: even though we don't handle this interface, we still want to
+    //       support it since some other aspects of our plugin are
+    //       multilingual...
+}
+
+//==============================================================================
+// Solver interface
+//==============================================================================
+
+
+Solver::Solver * DormandPrinceSolverPlugin::solverInstance() const
+{
+    // Create and return an instance of the solver
+
+    return new DormandPrinceSolver();
+}
+
+//==============================================================================
+
+QString DormandPrinceSolverPlugin::id(const QString &pKisaoId) const
+{
+    // Return the id for the given KiSAO id
+
+    if (!pKisaoId.compare("KISAO:0000087"))
+        return solverName();
+    else if (!pKisaoId.compare("KISAO:0000467"))
+        return MaximumStepId;
+    else if (!pKisaoId.compare("KISAO:0000209"))
+        return RelativeToleranceId;
+    else if (!pKisaoId.compare("KISAO:0000211"))
+        return AbsoluteToleranceId;
+    else if (!pKisaoId.compare("KISAO:0000481"))
+        return InterpolateSolutionId;
+
+    return QString();
+}
+
+//==============================================================================
+
+QString DormandPrinceSolverPlugin::kisaoId(const QString &pId) const
+{
+    // Return the KiSAO id for the given id
+
+    if (!pId.compare(solverName()))
+        return "KISAO:0000087";
+    else if (!pId.compare(MaximumStepId))
+        return "KISAO:0000467";
+    else if (!pId.compare(RelativeToleranceId))
+        return "KISAO:0000209";
+    else if (!pId.compare(AbsoluteToleranceId))
+        return "KISAO:0000211";
+    else if (!pId.compare(InterpolateSolutionId))
+        return "KISAO:0000481";
+
+    return QString();
+}
+
+//==============================================================================
+
+Solver::Type DormandPrinceSolverPlugin::solverType() const
+{
+    // Return the type of the solver
+
+    return Solver::Ode;
+}
+
+//==============================================================================
+
+QString DormandPrinceSolverPlugin::solverName() const
+{
+    // Return the name of the solver
+
+    return "Dormand-Prince";
+}
+
+//==============================================================================
+
+Solver::Properties DormandPrinceSolverPlugin::solverProperties() const
+{
+    // Return the properties supported by the solver
+
+    Descriptions MaximumStepDescriptions;
+    Descriptions RelativeToleranceDescriptions;
+    Descriptions AbsoluteToleranceDescriptions;
+    Descriptions InterpolateSolutionDescriptions;
+
+    MaximumStepDescriptions.insert("en", QString::fromUtf8("Maximum step"));
+    MaximumStepDescriptions.insert("fr", QString::fromUtf8("Pas maximum"));
+
+    RelativeToleranceDescriptions.insert("en", QString::fromUtf8("Relative tolerance"));
+    RelativeToleranceDescriptions.insert("fr", QString::fromUtf8("Tolérance relative"));
+
+    AbsoluteToleranceDescriptions.insert("en", QString::fromUtf8("Absolute tolerance"));
+    AbsoluteToleranceDescriptions.insert("fr", QString::fromUtf8("Tolérance absolue"));
+
+    InterpolateSolutionDescriptions.insert("en", QString::fromUtf8("Interpolate solution"));
+    InterpolateSolutionDescriptions.insert("fr", QString::fromUtf8("Interpoler solution"));
+
+    return Solver::Properties() << Solver::Property(Solver::Property::Double, MaximumStepId, MaximumStepDescriptions, QStringList(), MaximumStepDefaultValue, true)
+                                << Solver::Property(Solver::Property::Double, RelativeToleranceId, RelativeToleranceDescriptions, QStringList(), RelativeToleranceDefaultValue, false)
+                                << Solver::Property(Solver::Property::Double, AbsoluteToleranceId, AbsoluteToleranceDescriptions, QStringList(), AbsoluteToleranceDefaultValue, false)
+                                << Solver::Property(Solver::Property::Boolean, InterpolateSolutionId, InterpolateSolutionDescriptions, QStringList(), InterpolateSolutionDefaultValue, false);
+}
+
+//==============================================================================
+
+QMap<QString, bool> DormandPrinceSolverPlugin::solverPropertiesVisibility(const QMap<QString, QString> &pSolverPropertiesValues) const
+{
+    Q_UNUSED(pSolverPropertiesValues);
+
+    // We don't handle this interface...
+
+    return QMap<QString, bool>();
+}
+
+//==============================================================================
+
+}   // namespace DormandPrinceSolver
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -0,0 +1,288 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Dormand-Prince solver tests
+//==============================================================================
+
+#include "dormandprincesolver.h"
+#include "tests.h"
+
+//==============================================================================
+
+#include <QtTest/QtTest>
+
+//==============================================================================
+
+#include <math.h>
+
+//==============================================================================
+
+static const double Tolerance = 1.0e-10;
+
+//==============================================================================
+
+static OpenCOR::Solver::Solver::Properties properties(const bool &pInterpolateSolution)
+{
+    // Return the properties to be used by our solver
+
+    OpenCOR::Solver::Solver::Properties res = OpenCOR::Solver::Solver::Properties();
+
+    res.insert(OpenCOR::DormandPrinceSolver::MaximumStepId, OpenCOR::DormandPrinceSolver::MaximumStepDefaultValue);
+    res.insert(OpenCOR::DormandPrinceSolver::RelativeToleranceId, Tolerance);
+    res.insert(OpenCOR::DormandPrinceSolver::AbsoluteToleranceId, Tolerance);
+    res.insert(OpenCOR::DormandPrinceSolver::InterpolateSolutionId, pInterpolateSolution);
+
+    return res;
+}
+
+//==============================================================================
+
+static int exponentialDecayRates(double VOI, double *CONSTANTS, double *RATES,
+                                 double *STATES, double *ALGEBRAIC)
+{
+    Q_UNUSED(VOI);
+    Q_UNUSED(ALGEBRAIC);
+
+    RATES[0] = -CONSTANTS[0]*STATES[0];
+
+    return 0;
+}
+
+//==============================================================================
+
+static int algebraicDecayRates(double VOI, double *CONSTANTS, double *RATES,
+                               double *STATES, double *ALGEBRAIC)
+{
+    ALGEBRAIC[0] = CONSTANTS[0]*STATES[0];
+    ALGEBRAIC[1] = VOI;
+
+    RATES[0] = -ALGEBRAIC[0];
+
+    return 0;
+}
+
+//==============================================================================
+
+static int vanDerPolRates(double VOI, double *CONSTANTS, double *RATES,
+                          double *STATES, double *ALGEBRAIC)
+{
+    Q_UNUSED(VOI);
+    Q_UNUSED(ALGEBRAIC);
+
+    RATES[0] = STATES[1];
+    RATES[1] = CONSTANTS[0]*(1.0-STATES[0]*STATES[0])*STATES[1]-STATES[0];
+
+    return 0;
+}
+
+//==============================================================================
+
+static int singularRates(double VOI, double *CONSTANTS, double *RATES,
+                         double *STATES, double *ALGEBRAIC)
+{
+    Q_UNUSED(CONSTANTS);
+    Q_UNUSED(STATES);
+    Q_UNUSED(ALGEBRAIC);
+
+    // Note: our rate cannot be computed past VOI = 1...
+
+    RATES[0] = (VOI > 1.0)?qQNaN():0.0;
+
+    return 0;
+}
+
+//==============================================================================
+
+void Tests::exponentialDecayTests()
+{
+    // Solve dy/dt = -k*y, with and without interpolating our solution, and
+    // check our solution against its analytical solution
+
+    for (int i = 0; i < 2; ++i) {
+        OpenCOR::DormandPrinceSolver::DormandPrinceSolver solver;
+        double constants[1] = { 0.7 };
+        double rates[1];
+        double states[1] = { 1.0 };
+        double algebraic[1];
+        double voi = 0.0;
+
+        QSignalSpy errorSpy(&solver, SIGNAL(error(const QString &)));
+
+        solver.setProperties(properties(i));
+        solver.initialize(voi, 1, constants, rates, states, algebraic,
+                          exponentialDecayRates);
+
+        for (int j = 1; j <= 20; ++j) {
+            solver.solve(voi, 0.5*j);
+
+            QCOMPARE(voi, 0.5*j);
+            QVERIFY(fabs(states[0]-exp(-constants[0]*voi)) < 1.0e-8);
+        }
+
+        QCOMPARE(errorSpy.count(), 0);
+    }
+}
+
+//==============================================================================
+
+void Tests::ratesAndAlgebraicTests()
+{
+    // Solve dy/dt = -k*y, with k*y computed as an algebraic variable, while
+    // interpolating our solution, and check that our rates and algebraic
+    // variables are up to date at our (interpolated) output points
+
+    OpenCOR::DormandPrinceSolver::DormandPrinceSolver solver;
+    double constants[1] = { 0.7 };
+    double rates[1] = { 0.0 };
+    double states[1] = { 1.0 };
+    double algebraic[2] = { 0.0, 0.0 };
+    double voi = 0.0;
+
+    QSignalSpy errorSpy(&solver, SIGNAL(error(const QString &)));
+
+    solver.setProperties(properties(true));
+    solver.initialize(voi, 1, constants, rates, states, algebraic,
+                      algebraicDecayRates);
+
+    for (int j = 1; j <= 20; ++j) {
+        solver.solve(voi, 0.5*j);
+
+        double expectedAlgebraic = constants[0]*exp(-constants[0]*voi);
+
+        QCOMPARE(voi, 0.5*j);
+        QVERIFY(fabs(rates[0]+expectedAlgebraic) < 1.0e-8);
+        QVERIFY(fabs(algebraic[0]-expectedAlgebraic) < 1.0e-8);
+        QCOMPARE(algebraic[1], voi);
+    }
+
+    QCOMPARE(errorSpy.count(), 0);
+}
+
+//==============================================================================
+
+void Tests::vanDerPolTests()
+{
+    // Solve the van der Pol oscillator, with and without interpolating our
+    // solution, and check our solution against the one of a fourth-order
+    // Runge-Kutta method that uses a very small fixed step
+
+    static const double Mu = 1.0;
+    static const double ReferenceStep = 1.0e-4;
+
+    double refStates[2] = { 2.0, 0.0 };
+    double refVoi = 0.0;
+    QList<double> refSolution = QList<double>();
+
+    for (int j = 1; j <= 10; ++j) {
+        int stepsCount = qRound(1.0/ReferenceStep);
+
+        for (int k = 0; k < stepsCount; ++k) {
+            double constants[1] = { Mu };
+            double k1[2], k2[2], k3[2], k4[2];
+            double y[2];
+
+            vanDerPolRates(refVoi, constants, k1, refStates, 0);
+
+            for (int i = 0; i < 2; ++i)
+                y[i] = refStates[i]+0.5*ReferenceStep*k1[i];
+
+            vanDerPolRates(refVoi+0.5*ReferenceStep, constants, k2, y, 0);
+
+            for (int i = 0; i < 2; ++i)
+                y[i] = refStates[i]+0.5*ReferenceStep*k2[i];
+
+            vanDerPolRates(refVoi+0.5*ReferenceStep, constants, k3, y, 0);
+
+            for (int i = 0; i < 2; ++i)
+                y[i] = refStates[i]+ReferenceStep*k3[i];
+
+            vanDerPolRates(refVoi+ReferenceStep, constants, k4, y, 0);
+
+            for (int i = 0; i < 2; ++i)
+                refStates[i] += ReferenceStep*(k1[i]+2.0*(k2[i]+k3[i])+k4[i])/6.0;
+
+            refVoi = j-1+(k+1)*ReferenceStep;
+        }
+
+        refSolution << refStates[0] << refStates[1];
+    }
+
+    for (int i = 0; i < 2; ++i) {
+        OpenCOR::DormandPrinceSolver::DormandPrinceSolver solver;
+        double constants[1] = { Mu };
+        double rates[2];
+        double states[2] = { 2.0, 0.0 };
+        double algebraic[1];
+        double voi = 0.0;
+
+        QSignalSpy errorSpy(&solver, SIGNAL(error(const QString &)));
+
+        solver.setProperties(properties(i));
+        solver.initialize(voi, 2, constants, rates, states, algebraic,
+                          vanDerPolRates);
+
+        for (int j = 1; j <= 10; ++j) {
+            solver.solve(voi, j);
+
+            QCOMPARE(voi, double(j));
+            QVERIFY(fabs(states[0]-refSolution[2*(j-1)]) < 1.0e-6);
+            QVERIFY(fabs(states[1]-refSolution[2*(j-1)+1]) < 1.0e-6);
+        }
+
+        QCOMPARE(errorSpy.count(), 0);
+    }
+}
+
+//==============================================================================
+
+void Tests::nanTests()
+{
+    // Solve a model which rate cannot be computed past VOI = 1 and make sure
+    // that we never accept a step that yields a non-finite error
+    // Note: our model's rate is zero up to VOI = 1, so our step size keeps
+    //       growing until a step ends up past VOI = 1. That step must be
+    //       rejected, or our dense output (and therefore our solution at
+    //       VOI = 0.9) would be NaN...
+
+    OpenCOR::DormandPrinceSolver::DormandPrinceSolver solver;
+    double constants[1];
+    double rates[1];
+    double states[1] = { 1.0 };
+    double algebraic[1];
+    double voi = 0.0;
+
+    QSignalSpy errorSpy(&solver, SIGNAL(error(const QString &)));
+
+    solver.setProperties(properties(true));
+    solver.initialize(voi, 1, constants, rates, states, algebraic,
+                      singularRates);
+    solver.solve(voi, 0.9);
+
+    QCOMPARE(voi, 0.9);
+    QCOMPARE(states[0], 1.0);
+    QCOMPARE(errorSpy.count(), 0);
+}
+
+//==============================================================================
+
+QTEST_GUILESS_MAIN(Tests)
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -88,7 +88,7 @@ void ForwardEulerSolver::solve(double &pVoi, const double &pVoiEnd) const
 
         // Compute Y_n+1
 
-        for (int i = 0; i < mRatesStatesCount; ++i)
+        for (int i = 0, iMax = mRatesStatesCount*mLanesCount; i < iMax; ++i)
             mStates[i] += realStep*mRates[i];
 
         // Advance through time
@@ -102,6 +102,16 @@ void ForwardEulerSolver::solve(double &pVoi, const double &pVoiEnd) const
 
 //==============================================================================
 
+bool ForwardEulerSolver::supportsLanes() const
+{
+    // We can integrate several lanes at once since all our operations are
+    // element-wise
+
+    return true;
+}
+
+//==============================================================================
+
 }   // namespace ForwardEulerSolver
 }   // namespace OpenCOR
 
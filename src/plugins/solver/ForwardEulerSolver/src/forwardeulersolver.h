@@ -53,6 +53,8 @@ public:
 
     virtual void solve(double &pVoi, const double &pVoiEnd) const;
 
+    virtual bool supportsLanes() const;
+
 private:
     double mStep;
 };
@@ -85,9 +85,9 @@ void FourthOrderRungeKuttaSolver::initialize(const double &pVoiStart,
     delete[] mK23;
     delete[] mYk123;
 
-    mK1    = new double[pRatesStatesCount];
-    mK23   = new double[pRatesStatesCount];
-    mYk123 = new double[pRatesStatesCount];
+    mK1    = new double[pRatesStatesCount*mLanesCount];
+    mK23   = new double[pRatesStatesCount*mLanesCount];
+    mYk123 = new double[pRatesStatesCount*mLanesCount];
 }
 
 //==============================================================================
@@ -127,7 +127,7 @@ void FourthOrderRungeKuttaSolver::solve(double &pVoi,
 
         // Compute k1 and Yk1
 
-        for (int i = 0; i < mRatesStatesCount; ++i) {
+        for (int i = 0, iMax = mRatesStatesCount*mLanesCount; i < iMax; ++i) {
             mK1[i]    = mRates[i];
             mYk123[i] = mStates[i]+realHalfStep*mK1[i];
         }
@@ -138,7 +138,7 @@ void FourthOrderRungeKuttaSolver::solve(double &pVoi,
 
         // Compute k2 and Yk2
 
-        for (int i = 0; i < mRatesStatesCount; ++i) {
+        for (int i = 0, iMax = mRatesStatesCount*mLanesCount; i < iMax; ++i) {
             mK23[i]   = mRates[i];
             mYk123[i] = mStates[i]+realHalfStep*mK23[i];
         }
@@ -149,7 +149,7 @@ void FourthOrderRungeKuttaSolver::solve(double &pVoi,
 
         // Compute k3 and Yk3
 
-        for (int i = 0; i < mRatesStatesCount; ++i) {
+        for (int i = 0, iMax = mRatesStatesCount*mLanesCount; i < iMax; ++i) {
             mK23[i]   += mRates[i];
             mYk123[i]  = mStates[i]+realStep*mK23[i];
         }
@@ -160,7 +160,7 @@ void FourthOrderRungeKuttaSolver::solve(double &pVoi,
 
         // Compute k4 and therefore Y_n+1
 
-        for (int i = 0; i < mRatesStatesCount; ++i)
+        for (int i = 0, iMax = mRatesStatesCount*mLanesCount; i < iMax; ++i)
             mStates[i] += realStep*(OneOverSix*(mK1[i]+mRates[i])+OneOverThree*mK23[i]);
 
         // Advance through time
@@ -174,6 +174,16 @@ void FourthOrderRungeKuttaSolver::solve(double &pVoi,
 
 //==============================================================================
 
+bool FourthOrderRungeKuttaSolver::supportsLanes() const
+{
+    // We can integrate several lanes at once since all our operations are
+    // element-wise
+
+    return true;
+}
+
+//==============================================================================
+
 }   // namespace FourthOrderRungeKuttaSolver
 }   // namespace OpenCOR
 
@@ -54,6 +54,8 @@ public:
 
     virtual void solve(double &pVoi, const double &pVoiEnd) const;
 
+    virtual bool supportsLanes() const;
+
 private:
     double mStep;
 
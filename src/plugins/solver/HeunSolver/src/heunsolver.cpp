@@ -80,8 +80,8 @@ void HeunSolver::initialize(const double &pVoiStart,
     delete[] mK;
     delete[] mYk;
 
-    mK  = new double[pRatesStatesCount];
-    mYk = new double[pRatesStatesCount];
+    mK  = new double[pRatesStatesCount*mLanesCount];
+    mYk = new double[pRatesStatesCount*mLanesCount];
 }
 
 //==============================================================================
@@ -111,7 +111,7 @@ void HeunSolver::solve(double &pVoi, const double &pVoiEnd) const
 
         // Compute k and Yk
 
-        for (int i = 0; i < mRatesStatesCount; ++i) {
+        for (int i = 0, iMax = mRatesStatesCount*mLanesCount; i < iMax; ++i) {
             mK[i]  = mRates[i];
             mYk[i] = mStates[i]+realStep*mRates[i];
         }
@@ -122,7 +122,7 @@ void HeunSolver::solve(double &pVoi, const double &pVoiEnd) const
 
         // Compute Y_n+1
 
-        for (int i = 0; i < mRatesStatesCount; ++i)
+        for (int i = 0, iMax = mRatesStatesCount*mLanesCount; i < iMax; ++i)
             mStates[i] += realHalfStep*(mK[i]+mRates[i]);
 
         // Advance through time
@@ -136,6 +136,16 @@ void HeunSolver::solve(double &pVoi, const double &pVoiEnd) const
 
 //==============================================================================
 
+bool HeunSolver::supportsLanes() const
+{
+    // We can integrate several lanes at once since all our operations are
+    // element-wise
+
+    return true;
+}
+
+//==============================================================================
+
 }   // namespace HeunSolver
 }   // namespace OpenCOR
 
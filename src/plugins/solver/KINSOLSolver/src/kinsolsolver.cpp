@@ -82,6 +82,15 @@ void * KinsolSolverUserData::userData() const
 
 //==============================================================================
 
+void KinsolSolverUserData::setUserData(void *pUserData)
+{
+    // Set our user data
+
+    mUserData = pUserData;
+}
+
+//==============================================================================
+
 Solver::NlaSolver::ComputeSystemFunction KinsolSolverUserData::computeSystem() const
 {
     // Return our compute system function
@@ -91,11 +100,83 @@ Solver::NlaSolver::ComputeSystemFunction KinsolSolverUserData::computeSystem() c
 
 //==============================================================================
 
+KinsolSolverData::KinsolSolverData(void *pSolver, N_Vector pParametersVector,
+                                   N_Vector pSolutionVector,
+                                   N_Vector pOnesVector,
+                                   KinsolSolverUserData *pUserData) :
+    mSolver(pSolver),
+    mParametersVector(pParametersVector),
+    mSolutionVector(pSolutionVector),
+    mOnesVector(pOnesVector),
+    mUserData(pUserData)
+{
+}
+
+//==============================================================================
+
+KinsolSolverData::~KinsolSolverData()
+{
+    // Delete some internal objects
+
+    N_VDestroy_Serial(mParametersVector);
+    N_VDestroy_Serial(mSolutionVector);
+    N_VDestroy_Serial(mOnesVector);
+
+    KINFree(&mSolver);
+
+    delete mUserData;
+}
+
+//==============================================================================
+
+void * KinsolSolverData::solver() const
+{
+    // Return our solver
+
+    return mSolver;
+}
+
+//==============================================================================
+
+N_Vector KinsolSolverData::parametersVector() const
+{
+    // Return our parameters vector
+
+    return mParametersVector;
+}
+
+//==============================================================================
+
+N_Vector KinsolSolverData::solutionVector() const
+{
+    // Return our solution vector
+
+    return mSolutionVector;
+}
+
+//==============================================================================
+
+N_Vector KinsolSolverData::onesVector() const
+{
+    // Return our ones vector
+
+    return mOnesVector;
+}
+
+//==============================================================================
+
+KinsolSolverUserData * KinsolSolverData::userData() const
+{
+    // Return our user data
+
+    return mUserData;
+}
+
+//==============================================================================
+
 KinsolSolver::KinsolSolver() :
-    mSolver(0),
-    mParametersVector(0),
-    mOnesVector(0),
-    mUserData(0)
+    mData(KinsolSolverDataMap()),
+    mCurrentData(0)
 {
 }
 
@@ -112,17 +193,14 @@ KinsolSolver::~KinsolSolver()
 
 void KinsolSolver::reset()
 {
-    // Make sure that the solver has been initialised
+    // Delete the data of all the NLA systems we have come across
 
-    if (!mSolver)
-        return;
+    foreach (KinsolSolverData *data, mData)
+        delete data;
 
-    N_VDestroy_Serial(mParametersVector);
-    N_VDestroy_Serial(mOnesVector);
+    mData.clear();
 
-    KINFree(&mSolver);
-
-    delete mUserData;
+    mCurrentData = 0;
 }
 
 //==============================================================================
@@ -130,52 +208,95 @@ void KinsolSolver::reset()
 void KinsolSolver::initialize(ComputeSystemFunction pComputeSystem,
                               double *pParameters, int pSize, void *pUserData)
 {
-    if (mSolver)
-        // The solver has already been initialised, so reset things...
+    // Initialise the NLA solver itself
 
-        reset();
+    OpenCOR::Solver::NlaSolver::initialize(pComputeSystem, pParameters, pSize);
 
-    // Initialise the ODE solver itself
+    // Retrieve the data for the given NLA system, if we have already come
+    // across it, and make sure that it is still valid
+    // Note: we get called every time an NLA system needs to be solved, i.e.
+    //       within every call to the function that computes the rates of a
+    //       model, so we really don't want to (re)create a KINSOL solver
+    //       unless we really have to...
 
-    OpenCOR::Solver::NlaSolver::initialize(pComputeSystem, pParameters, pSize);
+    quintptr system = quintptr(pComputeSystem);
+
+    mCurrentData = mData.value(system);
+
+    if (mCurrentData && (NV_LENGTH_S(mCurrentData->parametersVector()) != pSize)) {
+        delete mCurrentData;
+
+        mData.remove(system);
+
+        mCurrentData = 0;
+    }
+
+    if (mCurrentData) {
+        // We can reuse our KINSOL solver, so just make sure that it is to use
+        // the given parameters and user data, and that it gets warm-started
+        // from our previous solution
+        // Note: the parameters of an NLA system are local to the code that is
+        //       generated for it (so that a model can be simulated by several
+        //       threads at once), hence we need to keep track of our previous
+        //       solution ourselves...
+
+        N_VSetArrayPointer_Serial(pParameters, mCurrentData->parametersVector());
+        N_VScale(1.0, mCurrentData->solutionVector(), mCurrentData->parametersVector());
+
+        mCurrentData->userData()->setUserData(pUserData);
+
+        return;
+    }
 
     // Create some vectors
 
-    mParametersVector = N_VMake_Serial(pSize, pParameters);
-    mOnesVector = N_VNew_Serial(pSize);
+    N_Vector parametersVector = N_VMake_Serial(pSize, pParameters);
+    N_Vector solutionVector = N_VNew_Serial(pSize);
+    N_Vector onesVector = N_VNew_Serial(pSize);
 
-    N_VConst(1.0, mOnesVector);
+    N_VConst(1.0, onesVector);
 
     // Create the KINSOL solver
 
-    mSolver = KINCreate();
+    void *solver = KINCreate();
 
     // Use our own error handler
 
-    KINSetErrHandlerFn(mSolver, errorHandler, this);
+    KINSetErrHandlerFn(solver, errorHandler, this);
 
     // Initialise the KINSOL solver
 
-    KINInit(mSolver, systemFunction, mParametersVector);
+    KINInit(solver, systemFunction, parametersVector);
 
     // Set some user data
 
-    mUserData = new KinsolSolverUserData(pUserData, pComputeSystem);
+    KinsolSolverUserData *userData = new KinsolSolverUserData(pUserData, pComputeSystem);
 
-    KINSetUserData(mSolver, mUserData);
+    KINSetUserData(solver, userData);
 
     // Set the linear solver
 
-    KINDense(mSolver, pSize);
+    KINDense(solver, pSize);
+
+    // Keep track of our data for the given NLA system
+
+    mCurrentData = new KinsolSolverData(solver, parametersVector,
+                                        solutionVector, onesVector, userData);
+
+    mData.insert(system, mCurrentData);
 }
 
 //==============================================================================
 
 void KinsolSolver::solve() const
 {
-    // Solve the linear system
+    // Solve the linear system and keep track of its solution
+
+    KINSol(mCurrentData->solver(), mCurrentData->parametersVector(),
+           KIN_LINESEARCH, mCurrentData->onesVector(),
+           mCurrentData->onesVector());
 
-    KINSol(mSolver, mParametersVector, KIN_LINESEARCH, mOnesVector, mOnesVector);
+    N_VScale(1.0, mCurrentData->parametersVector(), mCurrentData->solutionVector());
 }
 
 //==============================================================================
@@ -32,6 +32,10 @@ limitations under the License.
 
 //==============================================================================
 
+#include <QMap>
+
+//==============================================================================
+
 namespace OpenCOR {
 namespace KINSOLSolver {
 
@@ -44,6 +48,7 @@ public:
                                   Solver::NlaSolver::ComputeSystemFunction pComputeSystem);
 
     void * userData() const;
+    void setUserData(void *pUserData);
 
     Solver::NlaSolver::ComputeSystemFunction computeSystem() const;
 
@@ -55,6 +60,38 @@ private:
 
 //==============================================================================
 
+class KinsolSolverData
+{
+public:
+    explicit KinsolSolverData(void *pSolver, N_Vector pParametersVector,
+                              N_Vector pSolutionVector, N_Vector pOnesVector,
+                              KinsolSolverUserData *pUserData);
+    ~KinsolSolverData();
+
+    void * solver() const;
+
+    N_Vector parametersVector() const;
+    N_Vector solutionVector() const;
+    N_Vector onesVector() const;
+
+    KinsolSolverUserData * userData() const;
+
+private:
+    void *mSolver;
+
+    N_Vector mParametersVector;
+    N_Vector mSolutionVector;
+    N_Vector mOnesVector;
+
+    KinsolSolverUserData *mUserData;
+};
+
+//==============================================================================
+
+typedef QMap<quintptr, KinsolSolverData *> KinsolSolverDataMap;
+
+//==============================================================================
+
 class KinsolSolver : public Solver::NlaSolver
 {
 public:
@@ -67,10 +104,8 @@ public:
     virtual void solve() const;
 
 private:
-    void *mSolver;
-    N_Vector mParametersVector;
-    N_Vector mOnesVector;
-    KinsolSolverUserData *mUserData;
+    KinsolSolverDataMap mData;
+    KinsolSolverData *mCurrentData;
 
     void reset();
 };
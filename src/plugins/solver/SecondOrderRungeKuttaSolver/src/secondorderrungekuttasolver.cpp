@@ -79,7 +79,7 @@ void SecondOrderRungeKuttaSolver::initialize(const double &pVoiStart,
 
     delete[] mYk1;
 
-    mYk1 = new double[pRatesStatesCount];
+    mYk1 = new double[pRatesStatesCount*mLanesCount];
 }
 
 //==============================================================================
@@ -114,7 +114,7 @@ void SecondOrderRungeKuttaSolver::solve(double &pVoi,
 
         // Compute k1 and therefore Yk1
 
-        for (int i = 0; i < mRatesStatesCount; ++i)
+        for (int i = 0, iMax = mRatesStatesCount*mLanesCount; i < iMax; ++i)
             mYk1[i] = mStates[i]+realHalfStep*mRates[i];
 
         // Compute f(t_n + h / 2, Y_n + k1 / 2)
@@ -123,7 +123,7 @@ void SecondOrderRungeKuttaSolver::solve(double &pVoi,
 
         // Compute Y_n+1
 
-        for (int i = 0; i < mRatesStatesCount; ++i)
+        for (int i = 0, iMax = mRatesStatesCount*mLanesCount; i < iMax; ++i)
             mStates[i] += realStep*mRates[i];
 
         // Advance through time
@@ -137,6 +137,16 @@ void SecondOrderRungeKuttaSolver::solve(double &pVoi,
 
 //==============================================================================
 
+bool SecondOrderRungeKuttaSolver::supportsLanes() const
+{
+    // We can integrate several lanes at once since all our operations are
+    // element-wise
+
+    return true;
+}
+
+//==============================================================================
+
 }   // namespace SecondOrderRungeKuttaSolver
 }   // namespace OpenCOR
 
@@ -24,18 +24,18 @@ limitations under the License.
 
 //==============================================================================
 
-#include <QApplication>
+#include <QThread>
 
 //==============================================================================
 
-void doNonLinearSolve(char *pRuntime,
+void doNonLinearSolve(void *pNlaSolverRegistry,
                       void (*pFunction)(double *, double *, void *),
                       double *pParameters, int *pRes, int pSize,
                       void *pUserData)
 {
     // Retrieve the NLA solver which we should use
 
-    OpenCOR::Solver::NlaSolver *nlaSolver = OpenCOR::Solver::nlaSolver(pRuntime);
+    OpenCOR::Solver::NlaSolver *nlaSolver = static_cast<OpenCOR::Solver::NlaSolverRegistry *>(pNlaSolverRegistry)->nlaSolver();
 
     if (nlaSolver) {
         // We have found our NLA solver, so initialise it
@@ -116,12 +116,65 @@ VoiSolver::VoiSolver() :
 
 OdeSolver::OdeSolver() :
     VoiSolver(),
-    mComputeRates(0)
+    mComputeRates(0),
+    mComputeJacobian(0),
+    mAlgebraicCount(0),
+    mLanesCount(1)
 {
 }
 
 //==============================================================================
 
+void OdeSolver::setComputeJacobian(ComputeJacobianFunction pComputeJacobian,
+                                   const int &pAlgebraicCount)
+{
+    // Set the function that computes the Jacobian of our ODE system, if any
+    // Note: this must be done before initialising the ODE solver, which may
+    //       then use it rather than compute the Jacobian using finite
+    //       differences...
+
+    mComputeJacobian = pComputeJacobian;
+
+    mAlgebraicCount = pAlgebraicCount;
+}
+
+//==============================================================================
+
+bool OdeSolver::supportsLanes() const
+{
+    // By default, an ODE solver can only integrate one set of states at a time
+
+    return false;
+}
+
+//==============================================================================
+
+int OdeSolver::lanesCount() const
+{
+    // Return our number of lanes
+
+    return mLanesCount;
+}
+
+//==============================================================================
+
+void OdeSolver::setLanesCount(const int &pLanesCount)
+{
+    // Set our number of lanes, i.e. the number of sets of states that we are
+    // to integrate in lockstep
+    // Note #1: this must be done before initialising the ODE solver, and only
+    //          if it supports lanes...
+    // Note #2: with several lanes, our constants, rates, states and algebraic
+    //          arrays are expected to be structures of arrays, i.e. the value
+    //          of the i-th state of the l-th lane is STATES[i*lanesCount+l],
+    //          and our compute rates function to compute the rates of all our
+    //          lanes at once...
+
+    mLanesCount = supportsLanes()?qMax(1, pLanesCount):1;
+}
+
+//==============================================================================
+
 void OdeSolver::initialize(const double &pVoiStart,
                            const int &pRatesStatesCount, double *pConstants,
                            double *pRates, double *pStates, double *pAlgebraic,
@@ -228,36 +281,46 @@ void NlaSolver::initialize(ComputeSystemFunction pComputeSystem,
 
 //==============================================================================
 
-NlaSolver * nlaSolver(const QString &pRuntimeAddress)
+NlaSolverRegistry::NlaSolverRegistry() :
+    mLock(),
+    mNlaSolvers(QHash<Qt::HANDLE, NlaSolver *>())
+{
+}
+
+//==============================================================================
+
+NlaSolver * NlaSolverRegistry::nlaSolver() const
 {
-    // Return the runtime's NLA solver
+    // Return the NLA solver for the current thread
+    // Note: this gets called every time an NLA system needs to be solved, so
+    //       we only lock our registry for reading, meaning that several
+    //       threads can retrieve their NLA solver at the same time...
 
-    QByteArray runtimeAddress = pRuntimeAddress.toUtf8();
-    QVariant res = qApp->property(runtimeAddress.constData());
+    QReadLocker locker(&mLock);
 
-    return res.isValid()?static_cast<NlaSolver *>((void *) res.toULongLong()):0;
+    return mNlaSolvers.value(QThread::currentThreadId());
 }
 
 //==============================================================================
 
-void setNlaSolver(const QString &pRuntimeAddress, NlaSolver *pGlobalNlaSolver)
+void NlaSolverRegistry::setNlaSolver(NlaSolver *pNlaSolver)
 {
-    // Keep track of the runtime's NLA solver
+    // Keep track of the NLA solver for the current thread
 
-    QByteArray runtimeAddress = pRuntimeAddress.toUtf8();
+    QWriteLocker locker(&mLock);
 
-    qApp->setProperty(runtimeAddress.constData(), qulonglong(pGlobalNlaSolver));
+    mNlaSolvers.insert(QThread::currentThreadId(), pNlaSolver);
 }
 
 //==============================================================================
 
-void unsetNlaSolver(const QString &pRuntimeAddress)
+void NlaSolverRegistry::unsetNlaSolver()
 {
-    // Stop tracking the runtime's NLA solver
+    // Stop tracking the NLA solver for the current thread
 
-    QByteArray runtimeAddress = pRuntimeAddress.toUtf8();
+    QWriteLocker locker(&mLock);
 
-    qApp->setProperty(runtimeAddress.constData(), QVariant::Invalid);
+    mNlaSolvers.remove(QThread::currentThreadId());
 }
 
 //==============================================================================
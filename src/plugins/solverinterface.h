@@ -28,12 +28,14 @@ limitations under the License.
 
 //==============================================================================
 
+#include <QHash>
 #include <QList>
+#include <QReadWriteLock>
 #include <QVariant>
 
 //==============================================================================
 
-extern "C" void doNonLinearSolve(char *pRuntime,
+extern "C" void doNonLinearSolve(void *pNlaSolverRegistry,
                                  void (*pFunction)(double *, double *, void *),
                                  double *pParameters, int *pRes, int pSize,
                                  void *pUserData);
@@ -95,9 +97,18 @@ class OdeSolver : public VoiSolver
 {
 public:
     typedef int (*ComputeRatesFunction)(double VOI, double *CONSTANTS, double *RATES, double *STATES, double *ALGEBRAIC);
+    typedef int (*ComputeJacobianFunction)(double VOI, double *CONSTANTS, double *RATES, double *STATES, double *ALGEBRAIC, double *JACOBIAN, double *DALGEBRAIC);
 
     explicit OdeSolver();
 
+    void setComputeJacobian(ComputeJacobianFunction pComputeJacobian,
+                            const int &pAlgebraicCount);
+
+    virtual bool supportsLanes() const;
+
+    int lanesCount() const;
+    void setLanesCount(const int &pLanesCount);
+
     virtual void initialize(const double &pVoiStart,
                             const int &pRatesStatesCount, double *pConstants,
                             double *pRates, double *pStates, double *pAlgebraic,
@@ -105,6 +116,11 @@ public:
 
 protected:
     ComputeRatesFunction mComputeRates;
+    ComputeJacobianFunction mComputeJacobian;
+
+    int mAlgebraicCount;
+
+    int mLanesCount;
 };
 
 //==============================================================================
@@ -163,10 +179,21 @@ private:
 
 //==============================================================================
 
-NlaSolver * nlaSolver(const QString &pRuntimeAddress);
+class NlaSolverRegistry
+{
+public:
+    explicit NlaSolverRegistry();
+
+    NlaSolver * nlaSolver() const;
+
+    void setNlaSolver(NlaSolver *pNlaSolver);
+    void unsetNlaSolver();
 
-void setNlaSolver(const QString &pRuntimeAddress, NlaSolver *pGlobalNlaSolver);
-void unsetNlaSolver(const QString &pRuntimeAddress);
+private:
+    mutable QReadWriteLock mLock;
+
+    QHash<Qt::HANDLE, NlaSolver *> mNlaSolvers;
+};
 
 //==============================================================================
 
@@ -23,6 +23,7 @@ limitations under the License.
 #include "cellmlfile.h"
 #include "cellmlfilecellml10exporter.h"
 #include "cellmlfilecellml11exporter.h"
+#include "cellmlfileimportcache.h"
 #include "cellmlfilemanager.h"
 #include "corecliutils.h"
 #include "filemanager.h"
@@ -31,8 +32,10 @@ limitations under the License.
 
 #include <QDomDocument>
 #include <QFile>
+#include <QFutureInterface>
 #include <QStringList>
 #include <QUrl>
+#include <QtConcurrentRun>
 
 //==============================================================================
 
@@ -75,7 +78,9 @@ CellmlFile::CellmlFile(const QString &pFileName) :
     mModel(0),
     mRdfApiRepresentation(0),
     mRdfDataSource(0),
-    mRdfTriples(CellmlFileRdfTriples(this))
+    mRdfTriples(CellmlFileRdfTriples(this)),
+    mRuntimeFuture(QFuture<CellmlFileRuntime *>()),
+    mRuntimeUpdating(false)
 {
     // Instantiate our runtime object
 
@@ -103,6 +108,11 @@ CellmlFile::~CellmlFile()
 
 void CellmlFile::reset()
 {
+    // Make sure that our runtime is not being updated in the background, since
+    // it relies on our model
+
+    waitForRuntime();
+
     // Reset all of our properties
 
     mModel = 0;
@@ -198,7 +208,8 @@ bool CellmlFile::fullyInstantiateImports(iface::cellml_api::Model *pModel,
             //       call CDA_CellMLImport::instantiateFromText() instead, which
             //       requires loading the imported CellML file. Otherwise, to
             //       speed things up as much as possible, we cache the contents
-            //       of the URLs that we load...
+            //       of the URLs that we load and we retrieve all the remote
+            //       imports at a given level at once...
 
             // Retrieve the list of imports, together with their XML base values
 
@@ -209,47 +220,87 @@ bool CellmlFile::fullyInstantiateImports(iface::cellml_api::Model *pModel,
             retrieveImports(QString::fromStdWString(baseUri->asText()),
                             pModel, importList, importXmlBaseList);
 
-            // Instantiate all the imports in our list
+            // Instantiate all the imports in our list, one level at a time
 
             while (!importList.isEmpty()) {
-                // Retrieve the first import and instantiate it, if needed
+                // Retrieve the imports at the current level and get ready for
+                // those at the next level
 
-                ObjRef<iface::cellml_api::CellMLImport> import = importList.first();
-                QString importXmlBase = importXmlBaseList.first();
+                QList<iface::cellml_api::CellMLImport *> levelImportList = importList;
+                QStringList levelImportXmlBaseList = importXmlBaseList;
 
-                importList.removeFirst();
-                importXmlBaseList.removeFirst();
+                importList.clear();
+                importXmlBaseList.clear();
 
-                if (!import->wasInstantiated()) {
-                    // Note: CDA_CellMLImport::instantiate() would normally be
-                    //       called, but it doesn't work with https, so we
-                    //       retrieve the contents of the import ourselves and
-                    //       instantiate it from text instead...
+                // Determine the file name or URL of the imports that need to be
+                // instantiated and retrieve, all at once, the contents of the
+                // remote ones that we haven't already loaded
+                // Note: CDA_CellMLImport::instantiate() would normally be
+                //       called, but it doesn't work with https, so we retrieve
+                //       the contents of the imports ourselves and instantiate
+                //       them from text instead. Also, retrieving the contents
+                //       of remote imports is done through our import cache,
+                //       which means that all of them get retrieved at once and
+                //       that they only get downloaded if they have changed
+                //       since we last retrieved them...
 
-                    ObjRef<iface::cellml_api::URI> xlinkHref = import->xlinkHref();
-                    QString url = QUrl(importXmlBase).resolved(QString::fromStdWString(xlinkHref->asText())).toString();
-                    bool isLocalFile;
-                    QString fileNameOrUrl;
+                QList<bool> levelIsLocalFileList = QList<bool>();
+                QStringList levelFileNameOrUrlList = QStringList();
+                QStringList urls = QStringList();
 
-                    Core::checkFileNameOrUrl(url, isLocalFile, fileNameOrUrl);
+                for (int i = 0, iMax = levelImportList.count(); i < iMax; ++i) {
+                    bool isLocalFile = false;
+                    QString fileNameOrUrl = QString();
 
-                    if (!fileNameOrUrl.compare(mFileName)) {
-                        // We want to import ourselves, so...
+                    if (!levelImportList[i]->wasInstantiated()) {
+                        ObjRef<iface::cellml_api::URI> xlinkHref = levelImportList[i]->xlinkHref();
+                        QString url = QUrl(levelImportXmlBaseList[i]).resolved(QString::fromStdWString(xlinkHref->asText())).toString();
 
-                        throw(std::exception());
-                    } else if (mImportContents.contains(fileNameOrUrl)) {
+                        Core::checkFileNameOrUrl(url, isLocalFile, fileNameOrUrl);
+
+                        if (!fileNameOrUrl.compare(mFileName)) {
+                            // We want to import ourselves, so...
+
+                            throw(std::exception());
+                        } else if (   !isLocalFile
+                                   && !mImportContents.contains(fileNameOrUrl)) {
+                            urls << fileNameOrUrl;
+                        }
+                    }
+
+                    levelIsLocalFileList << isLocalFile;
+                    levelFileNameOrUrlList << fileNameOrUrl;
+                }
+
+                QMap<QString, QByteArray> urlsContents = CellmlFileImportCache::instance()->contents(urls);
+
+                // Instantiate the imports at the current level, if needed
+
+                for (int i = 0, iMax = levelImportList.count(); i < iMax; ++i) {
+                    ObjRef<iface::cellml_api::CellMLImport> import = levelImportList[i];
+
+                    if (import->wasInstantiated())
+                        continue;
+
+                    bool isLocalFile = levelIsLocalFileList[i];
+                    QString fileNameOrUrl = levelFileNameOrUrlList[i];
+
+                    if (mImportContents.contains(fileNameOrUrl)) {
                         // We have already loaded the import contents, so
                         // directly instantiate the import with it
 
                         import->instantiateFromText(mImportContents.value(fileNameOrUrl).toStdWString());
                     } else {
                         // We haven't already loaded the import contents, so do
-                        // so now
+                        // so now (or use the ones we have just retrieved)
 
                         QByteArray fileContents;
 
                         if (   ( isLocalFile && Core::readFileContentsFromFile(fileNameOrUrl, fileContents))
-                            || (!isLocalFile && Core::readFileContentsFromUrl(fileNameOrUrl, fileContents))) {
+                            || (!isLocalFile && urlsContents.contains(fileNameOrUrl))) {
+                            if (!isLocalFile)
+                                fileContents = urlsContents.value(fileNameOrUrl);
+
                             // We were able to retrieve the import contents, so
                             // instantiate the import with it
 
@@ -271,7 +322,7 @@ bool CellmlFile::fullyInstantiateImports(iface::cellml_api::Model *pModel,
                     }
 
                     // Now that the import is instantiated, add its own imports
-                    // to our list
+                    // to the list of imports at the next level
 
                     ObjRef<iface::cellml_api::Model> importModel = import->importedModel();
 
@@ -737,6 +788,10 @@ CellmlFileIssues CellmlFile::issues() const
 
 CellmlFileRuntime * CellmlFile::runtime()
 {
+    // Wait for our runtime to be updated in the background, if it is being
+
+    waitForRuntime();
+
     // Check whether the runtime needs to be updated
 
     if (!mRuntimeUpdateNeeded)
@@ -765,6 +820,71 @@ CellmlFileRuntime * CellmlFile::runtime()
 
 //==============================================================================
 
+QFuture<CellmlFileRuntime *> CellmlFile::runtimeFuture()
+{
+    // Return a future for our runtime, which gets updated in the background, if
+    // needed, so that our caller doesn't get blocked and so that several
+    // runtimes can be updated at once
+    // Note: we load ourselves and fully instantiate our imports, if needed, in
+    //       our own thread, since it may involve our file manager. So, only
+    //       the generation and compilation of our model code is done in the
+    //       background, and it only reads our model...
+
+    if (mRuntimeFuture.isRunning())
+        return mRuntimeFuture;
+
+    waitForRuntime();
+
+    if (mRuntimeUpdateNeeded && load() && fullyInstantiateImports(mModel, mIssues)) {
+        mRuntimeFuture = QtConcurrent::run(this, &CellmlFile::updatedRuntime);
+        mRuntimeUpdating = true;
+    } else {
+        // Either our runtime is up to date or it cannot be updated, so return
+        // a future that is already finished
+
+        QFutureInterface<CellmlFileRuntime *> futureInterface;
+        CellmlFileRuntime *runtime = mRuntimeUpdateNeeded?0:mRuntime;
+
+        futureInterface.reportStarted();
+        futureInterface.reportFinished(&runtime);
+
+        mRuntimeFuture = futureInterface.future();
+    }
+
+    return mRuntimeFuture;
+}
+
+//==============================================================================
+
+void CellmlFile::waitForRuntime()
+{
+    // Wait for our runtime to be updated in the background, if it is being,
+    // and keep track of the fact that it is now up to date
+    // Note: mRuntimeUpdateNeeded is only ever accessed from our own thread,
+    //       hence it gets updated here rather than in updatedRuntime()...
+
+    if (mRuntimeUpdating) {
+        mRuntimeFuture.waitForFinished();
+
+        mRuntimeUpdating = false;
+        mRuntimeUpdateNeeded = false;
+    }
+}
+
+//==============================================================================
+
+CellmlFileRuntime * CellmlFile::updatedRuntime()
+{
+    // Update and return our runtime
+    // Note: this is done in the background (see runtimeFuture())...
+
+    mRuntime->update();
+
+    return mRuntime;
+}
+
+//==============================================================================
+
 QStringList CellmlFile::dependencies()
 {
     // Check whether the dependencies need to be retrieved
@@ -33,6 +33,7 @@ limitations under the License.
 //==============================================================================
 
 #include <QDomElement>
+#include <QFuture>
 #include <QMap>
 
 //==============================================================================
@@ -86,6 +87,7 @@ public:
     CellmlFileIssues issues() const;
 
     CellmlFileRuntime * runtime();
+    QFuture<CellmlFileRuntime *> runtimeFuture();
 
     QStringList dependencies();
 
@@ -146,6 +148,8 @@ private:
     CellmlFileIssues mIssues;
 
     CellmlFileRuntime *mRuntime;
+    QFuture<CellmlFileRuntime *> mRuntimeFuture;
+    bool mRuntimeUpdating;
 
     bool mLoadingNeeded;
     bool mFullInstantiationNeeded;
@@ -158,6 +162,9 @@ private:
 
     virtual void reset();
 
+    void waitForRuntime();
+    CellmlFileRuntime * updatedRuntime();
+
     void retrieveImports(const QString &pXmlBase,
                          iface::cellml_api::Model *pModel,
                          QList<iface::cellml_api::CellMLImport *> &pImportList,
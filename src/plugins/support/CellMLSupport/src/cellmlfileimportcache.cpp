@@ -0,0 +1,389 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// CellML file import cache
+//==============================================================================
+
+#include "cellmlfileimportcache.h"
+#include "corecliutils.h"
+
+//==============================================================================
+
+#include <QDataStream>
+#include <QDir>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QUrl>
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace CellMLSupport {
+
+//==============================================================================
+
+static const auto CacheFormatVersion = QStringLiteral("1");
+static const auto ImportFileExtension = QStringLiteral(".import");
+
+//==============================================================================
+
+CellmlFileImportCache::CellmlFileImportCache() :
+    mMutex(),
+    mEnabled(true),
+    mDirectory(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)+QDir::separator()+"CellMLImports"),
+    mHits(0),
+    mMisses(0)
+{
+}
+
+//==============================================================================
+
+CellmlFileImportCache * CellmlFileImportCache::instance()
+{
+    // Return the 'global' instance of our CellML file import cache class
+
+    static CellmlFileImportCache instance;
+
+    return static_cast<CellmlFileImportCache *>(Core::globalInstance("OpenCOR::CellMLSupport::CellmlFileImportCache::instance()",
+                                                                     &instance));
+}
+
+//==============================================================================
+
+bool CellmlFileImportCache::isEnabled() const
+{
+    // Return whether we are enabled
+
+    QMutexLocker locker(&mMutex);
+
+    return mEnabled;
+}
+
+//==============================================================================
+
+void CellmlFileImportCache::setEnabled(const bool &pEnabled)
+{
+    // Enable/disable ourselves
+
+    QMutexLocker locker(&mMutex);
+
+    mEnabled = pEnabled;
+}
+
+//==============================================================================
+
+QString CellmlFileImportCache::directory() const
+{
+    // Return our directory
+
+    QMutexLocker locker(&mMutex);
+
+    return mDirectory;
+}
+
+//==============================================================================
+
+void CellmlFileImportCache::setDirectory(const QString &pDirectory)
+{
+    // Set our directory
+
+    QMutexLocker locker(&mMutex);
+
+    mDirectory = pDirectory;
+}
+
+//==============================================================================
+
+quint64 CellmlFileImportCache::hits() const
+{
+    // Return our number of hits
+
+    QMutexLocker locker(&mMutex);
+
+    return mHits;
+}
+
+//==============================================================================
+
+quint64 CellmlFileImportCache::misses() const
+{
+    // Return our number of misses
+
+    QMutexLocker locker(&mMutex);
+
+    return mMisses;
+}
+
+//==============================================================================
+
+void CellmlFileImportCache::resetStatistics()
+{
+    // Reset our statistics
+
+    QMutexLocker locker(&mMutex);
+
+    mHits = 0;
+    mMisses = 0;
+}
+
+//==============================================================================
+
+void CellmlFileImportCache::clear()
+{
+    // Remove all the imports we currently hold
+
+    QMutexLocker locker(&mMutex);
+
+    foreach (const QFileInfo &fileInfo,
+             QDir(mDirectory).entryInfoList(QStringList() << "*"+ImportFileExtension,
+                                            QDir::Files)) {
+        QFile::remove(fileInfo.absoluteFilePath());
+    }
+}
+
+//==============================================================================
+
+QMap<QString, QByteArray> CellmlFileImportCache::contents(const QStringList &pUrls)
+{
+    // Retrieve the contents of the given URLs, all at once
+    // Note #1: should we already have some contents for a URL, then we send a
+    //          conditional request (using the ETag and/or Last-Modified values
+    //          that came with those contents), so that we only download them
+    //          again if they have changed...
+    // Note #2: should a request fail because we couldn't get a response (e.g.
+    //          we are offline), then we fall back on our cached contents, if
+    //          any...
+    // Note #3: a URL for which we couldn't retrieve any contents won't be
+    //          part of the returned map...
+
+    QMap<QString, QByteArray> res = QMap<QString, QByteArray>();
+
+    if (pUrls.isEmpty())
+        return res;
+
+    // Create a network access manager so that we can retrieve the contents of
+    // our URLs and make sure that we get told if there are SSL errors (which
+    // would happen if a website's certificate is invalid, e.g. it has expired)
+    // Note: we may be running in a thread other than the one we live in, hence
+    //       our direct connection...
+
+    QNetworkAccessManager networkAccessManager;
+
+    connect(&networkAccessManager, SIGNAL(sslErrors(QNetworkReply *, const QList<QSslError> &)),
+            this, SLOT(networkAccessManagerSslErrors(QNetworkReply *, const QList<QSslError> &)),
+            Qt::DirectConnection);
+
+    // Send a request for each of our URLs
+
+    bool enabled = isEnabled();
+    QMap<QString, QByteArray> urlsCachedContents = QMap<QString, QByteArray>();
+    QMap<QNetworkReply *, QString> networkReplies = QMap<QNetworkReply *, QString>();
+
+    foreach (const QString &url, pUrls) {
+        if (networkReplies.values().contains(url))
+            continue;
+
+        QNetworkRequest networkRequest = QNetworkRequest(url);
+        QByteArray urlCachedContents;
+        QByteArray etag;
+        QByteArray lastModified;
+
+        if (enabled && cachedContents(url, urlCachedContents, etag, lastModified)) {
+            urlsCachedContents.insert(url, urlCachedContents);
+
+            if (!etag.isEmpty())
+                networkRequest.setRawHeader("If-None-Match", etag);
+
+            if (!lastModified.isEmpty())
+                networkRequest.setRawHeader("If-Modified-Since", lastModified);
+        }
+
+        networkReplies.insert(networkAccessManager.get(networkRequest), url);
+    }
+
+    // Wait for all our requests to be finished
+
+    QEventLoop eventLoop;
+
+    connect(&networkAccessManager, SIGNAL(finished(QNetworkReply *)),
+            &eventLoop, SLOT(quit()));
+
+    while (!networkReplies.isEmpty()) {
+        eventLoop.exec();
+
+        foreach (QNetworkReply *networkReply, networkReplies.keys()) {
+            if (!networkReply->isFinished())
+                continue;
+
+            QString url = networkReplies.take(networkReply);
+            QVariant httpStatusCode = networkReply->attribute(QNetworkRequest::HttpStatusCodeAttribute);
+            QUrl redirectedUrl = networkReply->attribute(QNetworkRequest::RedirectionTargetAttribute).toUrl();
+
+            if (networkReply->error() == QNetworkReply::NoError) {
+                if (!redirectedUrl.isEmpty()) {
+                    // We are dealing with a redirection, so follow it, keeping
+                    // our conditional headers, if any
+
+                    QNetworkRequest networkRequest = QNetworkRequest(networkReply->url().resolved(redirectedUrl));
+                    QNetworkRequest originalNetworkRequest = networkReply->request();
+
+                    foreach (const QByteArray &header, originalNetworkRequest.rawHeaderList())
+                        networkRequest.setRawHeader(header, originalNetworkRequest.rawHeader(header));
+
+                    networkReplies.insert(networkAccessManager.get(networkRequest), url);
+                } else if (   (httpStatusCode.toInt() == 304)
+                           && urlsCachedContents.contains(url)) {
+                    // Our cached contents are still valid, so use them
+
+                    res.insert(url, urlsCachedContents.value(url));
+
+                    QMutexLocker locker(&mMutex);
+
+                    ++mHits;
+                } else {
+                    // We have got some new contents, so use and cache them
+
+                    QByteArray urlContents = networkReply->readAll();
+
+                    res.insert(url, urlContents);
+
+                    if (enabled) {
+                        storeContents(url, urlContents,
+                                      networkReply->rawHeader("ETag"),
+                                      networkReply->rawHeader("Last-Modified"));
+                    }
+
+                    QMutexLocker locker(&mMutex);
+
+                    ++mMisses;
+                }
+            } else if (!httpStatusCode.isValid() && urlsCachedContents.contains(url)) {
+                // We couldn't get a response, so fall back on our cached
+                // contents
+
+                res.insert(url, urlsCachedContents.value(url));
+
+                QMutexLocker locker(&mMutex);
+
+                ++mHits;
+            }
+
+            networkReply->deleteLater();
+        }
+    }
+
+    return res;
+}
+
+//==============================================================================
+
+QString CellmlFileImportCache::fileName(const QString &pUrl) const
+{
+    // Return the name of the file that holds (or would hold) the contents of
+    // the given URL
+    // Note: our caller is expected to have locked our mutex...
+
+    return mDirectory+QDir::separator()+Core::sha1(pUrl.toUtf8())+ImportFileExtension;
+}
+
+//==============================================================================
+
+bool CellmlFileImportCache::cachedContents(const QString &pUrl,
+                                           QByteArray &pContents,
+                                           QByteArray &pEtag,
+                                           QByteArray &pLastModified) const
+{
+    // Retrieve the cached contents of the given URL, together with their ETag
+    // and Last-Modified values
+    // Note: we check the version of our cache format and the URL, so that we
+    //       don't end up using some contents that were cached by an
+    //       incompatible version of OpenCOR or for another URL...
+
+    QMutexLocker locker(&mMutex);
+
+    QFile file(fileName(pUrl));
+
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream stream(&file);
+    QString cacheFormatVersion;
+    QString url;
+
+    stream >> cacheFormatVersion >> url >> pEtag >> pLastModified >> pContents;
+
+    return    (stream.status() == QDataStream::Ok)
+           && !cacheFormatVersion.compare(CacheFormatVersion)
+           && !url.compare(pUrl);
+}
+
+//==============================================================================
+
+void CellmlFileImportCache::storeContents(const QString &pUrl,
+                                          const QByteArray &pContents,
+                                          const QByteArray &pEtag,
+                                          const QByteArray &pLastModified)
+{
+    // Store the given contents of the given URL, together with their ETag and
+    // Last-Modified values
+    // Note: we use a QSaveFile object so that the contents are either fully
+    //       stored or not at all...
+
+    QMutexLocker locker(&mMutex);
+
+    if (!QDir().mkpath(mDirectory))
+        return;
+
+    QSaveFile file(fileName(pUrl));
+
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+
+    QDataStream stream(&file);
+
+    stream << CacheFormatVersion << pUrl << pEtag << pLastModified << pContents;
+
+    file.commit();
+}
+
+//==============================================================================
+
+void CellmlFileImportCache::networkAccessManagerSslErrors(QNetworkReply *pNetworkReply,
+                                                          const QList<QSslError> &pSslErrors)
+{
+    // Ignore the SSL errors since we assume the user knows what s/he is doing
+
+    pNetworkReply->ignoreSslErrors(pSslErrors);
+}
+
+//==============================================================================
+
+}   // namespace CellMLSupport
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -0,0 +1,103 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// CellML file import cache
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include "cellmlsupportglobal.h"
+
+//==============================================================================
+
+#include <QByteArray>
+#include <QMap>
+#include <QMutex>
+#include <QObject>
+#include <QSslError>
+#include <QString>
+#include <QStringList>
+
+//==============================================================================
+
+class QNetworkReply;
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace CellMLSupport {
+
+//==============================================================================
+
+class CELLMLSUPPORT_EXPORT CellmlFileImportCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CellmlFileImportCache();
+
+    static CellmlFileImportCache * instance();
+
+    bool isEnabled() const;
+    void setEnabled(const bool &pEnabled);
+
+    QString directory() const;
+    void setDirectory(const QString &pDirectory);
+
+    quint64 hits() const;
+    quint64 misses() const;
+
+    void resetStatistics();
+
+    void clear();
+
+    QMap<QString, QByteArray> contents(const QStringList &pUrls);
+
+private:
+    mutable QMutex mMutex;
+
+    bool mEnabled;
+    QString mDirectory;
+
+    quint64 mHits;
+    quint64 mMisses;
+
+    QString fileName(const QString &pUrl) const;
+
+    bool cachedContents(const QString &pUrl, QByteArray &pContents,
+                        QByteArray &pEtag, QByteArray &pLastModified) const;
+    void storeContents(const QString &pUrl, const QByteArray &pContents,
+                       const QByteArray &pEtag,
+                       const QByteArray &pLastModified);
+
+private slots:
+    void networkAccessManagerSslErrors(QNetworkReply *pNetworkReply,
+                                       const QList<QSslError> &pSslErrors);
+};
+
+//==============================================================================
+
+}   // namespace CellMLSupport
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
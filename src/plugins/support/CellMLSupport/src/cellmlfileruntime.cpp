@@ -22,6 +22,7 @@ limitations under the License.
 
 #include "cellmlfile.h"
 #include "cellmlfileruntime.h"
+#include "cellmlfileruntimejacobian.h"
 #include "compilerengine.h"
 #include "compilermath.h"
 #include "corecliutils.h"
@@ -34,6 +35,7 @@ limitations under the License.
 //==============================================================================
 
 #include <QRegularExpression>
+#include <QSet>
 #include <QStringList>
 
 //==============================================================================
@@ -181,8 +183,11 @@ CellmlFileRuntime::CellmlFileRuntime(CellmlFile *pCellmlFile) :
     mAlgebraicCount(0),
     mCondVarCount(0),
     mCompilerEngine(0),
+    mNlaSolverRegistry(new Solver::NlaSolverRegistry()),
     mVariableOfIntegration(0),
-    mParameters(CellmlFileRuntimeParameters())
+    mParameters(CellmlFileRuntimeParameters()),
+    mBatchCompilerEngine(0),
+    mSpecializedCompilerEngine(0)
 {
     // Reset (initialise, here) our properties
 
@@ -196,6 +201,10 @@ CellmlFileRuntime::~CellmlFileRuntime()
     // Reset our properties
 
     reset(false, false);
+
+    // Delete some internal objects
+
+    delete mNlaSolverRegistry;
 }
 
 //==============================================================================
@@ -209,11 +218,11 @@ CellmlFile * CellmlFileRuntime::cellmlFile()
 
 //==============================================================================
 
-QString CellmlFileRuntime::address() const
+Solver::NlaSolverRegistry * CellmlFileRuntime::nlaSolverRegistry() const
 {
-    // Return our address as a string
+    // Return our NLA solver registry
 
-    return QString::number(qulonglong(this));
+    return mNlaSolverRegistry;
 }
 
 //==============================================================================
@@ -344,6 +353,129 @@ CellmlFileRuntime::ComputeOdeVariablesFunction CellmlFileRuntime::computeOdeVari
 
 //==============================================================================
 
+CellmlFileRuntime::ComputeOdeJacobianFunction CellmlFileRuntime::computeOdeJacobian() const
+{
+    // Return the computeOdeJacobian function, if any
+
+    return mComputeOdeJacobian;
+}
+
+//==============================================================================
+
+int CellmlFileRuntime::odeBatchLanesCount() const
+{
+    // Return the number of lanes computed by the computeOdeRatesBatch function
+
+    return mOdeBatchLanesCount;
+}
+
+//==============================================================================
+
+CellmlFileRuntime::ComputeOdeRatesBatchFunction CellmlFileRuntime::computeOdeRatesBatch() const
+{
+    // Return the computeOdeRatesBatch function, if any
+
+    return mComputeOdeRatesBatch;
+}
+
+//==============================================================================
+
+CellmlFileRuntime::ComputeOdeRatesFunction CellmlFileRuntime::specializedComputeOdeRates(const QList<int> &pVaryingConstants)
+{
+    // Return a version of our computeOdeRates function where our constants and
+    // computed constants are inlined, except for the given varying constants
+    // and the computed constants that depend on them, so that the compiler can
+    // fold and hoist them
+    // Note #1: the value of an inlined constant is its initial value, i.e. the
+    //          one set by our initializeConstants function...
+    // Note #2: our specialised function gets regenerated and recompiled only
+    //          if the varying constants are different from the ones used the
+    //          last time round...
+
+    if ((mModelType != CellmlFileRuntime::Ode) || !mComputeOdeRates)
+        return 0;
+
+    QList<int> varyingConstants = pVaryingConstants.toSet().toList();
+
+    std::sort(varyingConstants.begin(), varyingConstants.end());
+
+    if (mSpecializedComputeOdeRates && (varyingConstants == mSpecializedVaryingConstants))
+        return mSpecializedComputeOdeRates;
+
+    // Determine the constants that can be inlined, starting with our 'proper'
+    // constants, and their inlined value
+    // Note: we make sure that the inlined value of a constant is a floating
+    //       point literal, so that something like 1/2 doesn't end up being
+    //       evaluated as an integer division...
+
+    static const QRegularExpression ConstantInitializationRegEx = QRegularExpression("^CONSTANTS\\[(\\d+)\\] = ([^;]+);$");
+    static const QRegularExpression ComputedConstantRegEx = QRegularExpression("^CONSTANTS\\[(\\d+)\\] = ([^;{}]+);$");
+    static const QRegularExpression ConstantRegEx = QRegularExpression("\\bCONSTANTS\\[\\d+\\]");
+    static const QRegularExpression OtherVariableRegEx = QRegularExpression("\\b(VOI|RATES|STATES|ALGEBRAIC)\\b");
+    static const int MaximumInlinedConstantSize = 4096;
+
+    QMap<int, QString> inlinedConstants = QMap<int, QString>();
+
+    foreach (const QString &initConst, mInitConstsCode.split("\n")) {
+        QRegularExpressionMatch match = ConstantInitializationRegEx.match(initConst.trimmed());
+
+        if (match.hasMatch() && !varyingConstants.contains(match.captured(1).toInt())) {
+            QString value = QString::number(match.captured(2).toDouble(), 'g', 17);
+
+            if (!value.contains('.') && !value.contains('e'))
+                value += ".0";
+
+            inlinedConstants.insert(match.captured(1).toInt(), "("+value+")");
+        }
+    }
+
+    // Now, go through our computed constants and inline those that only depend
+    // on inlined constants, in which case their expression gets inlined and it
+    // is for the compiler to evaluate it
+    // Note: we don't inline a computed constant which expression would be too
+    //       long, as can happen with deep chains of computed constants...
+
+    foreach (const QString &compCompConst, mCompCompConstsCode.split("\n")) {
+        QRegularExpressionMatch match = ComputedConstantRegEx.match(compCompConst.trimmed());
+
+        if (   !match.hasMatch()
+            ||  varyingConstants.contains(match.captured(1).toInt())
+            ||  OtherVariableRegEx.match(match.captured(2)).hasMatch()) {
+            continue;
+        }
+
+        QString expression = inlinedConstantsCode(match.captured(2), inlinedConstants);
+
+        if (   !ConstantRegEx.match(expression).hasMatch()
+            &&  (expression.size() <= MaximumInlinedConstantSize)) {
+            inlinedConstants.insert(match.captured(1).toInt(), "("+expression+")");
+        }
+    }
+
+    // Generate and compile our specialised computeOdeRates function
+    // Note: it is compiled using its own compiler engine, so that our generic
+    //       functions remain available. Also, if our model has NLA systems,
+    //       then those need to be compiled too, but they keep reading our
+    //       constants from memory...
+
+    delete mSpecializedCompilerEngine;
+
+    mSpecializedCompilerEngine = new Compiler::CompilerEngine();
+    mSpecializedVaryingConstants = varyingConstants;
+    mSpecializedComputeOdeRates = 0;
+
+    QString modelCode = mNlaSystemsCode
+                       +functionCode("int computeOdeRates(double VOI, double *CONSTANTS, double *RATES, double *STATES, double *ALGEBRAIC)",
+                                     inlinedConstantsCode(mRatesCode, inlinedConstants));
+
+    if (mSpecializedCompilerEngine->compileCode(modelCode))
+        mSpecializedComputeOdeRates = (ComputeOdeRatesFunction) (intptr_t) mSpecializedCompilerEngine->getFunction("computeOdeRates");
+
+    return mSpecializedComputeOdeRates;
+}
+
+//==============================================================================
+
 CellmlFileRuntime::ComputeDaeEssentialVariablesFunction CellmlFileRuntime::computeDaeEssentialVariables() const
 {
     // Return the computeDaeEssentialVariables function
@@ -389,6 +521,129 @@ CellmlFileRuntime::ComputeDaeVariablesFunction CellmlFileRuntime::computeDaeVari
 
 //==============================================================================
 
+CellmlFileRuntime::ComputeOdeVariablesFunction CellmlFileRuntime::slicedComputeOdeVariables(const QList<int> &pAlgebraic)
+{
+    // Return a version of our computeOdeVariables function that only computes
+    // the given algebraic variables, if possible
+
+    if (mModelType != CellmlFileRuntime::Ode)
+        return 0;
+
+    return (ComputeOdeVariablesFunction) (intptr_t) slicedVariablesFunction(pAlgebraic);
+}
+
+//==============================================================================
+
+CellmlFileRuntime::ComputeDaeVariablesFunction CellmlFileRuntime::slicedComputeDaeVariables(const QList<int> &pAlgebraic)
+{
+    // Return a version of our computeDaeVariables function that only computes
+    // the given algebraic variables, if possible
+
+    if (mModelType != CellmlFileRuntime::Dae)
+        return 0;
+
+    return (ComputeDaeVariablesFunction) (intptr_t) slicedVariablesFunction(pAlgebraic);
+}
+
+//==============================================================================
+
+void * CellmlFileRuntime::slicedVariablesFunction(const QList<int> &pAlgebraic)
+{
+    // Make sure that we have some functions
+
+    if (!mInitializeConstants)
+        return 0;
+
+    // Check whether we have already sliced our variables code for the given
+    // algebraic variables
+    // Note: we also keep track of failed attempts, so that we don't retry
+    //       them...
+
+    QList<int> algebraic = pAlgebraic.toSet().toList();
+
+    std::sort(algebraic.begin(), algebraic.end());
+
+    if (mSlicedVariablesFunctions.contains(algebraic))
+        return mSlicedVariablesFunctions.value(algebraic);
+
+    mSlicedVariablesFunctions.insert(algebraic, 0);
+
+    // Break our variables code into statements, which must all be plain
+    // assignments (i.e. no NLA systems, no conditional statements), and keep
+    // track of the variable each of them computes and of the variables it
+    // depends on
+
+    static const QRegularExpression AssignmentRegEx = QRegularExpression("^(\\w+\\[\\d+\\]) = ([^{}]+)$");
+    static const QRegularExpression VariableRegEx = QRegularExpression("\\b\\w+\\[\\d+\\]");
+
+    QStringList statements = QStringList();
+    QStringList variables = QStringList();
+    QList<QStringList> dependencies = QList<QStringList>();
+
+    foreach (const QString &statement, mVariablesCode.split(";", QString::SkipEmptyParts)) {
+        QString simplifiedStatement = statement.simplified();
+
+        if (simplifiedStatement.isEmpty())
+            continue;
+
+        QRegularExpressionMatch match = AssignmentRegEx.match(simplifiedStatement);
+
+        if (!match.hasMatch())
+            return 0;
+
+        QStringList statementDependencies = QStringList();
+        QRegularExpressionMatchIterator matchIterator = VariableRegEx.globalMatch(match.captured(2));
+
+        while (matchIterator.hasNext())
+            statementDependencies << matchIterator.next().captured(0);
+
+        statements << simplifiedStatement;
+        variables << match.captured(1);
+        dependencies << statementDependencies;
+    }
+
+    // Slice our variables code, i.e. go backward through our statements and
+    // only keep those that compute a variable that is needed, either because
+    // it is one of the given algebraic variables or because a statement that
+    // we keep depends on it
+
+    QSet<QString> neededVariables = QSet<QString>();
+
+    foreach (int index, algebraic)
+        neededVariables << QString("ALGEBRAIC[%1]").arg(index);
+
+    QString slicedCode = QString();
+
+    for (int i = statements.count()-1; i >= 0; --i) {
+        if (neededVariables.contains(variables[i])) {
+            slicedCode = statements[i]+";\n"+slicedCode;
+
+            neededVariables += dependencies[i].toSet();
+        }
+    }
+
+    // Compile our sliced code using its own compiler engine
+
+    Compiler::CompilerEngine *compilerEngine = new Compiler::CompilerEngine();
+
+    mSlicedCompilerEngines << compilerEngine;
+
+    QString functionSignature = (mModelType == CellmlFileRuntime::Ode)?
+                                    "int computeVariables(double VOI, double *CONSTANTS, double *RATES, double *STATES, double *ALGEBRAIC)":
+                                    "int computeVariables(double VOI, double *CONSTANTS, double *RATES, double *STATES, double *ALGEBRAIC, double *CONDVAR)";
+
+    if (!compilerEngine->compileCode(functionCode(functionSignature, slicedCode)))
+        return 0;
+
+    void *res = compilerEngine->getFunction("computeVariables");
+
+    mSlicedVariablesFunctions.insert(algebraic, res);
+
+    return res;
+}
+
+//==============================================================================
+
 CellmlFileIssues CellmlFileRuntime::issues() const
 {
     // Return the issue(s)
@@ -439,6 +694,13 @@ void CellmlFileRuntime::resetFunctions()
 
     mComputeOdeRates = 0;
     mComputeOdeVariables = 0;
+    mComputeOdeJacobian = 0;
+
+    mOdeBatchLanesCount = 1;
+    mComputeOdeRatesBatch = 0;
+
+    mSpecializedVaryingConstants.clear();
+    mSpecializedComputeOdeRates = 0;
 
     mComputeDaeEssentialVariables = 0;
     mComputeDaeResiduals = 0;
@@ -467,8 +729,28 @@ void CellmlFileRuntime::reset(const bool &pRecreateCompilerEngine,
     else
         mCompilerEngine = 0;
 
+    delete mBatchCompilerEngine;
+
+    mBatchCompilerEngine = 0;
+
+    delete mSpecializedCompilerEngine;
+
+    mSpecializedCompilerEngine = 0;
+
     resetFunctions();
 
+    mNlaSystemsCode = QString();
+    mInitConstsCode = QString();
+    mCompCompConstsCode = QString();
+    mRatesCode = QString();
+    mVariablesCode = QString();
+
+    foreach (Compiler::CompilerEngine *slicedCompilerEngine, mSlicedCompilerEngines)
+        delete slicedCompilerEngine;
+
+    mSlicedCompilerEngines.clear();
+    mSlicedVariablesFunctions.clear();
+
     if (pResetIssues)
         mIssues.clear();
 
@@ -630,6 +912,86 @@ QString CellmlFileRuntime::functionCode(const QString &pFunctionSignature,
 
 //==============================================================================
 
+QString CellmlFileRuntime::batchCode(const QString &pCode,
+                                     const int &pLanesCount)
+{
+    // Generate a version of the given code that computes several lanes (i.e.
+    // sets of constants and states) at once, using a structure-of-arrays layout
+    // (i.e. X[i] becomes X[i*pLanesCount+l] for lane l) and a loop over our
+    // lanes for each statement, so that the compiler can vectorise it
+    // Note: this can only be done if the given code consists of plain
+    //       assignments (i.e. no NLA systems, no conditional statements), so
+    //       we return an empty string if that's not the case...
+
+    static const QRegularExpression AssignmentRegEx = QRegularExpression("^(ALGEBRAIC|RATES)\\[\\d+\\] = [^{}]+$");
+    static const QRegularExpression VariableRegEx = QRegularExpression("\\b(CONSTANTS|RATES|STATES|ALGEBRAIC)\\[(\\d+)\\]");
+
+    QString lanesCount = QString::number(pLanesCount);
+    QString res = QString();
+
+    foreach (const QString &statement, pCode.split(";", QString::SkipEmptyParts)) {
+        QString simplifiedStatement = statement.simplified();
+
+        if (simplifiedStatement.isEmpty())
+            continue;
+
+        if (!AssignmentRegEx.match(simplifiedStatement).hasMatch())
+            return QString();
+
+        QRegularExpressionMatchIterator matchIterator = VariableRegEx.globalMatch(simplifiedStatement);
+        QString batchStatement = QString();
+        int position = 0;
+
+        while (matchIterator.hasNext()) {
+            QRegularExpressionMatch match = matchIterator.next();
+
+            batchStatement += simplifiedStatement.mid(position, match.capturedStart()-position)
+                             +match.captured(1)+"["+QString::number(match.captured(2).toInt()*pLanesCount)+"+l]";
+
+            position = match.capturedEnd();
+        }
+
+        batchStatement += simplifiedStatement.mid(position);
+
+        res += "\n"
+               "    for (l = 0; l < "+lanesCount+"; ++l)\n"
+               "        "+batchStatement+";\n";
+    }
+
+    return res.isEmpty()?QString():"    int l;\n"+res;
+}
+
+//==============================================================================
+
+QString CellmlFileRuntime::inlinedConstantsCode(const QString &pCode,
+                                                const QMap<int, QString> &pInlinedConstants)
+{
+    // Generate a version of the given code where the given constants are
+    // replaced with their inlined value
+
+    static const QRegularExpression ConstantRegEx = QRegularExpression("\\bCONSTANTS\\[(\\d+)\\]");
+
+    QRegularExpressionMatchIterator matchIterator = ConstantRegEx.globalMatch(pCode);
+    QString res = QString();
+    int position = 0;
+
+    while (matchIterator.hasNext()) {
+        QRegularExpressionMatch match = matchIterator.next();
+        int index = match.captured(1).toInt();
+
+        if (pInlinedConstants.contains(index)) {
+            res += pCode.mid(position, match.capturedStart()-position)
+                  +pInlinedConstants.value(index);
+
+            position = match.capturedEnd();
+        }
+    }
+
+    return res+pCode.mid(position);
+}
+
+//==============================================================================
+
 bool sortParameters(CellmlFileRuntimeParameter *pParameter1,
                     CellmlFileRuntimeParameter *pParameter2)
 {
@@ -923,11 +1285,15 @@ void CellmlFileRuntime::update()
     // Generate the model code
 
     QString modelCode = QString();
+    QString ratesBatchCode = QString();
     QString functionsString = QString::fromStdWString(genericCodeInformation->functionsString());
 
     if (!functionsString.isEmpty()) {
         // We will need to solve at least one NLA system
 
+        static const QRegularExpression StaticParametersRegEx = QRegularExpression("^(\\s*)static double ",
+                                                                                   QRegularExpression::MultilineOption);
+
         mAtLeastOneNlaSystem = true;
 
         modelCode +=  "struct rootfind_info\n"
@@ -942,19 +1308,26 @@ void CellmlFileRuntime::update()
                       "    int *aPRET;\n"
                       "};\n"
                       "\n"
-                      "extern void doNonLinearSolve(char *, void (*)(double *, double *, void*), double *, int *, int, void *);\n"
+                      "extern void doNonLinearSolve(void *, void (*)(double *, double *, void*), double *, int *, int, void *);\n"
                       "\n"
-                     +functionsString.replace("do_nonlinearsolve(", QString("doNonLinearSolve(\"%1\", ").arg(address()))
+                     +functionsString.replace("do_nonlinearsolve(", QString("doNonLinearSolve((void *) %1ULL, ").arg(quintptr(mNlaSolverRegistry)))
+                                     .replace(StaticParametersRegEx, "\\1double ")
                      +"\n";
 
         // Note: we rename do_nonlinearsolve() to doNonLinearSolve() because
         //       CellML's CIS service already defines do_nonlinearsolve(), yet
         //       we want to use our own non-linear solve routine defined in our
         //       Compiler plugin. Also, we add a new parameter to all our calls
-        //       to doNonLinearSolve() so that doNonLinearSolve() can retrieve
-        //       the correct instance of our NLA solver...
+        //       to doNonLinearSolve() so that doNonLinearSolve() can directly
+        //       access our NLA solver registry and, from there, retrieve the
+        //       instance of our NLA solver for the calling thread. Finally, we
+        //       make the parameters of our NLA systems local rather than
+        //       static, so that several threads can solve them at once (our NLA
+        //       solver warm-starts them from their previous solution)...
     }
 
+    mNlaSystemsCode = modelCode;
+
     // Retrieve the body of the function that initialises constants and extract
     // the statements that are related to computed variables (since we want to
     // be able to recompute those whenever the user modifies a parameter)
@@ -978,6 +1351,9 @@ void CellmlFileRuntime::update()
             compCompConsts += (compCompConsts.isEmpty()?QString():"\n")+initConst;
     }
 
+    mInitConstsCode = initConsts;
+    mCompCompConstsCode = compCompConsts;
+
     modelCode += functionCode("int initializeConstants(double *CONSTANTS, double *RATES, double *STATES)",
                               initConsts, true);
     modelCode += "\n";
@@ -987,12 +1363,40 @@ void CellmlFileRuntime::update()
 
     // Retrieve the body of the remaining functions
 
+    mVariablesCode = cleanCode(genericCodeInformation->variablesString());
+
     if (mModelType == CellmlFileRuntime::Ode) {
+        QString ratesCode = cleanCode(mOdeCodeInformation->ratesString());
+
+        mRatesCode = ratesCode;
+
         modelCode += functionCode("int computeOdeRates(double VOI, double *CONSTANTS, double *RATES, double *STATES, double *ALGEBRAIC)",
-                                  cleanCode(mOdeCodeInformation->ratesString()));
+                                  ratesCode);
         modelCode += "\n";
         modelCode += functionCode("int computeOdeVariables(double VOI, double *CONSTANTS, double *RATES, double *STATES, double *ALGEBRAIC)",
-                                  cleanCode(genericCodeInformation->variablesString()));
+                                  mVariablesCode);
+
+        // Generate the code that computes the Jacobian of our ODE system, if
+        // we can
+        // Note: we can't always generate that code (e.g. if the model has an
+        //       NLA system), in which case our ODE solver will have to compute
+        //       the Jacobian using finite differences...
+
+        CellmlFileRuntimeJacobian jacobian = CellmlFileRuntimeJacobian(ratesCode, mStatesRatesCount, mAlgebraicCount);
+
+        if (jacobian.isValid()) {
+            modelCode += "\n";
+            modelCode += functionCode("int computeOdeJacobian(double VOI, double *CONSTANTS, double *RATES, double *STATES, double *ALGEBRAIC, double *JACOBIAN, double *DALGEBRAIC)",
+                                      jacobian.code());
+        }
+
+        // Generate a batch version of our computeOdeRates() function, so that
+        // several sets of constants and states can be integrated in lockstep
+        // (e.g. when running a parameter ensemble), if we can
+        // Note: the batch code is compiled separately (see below), since it is
+        //       the only code that we tune for the host CPU...
+
+        ratesBatchCode = batchCode(ratesCode, Compiler::CompilerEngine::vectorWidth());
     } else {
         modelCode += functionCode("int computeDaeEssentialVariables(double VOI, double *CONSTANTS, double *RATES, double *OLDRATES, double *STATES, double *OLDSTATES, double *ALGEBRAIC, double *CONDVAR)",
                                   cleanCode(mDaeCodeInformation->essentialVariablesString()));
@@ -1006,7 +1410,7 @@ void CellmlFileRuntime::update()
                                   cleanCode(mDaeCodeInformation->stateInformationString()));
         modelCode += "\n";
         modelCode += functionCode("int computeDaeVariables(double VOI, double *CONSTANTS, double *RATES, double *STATES, double *ALGEBRAIC, double *CONDVAR)",
-                                  cleanCode(genericCodeInformation->variablesString()));
+                                  mVariablesCode);
     }
 
     // Check whether the model code contains a definite integral, otherwise
@@ -1020,6 +1424,23 @@ void CellmlFileRuntime::update()
                                    mCompilerEngine->error());
     }
 
+    // Compile the batch version of our computeOdeRates() function, if any,
+    // using its own compiler engine, which targets the host CPU
+    // Note: we don't report an issue if it can't be compiled since we can
+    //       always do without it...
+
+    if (!mIssues.count() && !ratesBatchCode.isEmpty()) {
+        mBatchCompilerEngine = new Compiler::CompilerEngine();
+
+        if (!mBatchCompilerEngine->compileCode(functionCode("int computeOdeRatesBatch(double VOI, double *CONSTANTS, double *RATES, double *STATES, double *ALGEBRAIC)",
+                                                            ratesBatchCode),
+                                               true)) {
+            delete mBatchCompilerEngine;
+
+            mBatchCompilerEngine = 0;
+        }
+    }
+
     // Keep track of the ODE/DAE functions, but only if no issues were reported
 
     if (mIssues.count()) {
@@ -1040,6 +1461,13 @@ void CellmlFileRuntime::update()
         if (mModelType == CellmlFileRuntime::Ode) {
             mComputeOdeRates     = (ComputeOdeRatesFunction) (intptr_t) mCompilerEngine->getFunction("computeOdeRates");
             mComputeOdeVariables = (ComputeOdeVariablesFunction) (intptr_t) mCompilerEngine->getFunction("computeOdeVariables");
+            mComputeOdeJacobian  = (ComputeOdeJacobianFunction) (intptr_t) mCompilerEngine->getFunction("computeOdeJacobian");
+
+            if (mBatchCompilerEngine)
+                mComputeOdeRatesBatch = (ComputeOdeRatesBatchFunction) (intptr_t) mBatchCompilerEngine->getFunction("computeOdeRatesBatch");
+
+            if (mComputeOdeRatesBatch)
+                mOdeBatchLanesCount = Compiler::CompilerEngine::vectorWidth();
         } else {
             mComputeDaeEssentialVariables = (ComputeDaeEssentialVariablesFunction) (intptr_t) mCompilerEngine->getFunction("computeDaeEssentialVariables");
             mComputeDaeResiduals          = (ComputeDaeResidualsFunction) (intptr_t) mCompilerEngine->getFunction("computeDaeResiduals");
@@ -30,6 +30,7 @@ limitations under the License.
 //==============================================================================
 
 #include <QList>
+#include <QMap>
 #include <QStringList>
 
 //==============================================================================
@@ -51,6 +52,10 @@ namespace Compiler {
     class CompilerEngine;
 }   // namespace Compiler
 
+namespace Solver {
+    class NlaSolverRegistry;
+}   // namespace Solver
+
 namespace CellMLSupport {
 
 //==============================================================================
@@ -83,6 +88,7 @@ public:
     QString name() const;
     int degree() const;
     QString unit() const;
+
     QStringList componentHierarchy() const;
     ParameterType type() const;
     int index() const;
@@ -122,6 +128,8 @@ public:
 
     typedef int (*ComputeOdeRatesFunction)(double VOI, double *CONSTANTS, double *RATES, double *STATES, double *ALGEBRAIC);
     typedef int (*ComputeOdeVariablesFunction)(double VOI, double *CONSTANTS, double *RATES, double *STATES, double *ALGEBRAIC);
+    typedef int (*ComputeOdeRatesBatchFunction)(double VOI, double *CONSTANTS, double *RATES, double *STATES, double *ALGEBRAIC);
+    typedef int (*ComputeOdeJacobianFunction)(double VOI, double *CONSTANTS, double *RATES, double *STATES, double *ALGEBRAIC, double *JACOBIAN, double *DALGEBRAIC);
 
     typedef int (*ComputeDaeEssentialVariablesFunction)(double VOI, double *CONSTANTS, double *RATES, double *OLDRATES, double *STATES, double *OLDSTATES, double *ALGEBRAIC, double *CONDVAR);
     typedef int (*ComputeDaeResidualsFunction)(double VOI, double *CONSTANTS, double *RATES, double *OLDRATES, double *STATES, double *OLDSTATES, double *ALGEBRAIC, double *CONDVAR, double *resid);
@@ -134,7 +142,7 @@ public:
 
     CellmlFile * cellmlFile();
 
-    QString address() const;
+    Solver::NlaSolverRegistry * nlaSolverRegistry() const;
 
     bool isValid() const;
 
@@ -156,6 +164,12 @@ public:
 
     ComputeOdeRatesFunction computeOdeRates() const;
     ComputeOdeVariablesFunction computeOdeVariables() const;
+    ComputeOdeJacobianFunction computeOdeJacobian() const;
+
+    int odeBatchLanesCount() const;
+    ComputeOdeRatesBatchFunction computeOdeRatesBatch() const;
+
+    ComputeOdeRatesFunction specializedComputeOdeRates(const QList<int> &pVaryingConstants);
 
     ComputeDaeEssentialVariablesFunction computeDaeEssentialVariables() const;
     ComputeDaeResidualsFunction computeDaeResiduals() const;
@@ -163,6 +177,9 @@ public:
     ComputeDaeStateInformationFunction computeDaeStateInformation() const;
     ComputeDaeVariablesFunction computeDaeVariables() const;
 
+    ComputeOdeVariablesFunction slicedComputeOdeVariables(const QList<int> &pAlgebraic);
+    ComputeDaeVariablesFunction slicedComputeDaeVariables(const QList<int> &pAlgebraic);
+
     CellmlFileIssues issues() const;
 
     CellmlFileRuntimeParameters parameters() const;
@@ -187,6 +204,8 @@ private:
 
     Compiler::CompilerEngine *mCompilerEngine;
 
+    Solver::NlaSolverRegistry *mNlaSolverRegistry;
+
     CellmlFileIssues mIssues;
 
     CellmlFileRuntimeParameter *mVariableOfIntegration;
@@ -198,6 +217,24 @@ private:
 
     ComputeOdeRatesFunction mComputeOdeRates;
     ComputeOdeVariablesFunction mComputeOdeVariables;
+    ComputeOdeJacobianFunction mComputeOdeJacobian;
+
+    Compiler::CompilerEngine *mBatchCompilerEngine;
+    int mOdeBatchLanesCount;
+    ComputeOdeRatesBatchFunction mComputeOdeRatesBatch;
+
+    QString mNlaSystemsCode;
+    QString mInitConstsCode;
+    QString mCompCompConstsCode;
+    QString mRatesCode;
+    QString mVariablesCode;
+
+    Compiler::CompilerEngine *mSpecializedCompilerEngine;
+    QList<int> mSpecializedVaryingConstants;
+    ComputeOdeRatesFunction mSpecializedComputeOdeRates;
+
+    QList<Compiler::CompilerEngine *> mSlicedCompilerEngines;
+    QMap<QList<int>, void *> mSlicedVariablesFunctions;
 
     ComputeDaeEssentialVariablesFunction mComputeDaeEssentialVariables;
     ComputeDaeResidualsFunction mComputeDaeResiduals;
@@ -225,6 +262,11 @@ private:
     QString functionCode(const QString &pFunctionSignature,
                          const QString &pFunctionBody,
                          const bool &pHasDefines = false);
+    QString batchCode(const QString &pCode, const int &pLanesCount);
+    QString inlinedConstantsCode(const QString &pCode,
+                                 const QMap<int, QString> &pInlinedConstants);
+
+    void * slicedVariablesFunction(const QList<int> &pAlgebraic);
 
     QStringList componentHierarchy(iface::cellml_api::CellMLElement *pElement);
 };
@@ -0,0 +1,781 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// CellML file runtime Jacobian
+//==============================================================================
+
+#include "cellmlfileruntimejacobian.h"
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace CellMLSupport {
+
+//==============================================================================
+
+class CellmlFileRuntimeJacobianNode
+{
+public:
+    enum Type {
+        Number,
+        Identifier,
+        Variable,
+        Call,
+        Cast,
+        Unary,
+        Binary,
+        Ternary
+    };
+
+    explicit CellmlFileRuntimeJacobianNode(const Type &pType,
+                                           const QString &pValue);
+    ~CellmlFileRuntimeJacobianNode();
+
+    Type type() const;
+    QString value() const;
+
+    QList<CellmlFileRuntimeJacobianNode *> children() const;
+    void addChild(CellmlFileRuntimeJacobianNode *pChild);
+
+    QString code() const;
+
+private:
+    Type mType;
+    QString mValue;
+
+    QList<CellmlFileRuntimeJacobianNode *> mChildren;
+};
+
+//==============================================================================
+
+CellmlFileRuntimeJacobianNode::CellmlFileRuntimeJacobianNode(const Type &pType,
+                                                             const QString &pValue) :
+    mType(pType),
+    mValue(pValue),
+    mChildren(QList<CellmlFileRuntimeJacobianNode *>())
+{
+}
+
+//==============================================================================
+
+CellmlFileRuntimeJacobianNode::~CellmlFileRuntimeJacobianNode()
+{
+    // Delete some internal objects
+
+    qDeleteAll(mChildren);
+}
+
+//==============================================================================
+
+CellmlFileRuntimeJacobianNode::Type CellmlFileRuntimeJacobianNode::type() const
+{
+    // Return our type
+
+    return mType;
+}
+
+//==============================================================================
+
+QString CellmlFileRuntimeJacobianNode::value() const
+{
+    // Return our value
+
+    return mValue;
+}
+
+//==============================================================================
+
+QList<CellmlFileRuntimeJacobianNode *> CellmlFileRuntimeJacobianNode::children() const
+{
+    // Return our children
+
+    return mChildren;
+}
+
+//==============================================================================
+
+void CellmlFileRuntimeJacobianNode::addChild(CellmlFileRuntimeJacobianNode *pChild)
+{
+    // Add the given child to our children
+
+    mChildren << pChild;
+}
+
+//==============================================================================
+
+QString CellmlFileRuntimeJacobianNode::code() const
+{
+    // Return the (fully parenthesised) C code for our node
+
+    switch (mType) {
+    case Number:
+    case Identifier:
+    case Variable:
+        return mValue;
+    case Call: {
+        QStringList arguments = QStringList();
+
+        foreach (CellmlFileRuntimeJacobianNode *child, mChildren)
+            arguments << child->code();
+
+        return mValue+"("+arguments.join(", ")+")";
+    }
+    case Cast:
+        return "((int) "+mChildren[0]->code()+")";
+    case Unary:
+        return "("+mValue+mChildren[0]->code()+")";
+    case Binary:
+        return "("+mChildren[0]->code()+" "+mValue+" "+mChildren[1]->code()+")";
+    case Ternary:
+        return "("+mChildren[0]->code()+"?"+mChildren[1]->code()+":"+mChildren[2]->code()+")";
+    }
+
+    return QString();
+}
+
+//==============================================================================
+
+static const auto Algebraic = QStringLiteral("ALGEBRAIC");
+static const auto Constants = QStringLiteral("CONSTANTS");
+static const auto Rates     = QStringLiteral("RATES");
+static const auto States    = QStringLiteral("STATES");
+
+//==============================================================================
+
+CellmlFileRuntimeJacobian::CellmlFileRuntimeJacobian(const QString &pRatesCode,
+                                                     const int &pStatesCount,
+                                                     const int &pAlgebraicCount) :
+    mStatesCount(pStatesCount),
+    mAlgebraicCount(pAlgebraicCount),
+    mValid(false),
+    mCode(QString()),
+    mTokens(QStringList()),
+    mPosition(0),
+    mActiveVariables(QSet<QString>())
+{
+    // Generate the code that computes the Jacobian of our rates with respect
+    // to our states, using forward mode differentiation of the given rates
+    // code
+    // Note #1: the Jacobian is stored in row-major order in JACOBIAN, i.e.
+    //          JACOBIAN[i*N+j] is d(RATES[i])/d(STATES[j]), while DALGEBRAIC is
+    //          a work array in which we keep track of d(ALGEBRAIC[k])/d(STATES)
+    //          for all the algebraic variables that depend on our states...
+    // Note #2: the generated code may only use the mathematical functions that
+    //          are declared by our compiler engine, hence we use pow() rather
+    //          than sqrt()...
+    // Note #3: we only handle rates code that consists of plain assignments
+    //          (i.e. no NLA systems, no conditional statements), as well as
+    //          mathematical functions that we know how to differentiate. For
+    //          anything else, we give up and let our ODE solver compute the
+    //          Jacobian using finite differences...
+
+    if (!mStatesCount)
+        return;
+
+    mCode = "    int j;\n"
+            "\n"
+            "    for (j = 0; j < "+QString::number(mStatesCount*mStatesCount)+"; ++j)\n"
+            "        JACOBIAN[j] = 0.0;\n";
+
+    foreach (const QString &statement, pRatesCode.split(";", QString::SkipEmptyParts)) {
+        if (statement.trimmed().isEmpty())
+            continue;
+
+        if (!generateStatementCode(statement.trimmed())) {
+            mCode = QString();
+
+            return;
+        }
+    }
+
+    mValid = true;
+}
+
+//==============================================================================
+
+bool CellmlFileRuntimeJacobian::isValid() const
+{
+    // Return whether we could generate the code for our Jacobian
+
+    return mValid;
+}
+
+//==============================================================================
+
+QString CellmlFileRuntimeJacobian::code() const
+{
+    // Return the code for our Jacobian
+
+    return mCode;
+}
+
+//==============================================================================
+
+QString CellmlFileRuntimeJacobian::token(const int &pOffset) const
+{
+    // Return the requested token, if any
+
+    int position = mPosition+pOffset;
+
+    return (position < mTokens.count())?mTokens[position]:QString();
+}
+
+//==============================================================================
+
+bool CellmlFileRuntimeJacobian::accept(const QString &pToken)
+{
+    // Move to the next token, if the current one is the one we are after
+
+    if (token() != pToken)
+        return false;
+
+    ++mPosition;
+
+    return true;
+}
+
+//==============================================================================
+
+void CellmlFileRuntimeJacobian::tokenize(const QString &pStatement)
+{
+    // Split the given statement into tokens
+    // Note: an empty token is used to signal a character we don't know about,
+    //       which will result in our parsing failing...
+
+    static const QStringList DoubleCharacterOperators = QStringList() << "&&" << "||" << "==" << "!=" << "<=" << ">=";
+    static const QString SingleCharacterOperators = "+-*/%()[],?:<>!^=";
+
+    mTokens = QStringList();
+    mPosition = 0;
+
+    int i = 0;
+    int iMax = pStatement.length();
+
+    while (i < iMax) {
+        QChar character = pStatement[i];
+
+        if (character.isSpace()) {
+            ++i;
+        } else if (character.isDigit() || (character == '.')) {
+            int start = i;
+
+            while ((i < iMax) && (pStatement[i].isDigit() || (pStatement[i] == '.')))
+                ++i;
+
+            if ((i < iMax) && ((pStatement[i] == 'e') || (pStatement[i] == 'E'))) {
+                ++i;
+
+                if ((i < iMax) && ((pStatement[i] == '+') || (pStatement[i] == '-')))
+                    ++i;
+
+                while ((i < iMax) && pStatement[i].isDigit())
+                    ++i;
+            }
+
+            mTokens << pStatement.mid(start, i-start);
+        } else if (character.isLetter() || (character == '_')) {
+            int start = i;
+
+            while ((i < iMax) && (pStatement[i].isLetterOrNumber() || (pStatement[i] == '_')))
+                ++i;
+
+            mTokens << pStatement.mid(start, i-start);
+        } else if (DoubleCharacterOperators.contains(pStatement.mid(i, 2))) {
+            mTokens << pStatement.mid(i, 2);
+
+            i += 2;
+        } else if (SingleCharacterOperators.contains(character)) {
+            mTokens << QString(character);
+
+            ++i;
+        } else {
+            mTokens << QString();
+
+            return;
+        }
+    }
+}
+
+//==============================================================================
+
+CellmlFileRuntimeJacobianNode * CellmlFileRuntimeJacobian::parseExpression()
+{
+    // Parse a (possibly ternary) expression
+
+    CellmlFileRuntimeJacobianNode *condition = parseBinaryExpression(0);
+
+    if (!condition || !accept("?"))
+        return condition;
+
+    CellmlFileRuntimeJacobianNode *res = new CellmlFileRuntimeJacobianNode(CellmlFileRuntimeJacobianNode::Ternary, "?");
+
+    res->addChild(condition);
+
+    CellmlFileRuntimeJacobianNode *trueExpression = parseExpression();
+
+    if (!trueExpression || !accept(":")) {
+        delete trueExpression;
+        delete res;
+
+        return 0;
+    }
+
+    res->addChild(trueExpression);
+
+    CellmlFileRuntimeJacobianNode *falseExpression = parseExpression();
+
+    if (!falseExpression) {
+        delete res;
+
+        return 0;
+    }
+
+    res->addChild(falseExpression);
+
+    return res;
+}
+
+//==============================================================================
+
+CellmlFileRuntimeJacobianNode * CellmlFileRuntimeJacobian::parseBinaryExpression(const int &pLevel)
+{
+    // Parse a binary expression, using C's operator precedence
+
+    static const QList<QStringList> Operators = QList<QStringList>() << (QStringList() << "||")
+                                                                     << (QStringList() << "&&")
+                                                                     << (QStringList() << "^")
+                                                                     << (QStringList() << "==" << "!=")
+                                                                     << (QStringList() << "<" << ">" << "<=" << ">=")
+                                                                     << (QStringList() << "+" << "-")
+                                                                     << (QStringList() << "*" << "/" << "%");
+
+    if (pLevel == Operators.count())
+        return parseUnaryExpression();
+
+    CellmlFileRuntimeJacobianNode *res = parseBinaryExpression(pLevel+1);
+
+    while (res && Operators[pLevel].contains(token())) {
+        CellmlFileRuntimeJacobianNode *binaryExpression = new CellmlFileRuntimeJacobianNode(CellmlFileRuntimeJacobianNode::Binary, token());
+
+        ++mPosition;
+
+        binaryExpression->addChild(res);
+
+        res = binaryExpression;
+
+        CellmlFileRuntimeJacobianNode *rightOperand = parseBinaryExpression(pLevel+1);
+
+        if (!rightOperand) {
+            delete res;
+
+            return 0;
+        }
+
+        res->addChild(rightOperand);
+    }
+
+    return res;
+}
+
+//==============================================================================
+
+CellmlFileRuntimeJacobianNode * CellmlFileRuntimeJacobian::parseUnaryExpression()
+{
+    // Parse a unary expression, including an integer cast
+
+    CellmlFileRuntimeJacobianNode *res = 0;
+
+    if ((token() == "-") || (token() == "+") || (token() == "!")) {
+        res = new CellmlFileRuntimeJacobianNode(CellmlFileRuntimeJacobianNode::Unary, token());
+
+        ++mPosition;
+    } else if ((token() == "(") && (token(1) == "int") && (token(2) == ")")) {
+        res = new CellmlFileRuntimeJacobianNode(CellmlFileRuntimeJacobianNode::Cast, "int");
+
+        mPosition += 3;
+    } else {
+        return parsePrimaryExpression();
+    }
+
+    CellmlFileRuntimeJacobianNode *operand = parseUnaryExpression();
+
+    if (!operand) {
+        delete res;
+
+        return 0;
+    }
+
+    res->addChild(operand);
+
+    return res;
+}
+
+//==============================================================================
+
+CellmlFileRuntimeJacobianNode * CellmlFileRuntimeJacobian::parsePrimaryExpression()
+{
+    // Parse a primary expression, i.e. a number, a variable, a function call,
+    // an identifier or a parenthesised expression
+
+    QString currentToken = token();
+
+    if (currentToken.isEmpty())
+        return 0;
+
+    if (currentToken[0].isDigit() || (currentToken[0] == '.')) {
+        ++mPosition;
+
+        return new CellmlFileRuntimeJacobianNode(CellmlFileRuntimeJacobianNode::Number, currentToken);
+    } else if (currentToken[0].isLetter() || (currentToken[0] == '_')) {
+        ++mPosition;
+
+        if (accept("[")) {
+            // We are dealing with an array element, which must be one of our
+            // model arrays and have a valid index
+
+            bool validIndex;
+            int index = token().toInt(&validIndex);
+
+            ++mPosition;
+
+            if (   !validIndex || (index < 0) || !accept("]")
+                || (   (currentToken != Constants)
+                    && ((currentToken != States) || (index >= mStatesCount))
+                    && ((currentToken != Rates) || (index >= mStatesCount))
+                    && ((currentToken != Algebraic) || (index >= mAlgebraicCount)))) {
+                return 0;
+            }
+
+            return new CellmlFileRuntimeJacobianNode(CellmlFileRuntimeJacobianNode::Variable,
+                                                     currentToken+"["+QString::number(index)+"]");
+        } else if (accept("(")) {
+            // We are dealing with a function call
+
+            CellmlFileRuntimeJacobianNode *res = new CellmlFileRuntimeJacobianNode(CellmlFileRuntimeJacobianNode::Call, currentToken);
+
+            if (accept(")"))
+                return res;
+
+            forever {
+                CellmlFileRuntimeJacobianNode *argument = parseExpression();
+
+                if (!argument) {
+                    delete res;
+
+                    return 0;
+                }
+
+                res->addChild(argument);
+
+                if (accept(")"))
+                    return res;
+
+                if (!accept(",")) {
+                    delete res;
+
+                    return 0;
+                }
+            }
+        } else {
+            return new CellmlFileRuntimeJacobianNode(CellmlFileRuntimeJacobianNode::Identifier, currentToken);
+        }
+    } else if (accept("(")) {
+        CellmlFileRuntimeJacobianNode *res = parseExpression();
+
+        if (res && !accept(")")) {
+            delete res;
+
+            return 0;
+        }
+
+        return res;
+    }
+
+    return 0;
+}
+
+//==============================================================================
+
+bool CellmlFileRuntimeJacobian::isActive(CellmlFileRuntimeJacobianNode *pNode) const
+{
+    // Determine whether the given node depends on our states
+
+    if (pNode->type() == CellmlFileRuntimeJacobianNode::Variable)
+        return    pNode->value().startsWith(States+"[")
+               || mActiveVariables.contains(pNode->value());
+
+    foreach (CellmlFileRuntimeJacobianNode *child, pNode->children()) {
+        if (isActive(child))
+            return true;
+    }
+
+    return false;
+}
+
+//==============================================================================
+
+bool CellmlFileRuntimeJacobian::differentiate(CellmlFileRuntimeJacobianNode *pNode,
+                                              const QString &pAdjoint,
+                                              QMap<QString, QString> &pPartials) const
+{
+    // Propagate the given adjoint to the active variables of the given node
+    // Note: pPartials ends up containing, for each active variable, the code
+    //       that computes the partial derivative of our statement with respect
+    //       to that variable...
+
+    if (!isActive(pNode))
+        return true;
+
+    QList<CellmlFileRuntimeJacobianNode *> children = pNode->children();
+
+    switch (pNode->type()) {
+    case CellmlFileRuntimeJacobianNode::Variable: {
+        QString partial = pPartials.value(pNode->value());
+
+        pPartials.insert(pNode->value(), partial.isEmpty()?pAdjoint:partial+"+"+pAdjoint);
+
+        return true;
+    }
+    case CellmlFileRuntimeJacobianNode::Unary:
+        if (pNode->value() == "-")
+            return differentiate(children[0], "(-"+pAdjoint+")", pPartials);
+        else if (pNode->value() == "+")
+            return differentiate(children[0], pAdjoint, pPartials);
+
+        return true;
+    case CellmlFileRuntimeJacobianNode::Binary: {
+        QString left = children[0]->code();
+        QString right = children[1]->code();
+
+        if (pNode->value() == "+") {
+            return    differentiate(children[0], pAdjoint, pPartials)
+                   && differentiate(children[1], pAdjoint, pPartials);
+        } else if (pNode->value() == "-") {
+            return    differentiate(children[0], pAdjoint, pPartials)
+                   && differentiate(children[1], "(-"+pAdjoint+")", pPartials);
+        } else if (pNode->value() == "*") {
+            return    differentiate(children[0], "("+pAdjoint+"*"+right+")", pPartials)
+                   && differentiate(children[1], "("+pAdjoint+"*"+left+")", pPartials);
+        } else if (pNode->value() == "/") {
+            return    differentiate(children[0], "("+pAdjoint+"/"+right+")", pPartials)
+                   && differentiate(children[1], "(-"+pAdjoint+"*"+left+"/("+right+"*"+right+"))", pPartials);
+        }
+
+        // Comparison, logical and integer operators are piecewise constant
+
+        return true;
+    }
+    case CellmlFileRuntimeJacobianNode::Ternary: {
+        QString condition = children[0]->code();
+
+        return    differentiate(children[1], "("+condition+"?"+pAdjoint+":0.0)", pPartials)
+               && differentiate(children[2], "("+condition+"?0.0:"+pAdjoint+")", pPartials);
+    }
+    case CellmlFileRuntimeJacobianNode::Call: {
+        QString function = pNode->value();
+
+        if (   (function == "floor") || (function == "ceil")
+            || (function == "factorial")
+            || (function == "gcd_multi") || (function == "lcm_multi")) {
+            return true;
+        } else if ((function == "pow") && (children.count() == 2)) {
+            QString base = children[0]->code();
+            QString exponent = children[1]->code();
+
+            return    differentiate(children[0], "("+pAdjoint+"*"+exponent+"*pow("+base+", "+exponent+"-1.0))", pPartials)
+                   && differentiate(children[1], "("+pAdjoint+"*log("+base+")*pow("+base+", "+exponent+"))", pPartials);
+        } else if ((function == "arbitrary_log") && (children.count() == 2)) {
+            QString argument = children[0]->code();
+            QString base = children[1]->code();
+
+            return    differentiate(children[0], "("+pAdjoint+"/("+argument+"*log("+base+")))", pPartials)
+                   && differentiate(children[1], "(-"+pAdjoint+"*log("+argument+")/("+base+"*log("+base+")*log("+base+")))", pPartials);
+        } else if (children.count() == 1) {
+            QString u = children[0]->code();
+            QString derivative = QString();
+
+            if (function == "exp")
+                derivative = "exp("+u+")";
+            else if (function == "log")
+                derivative = "1.0/"+u;
+            else if (function == "fabs")
+                derivative = "(("+u+" < 0.0)?-1.0:1.0)";
+            else if (function == "sin")
+                derivative = "cos("+u+")";
+            else if (function == "cos")
+                derivative = "(-sin("+u+"))";
+            else if (function == "tan")
+                derivative = "1.0/(cos("+u+")*cos("+u+"))";
+            else if (function == "sinh")
+                derivative = "cosh("+u+")";
+            else if (function == "cosh")
+                derivative = "sinh("+u+")";
+            else if (function == "tanh")
+                derivative = "(1.0-tanh("+u+")*tanh("+u+"))";
+            else if (function == "asin")
+                derivative = "1.0/pow(1.0-"+u+"*"+u+", 0.5)";
+            else if (function == "acos")
+                derivative = "(-1.0/pow(1.0-"+u+"*"+u+", 0.5))";
+            else if (function == "atan")
+                derivative = "1.0/(1.0+"+u+"*"+u+")";
+            else if (function == "asinh")
+                derivative = "1.0/pow("+u+"*"+u+"+1.0, 0.5)";
+            else if (function == "acosh")
+                derivative = "1.0/pow("+u+"*"+u+"-1.0, 0.5)";
+            else if (function == "atanh")
+                derivative = "1.0/(1.0-"+u+"*"+u+")";
+            else
+                return false;
+
+            return differentiate(children[0], "("+pAdjoint+"*"+derivative+")", pPartials);
+        }
+
+        // We don't know how to differentiate the given function (e.g.
+        // multi_max() or multi_min())
+
+        return false;
+    }
+    case CellmlFileRuntimeJacobianNode::Number:
+    case CellmlFileRuntimeJacobianNode::Identifier:
+    case CellmlFileRuntimeJacobianNode::Cast:
+        return true;
+    }
+
+    return false;
+}
+
+//==============================================================================
+
+QString CellmlFileRuntimeJacobian::tangent(const QString &pVariable) const
+{
+    // Return the beginning of the array element in which we keep track of the
+    // derivatives of the given variable with respect to our states, i.e.
+    // something like "DALGEBRAIC[k*N+", which is to be completed with the
+    // index of a state
+
+    QString array = pVariable.left(pVariable.indexOf('['));
+    int index = pVariable.mid(array.length()+1, pVariable.length()-array.length()-2).toInt();
+
+    return QString("%1[%2+").arg((array == Rates)?"JACOBIAN":"DALGEBRAIC")
+                            .arg(index*mStatesCount);
+}
+
+//==============================================================================
+
+bool CellmlFileRuntimeJacobian::generateStatementCode(const QString &pStatement)
+{
+    // Parse the given statement, which must be of the form 'X[i] = expr' with
+    // X either ALGEBRAIC or RATES
+
+    tokenize(pStatement);
+
+    bool validIndex;
+    int index = token(2).toInt(&validIndex);
+
+    if (   !validIndex || (token(1) != "[") || (token(3) != "]") || (token(4) != "=")
+        || (((token() != Algebraic) || (index >= mAlgebraicCount)) && ((token() != Rates) || (index >= mStatesCount)))) {
+        return false;
+    }
+
+    QString variable = token()+"["+QString::number(index)+"]";
+
+    mPosition = 5;
+
+    CellmlFileRuntimeJacobianNode *expression = parseExpression();
+
+    if (!expression)
+        return false;
+
+    if (mPosition != mTokens.count()) {
+        delete expression;
+
+        return false;
+    }
+
+    // Differentiate our expression
+
+    QMap<QString, QString> partials = QMap<QString, QString>();
+    bool active = isActive(expression);
+
+    if (active && !differentiate(expression, "1.0", partials)) {
+        delete expression;
+
+        return false;
+    }
+
+    delete expression;
+
+    // Generate the code that computes the derivatives of our variable, if
+    // needed, followed by the code for our statement
+    // Note: the derivatives are computed first since they rely on the value
+    //       our variable had before our statement (in case our statement
+    //       references our variable)...
+
+    mCode += "\n";
+
+    if (active || mActiveVariables.contains(variable)) {
+        QString variableTangent = tangent(variable);
+        QString tangentsSum = QString();
+        QString statesCode = QString();
+        int partialIndex = 0;
+
+        mCode += "    {\n";
+
+        foreach (const QString &partialVariable, partials.keys()) {
+            QString partialName = QString("d%1").arg(partialIndex++);
+
+            mCode += "        const double "+partialName+" = "+partials.value(partialVariable)+";\n";
+
+            if (partialVariable.startsWith(States+"[")) {
+                statesCode += "        "+variableTangent+partialVariable.mid(States.length()+1)
+                             +" += "+partialName+";\n";
+            } else {
+                tangentsSum += (tangentsSum.isEmpty()?QString():"+")
+                              +partialName+"*"+tangent(partialVariable)+"j]";
+            }
+        }
+
+        if (!partials.isEmpty())
+            mCode += "\n";
+
+        mCode += "        for (j = 0; j < "+QString::number(mStatesCount)+"; ++j)\n"
+                 "            "+variableTangent+"j] = "+(tangentsSum.isEmpty()?QString("0.0"):tangentsSum)+";\n";
+
+        if (!statesCode.isEmpty())
+            mCode += "\n"+statesCode;
+
+        mCode += "    }\n"
+                 "\n";
+
+        mActiveVariables << variable;
+    }
+
+    mCode += "    "+pStatement+";\n";
+
+    return true;
+}
+
+//==============================================================================
+
+}   // namespace CellMLSupport
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -0,0 +1,97 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// CellML file runtime Jacobian
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include "cellmlsupportglobal.h"
+
+//==============================================================================
+
+#include <QMap>
+#include <QSet>
+#include <QStringList>
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace CellMLSupport {
+
+//==============================================================================
+
+class CellmlFileRuntimeJacobianNode;
+
+//==============================================================================
+
+class CELLMLSUPPORT_EXPORT CellmlFileRuntimeJacobian
+{
+public:
+    explicit CellmlFileRuntimeJacobian(const QString &pRatesCode,
+                                       const int &pStatesCount,
+                                       const int &pAlgebraicCount);
+
+    bool isValid() const;
+
+    QString code() const;
+
+private:
+    int mStatesCount;
+    int mAlgebraicCount;
+
+    bool mValid;
+    QString mCode;
+
+    QStringList mTokens;
+    int mPosition;
+
+    QSet<QString> mActiveVariables;
+
+    QString token(const int &pOffset = 0) const;
+    bool accept(const QString &pToken);
+
+    void tokenize(const QString &pStatement);
+
+    CellmlFileRuntimeJacobianNode * parseExpression();
+    CellmlFileRuntimeJacobianNode * parseBinaryExpression(const int &pLevel);
+    CellmlFileRuntimeJacobianNode * parseUnaryExpression();
+    CellmlFileRuntimeJacobianNode * parsePrimaryExpression();
+
+    bool isActive(CellmlFileRuntimeJacobianNode *pNode) const;
+
+    bool differentiate(CellmlFileRuntimeJacobianNode *pNode,
+                       const QString &pAdjoint,
+                       QMap<QString, QString> &pPartials) const;
+
+    QString tangent(const QString &pVariable) const;
+
+    bool generateStatementCode(const QString &pStatement);
+};
+
+//==============================================================================
+
+}   // namespace CellMLSupport
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -25,6 +25,7 @@ limitations under the License.
 //==============================================================================
 
 #include "cellmlfile.h"
+#include "cellmlfileimportcache.h"
 #include "corecliutils.h"
 #include "tests.h"
 
@@ -34,6 +35,98 @@ limitations under the License.
 
 //==============================================================================
 
+#include <QTcpSocket>
+
+//==============================================================================
+
+HttpServer::HttpServer(const QByteArray &pContents, const QByteArray &pEtag) :
+    mContents(pContents),
+    mEtag(pEtag),
+    mRequestsCount(0),
+    mNotModifiedCount(0)
+{
+    // Act as a (very) minimal local HTTP server that serves some contents with
+    // a given ETag value
+
+    connect(this, SIGNAL(newConnection()),
+            this, SLOT(handleConnection()));
+
+    listen(QHostAddress::LocalHost);
+}
+
+//==============================================================================
+
+int HttpServer::requestsCount() const
+{
+    // Return the number of requests we have handled
+
+    return mRequestsCount;
+}
+
+//==============================================================================
+
+int HttpServer::notModifiedCount() const
+{
+    // Return the number of requests to which we replied that our contents were
+    // not modified
+
+    return mNotModifiedCount;
+}
+
+//==============================================================================
+
+void HttpServer::handleConnection()
+{
+    // Handle our pending connections
+
+    while (hasPendingConnections()) {
+        QTcpSocket *socket = nextPendingConnection();
+
+        connect(socket, SIGNAL(readyRead()),
+                this, SLOT(handleRequest()));
+        connect(socket, SIGNAL(disconnected()),
+                socket, SLOT(deleteLater()));
+    }
+}
+
+//==============================================================================
+
+void HttpServer::handleRequest()
+{
+    // Wait for the full header of the request before replying to it, either by
+    // telling the client that our contents were not modified (if it knows
+    // about our ETag value) or by sending our contents
+
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    QByteArray request = socket->property("request").toByteArray()+socket->readAll();
+
+    socket->setProperty("request", request);
+
+    if (!request.contains("\r\n\r\n"))
+        return;
+
+    ++mRequestsCount;
+
+    if (request.contains("If-None-Match: "+mEtag+"\r\n")) {
+        ++mNotModifiedCount;
+
+        socket->write("HTTP/1.1 304 Not Modified\r\n"
+                      "ETag: "+mEtag+"\r\n"
+                      "Connection: close\r\n"
+                      "\r\n");
+    } else {
+        socket->write("HTTP/1.1 200 OK\r\n"
+                      "ETag: "+mEtag+"\r\n"
+                      "Content-Length: "+QByteArray::number(mContents.size())+"\r\n"
+                      "Connection: close\r\n"
+                      "\r\n"+mContents);
+    }
+
+    socket->disconnectFromHost();
+}
+
+//==============================================================================
+
 void Tests::doRuntimeTest(const QString &pFileName,
                           const QString &pCellmlVersion,
                           const QStringList &pModelParameters)
@@ -123,6 +216,294 @@ void Tests::runtimeTests()
 
 //==============================================================================
 
+void Tests::jacobianTests()
+{
+    // Check that the Jacobian generated for the Noble 1962 model agrees with
+    // one computed using central finite differences
+
+    OpenCOR::CellMLSupport::CellmlFile cellmlFile(OpenCOR::fileName("models/noble_model_1962.cellml"));
+    OpenCOR::CellMLSupport::CellmlFileRuntime *runtime = cellmlFile.runtime();
+
+    QVERIFY(runtime);
+    QVERIFY(runtime->isValid());
+    QVERIFY(runtime->computeOdeJacobian());
+
+    int statesCount = runtime->statesCount();
+    int algebraicCount = runtime->algebraicCount();
+
+    QVector<double> constants = QVector<double>(runtime->constantsCount());
+    QVector<double> rates = QVector<double>(statesCount);
+    QVector<double> otherRates = QVector<double>(statesCount);
+    QVector<double> states = QVector<double>(statesCount);
+    QVector<double> algebraic = QVector<double>(qMax(1, algebraicCount));
+    QVector<double> jacobian = QVector<double>(statesCount*statesCount);
+    QVector<double> dAlgebraic = QVector<double>(qMax(1, algebraicCount*statesCount));
+
+    runtime->initializeConstants()(constants.data(), rates.data(), states.data());
+    runtime->computeComputedConstants()(constants.data(), rates.data(), states.data());
+    runtime->computeOdeJacobian()(0.0, constants.data(), rates.data(),
+                                  states.data(), algebraic.data(),
+                                  jacobian.data(), dAlgebraic.data());
+
+    for (int j = 0; j < statesCount; ++j) {
+        double state = states[j];
+        double delta = 1.0e-6*qMax(1.0, qAbs(state));
+
+        states[j] = state+delta;
+
+        runtime->computeOdeRates()(0.0, constants.data(), rates.data(),
+                                   states.data(), algebraic.data());
+
+        states[j] = state-delta;
+
+        runtime->computeOdeRates()(0.0, constants.data(), otherRates.data(),
+                                   states.data(), algebraic.data());
+
+        states[j] = state;
+
+        for (int i = 0; i < statesCount; ++i) {
+            double finiteDifference = (rates[i]-otherRates[i])/(2.0*delta);
+
+            QVERIFY(qAbs(jacobian[i*statesCount+j]-finiteDifference) <= 1.0e-4*qMax(1.0, qAbs(finiteDifference)));
+        }
+    }
+}
+
+//==============================================================================
+
+void Tests::specializationTests()
+{
+    // Check that the specialised versions of computeOdeRates for the Noble
+    // 1962 model agree with its generic version, be it with all of its
+    // constants inlined or with some of them varying
+
+    OpenCOR::CellMLSupport::CellmlFile cellmlFile(OpenCOR::fileName("models/noble_model_1962.cellml"));
+    OpenCOR::CellMLSupport::CellmlFileRuntime *runtime = cellmlFile.runtime();
+
+    QVERIFY(runtime);
+    QVERIFY(runtime->isValid());
+
+    int constantsCount = runtime->constantsCount();
+    int statesCount = runtime->statesCount();
+
+    QVector<double> constants = QVector<double>(constantsCount);
+    QVector<double> rates = QVector<double>(statesCount);
+    QVector<double> specializedRates = QVector<double>(statesCount);
+    QVector<double> states = QVector<double>(statesCount);
+    QVector<double> algebraic = QVector<double>(qMax(1, runtime->algebraicCount()));
+
+    for (int i = 0; i <= constantsCount; ++i) {
+        // Specialise computeOdeRates with either none or one of our constants
+        // varying
+
+        QList<int> varyingConstants = QList<int>();
+
+        if (i < constantsCount)
+            varyingConstants << i;
+
+        OpenCOR::CellMLSupport::CellmlFileRuntime::ComputeOdeRatesFunction computeOdeRates = runtime->specializedComputeOdeRates(varyingConstants);
+
+        QVERIFY(computeOdeRates);
+        QCOMPARE(runtime->specializedComputeOdeRates(varyingConstants), computeOdeRates);
+
+        // Modify our varying constant, if any, and check that both versions
+        // of computeOdeRates give the same rates
+
+        runtime->initializeConstants()(constants.data(), rates.data(), states.data());
+
+        if (i < constantsCount)
+            constants[i] *= 1.1;
+
+        runtime->computeComputedConstants()(constants.data(), rates.data(), states.data());
+
+        runtime->computeOdeRates()(0.0, constants.data(), rates.data(),
+                                   states.data(), algebraic.data());
+        computeOdeRates(0.0, constants.data(), specializedRates.data(),
+                        states.data(), algebraic.data());
+
+        for (int j = 0; j < statesCount; ++j)
+            QVERIFY(qAbs(specializedRates[j]-rates[j]) <= 1.0e-12*qMax(1.0, qAbs(rates[j])));
+    }
+}
+
+//==============================================================================
+
+void Tests::slicingTests()
+{
+    // Check that the sliced versions of computeOdeVariables for the Noble 1962
+    // model compute the same algebraic variables as its generic version
+
+    OpenCOR::CellMLSupport::CellmlFile cellmlFile(OpenCOR::fileName("models/noble_model_1962.cellml"));
+    OpenCOR::CellMLSupport::CellmlFileRuntime *runtime = cellmlFile.runtime();
+
+    QVERIFY(runtime);
+    QVERIFY(runtime->isValid());
+
+    int statesCount = runtime->statesCount();
+    int algebraicCount = runtime->algebraicCount();
+
+    QVector<double> constants = QVector<double>(runtime->constantsCount());
+    QVector<double> rates = QVector<double>(statesCount);
+    QVector<double> states = QVector<double>(statesCount);
+    QVector<double> algebraic = QVector<double>(qMax(1, algebraicCount));
+    QVector<double> slicedAlgebraic = QVector<double>(qMax(1, algebraicCount));
+
+    runtime->initializeConstants()(constants.data(), rates.data(), states.data());
+    runtime->computeComputedConstants()(constants.data(), rates.data(), states.data());
+    runtime->computeOdeRates()(0.0, constants.data(), rates.data(),
+                               states.data(), algebraic.data());
+    runtime->computeOdeVariables()(0.0, constants.data(), rates.data(),
+                                   states.data(), algebraic.data());
+
+    // Slice computeOdeVariables for each of our algebraic variables, as well
+    // as for none of them, and check that the algebraic variable of interest,
+    // if any, is the same as the one computed by the generic version
+
+    for (int i = 0; i <= algebraicCount; ++i) {
+        QList<int> slicedVariables = QList<int>();
+
+        if (i < algebraicCount)
+            slicedVariables << i;
+
+        OpenCOR::CellMLSupport::CellmlFileRuntime::ComputeOdeVariablesFunction computeOdeVariables = runtime->slicedComputeOdeVariables(slicedVariables);
+
+        QVERIFY(computeOdeVariables);
+        QCOMPARE(runtime->slicedComputeOdeVariables(slicedVariables), computeOdeVariables);
+
+        slicedAlgebraic.fill(0.0);
+
+        runtime->computeOdeRates()(0.0, constants.data(), rates.data(),
+                                   states.data(), slicedAlgebraic.data());
+        computeOdeVariables(0.0, constants.data(), rates.data(),
+                            states.data(), slicedAlgebraic.data());
+
+        if (i < algebraicCount)
+            QCOMPARE(slicedAlgebraic[i], algebraic[i]);
+    }
+}
+
+//==============================================================================
+
+void Tests::importCacheTests()
+{
+    // Use a temporary directory for our import cache and enable it
+
+    QTemporaryDir importCacheDirectory;
+    OpenCOR::CellMLSupport::CellmlFileImportCache *importCache = OpenCOR::CellMLSupport::CellmlFileImportCache::instance();
+
+    QVERIFY(importCacheDirectory.isValid());
+
+    importCache->setDirectory(importCacheDirectory.path());
+    importCache->setEnabled(true);
+    importCache->resetStatistics();
+
+    // Retrieve the contents of a couple of URLs from a local HTTP server for
+    // the first time, which should result in them being downloaded
+
+    QByteArray contents = "<model name=\"my_model\"/>";
+    HttpServer httpServer(contents, "\"1\"");
+
+    QVERIFY(httpServer.isListening());
+
+    QString baseUrl = QString("http://127.0.0.1:%1/").arg(httpServer.serverPort());
+    QStringList urls = QStringList() << baseUrl+"model1.cellml"
+                                     << baseUrl+"model2.cellml"
+                                     << baseUrl+"model1.cellml";
+    QMap<QString, QByteArray> urlsContents = importCache->contents(urls);
+
+    QCOMPARE(urlsContents.count(), 2);
+    QCOMPARE(urlsContents.value(urls[0]), contents);
+    QCOMPARE(urlsContents.value(urls[1]), contents);
+    QCOMPARE(httpServer.requestsCount(), 2);
+    QCOMPARE(httpServer.notModifiedCount(), 0);
+    QCOMPARE(importCache->hits(), quint64(0));
+    QCOMPARE(importCache->misses(), quint64(2));
+
+    // Retrieve the contents of our URLs again, which should result in them
+    // being revalidated rather than downloaded again
+
+    urlsContents = importCache->contents(urls);
+
+    QCOMPARE(urlsContents.count(), 2);
+    QCOMPARE(urlsContents.value(urls[0]), contents);
+    QCOMPARE(urlsContents.value(urls[1]), contents);
+    QCOMPARE(httpServer.requestsCount(), 4);
+    QCOMPARE(httpServer.notModifiedCount(), 2);
+    QCOMPARE(importCache->hits(), quint64(2));
+    QCOMPARE(importCache->misses(), quint64(2));
+
+    // Stop our local HTTP server and make sure that we fall back on our cached
+    // contents, but only for the URLs we know about
+
+    httpServer.close();
+
+    urlsContents = importCache->contents(urls << baseUrl+"model3.cellml");
+
+    QCOMPARE(urlsContents.count(), 2);
+    QCOMPARE(urlsContents.value(urls[0]), contents);
+    QCOMPARE(urlsContents.value(urls[1]), contents);
+    QCOMPARE(importCache->hits(), quint64(4));
+
+    // Clear our import cache and make sure that we can't retrieve anything
+    // anymore
+
+    importCache->clear();
+
+    QVERIFY(importCache->contents(urls).isEmpty());
+}
+
+//==============================================================================
+
+void Tests::specializationBenchmark_data()
+{
+    QTest::addColumn<bool>("specialized");
+
+    QTest::newRow("generic") << false;
+    QTest::newRow("specialized") << true;
+}
+
+//==============================================================================
+
+void Tests::specializationBenchmark()
+{
+    // Compare the time it takes to compute the rates of the Noble 1962 model
+    // using the generic and specialised (with no varying constants) versions of
+    // computeOdeRates
+
+    QFETCH(bool, specialized);
+
+    OpenCOR::CellMLSupport::CellmlFile cellmlFile(OpenCOR::fileName("models/noble_model_1962.cellml"));
+    OpenCOR::CellMLSupport::CellmlFileRuntime *runtime = cellmlFile.runtime();
+
+    QVERIFY(runtime);
+    QVERIFY(runtime->isValid());
+
+    OpenCOR::CellMLSupport::CellmlFileRuntime::ComputeOdeRatesFunction computeOdeRates = specialized?
+                                                                                              runtime->specializedComputeOdeRates(QList<int>()):
+                                                                                              runtime->computeOdeRates();
+
+    QVERIFY(computeOdeRates);
+
+    int statesCount = runtime->statesCount();
+
+    QVector<double> constants = QVector<double>(runtime->constantsCount());
+    QVector<double> rates = QVector<double>(statesCount);
+    QVector<double> states = QVector<double>(statesCount);
+    QVector<double> algebraic = QVector<double>(qMax(1, runtime->algebraicCount()));
+
+    runtime->initializeConstants()(constants.data(), rates.data(), states.data());
+    runtime->computeComputedConstants()(constants.data(), rates.data(), states.data());
+
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            computeOdeRates(0.001*i, constants.data(), rates.data(),
+                            states.data(), algebraic.data());
+        }
+    }
+}
+
+//==============================================================================
+
 QTEST_GUILESS_MAIN(Tests)
 
 //==============================================================================
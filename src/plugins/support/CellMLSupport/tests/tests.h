@@ -25,6 +25,31 @@ limitations under the License.
 //==============================================================================
 
 #include <QObject>
+#include <QTcpServer>
+
+//==============================================================================
+
+class HttpServer : public QTcpServer
+{
+    Q_OBJECT
+
+public:
+    explicit HttpServer(const QByteArray &pContents, const QByteArray &pEtag);
+
+    int requestsCount() const;
+    int notModifiedCount() const;
+
+private:
+    QByteArray mContents;
+    QByteArray mEtag;
+
+    int mRequestsCount;
+    int mNotModifiedCount;
+
+private slots:
+    void handleConnection();
+    void handleRequest();
+};
 
 //==============================================================================
 
@@ -38,6 +63,12 @@ private:
 
 private slots:
     void runtimeTests();
+    void jacobianTests();
+    void specializationTests();
+    void slicingTests();
+    void importCacheTests();
+    void specializationBenchmark_data();
+    void specializationBenchmark();
 };
 
 //==============================================================================
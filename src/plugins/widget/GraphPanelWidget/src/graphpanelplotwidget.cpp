@@ -33,6 +33,7 @@ limitations under the License.
 #include <QMenu>
 #include <QMessageBox>
 #include <QPaintEvent>
+#include <QtNumeric>
 
 //==============================================================================
 
@@ -40,6 +41,7 @@ limitations under the License.
 
 //==============================================================================
 
+#include "qwt_clipper.h"
 #include "qwt_painter.h"
 #include "qwt_plot_canvas.h"
 #include "qwt_plot_directpainter.h"
@@ -55,12 +57,85 @@ namespace GraphPanelWidget {
 
 //==============================================================================
 
+GraphPanelPlotGraphBucket::GraphPanelPlotGraphBucket(const int &pIndex,
+                                                     const double &pY) :
+    mMinIndex(pIndex),
+    mMaxIndex(pIndex),
+    mMinY(pY),
+    mMaxY(pY)
+{
+}
+
+//==============================================================================
+
+void GraphPanelPlotGraphBucket::add(const int &pIndex, const double &pY)
+{
+    // Add the given sample to ourselves
+    // Note: we test for NaN since it compares false with everything...
+
+    if ((pY < mMinY) || qIsNaN(mMinY)) {
+        mMinIndex = pIndex;
+        mMinY = pY;
+    }
+
+    if ((pY > mMaxY) || qIsNaN(mMaxY)) {
+        mMaxIndex = pIndex;
+        mMaxY = pY;
+    }
+}
+
+//==============================================================================
+
+void GraphPanelPlotGraphBucket::add(const GraphPanelPlotGraphBucket &pBucket)
+{
+    // Add the given bucket, which follows us, to ourselves
+
+    add(pBucket.mMinIndex, pBucket.mMinY);
+    add(pBucket.mMaxIndex, pBucket.mMaxY);
+}
+
+//==============================================================================
+
+int GraphPanelPlotGraphBucket::minIndex() const
+{
+    // Return the index of our minimum sample
+
+    return mMinIndex;
+}
+
+//==============================================================================
+
+int GraphPanelPlotGraphBucket::maxIndex() const
+{
+    // Return the index of our maximum sample
+
+    return mMaxIndex;
+}
+
+//==============================================================================
+
+// Number of samples in a bucket of our first level of detail
+// Note: the number of samples in a bucket doubles with each level of detail.
+//       Also, we don't want our first level of detail to be too fine since its
+//       memory footprint would otherwise be too big compared to that of our
+//       data...
+
+enum {
+    LevelOfDetailBucketSize = 64
+};
+
+//==============================================================================
+
 GraphPanelPlotGraph::GraphPanelPlotGraph(void *pParameterX, void *pParameterY) :
     QwtPlotCurve(),
     mSelected(true),
     mFileName(QString()),
     mParameterX(pParameterX),
-    mParameterY(pParameterY)
+    mParameterY(pParameterY),
+    mLevelsOfDetailSize(0),
+    mLevelsOfDetailMonotonic(true),
+    mLevelsOfDetailLastX(0.0),
+    mLevelsOfDetail(QList<GraphPanelPlotGraphBuckets>())
 {
     // Customise ourselves a bit
 
@@ -109,9 +184,12 @@ QString GraphPanelPlotGraph::fileName() const
 
 void GraphPanelPlotGraph::setFileName(const QString &pFileName)
 {
-    // Set our file name
+    // Set our file name and reset our levels of detail since our data will be
+    // coming from somewhere else
 
     mFileName = pFileName;
+
+    resetLevelsOfDetail();
 }
 
 //==============================================================================
@@ -127,9 +205,12 @@ void * GraphPanelPlotGraph::parameterX() const
 
 void GraphPanelPlotGraph::setParameterX(void *pParameterX)
 {
-    // Set our parameter X
+    // Set our parameter X and reset our levels of detail since our data will be
+    // different
 
     mParameterX = pParameterX;
+
+    resetLevelsOfDetail();
 }
 
 //==============================================================================
@@ -145,9 +226,244 @@ void * GraphPanelPlotGraph::parameterY() const
 
 void GraphPanelPlotGraph::setParameterY(void *pParameterY)
 {
-    // Set our parameter Y
+    // Set our parameter Y and reset our levels of detail since our data will be
+    // different
 
     mParameterY = pParameterY;
+
+    resetLevelsOfDetail();
+}
+
+//==============================================================================
+
+void GraphPanelPlotGraph::resetLevelsOfDetail()
+{
+    // Reset our levels of detail
+
+    mLevelsOfDetailSize = 0;
+    mLevelsOfDetailMonotonic = true;
+    mLevelsOfDetailLastX = 0.0;
+
+    mLevelsOfDetail.clear();
+}
+
+//==============================================================================
+
+void GraphPanelPlotGraph::dataChanged()
+{
+    // Default handling of the event
+
+    QwtPlotCurve::dataChanged();
+
+    // Our data has changed, so update our levels of detail, which consist of a
+    // min/max pyramid of buckets of samples
+    // Note #1: our data normally grows (as a simulation runs) and only the new
+    //          samples need processing. So, if our data has shrunk, then it
+    //          means that we have some new data altogether...
+    // Note #2: our levels of detail are only of use if our X values are
+    //          monotonic (e.g. when plotting something against time). If they
+    //          are not, then we give up on them until we get reset...
+
+    int size = int(dataSize());
+
+    if (size < mLevelsOfDetailSize)
+        resetLevelsOfDetail();
+
+    if (size == mLevelsOfDetailSize)
+        return;
+
+    int oldSize = mLevelsOfDetailSize;
+
+    mLevelsOfDetailSize = size;
+
+    if (!mLevelsOfDetailMonotonic)
+        return;
+
+    // Add our new samples to our first level of detail
+
+    if (mLevelsOfDetail.isEmpty())
+        mLevelsOfDetail << GraphPanelPlotGraphBuckets();
+
+    GraphPanelPlotGraphBuckets &firstLevelOfDetail = mLevelsOfDetail.first();
+
+    for (int i = oldSize; i < size; ++i) {
+        QPointF point = sample(i);
+
+        if (i && (point.x() < mLevelsOfDetailLastX)) {
+            mLevelsOfDetailMonotonic = false;
+
+            mLevelsOfDetail.clear();
+
+            return;
+        }
+
+        mLevelsOfDetailLastX = point.x();
+
+        if (i % LevelOfDetailBucketSize)
+            firstLevelOfDetail.last().add(i, point.y());
+        else
+            firstLevelOfDetail << GraphPanelPlotGraphBucket(i, point.y());
+    }
+
+    // Update our other levels of detail, starting from the first bucket that
+    // got modified
+
+    int firstBucket = oldSize/LevelOfDetailBucketSize;
+
+    for (int i = 1; mLevelsOfDetail[i-1].count() > 1; ++i) {
+        if (i == mLevelsOfDetail.count())
+            mLevelsOfDetail << GraphPanelPlotGraphBuckets();
+
+        const GraphPanelPlotGraphBuckets &lowerLevelOfDetail = mLevelsOfDetail[i-1];
+        GraphPanelPlotGraphBuckets &levelOfDetail = mLevelsOfDetail[i];
+        int lowerLevelOfDetailCount = lowerLevelOfDetail.count();
+
+        firstBucket /= 2;
+
+        levelOfDetail.resize(firstBucket);
+
+        for (int j = 2*firstBucket; j < lowerLevelOfDetailCount; j += 2) {
+            GraphPanelPlotGraphBucket bucket = lowerLevelOfDetail[j];
+
+            if (j+1 < lowerLevelOfDetailCount)
+                bucket.add(lowerLevelOfDetail[j+1]);
+
+            levelOfDetail << bucket;
+        }
+    }
+}
+
+//==============================================================================
+
+int GraphPanelPlotGraph::sampleIndex(const double &pX,
+                                     const bool &pLowerBound) const
+{
+    // Return the index of the first sample which X value is greater than or
+    // equal to (lower bound) or greater than (upper bound) the given X value
+    // Note: our X values are monotonic, so we can do a binary search...
+
+    int first = 0;
+    int count = mLevelsOfDetailSize;
+
+    while (count > 0) {
+        int step = count/2;
+        double x = sample(first+step).x();
+
+        if (pLowerBound?(x < pX):(x <= pX)) {
+            first += step+1;
+            count -= step+1;
+        } else {
+            count = step;
+        }
+    }
+
+    return first;
+}
+
+//==============================================================================
+
+void GraphPanelPlotGraph::addSamples(QPolygonF &pPolyline,
+                                     const QwtScaleMap &pXMap,
+                                     const QwtScaleMap &pYMap,
+                                     const int &pFrom, const int &pTo) const
+{
+    // Add the given samples, as canvas points, to the given polyline
+
+    for (int i = pFrom; i <= pTo; ++i) {
+        QPointF point = sample(i);
+
+        pPolyline << QPointF(pXMap.transform(point.x()),
+                             pYMap.transform(point.y()));
+    }
+}
+
+//==============================================================================
+
+void GraphPanelPlotGraph::drawLines(QPainter *pPainter,
+                                    const QwtScaleMap &pXMap,
+                                    const QwtScaleMap &pYMap,
+                                    const QRectF &pCanvasRect,
+                                    int pFrom, int pTo) const
+{
+    // Make sure that we can use our levels of detail, i.e. that they are up to
+    // date and that we are neither fitted nor filled
+
+    if (   mLevelsOfDetail.isEmpty() || (pTo >= mLevelsOfDetailSize)
+        || testCurveAttribute(Fitted) || (brush().style() != Qt::NoBrush)) {
+        QwtPlotCurve::drawLines(pPainter, pXMap, pYMap, pCanvasRect, pFrom, pTo);
+
+        return;
+    }
+
+    // Only consider the samples that are within our current X range, as well
+    // as the samples on either side of it, so that lines that go across our
+    // canvas' edges are still drawn
+
+    int from = qMax(pFrom, sampleIndex(qMin(pXMap.s1(), pXMap.s2()), true)-1);
+    int to = qMin(pTo, sampleIndex(qMax(pXMap.s1(), pXMap.s2()), false));
+
+    if (from > to)
+        return;
+
+    // Determine the coarsest level of detail that has buckets that are no
+    // bigger than the number of samples per pixel, if any
+
+    double samplesPerPixel = (to-from+1)/qMax(1.0, pCanvasRect.width());
+    int level = -1;
+
+    while (   (level+1 < mLevelsOfDetail.count())
+           && ((LevelOfDetailBucketSize << (level+1)) <= samplesPerPixel)) {
+        ++level;
+    }
+
+    if (level == -1) {
+        QwtPlotCurve::drawLines(pPainter, pXMap, pYMap, pCanvasRect, from, to);
+
+        return;
+    }
+
+    // Draw our samples using our level of detail, i.e. the first, minimum,
+    // maximum and last samples of each bucket (in the order in which they
+    // come), which means that spikes are preserved exactly
+    // Note: the samples that are at the beginning/end of our range and that
+    //       don't fill a bucket are drawn as is...
+
+    const GraphPanelPlotGraphBuckets &levelOfDetail = mLevelsOfDetail[level];
+    int bucketSize = LevelOfDetailBucketSize << level;
+    int firstBucket = (from+bucketSize-1)/bucketSize;
+    int lastBucket = (to+1)/bucketSize-1;
+    QPolygonF polyline;
+
+    addSamples(polyline, pXMap, pYMap, from, qMin(firstBucket*bucketSize, to+1)-1);
+
+    for (int i = firstBucket; i <= lastBucket; ++i) {
+        const GraphPanelPlotGraphBucket &bucket = levelOfDetail[i];
+        int firstIndex = i*bucketSize;
+        int indexes[] = { firstIndex,
+                          qMin(bucket.minIndex(), bucket.maxIndex()),
+                          qMax(bucket.minIndex(), bucket.maxIndex()),
+                          firstIndex+bucketSize-1 };
+        int previousIndex = -1;
+
+        for (int j = 0; j < 4; ++j) {
+            if (indexes[j] != previousIndex) {
+                addSamples(polyline, pXMap, pYMap, indexes[j], indexes[j]);
+
+                previousIndex = indexes[j];
+            }
+        }
+    }
+
+    addSamples(polyline, pXMap, pYMap, qMax(from, (lastBucket+1)*bucketSize), to);
+
+    if (testPaintAttribute(ClipPolygons)) {
+        double penWidth = qMax(1.0, pPainter->pen().widthF());
+
+        polyline = QwtClipper::clipPolygonF(pCanvasRect.adjusted(-penWidth, -penWidth, penWidth, penWidth),
+                                            polyline, false);
+    }
+
+    QwtPainter::drawPolyline(pPainter, polyline);
 }
 
 //==============================================================================
@@ -29,6 +29,10 @@ limitations under the License.
 
 //==============================================================================
 
+#include <QVector>
+
+//==============================================================================
+
 #include "qwt_plot.h"
 #include "qwt_plot_curve.h"
 #include "qwt_scale_draw.h"
@@ -57,6 +61,32 @@ static const QRectF DefPlotRect = QRectF(DefMinAxis, DefMinAxis,
 
 //==============================================================================
 
+class GraphPanelPlotGraphBucket
+{
+public:
+    explicit GraphPanelPlotGraphBucket(const int &pIndex = 0,
+                                       const double &pY = 0.0);
+
+    void add(const int &pIndex, const double &pY);
+    void add(const GraphPanelPlotGraphBucket &pBucket);
+
+    int minIndex() const;
+    int maxIndex() const;
+
+private:
+    int mMinIndex;
+    int mMaxIndex;
+
+    double mMinY;
+    double mMaxY;
+};
+
+//==============================================================================
+
+typedef QVector<GraphPanelPlotGraphBucket> GraphPanelPlotGraphBuckets;
+
+//==============================================================================
+
 class GRAPHPANELWIDGET_EXPORT GraphPanelPlotGraph : public QwtPlotCurve
 {
 public:
@@ -76,6 +106,15 @@ public:
     void * parameterY() const;
     void setParameterY(void *pParameterY);
 
+    void resetLevelsOfDetail();
+
+protected:
+    virtual void dataChanged();
+
+    virtual void drawLines(QPainter *pPainter, const QwtScaleMap &pXMap,
+                           const QwtScaleMap &pYMap, const QRectF &pCanvasRect,
+                           int pFrom, int pTo) const;
+
 private:
     bool mSelected;
 
@@ -83,6 +122,18 @@ private:
 
     void *mParameterX;
     void *mParameterY;
+
+    int mLevelsOfDetailSize;
+    bool mLevelsOfDetailMonotonic;
+    double mLevelsOfDetailLastX;
+
+    QList<GraphPanelPlotGraphBuckets> mLevelsOfDetail;
+
+    int sampleIndex(const double &pX, const bool &pLowerBound) const;
+
+    void addSamples(QPolygonF &pPolyline, const QwtScaleMap &pXMap,
+                    const QwtScaleMap &pYMap, const int &pFrom,
+                    const int &pTo) const;
 };
 
 //==============================================================================